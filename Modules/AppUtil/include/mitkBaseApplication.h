@@ -83,6 +83,7 @@ namespace mitk
     static const QString ARG_DEBUG;
     static const QString ARG_FORCE_PLUGIN_INSTALL;
     static const QString ARG_HOME;
+    static const QString ARG_LAZY_MODULE_ACTIVATION;
     static const QString ARG_NEWINSTANCE;
     static const QString ARG_NO_LAZY_REGISTRY_CACHE_LOADING;
     static const QString ARG_NO_REGISTRY_CACHE;
@@ -93,6 +94,7 @@ namespace mitk
     static const QString ARG_PROVISIONING;
     static const QString ARG_REGISTRY_MULTI_LANGUAGE;
     static const QString ARG_SPLASH_IMAGE;
+    static const QString ARG_STARTUP_TRACE;
     static const QString ARG_STORAGE_DIR;
     static const QString ARG_XARGS;
 
@@ -244,6 +246,12 @@ namespace mitk
      * This method is called in the initialize(Poco::Util::Application&)
      * after the CTK Plugin Framework storage directory property
      * was set.
+     *
+     * If the ARG_LAZY_MODULE_ACTIVATION argument was given, lazy
+     * activation is enabled for all modules loaded afterwards. Modules
+     * loaded before (e.g. MitkCore and its auto-load modules) are only
+     * activated lazily if the US_ENABLE_LAZY_ACTIVATION environment
+     * variable is set.
      */
     virtual void initializeCppMicroServices();
 
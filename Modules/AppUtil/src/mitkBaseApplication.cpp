@@ -25,6 +25,8 @@ found in the LICENSE file.
 #include <ctkPluginFramework_global.h>
 #include <ctkPluginFrameworkLauncher.h>
 
+#include <usModule.h>
+#include <usModuleRegistry.h>
 #include <usModuleSettings.h>
 
 #include <vtkOpenGLRenderWindow.h>
@@ -32,7 +34,12 @@ found in the LICENSE file.
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QRunnable>
 #include <QSplashScreen>
 #include <QStandardPaths>
@@ -81,6 +88,7 @@ namespace mitk
   const QString BaseApplication::ARG_DEBUG = "BlueBerry.debug";
   const QString BaseApplication::ARG_FORCE_PLUGIN_INSTALL = "BlueBerry.forcePlugins";
   const QString BaseApplication::ARG_HOME = "BlueBerry.home";
+  const QString BaseApplication::ARG_LAZY_MODULE_ACTIVATION = "BlueBerry.lazyModuleActivation";
   const QString BaseApplication::ARG_NEWINSTANCE = "BlueBerry.newInstance";
   const QString BaseApplication::ARG_NO_LAZY_REGISTRY_CACHE_LOADING = "BlueBerry.noLazyRegistryCacheLoading";
   const QString BaseApplication::ARG_NO_REGISTRY_CACHE = "BlueBerry.noRegistryCache";
@@ -91,6 +99,7 @@ namespace mitk
   const QString BaseApplication::ARG_PROVISIONING = "BlueBerry.provisioning";
   const QString BaseApplication::ARG_REGISTRY_MULTI_LANGUAGE = "BlueBerry.registryMultiLanguage";
   const QString BaseApplication::ARG_SPLASH_IMAGE = "BlueBerry.splashscreen";
+  const QString BaseApplication::ARG_STARTUP_TRACE = "BlueBerry.startupTrace";
   const QString BaseApplication::ARG_STORAGE_DIR = "BlueBerry.storageDir";
   const QString BaseApplication::ARG_XARGS = "xargs";
 
@@ -102,21 +111,79 @@ namespace mitk
   const QString BaseApplication::PROP_PRODUCT = "blueberry.product";
   const QString BaseApplication::PROP_REGISTRY_MULTI_LANGUAGE = BaseApplication::ARG_REGISTRY_MULTI_LANGUAGE;
 
-  class SplashCloserCallback : public QRunnable
+  /**
+   * Called by the CTK plugin framework launcher as soon as the
+   * application start-up has finished. Closes the splash screen and
+   * writes the (optional) start-up trace.
+   */
+  class StartupFinishedCallback : public QRunnable
   {
   public:
-    SplashCloserCallback(QSplashScreen* splashscreen)
-      : m_Splashscreen(splashscreen)
+    StartupFinishedCallback(QSplashScreen* splashscreen, const QElapsedTimer& timer, const QString& traceFile)
+      : m_Splashscreen(splashscreen),
+        m_Timer(timer),
+        m_TraceFile(traceFile)
     {
     }
 
     void run() override
     {
-      this->m_Splashscreen->close();
+      if (nullptr != m_Splashscreen)
+        m_Splashscreen->close();
+
+      if (!m_TraceFile.isEmpty())
+        this->WriteStartupTrace();
     }
 
   private:
+    static QJsonValue GetTime(const us::Module* module, const std::string& key)
+    {
+      auto value = module->GetProperty(key);
+
+      return value.Type() == typeid(long long)
+        ? QJsonValue(static_cast<double>(us::any_cast<long long>(value)))
+        : QJsonValue();
+    }
+
+    void WriteStartupTrace() const
+    {
+      QJsonArray modules;
+
+      for (const auto module : us::ModuleRegistry::GetLoadedModules())
+      {
+        QJsonObject moduleObject;
+        moduleObject["id"] = static_cast<double>(module->GetModuleId());
+        moduleObject["name"] = QString::fromStdString(module->GetName());
+        moduleObject["location"] = QString::fromStdString(module->GetLocation());
+        moduleObject["activationPolicy"] = QString::fromStdString(module->GetProperty(us::Module::PROP_ACTIVATION_POLICY()).ToString());
+        moduleObject["activated"] = module->IsActivated();
+        moduleObject["initTime"] = GetTime(module, us::Module::PROP_STARTUP_INIT_TIME());
+        moduleObject["activatorTime"] = GetTime(module, us::Module::PROP_STARTUP_ACTIVATOR_TIME());
+        moduleObject["autoLoadTime"] = GetTime(module, us::Module::PROP_STARTUP_AUTOLOAD_TIME());
+        modules.append(moduleObject);
+      }
+
+      // Module times are given in microseconds, the start-up time in milliseconds
+      QJsonObject trace;
+      trace["startupTime"] = static_cast<double>(m_Timer.elapsed());
+      trace["lazyActivation"] = us::ModuleSettings::IsLazyActivationEnabled();
+      trace["modules"] = modules;
+
+      QFile file(m_TraceFile);
+
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      {
+        MITK_WARN << "Could not write start-up trace to " << m_TraceFile.toStdString();
+        return;
+      }
+
+      file.write(QJsonDocument(trace).toJson());
+      MITK_INFO << "Start-up trace written to " << m_TraceFile.toStdString();
+    }
+
     QSplashScreen *m_Splashscreen; // Owned by BaseApplication::Impl
+    QElapsedTimer m_Timer;
+    QString m_TraceFile;
   };
 
   struct BaseApplication::Impl
@@ -140,7 +207,9 @@ namespace mitk
     bool m_SafeMode;
 
     QSplashScreen *m_Splashscreen;
-    SplashCloserCallback *m_SplashscreenClosingCallback;
+    StartupFinishedCallback *m_StartupFinishedCallback;
+
+    QElapsedTimer m_StartupTimer;
 
     QStringList m_PreloadLibs;
     QString m_ProvFile;
@@ -154,8 +223,10 @@ namespace mitk
         m_SingleMode(false),
         m_SafeMode(true),
         m_Splashscreen(nullptr),
-        m_SplashscreenClosingCallback(nullptr)
+        m_StartupFinishedCallback(nullptr)
     {
+      m_StartupTimer.start();
+
 #ifdef Q_OS_MAC
       /* On macOS the process serial number is passed as an command line argument (-psn_<NUMBER>)
          in certain circumstances. This option causes a Poco exception. We remove it, if present. */
@@ -179,7 +250,7 @@ namespace mitk
 
     ~Impl()
     {
-      delete m_SplashscreenClosingCallback;
+      delete m_StartupFinishedCallback;
       delete m_Splashscreen;
       delete m_QApp;
     }
@@ -625,6 +696,9 @@ namespace mitk
 
     if (!storageDir.isEmpty())
       us::ModuleSettings::SetStoragePath((storageDir + "us" + QDir::separator()).toStdString());
+
+    if (this->getProperty(ARG_LAZY_MODULE_ACTIVATION).toBool())
+      us::ModuleSettings::SetLazyActivationEnabled(true);
   }
 
   QCoreApplication *BaseApplication::getQApplication() const
@@ -690,13 +764,15 @@ namespace mitk
     for (auto const &arg : args)
       arguments.push_back(QString::fromStdString(arg));
 
-    if (nullptr != d->m_Splashscreen)
+    auto traceFile = d->getProperty(ARG_STARTUP_TRACE).toString();
+
+    if (nullptr != d->m_Splashscreen || !traceFile.isEmpty())
     {
-      // A splash screen is displayed. Create the closing callback.
-      d->m_SplashscreenClosingCallback = new SplashCloserCallback(d->m_Splashscreen);
+      // A splash screen is displayed or a start-up trace was requested. Create the callback.
+      d->m_StartupFinishedCallback = new StartupFinishedCallback(d->m_Splashscreen, d->m_StartupTimer, traceFile);
     }
 
-    return ctkPluginFrameworkLauncher::run(d->m_SplashscreenClosingCallback, QVariant::fromValue(arguments)).toInt();
+    return ctkPluginFrameworkLauncher::run(d->m_StartupFinishedCallback, QVariant::fromValue(arguments)).toInt();
   }
 
   void BaseApplication::defineOptions(Poco::Util::OptionSet &options)
@@ -759,6 +835,14 @@ namespace mitk
     registryMultiLanguageOption.callback(Poco::Util::OptionCallback<Impl>(d, &Impl::handleBooleanOption));
     options.addOption(registryMultiLanguageOption);
 
+    Poco::Util::Option lazyModuleActivationOption(ARG_LAZY_MODULE_ACTIVATION.toStdString(), "", "activate modules with a lazy activation policy on demand");
+    lazyModuleActivationOption.callback(Poco::Util::OptionCallback<Impl>(d, &Impl::handleBooleanOption));
+    options.addOption(lazyModuleActivationOption);
+
+    Poco::Util::Option startupTraceOption(ARG_STARTUP_TRACE.toStdString(), "", "write a start-up trace in JSON format");
+    startupTraceOption.argument("<filename>").binding(ARG_STARTUP_TRACE.toStdString());
+    options.addOption(startupTraceOption);
+
   Poco::Util::Option splashScreenOption(ARG_SPLASH_IMAGE.toStdString(), "", "optional picture to use as a splash screen");
   splashScreenOption.argument("<filename>").binding(ARG_SPLASH_IMAGE.toStdString());
   options.addOption(splashScreenOption);
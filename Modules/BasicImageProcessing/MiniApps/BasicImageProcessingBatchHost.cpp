@@ -0,0 +1,25 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCommandLineBatchHost.h"
+
+// Entry functions of the apps of this directory. They are compiled into the batch host with
+// MITK_COMMANDLINE_BATCH_HOST defined, which removes their main functions.
+int ResampleImageMain(int argc, char* argv[]);
+
+int main(int argc, char* argv[])
+{
+  mitk::CommandLineBatchHost host;
+  host.RegisterApp("ResampleImage", &ResampleImageMain);
+
+  return host.Execute(argc, argv, "Basic Image Processing Batch Host");
+}
@@ -15,7 +15,7 @@ found in the LICENSE file.
 #include "mitkCommandLineParser.h"
 #include "mitkIOUtil.h"
 
-#include <mitkArithmeticOperation.h>
+#include <mitkArithmeticExpression.h>
 
 static bool ConvertToBool(std::map<std::string, us::Any> &data, std::string name)
 {
@@ -90,55 +90,63 @@ int main(int argc, char* argv[])
   bool resultAsDouble = ConvertToBool(parsedArgs, "as-double");
   MITK_INFO << "Output image as double: " << resultAsDouble;
 
-  mitk::Image::Pointer tmpImage = image->Clone();
+  // the operations are only recorded and evaluated at once when the result is computed
+  mitk::ArithmeticExpression expression(image);
   if (ConvertToBool(parsedArgs, "image-right"))
   {
     if (ConvertToBool(parsedArgs, "add"))
     {
-      MITK_INFO << " Start Doing Operation: ADD()";
-      tmpImage = mitk::ArithmeticOperation::Add(value, tmpImage, resultAsDouble);
+      MITK_INFO << "Adding operation ADD()";
+      expression = value + expression;
     }
     if (ConvertToBool(parsedArgs, "subtract"))
     {
-      MITK_INFO << " Start Doing Operation: SUB()";
-      tmpImage = mitk::ArithmeticOperation::Subtract(value, tmpImage, resultAsDouble);
+      MITK_INFO << "Adding operation SUB()";
+      expression = value - expression;
     }
     if (ConvertToBool(parsedArgs, "multiply"))
     {
-      MITK_INFO << " Start Doing Operation: MULT()";
-      tmpImage = mitk::ArithmeticOperation::Multiply(value, tmpImage, resultAsDouble);
+      MITK_INFO << "Adding operation MULT()";
+      expression = value * expression;
     }
     if (ConvertToBool(parsedArgs, "divide"))
     {
-      MITK_INFO << " Start Doing Operation: DIV()";
-      tmpImage = mitk::ArithmeticOperation::Divide(value, tmpImage, resultAsDouble);
+      MITK_INFO << "Adding operation DIV()";
+      expression = value / expression;
     }
   }
   else {
     if (ConvertToBool(parsedArgs, "add"))
     {
-      MITK_INFO << " Start Doing Operation: ADD()";
-      tmpImage = mitk::ArithmeticOperation::Add(tmpImage, value, resultAsDouble);
+      MITK_INFO << "Adding operation ADD()";
+      expression = expression + value;
     }
     if (ConvertToBool(parsedArgs, "subtract"))
     {
-      MITK_INFO << " Start Doing Operation: SUB()";
-      tmpImage = mitk::ArithmeticOperation::Subtract(tmpImage, value, resultAsDouble);
+      MITK_INFO << "Adding operation SUB()";
+      expression = expression - value;
     }
     if (ConvertToBool(parsedArgs, "multiply"))
     {
-      MITK_INFO << " Start Doing Operation: MULT()";
-      tmpImage = mitk::ArithmeticOperation::Multiply(tmpImage, value, resultAsDouble);
+      MITK_INFO << "Adding operation MULT()";
+      expression = expression * value;
     }
     if (ConvertToBool(parsedArgs, "divide"))
     {
-      MITK_INFO << " Start Doing Operation: DIV()";
-      tmpImage = mitk::ArithmeticOperation::Divide(tmpImage, value, resultAsDouble);
+      MITK_INFO << "Adding operation DIV()";
+      expression = expression / value;
     }
 
   }
 
-  mitk::IOUtil::Save(tmpImage, outputFilename);
+  const mitk::PixelType::ItkIOComponentType outputComponentType =
+    resultAsDouble ? itk::ImageIOBase::DOUBLE
+                   : static_cast<mitk::PixelType::ItkIOComponentType>(image->GetPixelType().GetComponentType());
+  MITK_INFO << "Start evaluating the operations";
+  mitk::Image::Pointer resultImage = expression.Evaluate(outputComponentType);
+  MITK_INFO << "Finished evaluating the operations";
+
+  mitk::IOUtil::Save(resultImage, outputFilename);
 
   return EXIT_SUCCESS;
 }
@@ -31,7 +31,7 @@ static bool ConvertToBool(std::map<std::string, us::Any> &data, std::string name
   }
 }
 
-int main(int argc, char* argv[])
+int ResampleImageMain(int argc, char* argv[])
 {
   mitkCommandLineParser parser;
 
@@ -158,3 +158,10 @@ int main(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return ResampleImageMain(argc, argv);
+}
+#endif
@@ -15,7 +15,7 @@ found in the LICENSE file.
 #include "mitkCommandLineParser.h"
 #include "mitkIOUtil.h"
 
-#include <mitkArithmeticOperation.h>
+#include <mitkArithmeticExpression.h>
 
 static bool ConvertToBool(std::map<std::string, us::Any> &data, std::string name)
 {
@@ -101,30 +101,38 @@ int main(int argc, char* argv[])
   bool resultAsDouble = ConvertToBool(parsedArgs, "as-double");
   MITK_INFO << "Output image as double: " << resultAsDouble;
 
-  mitk::Image::Pointer tmpImage = image1->Clone();
+  // the operations are only recorded and evaluated at once when the result is computed
+  mitk::ArithmeticExpression expression(image1);
 
   if (ConvertToBool(parsedArgs, "add"))
   {
-    MITK_INFO << " Start Doing Operation: ADD()";
-    tmpImage = mitk::ArithmeticOperation::Add(tmpImage, image2, resultAsDouble);
+    MITK_INFO << "Adding operation ADD()";
+    expression = expression + image2;
   }
   if (ConvertToBool(parsedArgs, "subtract"))
   {
-    MITK_INFO << " Start Doing Operation: SUB()";
-    tmpImage = mitk::ArithmeticOperation::Subtract(tmpImage, image2, resultAsDouble);
+    MITK_INFO << "Adding operation SUB()";
+    expression = expression - image2;
   }
   if (ConvertToBool(parsedArgs, "multiply"))
   {
-    MITK_INFO << " Start Doing Operation: MULT()";
-    tmpImage = mitk::ArithmeticOperation::Multiply(tmpImage, image2, resultAsDouble);
+    MITK_INFO << "Adding operation MULT()";
+    expression = expression * image2;
   }
   if (ConvertToBool(parsedArgs, "divide"))
   {
-    MITK_INFO << " Start Doing Operation: DIV()";
-    tmpImage = mitk::ArithmeticOperation::Divide(tmpImage, image2, resultAsDouble);
+    MITK_INFO << "Adding operation DIV()";
+    expression = expression / image2;
   }
 
-  mitk::IOUtil::Save(tmpImage, outputFilename);
+  const mitk::PixelType::ItkIOComponentType outputComponentType =
+    resultAsDouble ? itk::ImageIOBase::DOUBLE
+                   : static_cast<mitk::PixelType::ItkIOComponentType>(image1->GetPixelType().GetComponentType());
+  MITK_INFO << "Start evaluating the operations";
+  mitk::Image::Pointer resultImage = expression.Evaluate(outputComponentType);
+  MITK_INFO << "Finished evaluating the operations";
+
+  mitk::IOUtil::Save(resultImage, outputFilename);
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,121 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkArithmeticExpression_h
+#define mitkArithmeticExpression_h
+
+#include <mitkImage.h>
+#include <MitkBasicImageProcessingExports.h>
+
+#include <memory>
+
+namespace mitk
+{
+  /** \brief Arithmetic expression on images and values that is evaluated in one pass
+  *
+  * In contrast to mitk::ArithmeticOperation, building an expression does not compute anything. The
+  * operators and functions only record a small operation graph. Evaluate() then computes the whole
+  * expression voxel block by voxel block: each operation runs over a block in a tight loop, the
+  * blocks are distributed to several threads and no intermediate images are allocated. All
+  * intermediate values are double, only the result is converted to the chosen pixel type.
+  *
+  * All images of an expression must be scalar and have the same dimensions. The geometry of the
+  * result is taken from the first image of the expression.
+  *
+  * \code
+  * mitk::ArithmeticExpression a(imageA);
+  * auto expression = mitk::ArithmeticExpression::Sqrt(a * a + 1.0) / imageB;
+  * mitk::Image::Pointer result = expression.Evaluate(itk::ImageIOBase::FLOAT);
+  * \endcode
+  */
+  class MITKBASICIMAGEPROCESSING_EXPORT ArithmeticExpression
+  {
+  public:
+    enum class OperationType
+    {
+      Image,
+      Value,
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Pow,
+      Tan,
+      Atan,
+      Cos,
+      Acos,
+      Sin,
+      Asin,
+      Square,
+      Sqrt,
+      Abs,
+      Exp,
+      ExpNeg,
+      Log10
+    };
+
+    ArithmeticExpression(const Image *image);
+    ArithmeticExpression(const Image::Pointer &image);
+    ArithmeticExpression(double value);
+
+    static ArithmeticExpression Pow(const ArithmeticExpression &base, const ArithmeticExpression &exponent);
+    static ArithmeticExpression Tan(const ArithmeticExpression &expression);
+    static ArithmeticExpression Atan(const ArithmeticExpression &expression);
+    static ArithmeticExpression Cos(const ArithmeticExpression &expression);
+    static ArithmeticExpression Acos(const ArithmeticExpression &expression);
+    static ArithmeticExpression Sin(const ArithmeticExpression &expression);
+    static ArithmeticExpression Asin(const ArithmeticExpression &expression);
+    static ArithmeticExpression Square(const ArithmeticExpression &expression);
+    static ArithmeticExpression Sqrt(const ArithmeticExpression &expression);
+    static ArithmeticExpression Abs(const ArithmeticExpression &expression);
+    static ArithmeticExpression Exp(const ArithmeticExpression &expression);
+    static ArithmeticExpression ExpNeg(const ArithmeticExpression &expression);
+    static ArithmeticExpression Log10(const ArithmeticExpression &expression);
+
+    friend ArithmeticExpression operator+(const ArithmeticExpression &a, const ArithmeticExpression &b)
+    {
+      return ArithmeticExpression(OperationType::Add, a, b);
+    }
+    friend ArithmeticExpression operator-(const ArithmeticExpression &a, const ArithmeticExpression &b)
+    {
+      return ArithmeticExpression(OperationType::Subtract, a, b);
+    }
+    friend ArithmeticExpression operator*(const ArithmeticExpression &a, const ArithmeticExpression &b)
+    {
+      return ArithmeticExpression(OperationType::Multiply, a, b);
+    }
+    friend ArithmeticExpression operator/(const ArithmeticExpression &a, const ArithmeticExpression &b)
+    {
+      return ArithmeticExpression(OperationType::Divide, a, b);
+    }
+
+    /** Computes the expression.
+    *
+    * Integer results are rounded towards zero and clamped to the range of the pixel type.
+    * @param outputComponentType pixel type of the result, e.g. itk::ImageIOBase::DOUBLE.
+    * @param numberOfThreads number of threads, 0 (default) to use the default number of threads of ITK.
+    * @exception mitk::Exception if the expression contains no image, the images are not scalar, have
+    * different dimensions or the pixel type is not supported.
+    */
+    Image::Pointer Evaluate(PixelType::ItkIOComponentType outputComponentType = itk::ImageIOBase::DOUBLE,
+                            unsigned int numberOfThreads = 0) const;
+
+  private:
+    struct Node;
+
+    ArithmeticExpression(OperationType operation, const ArithmeticExpression &a);
+    ArithmeticExpression(OperationType operation, const ArithmeticExpression &a, const ArithmeticExpression &b);
+
+    std::shared_ptr<const Node> m_Node;
+  };
+}
+#endif // mitkArithmeticExpression_h
@@ -0,0 +1,475 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkArithmeticExpression.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+struct mitk::ArithmeticExpression::Node
+{
+  OperationType Operation;
+  double Value;
+  Image::ConstPointer InputImage;
+  std::shared_ptr<const Node> Operands[2];
+};
+
+namespace
+{
+  typedef mitk::ArithmeticExpression::OperationType OperationType;
+
+  // number of voxels that are computed by one operation at once
+  const std::size_t BlockSize = 1024;
+  // number of blocks that are computed by a thread at once
+  const std::size_t BlocksPerTask = 64;
+
+  typedef void (*ReadBlockFunction)(const void *buffer, std::size_t offset, std::size_t count, double *values);
+
+  template <typename TPixel>
+  void ReadBlock(const void *buffer, std::size_t offset, std::size_t count, double *values)
+  {
+    const TPixel *pixels = static_cast<const TPixel *>(buffer) + offset;
+    for (std::size_t i = 0; i < count; ++i)
+      values[i] = static_cast<double>(pixels[i]);
+  }
+
+  template <typename TPixel>
+  void WriteBlock(const double *values, std::size_t offset, std::size_t count, void *buffer)
+  {
+    TPixel *pixels = static_cast<TPixel *>(buffer) + offset;
+    if (std::numeric_limits<TPixel>::is_integer)
+    {
+      const double lowest = std::numeric_limits<TPixel>::lowest();
+      const double max = std::numeric_limits<TPixel>::max();
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const double value = values[i];
+        pixels[i] = std::isnan(value) ? TPixel(0) : static_cast<TPixel>(std::min(std::max(value, lowest), max));
+      }
+    }
+    else
+    {
+      for (std::size_t i = 0; i < count; ++i)
+        pixels[i] = static_cast<TPixel>(values[i]);
+    }
+  }
+
+  ReadBlockFunction GetReadBlockFunction(int componentType)
+  {
+    switch (componentType)
+    {
+      case itk::ImageIOBase::UCHAR:
+        return &ReadBlock<unsigned char>;
+      case itk::ImageIOBase::CHAR:
+        return &ReadBlock<char>;
+      case itk::ImageIOBase::USHORT:
+        return &ReadBlock<unsigned short>;
+      case itk::ImageIOBase::SHORT:
+        return &ReadBlock<short>;
+      case itk::ImageIOBase::UINT:
+        return &ReadBlock<unsigned int>;
+      case itk::ImageIOBase::INT:
+        return &ReadBlock<int>;
+      case itk::ImageIOBase::ULONG:
+        return &ReadBlock<unsigned long>;
+      case itk::ImageIOBase::LONG:
+        return &ReadBlock<long>;
+      case itk::ImageIOBase::FLOAT:
+        return &ReadBlock<float>;
+      case itk::ImageIOBase::DOUBLE:
+        return &ReadBlock<double>;
+      default:
+        mitkThrow() << "Cannot evaluate arithmetic expression. Unsupported pixel type of input image: "
+                    << itk::ImageIOBase::GetComponentTypeAsString(static_cast<itk::ImageIOBase::IOComponentType>(componentType));
+    }
+  }
+
+  struct Instruction
+  {
+    OperationType Operation;
+    double Value;
+    std::size_t Input;
+  };
+
+  struct Input
+  {
+    const void *Buffer;
+    ReadBlockFunction Read;
+  };
+
+  template <typename TFunction>
+  inline void UnaryBlock(double *a, std::size_t count, TFunction function)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      a[i] = function(a[i]);
+  }
+
+  template <typename TFunction>
+  inline void BinaryBlock(double *a, const double *b, std::size_t count, TFunction function)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      a[i] = function(a[i], b[i]);
+  }
+
+  void EvaluateBlock(const std::vector<Instruction> &program,
+                     const std::vector<Input> &inputs,
+                     std::size_t offset,
+                     std::size_t count,
+                     double *stack)
+  {
+    // points behind the topmost block of the stack
+    double *top = stack;
+
+    for (const auto &instruction : program)
+    {
+      switch (instruction.Operation)
+      {
+        case OperationType::Image:
+          inputs[instruction.Input].Read(inputs[instruction.Input].Buffer, offset, count, top);
+          top += BlockSize;
+          break;
+        case OperationType::Value:
+          std::fill(top, top + count, instruction.Value);
+          top += BlockSize;
+          break;
+
+        case OperationType::Add:
+          top -= BlockSize;
+          BinaryBlock(top - BlockSize, top, count, [](double x, double y) { return x + y; });
+          break;
+        case OperationType::Subtract:
+          top -= BlockSize;
+          BinaryBlock(top - BlockSize, top, count, [](double x, double y) { return x - y; });
+          break;
+        case OperationType::Multiply:
+          top -= BlockSize;
+          BinaryBlock(top - BlockSize, top, count, [](double x, double y) { return x * y; });
+          break;
+        case OperationType::Divide:
+          top -= BlockSize;
+          BinaryBlock(top - BlockSize, top, count, [](double x, double y) { return x / y; });
+          break;
+        case OperationType::Pow:
+          top -= BlockSize;
+          BinaryBlock(top - BlockSize, top, count, [](double x, double y) { return std::pow(x, y); });
+          break;
+
+        case OperationType::Tan:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::tan(x); });
+          break;
+        case OperationType::Atan:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::atan(x); });
+          break;
+        case OperationType::Cos:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::cos(x); });
+          break;
+        case OperationType::Acos:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::acos(x); });
+          break;
+        case OperationType::Sin:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::sin(x); });
+          break;
+        case OperationType::Asin:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::asin(x); });
+          break;
+        case OperationType::Square:
+          UnaryBlock(top - BlockSize, count, [](double x) { return x * x; });
+          break;
+        case OperationType::Sqrt:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::sqrt(x); });
+          break;
+        case OperationType::Abs:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::abs(x); });
+          break;
+        case OperationType::Exp:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::exp(x); });
+          break;
+        case OperationType::ExpNeg:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::exp(-x); });
+          break;
+        case OperationType::Log10:
+          UnaryBlock(top - BlockSize, count, [](double x) { return std::log10(x); });
+          break;
+      }
+    }
+  }
+
+  template <typename TOutputPixel>
+  mitk::Image::Pointer EvaluateProgram(const std::vector<Instruction> &program,
+                                       std::size_t stackDepth,
+                                       const std::vector<Input> &inputs,
+                                       const mitk::Image *referenceImage,
+                                       unsigned int numberOfThreads)
+  {
+    mitk::Image::Pointer outputImage = mitk::Image::New();
+    outputImage->Initialize(
+      mitk::MakeScalarPixelType<TOutputPixel>(), referenceImage->GetDimension(), referenceImage->GetDimensions());
+    outputImage->SetClonedTimeGeometry(referenceImage->GetTimeGeometry());
+
+    std::size_t numberOfVoxels = 1;
+    for (unsigned int i = 0; i < referenceImage->GetDimension(); ++i)
+      numberOfVoxels *= referenceImage->GetDimension(i);
+
+    mitk::ImageWriteAccessor outputAccessor(outputImage);
+    void *outputBuffer = outputAccessor.GetData();
+
+    const std::size_t voxelsPerTask = BlockSize * BlocksPerTask;
+    const std::size_t numberOfTasks = (numberOfVoxels + voxelsPerTask - 1) / voxelsPerTask;
+    numberOfThreads = mitk::GetParallelForNumberOfThreads(numberOfTasks, numberOfThreads);
+
+    std::vector<std::vector<double>> stacks(numberOfThreads, std::vector<double>(stackDepth * BlockSize));
+
+    mitk::ParallelFor(numberOfTasks, numberOfThreads, [&](std::size_t task, unsigned int thread) {
+      double *stack = stacks[thread].data();
+      const std::size_t taskEnd = std::min(numberOfVoxels, (task + 1) * voxelsPerTask);
+
+      for (std::size_t offset = task * voxelsPerTask; offset < taskEnd; offset += BlockSize)
+      {
+        const std::size_t count = std::min(BlockSize, taskEnd - offset);
+        EvaluateBlock(program, inputs, offset, count, stack);
+        WriteBlock<TOutputPixel>(stack, offset, count, outputBuffer);
+      }
+    });
+
+    return outputImage;
+  }
+}
+
+mitk::ArithmeticExpression::ArithmeticExpression(const Image *image)
+{
+  if (image == nullptr)
+  {
+    mitkThrow() << "Cannot create arithmetic expression. Image is nullptr.";
+  }
+
+  auto node = std::make_shared<Node>();
+  node->Operation = OperationType::Image;
+  node->Value = 0.0;
+  node->InputImage = image;
+  m_Node = node;
+}
+
+mitk::ArithmeticExpression::ArithmeticExpression(const Image::Pointer &image)
+  : ArithmeticExpression(image.GetPointer())
+{
+}
+
+mitk::ArithmeticExpression::ArithmeticExpression(double value)
+{
+  auto node = std::make_shared<Node>();
+  node->Operation = OperationType::Value;
+  node->Value = value;
+  m_Node = node;
+}
+
+mitk::ArithmeticExpression::ArithmeticExpression(OperationType operation, const ArithmeticExpression &a)
+{
+  auto node = std::make_shared<Node>();
+  node->Operation = operation;
+  node->Value = 0.0;
+  node->Operands[0] = a.m_Node;
+  m_Node = node;
+}
+
+mitk::ArithmeticExpression::ArithmeticExpression(OperationType operation,
+                                                 const ArithmeticExpression &a,
+                                                 const ArithmeticExpression &b)
+{
+  auto node = std::make_shared<Node>();
+  node->Operation = operation;
+  node->Value = 0.0;
+  node->Operands[0] = a.m_Node;
+  node->Operands[1] = b.m_Node;
+  m_Node = node;
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Pow(const ArithmeticExpression &base,
+                                                           const ArithmeticExpression &exponent)
+{
+  return ArithmeticExpression(OperationType::Pow, base, exponent);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Tan(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Tan, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Atan(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Atan, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Cos(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Cos, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Acos(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Acos, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Sin(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Sin, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Asin(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Asin, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Square(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Square, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Sqrt(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Sqrt, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Abs(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Abs, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Exp(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Exp, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::ExpNeg(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::ExpNeg, expression);
+}
+
+mitk::ArithmeticExpression mitk::ArithmeticExpression::Log10(const ArithmeticExpression &expression)
+{
+  return ArithmeticExpression(OperationType::Log10, expression);
+}
+
+mitk::Image::Pointer mitk::ArithmeticExpression::Evaluate(PixelType::ItkIOComponentType outputComponentType,
+                                                          unsigned int numberOfThreads) const
+{
+  std::vector<Instruction> program;
+  std::vector<const Image *> images;
+  std::size_t stackDepth = 0;
+
+  // convert the graph into a postfix program by a post-order traversal; each instruction pushes a block onto the
+  // stack of the program or replaces the topmost block(s) by the result of the operation
+  std::vector<std::pair<const Node *, bool>> traversal(1, std::make_pair(m_Node.get(), false));
+  std::size_t depth = 0;
+
+  while (!traversal.empty())
+  {
+    const Node *node = traversal.back().first;
+    const bool operandsDone = traversal.back().second;
+    traversal.pop_back();
+
+    if (!operandsDone && node->Operands[0] != nullptr)
+    {
+      traversal.emplace_back(node, true);
+      if (node->Operands[1] != nullptr)
+        traversal.emplace_back(node->Operands[1].get(), false);
+      traversal.emplace_back(node->Operands[0].get(), false);
+      continue;
+    }
+
+    Instruction instruction;
+    instruction.Operation = node->Operation;
+    instruction.Value = node->Value;
+    instruction.Input = 0;
+
+    if (node->Operation == OperationType::Image)
+    {
+      auto image = std::find(images.begin(), images.end(), node->InputImage.GetPointer());
+      instruction.Input = image - images.begin();
+      if (image == images.end())
+        images.push_back(node->InputImage.GetPointer());
+    }
+
+    if (node->Operands[0] == nullptr)
+    {
+      stackDepth = std::max(stackDepth, ++depth);
+    }
+    else if (node->Operands[1] != nullptr)
+    {
+      --depth;
+    }
+
+    program.push_back(instruction);
+  }
+
+  if (images.empty())
+  {
+    mitkThrow() << "Cannot evaluate arithmetic expression. The expression contains no image.";
+  }
+
+  const Image *referenceImage = images.front();
+  std::vector<std::unique_ptr<ImageReadAccessor>> accessors;
+  std::vector<Input> inputs;
+
+  for (const auto image : images)
+  {
+    if (image->GetPixelType().GetNumberOfComponents() != 1)
+    {
+      mitkThrow() << "Cannot evaluate arithmetic expression. Only images with scalar pixel types are supported.";
+    }
+
+    bool sameDimensions = image->GetDimension() == referenceImage->GetDimension();
+    for (unsigned int i = 0; sameDimensions && i < image->GetDimension(); ++i)
+      sameDimensions = image->GetDimension(i) == referenceImage->GetDimension(i);
+
+    if (!sameDimensions)
+    {
+      mitkThrow() << "Cannot evaluate arithmetic expression. Images have different dimensions.";
+    }
+
+    accessors.emplace_back(new ImageReadAccessor(image));
+
+    Input input;
+    input.Buffer = accessors.back()->GetData();
+    input.Read = GetReadBlockFunction(image->GetPixelType().GetComponentType());
+    inputs.push_back(input);
+  }
+
+  switch (outputComponentType)
+  {
+    case itk::ImageIOBase::UCHAR:
+      return EvaluateProgram<unsigned char>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::CHAR:
+      return EvaluateProgram<char>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::USHORT:
+      return EvaluateProgram<unsigned short>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::SHORT:
+      return EvaluateProgram<short>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::UINT:
+      return EvaluateProgram<unsigned int>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::INT:
+      return EvaluateProgram<int>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::FLOAT:
+      return EvaluateProgram<float>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    case itk::ImageIOBase::DOUBLE:
+      return EvaluateProgram<double>(program, stackDepth, inputs, referenceImage, numberOfThreads);
+    default:
+      mitkThrow() << "Cannot evaluate arithmetic expression. Unsupported output pixel type: "
+                  << itk::ImageIOBase::GetComponentTypeAsString(outputComponentType);
+  }
+}
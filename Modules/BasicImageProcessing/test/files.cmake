@@ -0,0 +1,8 @@
+set(MODULE_TESTS
+  mitkArithmeticExpressionTest.cpp
+)
+
+# not run by ctest, the benchmark takes some time and only reports timings
+set(MODULE_CUSTOM_TESTS
+  mitkArithmeticExpressionBenchmarkTest.cpp
+)
@@ -0,0 +1,84 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkArithmeticExpression.h>
+#include <mitkArithmeticOperation.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <chrono>
+
+/** Compares the runtime of a fused expression with the separate operations. It is not part of the regular tests,
+ * run it with the test driver of the module: MitkBasicImageProcessingTestDriver mitkArithmeticExpressionBenchmarkTest */
+class mitkArithmeticExpressionBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkArithmeticExpressionBenchmarkTestSuite);
+  MITK_TEST(Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer CreateImage(unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ)
+  {
+    unsigned int dimensions[3] = {sizeX, sizeY, sizeZ};
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<double>(), 3, dimensions);
+
+    mitk::ImageWriteAccessor accessor(image);
+    double *buffer = static_cast<double *>(accessor.GetData());
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(sizeX) * sizeY * sizeZ;
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      buffer[i] = static_cast<double>(i % 200) - 100.0;
+
+    return image;
+  }
+
+public:
+  /** 5 operations on a 256^3 double image, compared with the separate operations of mitk::ArithmeticOperation */
+  void Benchmark()
+  {
+    mitk::Image::Pointer image = CreateImage(256, 256, 256);
+
+    auto start = std::chrono::steady_clock::now();
+
+    mitk::Image::Pointer separateResult = mitk::ArithmeticOperation::Multiply(image, 0.5, true);
+    separateResult = mitk::ArithmeticOperation::Add(separateResult, 3.0, true);
+    separateResult = mitk::ArithmeticOperation::Square(separateResult, true);
+    separateResult = mitk::ArithmeticOperation::Sqrt(separateResult, true);
+    separateResult = mitk::ArithmeticOperation::Log10(separateResult, true);
+
+    auto separateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+
+    mitk::ArithmeticExpression a(image);
+    auto fusedResult = mitk::ArithmeticExpression::Log10(
+                         mitk::ArithmeticExpression::Sqrt(mitk::ArithmeticExpression::Square(a * 0.5 + 3.0)))
+                         .Evaluate();
+
+    auto fusedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    MITK_INFO << "5 operations on 256^3 voxels: separate operations " << separateTime << " s, fused expression "
+              << fusedTime << " s";
+
+    mitk::ImageReadAccessor separateAccessor(separateResult);
+    mitk::ImageReadAccessor fusedAccessor(fusedResult);
+    const double *separateBuffer = static_cast<const double *>(separateAccessor.GetData());
+    const double *fusedBuffer = static_cast<const double *>(fusedAccessor.GetData());
+    for (std::size_t i = 0; i < 256 * 256 * 256; i += 997)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(separateBuffer[i], fusedBuffer[i], 1e-9);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkArithmeticExpressionBenchmark)
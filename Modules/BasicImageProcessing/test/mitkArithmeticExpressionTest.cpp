@@ -0,0 +1,198 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkArithmeticExpression.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <itkMath.h>
+
+#include <cmath>
+
+class mitkArithmeticExpressionTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkArithmeticExpressionTestSuite);
+  MITK_TEST(TestImageAndValueOperations);
+  MITK_TEST(TestTwoImageOperations);
+  MITK_TEST(TestUnaryOperations);
+  MITK_TEST(TestIntegerOutput);
+  MITK_TEST(TestGeometry);
+  MITK_TEST(TestInvalidExpressions);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_ShortImage;
+  mitk::Image::Pointer m_FloatImage;
+
+  template <typename TPixel>
+  mitk::Image::Pointer CreateImage(unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ, double (*value)(std::size_t))
+  {
+    unsigned int dimensions[3] = {sizeX, sizeY, sizeZ};
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<TPixel>(), 3, dimensions);
+
+    mitk::ImageWriteAccessor accessor(image);
+    TPixel *buffer = static_cast<TPixel *>(accessor.GetData());
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(sizeX) * sizeY * sizeZ;
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      buffer[i] = static_cast<TPixel>(value(i));
+
+    return image;
+  }
+
+  static double ShortValue(std::size_t i) { return static_cast<double>(i % 200) - 100.0; }
+  static double FloatValue(std::size_t i) { return 0.5 + static_cast<double>(i % 7); }
+
+  /** checks each voxel of the double image against the expected values of the voxel indices */
+  template <typename TFunction>
+  void CheckDoubleImage(mitk::Image *image, TFunction expected)
+  {
+    CPPUNIT_ASSERT(image->GetPixelType().GetComponentType() == itk::ImageIOBase::DOUBLE);
+
+    std::size_t numberOfVoxels = 1;
+    for (unsigned int i = 0; i < image->GetDimension(); ++i)
+      numberOfVoxels *= image->GetDimension(i);
+
+    mitk::ImageReadAccessor accessor(image);
+    const double *buffer = static_cast<const double *>(accessor.GetData());
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+    {
+      if (!itk::Math::FloatAlmostEqual(buffer[i], expected(i), 4, 1e-10))
+      {
+        CPPUNIT_FAIL("Voxel " + std::to_string(i) + ": " + std::to_string(buffer[i]) +
+                     " != " + std::to_string(expected(i)));
+      }
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    // not a multiple of the block size of the evaluation
+    m_ShortImage = CreateImage<short>(37, 29, 11, &ShortValue);
+    m_FloatImage = CreateImage<float>(37, 29, 11, &FloatValue);
+  }
+
+  void tearDown() override
+  {
+    m_ShortImage = nullptr;
+    m_FloatImage = nullptr;
+  }
+
+  void TestImageAndValueOperations()
+  {
+    mitk::ArithmeticExpression a(m_ShortImage);
+
+    auto result = ((a + 2.0) * 3.0 - 1.0).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return (ShortValue(i) + 2.0) * 3.0 - 1.0; });
+
+    result = (10.0 - a / 4.0).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return 10.0 - ShortValue(i) / 4.0; });
+
+    result = mitk::ArithmeticExpression::Pow(a, 2.0).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return ShortValue(i) * ShortValue(i); });
+  }
+
+  void TestTwoImageOperations()
+  {
+    mitk::ArithmeticExpression a(m_ShortImage);
+    mitk::ArithmeticExpression b(m_FloatImage);
+
+    auto result = (a * b - a / b).Evaluate(itk::ImageIOBase::DOUBLE, 4);
+    CheckDoubleImage(result, [](std::size_t i) {
+      return ShortValue(i) * FloatValue(i) - ShortValue(i) / FloatValue(i);
+    });
+  }
+
+  void TestUnaryOperations()
+  {
+    mitk::ArithmeticExpression b(m_FloatImage);
+
+    auto result = mitk::ArithmeticExpression::Sqrt(mitk::ArithmeticExpression::Square(b) + 1.0).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return std::sqrt(FloatValue(i) * FloatValue(i) + 1.0); });
+
+    result = mitk::ArithmeticExpression::Log10(mitk::ArithmeticExpression::Exp(b)).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return std::log10(std::exp(FloatValue(i))); });
+
+    result = (mitk::ArithmeticExpression::Sin(b) * mitk::ArithmeticExpression::Cos(b) +
+              mitk::ArithmeticExpression::Atan(b) - mitk::ArithmeticExpression::ExpNeg(b))
+               .Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) {
+      const double x = FloatValue(i);
+      return std::sin(x) * std::cos(x) + std::atan(x) - std::exp(-x);
+    });
+
+    result = mitk::ArithmeticExpression::Abs(m_ShortImage).Evaluate();
+    CheckDoubleImage(result, [](std::size_t i) { return std::abs(ShortValue(i)); });
+  }
+
+  void TestIntegerOutput()
+  {
+    mitk::ArithmeticExpression a(m_ShortImage);
+
+    // values are clamped to the range of the output pixel type and rounded towards zero
+    auto result = (a * 1000.0 + 0.5).Evaluate(itk::ImageIOBase::SHORT);
+    CPPUNIT_ASSERT(result->GetPixelType().GetComponentType() == itk::ImageIOBase::SHORT);
+
+    mitk::ImageReadAccessor accessor(result);
+    const short *buffer = static_cast<const short *>(accessor.GetData());
+    for (std::size_t i = 0; i < 37 * 29 * 11; ++i)
+    {
+      const double expected = std::max(-32768.0, std::min(32767.0, ShortValue(i) * 1000.0 + 0.5));
+      CPPUNIT_ASSERT_EQUAL(static_cast<short>(expected), buffer[i]);
+    }
+
+    // NaN becomes 0
+    result = mitk::ArithmeticExpression::Sqrt(a - 1000.0).Evaluate(itk::ImageIOBase::UCHAR);
+    mitk::ImageReadAccessor nanAccessor(result);
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(static_cast<const unsigned char *>(nanAccessor.GetData())[0]));
+  }
+
+  void TestGeometry()
+  {
+    mitk::Vector3D spacing;
+    spacing[0] = 0.5;
+    spacing[1] = 2.0;
+    spacing[2] = 3.0;
+    m_FloatImage->SetSpacing(spacing);
+
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, 10.0, -20.0, 5.0);
+    m_FloatImage->SetOrigin(origin);
+
+    // the geometry is taken from the first image of the expression
+    auto result = (mitk::ArithmeticExpression(m_FloatImage) + m_ShortImage).Evaluate(itk::ImageIOBase::FLOAT);
+    CPPUNIT_ASSERT(result->GetPixelType().GetComponentType() == itk::ImageIOBase::FLOAT);
+    CPPUNIT_ASSERT_EQUAL(3u, result->GetDimension());
+    CPPUNIT_ASSERT_EQUAL(37u, result->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL(29u, result->GetDimension(1));
+    CPPUNIT_ASSERT_EQUAL(11u, result->GetDimension(2));
+    CPPUNIT_ASSERT(mitk::Equal(spacing, result->GetGeometry()->GetSpacing()));
+    CPPUNIT_ASSERT(mitk::Equal(origin, result->GetGeometry()->GetOrigin()));
+  }
+
+  void TestInvalidExpressions()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::ArithmeticExpression(2.0).Evaluate(), mitk::Exception);
+
+    auto smallImage = CreateImage<short>(10, 10, 10, &ShortValue);
+    CPPUNIT_ASSERT_THROW((mitk::ArithmeticExpression(m_ShortImage) + smallImage).Evaluate(), mitk::Exception);
+
+    CPPUNIT_ASSERT_THROW(mitk::ArithmeticExpression(m_ShortImage).Evaluate(itk::ImageIOBase::LONG), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkArithmeticExpression)
@@ -23,6 +23,9 @@ found in the LICENSE file.
 
 #include "itkImage.h"
 
+#include <functional>
+#include <vector>
+
 namespace mitk
 {
   /** Documentation
@@ -70,6 +73,16 @@ namespace mitk
     */
     itkSetMacro(UseCropTimeStepOnly, bool);
     itkGetMacro(UseCropTimeStepOnly, bool);
+    /**
+    * @brief Sets and Gets whether the output may reference the memory of the input instead of a copy (default: \a false)
+    *
+    * Only used for time steps where no pixel gets the outside value and the cropped region is contiguous in the
+    * memory of the input (e.g. when only slices are removed). The input must then outlive the output and must
+    * not be modified while the output is in use. All other time steps are copied.
+    */
+    itkSetMacro(ReferenceInputMemory, bool);
+    itkGetMacro(ReferenceInputMemory, bool);
+    itkBooleanMacro(ReferenceInputMemory);
 
   protected:
     BoundingShapeCropper();
@@ -86,6 +99,9 @@ namespace mitk
 
     /**
     * @brief Template Function for cropping and masking images with scalar pixel type
+    *
+    * Prepares the output of the time step and adds the copying of the pixels to the tasks that are run in
+    * parallel by GenerateData(). If all pixels are inside the bounding object, whole rows are copied.
     */
     template <typename TPixel, unsigned int VImageDimension>
     void CutImage(itk::Image<TPixel, VImageDimension> *inputItkImage, int timeStep);
@@ -122,6 +138,10 @@ namespace mitk
     */
     bool m_UseWholeInputRegion;
     /**
+    * @brief Use m_ReferenceInputMemory for referencing instead of copying contiguous crops (default: \a false)
+    */
+    bool m_ReferenceInputMemory;
+    /**
     * @brief Select single input image in a timeseries
     */
     mitk::ImageTimeSelector::Pointer m_InputTimeSelector;
@@ -136,6 +156,10 @@ namespace mitk
 
     mitk::SlicedData::RegionType m_InputRequestedRegion;
     /**
+    * @brief Copying of the time steps, collected by CutImage and run in parallel by GenerateData
+    */
+    std::vector<std::function<void()>> m_CutTasks;
+    /**
     * @brief Time when Header was last initialized
     **/
     itk::TimeStamp m_TimeOfHeaderInitialization;
@@ -15,9 +15,11 @@ found in the LICENSE file.
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
 #include "mitkImageToItk.h"
+#include "mitkParallelFor.h"
 #include "mitkStatusBar.h"
 #include "mitkTimeHelper.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "vtkMatrix4x4.h"
@@ -38,6 +40,7 @@ namespace mitk
     m_UseCropTimeStepOnly(false),
     m_CurrentTimeStep(0),
     m_UseWholeInputRegion(false),
+    m_ReferenceInputMemory(false),
     m_InputTimeSelector(mitk::ImageTimeSelector::New()),
     m_OutputTimeSelector(mitk::ImageTimeSelector::New())
   {
@@ -89,20 +92,6 @@ namespace mitk
     // create the ITK-image-region out of index and size
     ItkRegionType inputRegionOfInterest(index, size);
 
-    // Get access to the MITK output image via an ITK image
-    typename mitk::ImageToItk<ItkOutputImageType>::Pointer outputimagetoitk =
-      mitk::ImageToItk<ItkOutputImageType>::New();
-    outputimagetoitk->SetInput(this->m_OutputTimeSelector->GetOutput());
-    outputimagetoitk->Update();
-    typename ItkOutputImageType::Pointer outputItkImage = outputimagetoitk->GetOutput();
-
-    // create the iterators
-    ItkInputImageIteratorType inputIt(inputItkImage, inputRegionOfInterest);
-    ItkOutputImageIteratorType outputIt(outputItkImage, outputItkImage->GetLargestPossibleRegion());
-
-    // Cut the boundingbox out of the image by iterating through all images
-    // TODO: use more efficient method by using the contour instead off all single pixels
-    mitk::Point3D p;
     mitk::BaseGeometry *inputGeometry = this->GetInput()->GetGeometry(timeStep);
 
     // calculates translation based on offset+extent not on the transformation matrix
@@ -123,30 +112,132 @@ namespace mitk
     for (unsigned int i = 0; i < 3; ++i)
       extent[i] = (this->m_Geometry->GetGeometry()->GetExtent(i));
 
-    for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    // transforms an index of the input image to object coordinates: index to world followed by world to object
+    auto worldToObject = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Invert(transform->GetMatrix(), worldToObject);
+    auto indexToObject = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Multiply4x4(worldToObject, inputGeometry->GetVtkTransform()->GetMatrix(), indexToObject);
+
+    double indexToObjectMatrix[3][4];
+    for (unsigned int i = 0; i < 3; ++i)
+      for (unsigned int j = 0; j < 4; ++j)
+        indexToObjectMatrix[i][j] = indexToObject->GetElement(i, j);
+
+    // check if the index is within bounds
+    auto isInside = [indexToObjectMatrix, extent](const typename ItkRegionType::IndexType &pixelIndex) {
+      ScalarType p[3] = {0, 0, 0};
+      for (unsigned int j = 0; j < VImageDimension && j < 3; ++j)
+        p[j] = pixelIndex[j];
+
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const ScalarType p2 = indexToObjectMatrix[i][0] * p[0] + indexToObjectMatrix[i][1] * p[1] +
+                              indexToObjectMatrix[i][2] * p[2] + indexToObjectMatrix[i][3];
+        if (p2 < (-extent[i] / 2.0) || p2 > (extent[i] / 2.0))
+          return false;
+      }
+      return true;
+    };
+
+    const bool cropTimeStep = !this->m_UseCropTimeStepOnly || timeStep == this->m_CurrentTimeStep;
+
+    // the bounding object is convex, so all pixels are inside if all corners of the region are inside
+    bool allInside = cropTimeStep && inputRegionOfInterest.GetNumberOfPixels() > 0;
+    for (unsigned int corner = 0; allInside && corner < (1u << VImageDimension); ++corner)
     {
-      vtk2itk(inputIt.GetIndex(), p);
-      inputGeometry->IndexToWorld(p, p);
-      ScalarType p2[4];
-      p2[0] = p[0];
-      p2[1] = p[1];
-      p2[2] = p[2];
-      p2[3] = 1;
-      // transform point from world to object coordinates
-      transform->GetInverse()->TransformPoint(p2, p2);
-      // check if the world point is within bounds
-      bool isInside = (p2[0] >= (-extent[0] / 2.0)) && (p2[0] <= (extent[0] / 2.0)) && (p2[1] >= (-extent[1] / 2.0)) &&
-        (p2[1] <= (extent[1] / 2.0)) && (p2[2] >= (-extent[2] / 2.0)) && (p2[2] <= (extent[2] / 2.0));
-
-      if ((!this->m_UseCropTimeStepOnly && isInside) ||
-        (this->m_UseCropTimeStepOnly && timeStep == this->m_CurrentTimeStep && isInside))
+      typename ItkRegionType::IndexType cornerIndex = index;
+      for (unsigned int i = 0; i < VImageDimension; ++i)
       {
-        outputIt.Set((TOutputPixel)inputIt.Value());
+        if (corner & (1u << i))
+          cornerIndex[i] += static_cast<itk::IndexValueType>(size[i]) - 1;
       }
-      else
+      allInside = isInside(cornerIndex);
+    }
+
+    if (allInside && this->m_ReferenceInputMemory)
+    {
+      // the region is contiguous in memory if all dimensions after the first cropped one have size 1
+      const typename ItkRegionType::SizeType bufferedSize = inputItkImage->GetBufferedRegion().GetSize();
+      bool isContiguous = true;
+      bool isCropped = false;
+      for (unsigned int i = 0; i < VImageDimension; ++i)
       {
-        outputIt.Set(outsideValue);
+        if (isCropped && size[i] > 1)
+          isContiguous = false;
+
+        if (size[i] != bufferedSize[i])
+          isCropped = true;
       }
+
+      if (isContiguous)
+      {
+        TPixel *data = inputItkImage->GetBufferPointer() + inputItkImage->ComputeOffset(index);
+        this->GetOutput()->SetImportVolume(data, this->m_OutputTimeSelector->GetTimeNr(), 0, Image::ReferenceMemory);
+        return;
+      }
+    }
+
+    // Get access to the MITK output image via an ITK image
+    this->m_OutputTimeSelector->UpdateLargestPossibleRegion();
+    typename mitk::ImageToItk<ItkOutputImageType>::Pointer outputimagetoitk =
+      mitk::ImageToItk<ItkOutputImageType>::New();
+    outputimagetoitk->SetInput(this->m_OutputTimeSelector->GetOutput());
+    outputimagetoitk->Update();
+    typename ItkOutputImageType::Pointer outputItkImage = outputimagetoitk->GetOutput();
+    typename ItkInputImageType::Pointer input = inputItkImage;
+
+    if (allInside)
+    {
+      // copy the region row by row
+      this->m_CutTasks.push_back([input, outputItkImage, inputRegionOfInterest]() {
+        const typename ItkRegionType::IndexType &start = inputRegionOfInterest.GetIndex();
+        const typename ItkRegionType::SizeType &regionSize = inputRegionOfInterest.GetSize();
+        const TPixel *inputBuffer = input->GetBufferPointer();
+        TOutputPixel *outputBuffer = outputItkImage->GetBufferPointer();
+
+        const itk::SizeValueType rowLength = regionSize[0];
+        const itk::SizeValueType numberOfRows = inputRegionOfInterest.GetNumberOfPixels() / rowLength;
+
+        typename ItkRegionType::IndexType rowIndex = start;
+        for (itk::SizeValueType row = 0; row < numberOfRows; ++row)
+        {
+          const TPixel *inputRow = inputBuffer + input->ComputeOffset(rowIndex);
+          std::copy(inputRow, inputRow + rowLength, outputBuffer + row * rowLength);
+
+          for (unsigned int i = 1; i < VImageDimension; ++i)
+          {
+            if (++rowIndex[i] < start[i] + static_cast<itk::IndexValueType>(regionSize[i]))
+              break;
+
+            rowIndex[i] = start[i];
+          }
+        }
+      });
+    }
+    else if (!cropTimeStep)
+    {
+      this->m_CutTasks.push_back([outputItkImage, outsideValue]() { outputItkImage->FillBuffer(outsideValue); });
+    }
+    else
+    {
+      // Cut the boundingbox out of the image by iterating through all images
+      // TODO: use more efficient method by using the contour instead off all single pixels
+      this->m_CutTasks.push_back([input, outputItkImage, inputRegionOfInterest, isInside, outsideValue]() {
+        ItkInputImageIteratorType inputIt(input, inputRegionOfInterest);
+        ItkOutputImageIteratorType outputIt(outputItkImage, outputItkImage->GetLargestPossibleRegion());
+
+        for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+        {
+          if (isInside(inputIt.GetIndex()))
+          {
+            outputIt.Set((TOutputPixel)inputIt.Value());
+          }
+          else
+          {
+            outputIt.Set(outsideValue);
+          }
+        }
+      });
     }
   }
 
@@ -211,17 +302,12 @@ namespace mitk
     mitk::BoundingBox::PointType min = bsBoxRelativeToImage->GetMinimum();
     mitk::SlicedData::SizeType size = m_InputRequestedRegion.GetSize(); // init times and channels
     mitk::BoundingBox::PointType max = bsBoxRelativeToImage->GetMaximum();
-    mitk::Point<BoundingBox::PointType::CoordRepType, 5> maxCorrected;
-    maxCorrected[0] = max[0];
-    maxCorrected[1] = max[1];
-    maxCorrected[2] = max[2];
-    maxCorrected[3] = input->GetDimensions()[3];
-    maxCorrected[4] = 0;
-
-    for (unsigned int i = 0; i < dimension; i++)
+
+    // the bounding box is 3D, times and channels keep the largest possible region
+    for (unsigned int i = 0; i < 3; i++)
     {
       index[i] = (mitk::SlicedData::IndexType::IndexValueType)(std::ceil(min[i]));
-      size[i] = (mitk::SlicedData::SizeType::SizeValueType)(std::ceil(maxCorrected[i]) - index[i]);
+      size[i] = (mitk::SlicedData::SizeType::SizeValueType)(std::ceil(max[i]) - index[i]);
     }
     mitk::SlicedData::RegionType bsRegion(index, size);
 
@@ -284,6 +370,7 @@ namespace mitk
 
     m_InputTimeSelector->SetInput(input);
     m_OutputTimeSelector->SetInput(this->GetOutput());
+    m_CutTasks.clear();
 
     mitk::BoundingShapeCropper::RegionType outputRegion = output->GetRequestedRegion();
     mitk::BaseGeometry *inputImageGeometry = input->GetSlicedGeometry();
@@ -307,7 +394,6 @@ namespace mitk
       m_InputTimeSelector->SetTimeNr(m_CurrentTimeStep);
       m_InputTimeSelector->UpdateLargestPossibleRegion();
       m_OutputTimeSelector->SetTimeNr(tstart);
-      m_OutputTimeSelector->UpdateLargestPossibleRegion();
       ComputeData(m_InputTimeSelector->GetOutput(), m_CurrentTimeStep);
     }
     else
@@ -327,10 +413,17 @@ namespace mitk
         m_InputTimeSelector->SetTimeNr(t);
         m_InputTimeSelector->UpdateLargestPossibleRegion();
         m_OutputTimeSelector->SetTimeNr(t);
-        m_OutputTimeSelector->UpdateLargestPossibleRegion();
         ComputeData(m_InputTimeSelector->GetOutput(), t);
       }
     }
+
+    // the time steps are prepared one after another, the pixels are copied in parallel
+    mitk::ParallelFor(m_CutTasks.size(),
+                      this->GetNumberOfThreads(),
+                      [this](std::size_t i) { m_CutTasks[i](); },
+                      this->GetMultiThreader());
+    m_CutTasks.clear();
+
     m_InputTimeSelector->SetInput(nullptr);
     m_OutputTimeSelector->SetInput(nullptr);
     m_TimeOfHeaderInitialization.Modified();
@@ -0,0 +1,311 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkBoundingShapeCropper.h>
+#include <mitkGeometry3D.h>
+#include <mitkGeometryData.h>
+#include <mitkITKImageImport.h>
+#include <mitkImageReadAccessor.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkMath.h>
+
+namespace
+{
+  const short OutsideValue = -1;
+}
+
+class mitkBoundingShapeCropperTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBoundingShapeCropperTestSuite);
+  MITK_TEST(Crop_AxisAlignedBox_SameResultAsIterator);
+  MITK_TEST(Crop_RotatedBox_SameResultAsIterator);
+  MITK_TEST(Mask_RotatedBox_SameResultAsIterator);
+  MITK_TEST(Crop_4D_SameResultAsIterator);
+  MITK_TEST(Crop_4DCropTimeStepOnly_SameResultAsIterator);
+  MITK_TEST(Crop_ReferenceInputMemoryContiguousRegion_ReferencesInput);
+  MITK_TEST(Crop_ReferenceInputMemoryNonContiguousRegion_CopiesInput);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ImageType;
+  typedef itk::Image<short, 4> TimeImageType;
+
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_TimeImage;
+
+  /** Image with unique pixel values and an anisotropic spacing. */
+  template <typename TImageType>
+  static mitk::Image::Pointer CreateImage(unsigned int numberOfTimeSteps)
+  {
+    typename TImageType::RegionType region;
+    region.SetSize(0, 20);
+    region.SetSize(1, 16);
+    region.SetSize(2, 12);
+    for (unsigned int i = 3; i < TImageType::ImageDimension; ++i)
+      region.SetSize(i, numberOfTimeSteps);
+
+    typename TImageType::SpacingType spacing;
+    spacing.Fill(1.0);
+    spacing[2] = 2.0;
+
+    typename TImageType::Pointer image = TImageType::New();
+    image->SetRegions(region);
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    for (itk::ImageRegionIteratorWithIndex<TImageType> it(image, region); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      auto value = index[0] + 20 * index[1] + 320 * index[2];
+      for (unsigned int i = 3; i < TImageType::ImageDimension; ++i)
+        value += 4000 * index[i];
+
+      it.Set(static_cast<short>(value));
+    }
+
+    return mitk::GrabItkImageMemory(image);
+  }
+
+  static mitk::GeometryData::Pointer CreateBox(const mitk::Point3D &origin, const mitk::Vector3D &size, double angle)
+  {
+    mitk::ScalarType bounds[6] = {0, size[0], 0, size[1], 0, size[2]};
+
+    auto transform = mitk::AffineTransform3D::New();
+    transform->SetIdentity();
+    transform->Rotate(0, 1, angle);
+    transform->SetOffset(origin.GetVectorFromOrigin());
+
+    auto geometry = mitk::Geometry3D::New();
+    geometry->SetBounds(bounds);
+    geometry->SetIndexToWorldTransform(transform);
+
+    auto geometryData = mitk::GeometryData::New();
+    geometryData->SetGeometry(geometry);
+    return geometryData;
+  }
+
+  static mitk::Image::Pointer Crop(mitk::Image *image,
+                                   mitk::GeometryData *box,
+                                   bool useWholeInputRegion = false,
+                                   bool referenceInputMemory = false,
+                                   int cropTimeStep = -1)
+  {
+    auto cropper = mitk::BoundingShapeCropper::New();
+    cropper->SetInput(image);
+    cropper->SetGeometry(box);
+    cropper->SetOutsideValue(OutsideValue);
+    cropper->SetUseWholeInputRegion(useWholeInputRegion);
+    cropper->SetReferenceInputMemory(referenceInputMemory);
+    if (cropTimeStep >= 0)
+    {
+      cropper->SetUseCropTimeStepOnly(true);
+      cropper->SetCurrentTimeStep(cropTimeStep);
+    }
+    cropper->SetNumberOfThreads(4);
+    cropper->Update();
+    return cropper->GetOutput();
+  }
+
+  /** Index of the input at the first voxel of the output. */
+  static itk::Index<3> GetStartIndex(const mitk::Image *input, const mitk::Image *output)
+  {
+    mitk::Point3D start;
+    input->GetGeometry()->WorldToIndex(output->GetGeometry()->GetOrigin(), start);
+
+    itk::Index<3> index;
+    for (unsigned int i = 0; i < 3; ++i)
+      index[i] = itk::Math::Round<itk::IndexValueType>(start[i]);
+
+    return index;
+  }
+
+  /** Compares the output with the result of the former implementation, which tested every voxel of the cropped
+  * region: voxels whose center is inside the box keep their value, all others get the outside value. */
+  static void CheckSameResultAsIterator(const mitk::Image *input,
+                                        unsigned int inputTimeStep,
+                                        const mitk::Image *output,
+                                        unsigned int outputTimeStep,
+                                        const mitk::GeometryData *box)
+  {
+    const mitk::BaseGeometry *boxGeometry = box->GetGeometry();
+    const mitk::BaseGeometry *inputGeometry = input->GetGeometry(inputTimeStep);
+    const itk::Index<3> start = GetStartIndex(input, output);
+
+    mitk::ImageReadAccessor inputAccessor(input, input->GetVolumeData(inputTimeStep));
+    mitk::ImageReadAccessor outputAccessor(output, output->GetVolumeData(outputTimeStep));
+    const auto *inputData = static_cast<const short *>(inputAccessor.GetData());
+    const auto *outputData = static_cast<const short *>(outputAccessor.GetData());
+
+    unsigned int numberOfInsideVoxels = 0;
+
+    for (unsigned int z = 0; z < output->GetDimension(2); ++z)
+      for (unsigned int y = 0; y < output->GetDimension(1); ++y)
+        for (unsigned int x = 0; x < output->GetDimension(0); ++x)
+        {
+          mitk::Point3D index;
+          index[0] = start[0] + x;
+          index[1] = start[1] + y;
+          index[2] = start[2] + z;
+
+          mitk::Point3D world;
+          inputGeometry->IndexToWorld(index, world);
+          mitk::Point3D boxIndex;
+          boxGeometry->WorldToIndex(world, boxIndex);
+
+          bool isInside = true;
+          for (unsigned int i = 0; i < 3; ++i)
+            isInside = isInside && boxIndex[i] >= boxGeometry->GetBounds()[2 * i] &&
+                       boxIndex[i] <= boxGeometry->GetBounds()[2 * i + 1];
+
+          const auto inputOffset = static_cast<std::size_t>(index[0]) +
+                                   input->GetDimension(0) * (static_cast<std::size_t>(index[1]) +
+                                                             input->GetDimension(1) * static_cast<std::size_t>(index[2]));
+          const auto outputOffset = x + output->GetDimension(0) * (y + output->GetDimension(1) * std::size_t(z));
+
+          const short expected = isInside ? inputData[inputOffset] : OutsideValue;
+          CPPUNIT_ASSERT_EQUAL(expected, outputData[outputOffset]);
+
+          if (isInside)
+            ++numberOfInsideVoxels;
+        }
+
+    CPPUNIT_ASSERT(numberOfInsideVoxels > 0);
+  }
+
+  static mitk::Vector3D MakeVector(double x, double y, double z)
+  {
+    mitk::Vector3D vector;
+    vector[0] = x;
+    vector[1] = y;
+    vector[2] = z;
+    return vector;
+  }
+
+  static mitk::Point3D MakePoint(double x, double y, double z)
+  {
+    mitk::Point3D point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = z;
+    return point;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = CreateImage<ImageType>(1);
+    m_TimeImage = CreateImage<TimeImageType>(3);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_TimeImage = nullptr;
+  }
+
+  void Crop_AxisAlignedBox_SameResultAsIterator()
+  {
+    auto box = CreateBox(MakePoint(2.3, 3.3, 1.7), MakeVector(10, 8, 6), 0.0);
+    auto output = Crop(m_Image, box);
+
+    CPPUNIT_ASSERT_EQUAL(10u, output->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL(8u, output->GetDimension(1));
+    CPPUNIT_ASSERT_EQUAL(3u, output->GetDimension(2));
+    CheckSameResultAsIterator(m_Image, 0, output, 0, box);
+  }
+
+  void Crop_RotatedBox_SameResultAsIterator()
+  {
+    auto box = CreateBox(MakePoint(8.3, 1.3, 3.7), MakeVector(9, 7, 11), 0.5);
+    auto output = Crop(m_Image, box);
+
+    CheckSameResultAsIterator(m_Image, 0, output, 0, box);
+  }
+
+  void Mask_RotatedBox_SameResultAsIterator()
+  {
+    auto box = CreateBox(MakePoint(8.3, 1.3, 3.7), MakeVector(9, 7, 11), 0.5);
+    auto output = Crop(m_Image, box, true);
+
+    CPPUNIT_ASSERT_EQUAL(m_Image->GetDimension(0), output->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL(m_Image->GetDimension(1), output->GetDimension(1));
+    CPPUNIT_ASSERT_EQUAL(m_Image->GetDimension(2), output->GetDimension(2));
+    CheckSameResultAsIterator(m_Image, 0, output, 0, box);
+  }
+
+  void Crop_4D_SameResultAsIterator()
+  {
+    auto box = CreateBox(MakePoint(8.3, 1.3, 3.7), MakeVector(9, 7, 11), 0.5);
+    auto output = Crop(m_TimeImage, box);
+
+    CPPUNIT_ASSERT_EQUAL(4u, output->GetDimension());
+    CPPUNIT_ASSERT_EQUAL(3u, output->GetDimension(3));
+    for (unsigned int t = 0; t < 3; ++t)
+      CheckSameResultAsIterator(m_TimeImage, t, output, t, box);
+  }
+
+  void Crop_4DCropTimeStepOnly_SameResultAsIterator()
+  {
+    auto box = CreateBox(MakePoint(2.3, 3.3, 1.7), MakeVector(10, 8, 6), 0.0);
+    auto output = Crop(m_TimeImage, box, false, false, 1);
+
+    CPPUNIT_ASSERT_EQUAL(3u, output->GetDimension());
+    CheckSameResultAsIterator(m_TimeImage, 1, output, 0, box);
+
+    box = CreateBox(MakePoint(8.3, 1.3, 3.7), MakeVector(9, 7, 11), 0.5);
+    output = Crop(m_TimeImage, box, false, false, 2);
+
+    CPPUNIT_ASSERT_EQUAL(3u, output->GetDimension());
+    CheckSameResultAsIterator(m_TimeImage, 2, output, 0, box);
+  }
+
+  void Crop_ReferenceInputMemoryContiguousRegion_ReferencesInput()
+  {
+    // the box covers whole slices, so the cropped region is contiguous in memory
+    auto box = CreateBox(MakePoint(-0.5, -0.5, 1.7), MakeVector(20, 16, 8), 0.0);
+    auto output = Crop(m_Image, box, false, true);
+
+    CPPUNIT_ASSERT_EQUAL(20u, output->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL(16u, output->GetDimension(1));
+    CPPUNIT_ASSERT_EQUAL(4u, output->GetDimension(2));
+    CheckSameResultAsIterator(m_Image, 0, output, 0, box);
+
+    mitk::ImageReadAccessor inputAccessor(m_Image, m_Image->GetVolumeData(0));
+    mitk::ImageReadAccessor outputAccessor(output, output->GetVolumeData(0));
+    const auto *inputData = static_cast<const short *>(inputAccessor.GetData());
+    const auto *outputData = static_cast<const short *>(outputAccessor.GetData());
+    CPPUNIT_ASSERT(outputData == inputData + GetStartIndex(m_Image, output)[2] * 20 * 16);
+  }
+
+  void Crop_ReferenceInputMemoryNonContiguousRegion_CopiesInput()
+  {
+    // the box removes columns, so the rows of the cropped region are not contiguous
+    auto box = CreateBox(MakePoint(2.3, -0.5, 1.7), MakeVector(10, 16, 8), 0.0);
+    auto output = Crop(m_Image, box, false, true);
+
+    CPPUNIT_ASSERT_EQUAL(10u, output->GetDimension(0));
+    CheckSameResultAsIterator(m_Image, 0, output, 0, box);
+
+    mitk::ImageReadAccessor inputAccessor(m_Image, m_Image->GetVolumeData(0));
+    mitk::ImageReadAccessor outputAccessor(output, output->GetVolumeData(0));
+    const auto *inputData = static_cast<const short *>(inputAccessor.GetData());
+    const auto *outputData = static_cast<const short *>(outputAccessor.GetData());
+    CPPUNIT_ASSERT(outputData < inputData || outputData >= inputData + 20 * 16 * 12);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBoundingShapeCropper)
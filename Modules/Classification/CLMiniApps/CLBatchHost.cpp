@@ -0,0 +1,31 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCommandLineBatchHost.h"
+
+#include <QApplication>
+
+// Entry functions of the apps of this directory. They are compiled into the batch host with
+// MITK_COMMANDLINE_BATCH_HOST defined, which removes their main functions.
+int CLGlobalImageFeaturesMain(int argc, char* argv[]);
+
+int main(int argc, char* argv[])
+{
+  // CLGlobalImageFeatures renders screenshots, so it needs a QApplication in the main thread
+  QApplication qtapplication(argc, argv);
+
+  mitk::CommandLineBatchHost host;
+  // changes the locale of std::cout and uses the QApplication
+  host.RegisterApp("CLGlobalImageFeatures", &CLGlobalImageFeaturesMain, false);
+
+  return host.Execute(argc, argv, "Classification Batch Host");
+}
@@ -48,6 +48,7 @@ found in the LICENSE file.
 
 #include <iostream>
 #include <locale>
+#include <memory>
 
 #include <itkImageDuplicator.h>
 #include <itkImageRegionIterator.h>
@@ -358,7 +359,7 @@ void SaveSliceOrImageAsPNG(mitk::Image::Pointer image, mitk::Image::Pointer mask
   }
 }
 
-int main(int argc, char* argv[])
+int CLGlobalImageFeaturesMain(int argc, char* argv[])
 {
   // Commented : Updated to a common interface, include, if possible, mask is type unsigned short, uses Quantification, Comments
   //                                 Name follows standard scheme with Class Name::Feature Name
@@ -629,8 +630,12 @@ int main(int argc, char* argv[])
 
   // Create a QTApplication and a Datastorage
   // This is necessary in order to save screenshots of
-  // each image / slice.
-  QApplication qtapplication(argc, argv);
+  // each image / slice. The batch host may have created it already.
+  std::unique_ptr<QApplication> qtapplication;
+  if (QApplication::instance() == nullptr)
+  {
+    qtapplication.reset(new QApplication(argc, argv));
+  }
   QmitkRegisterClasses();
 
   std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> allStats;
@@ -755,4 +760,11 @@ int main(int argc, char* argv[])
   return 0;
 }
 
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return CLGlobalImageFeaturesMain(argc, argv);
+}
+#endif
+
 #endif
@@ -30,6 +30,7 @@ found in the LICENSE file.
 // ----------------------- Forest Handling ----------------------
 //#include <mitkDecisionForest.h>
 #include <mitkVigraRandomForestClassifier.h>
+#include <mitkTiledVoxelClassifier.h>
 //#include <mitkThresholdSplit.h>
 //#include <mitkImpurityLoss.h>
 //#include <mitkLinearSplitting.h>
@@ -44,6 +45,55 @@ found in the LICENSE file.
 //#include <mitkSpectralDensityEstimation.h>
 //#include <mitkULSIFDensityEstimation.h>
 
+static void SetOrAddData(mitk::DataCollection *collection, mitk::Image *image, const std::string &name)
+{
+  if (collection->HasElement(name))
+  {
+    collection->SetData(itk::DataObject::Pointer(image), name);
+  }
+  else
+  {
+    collection->AddData(itk::DataObject::Pointer(image), name);
+  }
+}
+
+// Predicts the test voxels of every patient of the collection tile by tile, so no feature matrix
+// of all test voxels is needed (see mitk::TiledVoxelClassifier).
+static void PredictTiled(mitk::DataCollection *collection, const mitk::VigraRandomForestClassifier *forest,
+                         const std::vector<std::string> &modalities, const std::string &mask,
+                         const std::string &resultMask, const std::string &resultProb, int tileSize)
+{
+  if (collection->HasElement(mask) && collection->GetMitkImage(mask).IsNotNull())
+  {
+    mitk::TiledVoxelClassifier::Pointer classifier = mitk::TiledVoxelClassifier::New();
+    classifier->SetClassifier(forest);
+    for (const auto &modality : modalities)
+    {
+      classifier->AddFeatureImage(collection->GetMitkImage(modality));
+    }
+    classifier->SetMask(collection->GetMitkImage(mask));
+    classifier->SetTileSize(tileSize);
+    classifier->Update();
+
+    SetOrAddData(collection, classifier->GetLabelImage(), resultMask);
+    const auto &probabilities = classifier->GetProbabilityImages();
+    for (std::size_t i = 0; i < probabilities.size(); ++i)
+    {
+      SetOrAddData(collection, probabilities[i], resultProb + std::to_string(i));
+    }
+    return;
+  }
+
+  for (std::size_t i = 0; i < collection->Size(); ++i)
+  {
+    auto child = dynamic_cast<mitk::DataCollection *>(collection->GetData(i).GetPointer());
+    if (child != nullptr)
+    {
+      PredictTiled(child, forest, modalities, mask, resultMask, resultProb, tileSize);
+    }
+  }
+}
+
 int main(int argc, char* argv[])
 {
   MITK_INFO << "Starting MITK_Forest Mini-App";
@@ -143,6 +193,8 @@ int main(int argc, char* argv[])
       weightLambda = 0.0;
     }
     int maximumTreeDepth =  allConfig.IntValue("Forest", "Maximum Tree Depth",10000);
+    // 0 = predict all test voxels at once, otherwise edge length of the tiles for the prediction
+    int tileSize = allConfig.IntValue("Forest", "Prediction Tile Size", 0);
     // TODO int randomSplit = allConfig.IntValue("Forest","Use RandomSplit",0);
     //////////////////////////////////////////////////////////////////////////////
     // Read Statistic Parameter
@@ -355,27 +407,35 @@ int main(int argc, char* argv[])
     //////////////////////////////////////////////////////////////////////////////
     // If required do test
     //////////////////////////////////////////////////////////////////////////////
-    MITK_INFO << "Convert Test data";
-    auto testDataX = mitk::DCUtilities::DC3dDToMatrixXd(testCollection,modalities, testMask);
-
-    MITK_INFO << "Predict Test Data";
-    auto testDataNewY = forest->Predict(testDataX);
-    auto testDataNewProb = forest->GetPointWiseProbabilities();
-    //MITK_INFO << testDataNewY;
-
-    auto maxClassValue = testDataNewProb.cols();
-    std::vector<std::string> names;
-    for (int i = 0; i < maxClassValue; ++i)
+    if (tileSize > 0)
     {
-      std::string name = resultProb + std::to_string(i);
-      MITK_INFO << name;
-      names.push_back(name);
+      MITK_INFO << "Predict Test Data in tiles of " << tileSize << " voxels";
+      PredictTiled(testCollection, forest, modalities, testMask, resultMask, resultProb, tileSize);
     }
-    //names.push_back("prob-1");
-    //names.push_back("prob-2");
+    else
+    {
+      MITK_INFO << "Convert Test data";
+      auto testDataX = mitk::DCUtilities::DC3dDToMatrixXd(testCollection,modalities, testMask);
 
-    mitk::DCUtilities::MatrixToDC3d(testDataNewY, testCollection, resultMask, testMask);
-    mitk::DCUtilities::MatrixToDC3d(testDataNewProb, testCollection, names, testMask);
+      MITK_INFO << "Predict Test Data";
+      auto testDataNewY = forest->Predict(testDataX);
+      auto testDataNewProb = forest->GetPointWiseProbabilities();
+      //MITK_INFO << testDataNewY;
+
+      auto maxClassValue = testDataNewProb.cols();
+      std::vector<std::string> names;
+      for (int i = 0; i < maxClassValue; ++i)
+      {
+        std::string name = resultProb + std::to_string(i);
+        MITK_INFO << name;
+        names.push_back(name);
+      }
+      //names.push_back("prob-1");
+      //names.push_back("prob-2");
+
+      mitk::DCUtilities::MatrixToDC3d(testDataNewY, testCollection, resultMask, testMask);
+      mitk::DCUtilities::MatrixToDC3d(testDataNewProb, testCollection, names, testMask);
+    }
     MITK_INFO << "Converted predicted data";
     //forest.SetMaskName(testMask);
     //forest.SetCollection(testCollection);
@@ -0,0 +1,129 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkTiledVoxelClassifier_h
+#define mitkTiledVoxelClassifier_h
+
+#include <MitkCLVigraRandomForestExports.h>
+
+#include <mitkImage.h>
+#include <mitkVigraRandomForestClassifier.h>
+
+#include <itkImage.h>
+#include <itkObject.h>
+
+#include <functional>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Classifies all voxels of an image tile by tile.
+  *
+  * The classic way to classify voxels (mitk::CLUtil::Transform or mitk::DCUtilities::DC3dDToMatrixXd
+  * followed by VigraRandomForestClassifier::Predict()) first copies the features of all masked voxels
+  * into one dense double matrix. For large images with many features this matrix alone needs tens
+  * of gigabytes.
+  *
+  * This class works on tiles of TileSize^3 voxels instead. For each tile it
+  * - collects the values of the feature images,
+  * - computes the feature functions on the tile plus a halo of voxels,
+  * - converts the features of the masked voxels of the tile into a float matrix,
+  * - predicts the tile with VigraRandomForestClassifier::PredictBlock() and
+  * - writes labels and probabilities directly into the output images.
+  * Besides the input and output images, the memory is bounded by the tile size times the number
+  * of threads. The tiles are processed in parallel.
+  *
+  * The columns of the feature matrix are ordered like for training: first the feature images in the
+  * order they were added, then the results of the feature functions in the order the functions were
+  * added.
+  *
+  * Voxels outside the mask get label 0 and probability 0.
+  */
+  class MITKCLVIGRARANDOMFOREST_EXPORT TiledVoxelClassifier : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(TiledVoxelClassifier, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef itk::Image<float, 3> FeatureImageType;
+    typedef itk::Image<unsigned char, 3> MaskImageType;
+    typedef itk::Image<int, 3> LabelImageType;
+
+    /** Computes features of a block of a feature image. The block contains the tile and its halo.
+    * The returned images must have the same geometry as the block and contain at least the tile.
+    * The function is called from several threads at the same time. */
+    typedef std::function<std::vector<FeatureImageType::Pointer>(const FeatureImageType *block)> FeatureFunctionType;
+
+    void SetClassifier(const VigraRandomForestClassifier *classifier);
+
+    /** Adds a 3D image whose voxel values are used as one feature. All images must have the same size and a
+    * scalar pixel type. The tiles are read directly from the image, without converting the whole image. */
+    void AddFeatureImage(const Image *image);
+
+    /** Adds a function that computes numberOfFeatures features from the feature image with the given index.
+    * @param halo number of voxels the function needs around a voxel to compute its features (e.g. the
+    * radius of a filter kernel). */
+    void AddFeatureFunction(unsigned int imageIndex, const FeatureFunctionType &function, unsigned int numberOfFeatures, unsigned int halo);
+
+    /** Only voxels with a mask value other than 0 are classified. Without mask, all voxels are classified. */
+    void SetMask(const Image *mask);
+
+    unsigned int GetNumberOfFeatures() const;
+
+    /** Edge length of the tiles in voxels. */
+    itkSetMacro(TileSize, unsigned int);
+    itkGetConstMacro(TileSize, unsigned int);
+
+    /** Number of threads, 0 (default) to use the default number of threads of ITK. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Computes the label image and, if ComputeProbabilities is on, one probability image per class.
+    * @exception mitk::Exception if no classifier or feature image is set, the images have different sizes
+    * or a feature function returns invalid images. */
+    void Update();
+
+    itkSetMacro(ComputeProbabilities, bool);
+    itkGetConstMacro(ComputeProbabilities, bool);
+    itkBooleanMacro(ComputeProbabilities);
+
+    Image::Pointer GetLabelImage() const;
+    const std::vector<Image::Pointer> &GetProbabilityImages() const;
+
+  protected:
+    TiledVoxelClassifier();
+    ~TiledVoxelClassifier() override;
+
+  private:
+    struct FeatureFunction
+    {
+      unsigned int ImageIndex;
+      FeatureFunctionType Function;
+      unsigned int NumberOfFeatures;
+      unsigned int Halo;
+    };
+
+    VigraRandomForestClassifier::ConstPointer m_Classifier;
+    std::vector<Image::ConstPointer> m_FeatureImages;
+    std::vector<FeatureFunction> m_FeatureFunctions;
+    Image::ConstPointer m_Mask;
+
+    unsigned int m_TileSize;
+    unsigned int m_NumberOfThreads;
+    bool m_ComputeProbabilities;
+
+    Image::Pointer m_LabelImage;
+    std::vector<Image::Pointer> m_ProbabilityImages;
+  };
+}
+
+#endif
@@ -42,6 +42,11 @@ namespace mitk
     Eigen::MatrixXi Predict(const Eigen::MatrixXd &X) override;
     Eigen::MatrixXi PredictWeighted(const Eigen::MatrixXd &X);
 
+    /// @brief Predicts the labels and class probabilities of a block of samples with float features.
+    /// In contrast to Predict(), the results are written to the given matrices and no member is
+    /// changed, so several blocks can be predicted concurrently (see mitk::TiledVoxelClassifier).
+    void PredictBlock(const Eigen::MatrixXf &X, Eigen::MatrixXi &labels, Eigen::MatrixXf &probabilities) const;
+
 
     bool SupportsPointWiseWeight() override;
     bool SupportsPointWiseProbability() override;
@@ -0,0 +1,308 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTiledVoxelClassifier.h>
+
+#include <mitkImageAccessByItk.h>
+#include <mitkITKImageImport.h>
+#include <mitkParallelFor.h>
+
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <algorithm>
+
+namespace
+{
+  typedef mitk::TiledVoxelClassifier::FeatureImageType FeatureImageType;
+  typedef FeatureImageType::RegionType RegionType;
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void CopyGeometry(const itk::Image<TPixel, VImageDimension> *image, itk::ImageBase<VImageDimension> *geometry)
+  {
+    geometry->CopyInformation(image);
+    geometry->SetRegions(image->GetLargestPossibleRegion());
+  }
+
+  /** Converts the voxels of a region of the image to float, in the order of an itk::ImageRegionConstIterator. */
+  template <typename TPixel, unsigned int VImageDimension>
+  void ReadRegion(const itk::Image<TPixel, VImageDimension> *image, const RegionType &region, float *values)
+  {
+    for (itk::ImageRegionConstIterator<itk::Image<TPixel, VImageDimension>> it(image, region); !it.IsAtEnd(); ++it)
+      *values++ = static_cast<float>(it.Get());
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void ReadMask(const itk::Image<TPixel, VImageDimension> *mask,
+                const RegionType &region,
+                std::vector<bool> &isMasked,
+                std::size_t &numberOfMaskedVoxels)
+  {
+    numberOfMaskedVoxels = 0;
+    std::size_t voxel = 0;
+    for (itk::ImageRegionConstIterator<itk::Image<TPixel, VImageDimension>> it(mask, region); !it.IsAtEnd(); ++it, ++voxel)
+    {
+      isMasked[voxel] = it.Get() != 0;
+      numberOfMaskedVoxels += isMasked[voxel] ? 1 : 0;
+    }
+  }
+
+  /** Returns the geometry of a 3D image with a scalar pixel type as an image without buffer. */
+  FeatureImageType::Pointer GetGeometry(const mitk::Image *image)
+  {
+    FeatureImageType::Pointer geometry = FeatureImageType::New();
+    try
+    {
+      AccessFixedDimensionByItk_n(image, CopyGeometry, 3, (geometry.GetPointer()));
+    }
+    catch (const mitk::AccessByItkException &e)
+    {
+      mitkThrow() << "Images must be 3D and have a scalar pixel type. " << e.what();
+    }
+    return geometry;
+  }
+}
+
+mitk::TiledVoxelClassifier::TiledVoxelClassifier()
+  : m_TileSize(64), m_NumberOfThreads(0), m_ComputeProbabilities(true)
+{
+}
+
+mitk::TiledVoxelClassifier::~TiledVoxelClassifier()
+{
+}
+
+void mitk::TiledVoxelClassifier::SetClassifier(const VigraRandomForestClassifier *classifier)
+{
+  m_Classifier = classifier;
+  this->Modified();
+}
+
+void mitk::TiledVoxelClassifier::AddFeatureImage(const Image *image)
+{
+  m_FeatureImages.push_back(image);
+  this->Modified();
+}
+
+void mitk::TiledVoxelClassifier::AddFeatureFunction(unsigned int imageIndex,
+                                                     const FeatureFunctionType &function,
+                                                     unsigned int numberOfFeatures,
+                                                     unsigned int halo)
+{
+  m_FeatureFunctions.push_back({imageIndex, function, numberOfFeatures, halo});
+  this->Modified();
+}
+
+void mitk::TiledVoxelClassifier::SetMask(const Image *mask)
+{
+  m_Mask = mask;
+  this->Modified();
+}
+
+unsigned int mitk::TiledVoxelClassifier::GetNumberOfFeatures() const
+{
+  unsigned int numberOfFeatures = static_cast<unsigned int>(m_FeatureImages.size());
+  for (const auto &featureFunction : m_FeatureFunctions)
+    numberOfFeatures += featureFunction.NumberOfFeatures;
+
+  return numberOfFeatures;
+}
+
+mitk::Image::Pointer mitk::TiledVoxelClassifier::GetLabelImage() const
+{
+  return m_LabelImage;
+}
+
+const std::vector<mitk::Image::Pointer> &mitk::TiledVoxelClassifier::GetProbabilityImages() const
+{
+  return m_ProbabilityImages;
+}
+
+void mitk::TiledVoxelClassifier::Update()
+{
+  if (m_Classifier.IsNull())
+    mitkThrow() << "No classifier set.";
+
+  if (m_FeatureImages.empty())
+    mitkThrow() << "No feature image set.";
+
+  if (m_TileSize == 0)
+    mitkThrow() << "Tile size must not be 0.";
+
+  // the tiles are read directly from the buffers of the images, so only the geometry is needed here
+  const FeatureImageType::Pointer geometry = GetGeometry(m_FeatureImages.front());
+  const RegionType largestRegion = geometry->GetLargestPossibleRegion();
+
+  for (const auto &image : m_FeatureImages)
+  {
+    if (GetGeometry(image)->GetLargestPossibleRegion() != largestRegion)
+      mitkThrow() << "All feature images must have the same size.";
+  }
+
+  for (const auto &featureFunction : m_FeatureFunctions)
+  {
+    if (featureFunction.ImageIndex >= m_FeatureImages.size())
+      mitkThrow() << "Feature function uses feature image " << featureFunction.ImageIndex << ", but only "
+                  << m_FeatureImages.size() << " feature images are set.";
+  }
+
+  if (m_Mask.IsNotNull() && GetGeometry(m_Mask)->GetLargestPossibleRegion() != largestRegion)
+    mitkThrow() << "Mask and feature images must have the same size.";
+
+  unsigned int halo = 0;
+  for (const auto &featureFunction : m_FeatureFunctions)
+    halo = std::max(halo, featureFunction.Halo);
+
+  const unsigned int numberOfFeatures = this->GetNumberOfFeatures();
+  const int numberOfClasses = m_Classifier->GetRandomForest().class_count();
+
+  // outputs
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->CopyInformation(geometry);
+  labelImage->SetRegions(largestRegion);
+  labelImage->Allocate();
+  labelImage->FillBuffer(0);
+
+  std::vector<FeatureImageType::Pointer> probabilityImages;
+  if (m_ComputeProbabilities)
+  {
+    for (int i = 0; i < numberOfClasses; ++i)
+    {
+      FeatureImageType::Pointer probabilityImage = FeatureImageType::New();
+      probabilityImage->CopyInformation(geometry);
+      probabilityImage->SetRegions(largestRegion);
+      probabilityImage->Allocate();
+      probabilityImage->FillBuffer(0);
+      probabilityImages.push_back(probabilityImage);
+    }
+  }
+
+  // tiling
+  RegionType::SizeType numberOfTiles;
+  std::size_t totalNumberOfTiles = 1;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    numberOfTiles[d] = (largestRegion.GetSize(d) + m_TileSize - 1) / m_TileSize;
+    totalNumberOfTiles *= numberOfTiles[d];
+  }
+
+  // exceptions of the feature functions are rethrown by ParallelFor after all threads finished
+  mitk::ParallelFor(totalNumberOfTiles, m_NumberOfThreads, [&](std::size_t tile) {
+    RegionType tileRegion;
+    std::size_t remainder = tile;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      const auto tileIndex = remainder % numberOfTiles[d];
+      remainder /= numberOfTiles[d];
+
+      tileRegion.SetIndex(d, largestRegion.GetIndex(d) + static_cast<itk::IndexValueType>(tileIndex * m_TileSize));
+      tileRegion.SetSize(d, std::min<itk::SizeValueType>(m_TileSize, largestRegion.GetSize(d) - tileIndex * m_TileSize));
+    }
+
+    // masked voxels of the tile; all images are iterated over the tile in the same order
+    std::vector<bool> isMasked(tileRegion.GetNumberOfPixels(), true);
+    std::size_t numberOfMaskedVoxels = isMasked.size();
+    if (m_Mask.IsNotNull())
+      AccessFixedDimensionByItk_n(m_Mask.GetPointer(), ReadMask, 3, (tileRegion, isMasked, numberOfMaskedVoxels));
+
+    if (numberOfMaskedVoxels == 0)
+      return;
+
+    Eigen::MatrixXf features(numberOfMaskedVoxels, numberOfFeatures);
+    Eigen::Index column = 0;
+    std::vector<float> values(isMasked.size());
+
+    auto addFeature = [&]() {
+      Eigen::Index row = 0;
+      for (std::size_t voxel = 0; voxel < values.size(); ++voxel)
+      {
+        if (isMasked[voxel])
+          features(row++, column) = values[voxel];
+      }
+      ++column;
+    };
+
+    for (const auto &image : m_FeatureImages)
+    {
+      AccessFixedDimensionByItk_n(image.GetPointer(), ReadRegion, 3, (tileRegion, values.data()));
+      addFeature();
+    }
+
+    if (!m_FeatureFunctions.empty())
+    {
+      RegionType paddedRegion = tileRegion;
+      paddedRegion.PadByRadius(halo);
+      paddedRegion.Crop(largestRegion);
+
+      std::vector<FeatureImageType::Pointer> blocks(m_FeatureImages.size());
+
+      for (const auto &featureFunction : m_FeatureFunctions)
+      {
+        auto &block = blocks[featureFunction.ImageIndex];
+        if (block.IsNull())
+        {
+          block = FeatureImageType::New();
+          block->CopyInformation(geometry);
+          block->SetRegions(paddedRegion);
+          block->Allocate();
+          AccessFixedDimensionByItk_n(m_FeatureImages[featureFunction.ImageIndex].GetPointer(),
+                                      ReadRegion,
+                                      3,
+                                      (paddedRegion, block->GetBufferPointer()));
+        }
+
+        auto functionFeatures = featureFunction.Function(block);
+        if (functionFeatures.size() != featureFunction.NumberOfFeatures)
+          mitkThrow() << "Feature function returned " << functionFeatures.size() << " instead of "
+                      << featureFunction.NumberOfFeatures << " features.";
+
+        for (const auto &featureImage : functionFeatures)
+        {
+          if (featureImage.IsNull() || !featureImage->GetBufferedRegion().IsInside(tileRegion))
+            mitkThrow() << "Feature function returned an image that does not contain the tile.";
+
+          ReadRegion(featureImage.GetPointer(), tileRegion, values.data());
+          addFeature();
+        }
+      }
+    }
+
+    Eigen::MatrixXi labels;
+    Eigen::MatrixXf probabilities;
+    m_Classifier->PredictBlock(features, labels, probabilities);
+
+    Eigen::Index row = 0;
+    std::size_t voxel = 0;
+    for (itk::ImageRegionIterator<LabelImageType> it(labelImage, tileRegion); !it.IsAtEnd(); ++it, ++voxel)
+    {
+      if (isMasked[voxel])
+        it.Set(labels(row++, 0));
+    }
+
+    for (int i = 0; i < static_cast<int>(probabilityImages.size()); ++i)
+    {
+      row = 0;
+      voxel = 0;
+      for (itk::ImageRegionIterator<FeatureImageType> it(probabilityImages[i], tileRegion); !it.IsAtEnd(); ++it, ++voxel)
+      {
+        if (isMasked[voxel])
+          it.Set(probabilities(row++, i));
+      }
+    }
+  });
+
+  m_LabelImage = mitk::GrabItkImageMemory(labelImage);
+
+  m_ProbabilityImages.clear();
+  for (const auto &probabilityImage : probabilityImages)
+    m_ProbabilityImages.push_back(mitk::GrabItkImageMemory(probabilityImage));
+}
@@ -235,6 +235,37 @@ Eigen::MatrixXi mitk::VigraRandomForestClassifier::PredictWeighted(const Eigen::
 
 
 
+void mitk::VigraRandomForestClassifier::PredictBlock(const Eigen::MatrixXf &X_in, Eigen::MatrixXi &labels, Eigen::MatrixXf &probabilities) const
+{
+  const int classCount = m_RandomForest.class_count();
+  probabilities.resize(X_in.rows(), classCount);
+  probabilities.fill(0);
+  labels.resize(X_in.rows(), 1);
+  labels.fill(0);
+
+  if (X_in.rows() == 0)
+    return;
+
+  vigra::MultiArrayView<2, float> P(vigra::Shape2(probabilities.rows(), probabilities.cols()), probabilities.data());
+  vigra::MultiArrayView<2, float> X(vigra::Shape2(X_in.rows(), X_in.cols()), const_cast<float *>(X_in.data()));
+
+  m_RandomForest.predictProbabilities(X, P);
+
+  // same label as predictLabels (class with the highest probability), without traversing the trees again
+  for (int row = 0; row < probabilities.rows(); ++row)
+  {
+    int maxCol = 0;
+    for (int col = 1; col < classCount; ++col)
+    {
+      if (probabilities(row, col) > probabilities(row, maxCol))
+        maxCol = col;
+    }
+    int label;
+    m_RandomForest.ext_param_.to_classlabel(maxCol, label);
+    labels(row, 0) = label;
+  }
+}
+
 void mitk::VigraRandomForestClassifier::SetTreeWeights(Eigen::MatrixXd weights)
 {
   m_TreeWeights = weights;
@@ -0,0 +1,244 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkTiledVoxelClassifier.h>
+#include <mitkVigraRandomForestClassifier.h>
+#include <mitkImageCast.h>
+#include <mitkITKImageImport.h>
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
+
+class mitkTiledVoxelClassifierTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTiledVoxelClassifierTestSuite);
+  MITK_TEST(Update_FeatureImagesAndFunction_SameResultAsPredict);
+  MITK_TEST(Update_SingleTile_SameResultAsPredict);
+  MITK_TEST(Update_IntegerFeatureImage_SameResultAsPredict);
+  MITK_TEST(Update_InvalidInput_Throws);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::TiledVoxelClassifier::FeatureImageType FeatureImageType;
+  typedef mitk::TiledVoxelClassifier::MaskImageType MaskImageType;
+  typedef mitk::TiledVoxelClassifier::LabelImageType LabelImageType;
+
+  mitk::Image::Pointer m_ImageA;
+  mitk::Image::Pointer m_ImageB;
+  mitk::Image::Pointer m_Mask;
+  FeatureImageType::Pointer m_NeighbourhoodSum;
+  mitk::VigraRandomForestClassifier::Pointer m_Classifier;
+
+  /** Sum of the 3x3x3 neighbourhood, restricted to the buffered region of the image. */
+  static FeatureImageType::Pointer NeighbourhoodSum(const FeatureImageType *image)
+  {
+    const auto region = image->GetBufferedRegion();
+
+    FeatureImageType::Pointer result = FeatureImageType::New();
+    result->CopyInformation(image);
+    result->SetRegions(region);
+    result->Allocate();
+
+    for (itk::ImageRegionConstIteratorWithIndex<FeatureImageType> it(image, region); !it.IsAtEnd(); ++it)
+    {
+      float sum = 0;
+      FeatureImageType::IndexType neighbour;
+      for (int z = -1; z <= 1; ++z)
+        for (int y = -1; y <= 1; ++y)
+          for (int x = -1; x <= 1; ++x)
+          {
+            neighbour = it.GetIndex();
+            neighbour[0] += x;
+            neighbour[1] += y;
+            neighbour[2] += z;
+            if (region.IsInside(neighbour))
+              sum += image->GetPixel(neighbour);
+          }
+      result->SetPixel(it.GetIndex(), sum);
+    }
+    return result;
+  }
+
+  /** Features of all masked voxels in the order used by the tiled classifier, as one dense matrix. */
+  Eigen::MatrixXd FullFeatureMatrix(std::vector<FeatureImageType::IndexType> &indices)
+  {
+    FeatureImageType::Pointer a, b;
+    MaskImageType::Pointer mask;
+    mitk::CastToItkImage(m_ImageA, a);
+    mitk::CastToItkImage(m_ImageB, b);
+    mitk::CastToItkImage(m_Mask, mask);
+
+    indices.clear();
+    for (itk::ImageRegionConstIteratorWithIndex<MaskImageType> it(mask, mask->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != 0)
+        indices.push_back(it.GetIndex());
+    }
+
+    Eigen::MatrixXd features(indices.size(), 3);
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      features(i, 0) = a->GetPixel(indices[i]);
+      features(i, 1) = b->GetPixel(indices[i]);
+      features(i, 2) = m_NeighbourhoodSum->GetPixel(indices[i]);
+    }
+    return features;
+  }
+
+  void CheckSameResultAsPredict(unsigned int tileSize, unsigned int numberOfThreads)
+  {
+    std::vector<FeatureImageType::IndexType> indices;
+    Eigen::MatrixXd features = FullFeatureMatrix(indices);
+    Eigen::MatrixXi expectedLabels = m_Classifier->Predict(features);
+    Eigen::MatrixXd expectedProbabilities = m_Classifier->GetPointWiseProbabilities();
+
+    auto tiledClassifier = mitk::TiledVoxelClassifier::New();
+    tiledClassifier->SetClassifier(m_Classifier);
+    tiledClassifier->AddFeatureImage(m_ImageA);
+    tiledClassifier->AddFeatureImage(m_ImageB);
+    tiledClassifier->AddFeatureFunction(0, [](const FeatureImageType *block) {
+      return std::vector<FeatureImageType::Pointer>{ NeighbourhoodSum(block) }; }, 1, 1);
+    tiledClassifier->SetMask(m_Mask);
+    tiledClassifier->SetTileSize(tileSize);
+    tiledClassifier->SetNumberOfThreads(numberOfThreads);
+    tiledClassifier->Update();
+
+    LabelImageType::Pointer labels;
+    mitk::CastToItkImage(tiledClassifier->GetLabelImage(), labels);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(expectedProbabilities.cols()), tiledClassifier->GetProbabilityImages().size());
+
+    std::vector<FeatureImageType::Pointer> probabilities;
+    for (const auto &image : tiledClassifier->GetProbabilityImages())
+    {
+      FeatureImageType::Pointer itkImage;
+      mitk::CastToItkImage(image, itkImage);
+      probabilities.push_back(itkImage);
+    }
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(expectedLabels(i, 0), labels->GetPixel(indices[i]));
+      for (std::size_t c = 0; c < probabilities.size(); ++c)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedProbabilities(i, c), probabilities[c]->GetPixel(indices[i]), 1e-5);
+    }
+
+    // voxels outside of the mask are not classified
+    LabelImageType::IndexType outside;
+    outside.Fill(0);
+    CPPUNIT_ASSERT_EQUAL(0, labels->GetPixel(outside));
+  }
+
+public:
+  void setUp() override
+  {
+    FeatureImageType::RegionType region;
+    region.SetSize(0, 23);
+    region.SetSize(1, 17);
+    region.SetSize(2, 11);
+
+    FeatureImageType::Pointer a = FeatureImageType::New();
+    a->SetRegions(region);
+    a->Allocate();
+    FeatureImageType::Pointer b = FeatureImageType::New();
+    b->SetRegions(region);
+    b->Allocate();
+    MaskImageType::Pointer mask = MaskImageType::New();
+    mask->SetRegions(region);
+    mask->Allocate();
+
+    // values that are exact in float, so float and double features are split the same way
+    for (itk::ImageRegionConstIteratorWithIndex<FeatureImageType> it(a, region); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      a->SetPixel(index, static_cast<float>((index[0] + 2 * index[1] + index[2]) % 10));
+      b->SetPixel(index, 0.5f * index[2]);
+      mask->SetPixel(index, index[0] > 2 ? 1 : 0);
+    }
+
+    m_NeighbourhoodSum = NeighbourhoodSum(a);
+
+    m_ImageA = mitk::GrabItkImageMemory(a);
+    m_ImageB = mitk::GrabItkImageMemory(b);
+    m_Mask = mitk::GrabItkImageMemory(mask);
+
+    std::vector<FeatureImageType::IndexType> indices;
+    Eigen::MatrixXd features = FullFeatureMatrix(indices);
+    Eigen::MatrixXi labels(features.rows(), 1);
+    for (Eigen::Index i = 0; i < features.rows(); ++i)
+      labels(i, 0) = features(i, 2) > 120 ? 2 : (features(i, 1) > 2 ? 1 : 0);
+
+    m_Classifier = mitk::VigraRandomForestClassifier::New();
+    m_Classifier->SetTreeCount(10);
+    m_Classifier->Train(features, labels);
+  }
+
+  void tearDown() override
+  {
+    m_ImageA = nullptr;
+    m_ImageB = nullptr;
+    m_Mask = nullptr;
+    m_NeighbourhoodSum = nullptr;
+    m_Classifier = nullptr;
+  }
+
+  void Update_FeatureImagesAndFunction_SameResultAsPredict()
+  {
+    // the tile size is no divisor of the image size, so there are partial tiles at the borders
+    CheckSameResultAsPredict(5, 4);
+  }
+
+  void Update_SingleTile_SameResultAsPredict()
+  {
+    CheckSameResultAsPredict(64, 1);
+  }
+
+  void Update_IntegerFeatureImage_SameResultAsPredict()
+  {
+    // the values of image A are integers, so the classifier must give the same result for a short image
+    FeatureImageType::Pointer a;
+    mitk::CastToItkImage(m_ImageA, a);
+
+    itk::Image<short, 3>::Pointer shortImage = itk::Image<short, 3>::New();
+    shortImage->CopyInformation(a);
+    shortImage->SetRegions(a->GetLargestPossibleRegion());
+    shortImage->Allocate();
+
+    itk::ImageRegionConstIterator<FeatureImageType> source(a, a->GetLargestPossibleRegion());
+    itk::ImageRegionIterator<itk::Image<short, 3>> target(shortImage, shortImage->GetLargestPossibleRegion());
+    for (; !source.IsAtEnd(); ++source, ++target)
+      target.Set(static_cast<short>(source.Get()));
+
+    m_ImageA = mitk::GrabItkImageMemory(shortImage);
+
+    CheckSameResultAsPredict(5, 2);
+  }
+
+  void Update_InvalidInput_Throws()
+  {
+    auto tiledClassifier = mitk::TiledVoxelClassifier::New();
+    tiledClassifier->AddFeatureImage(m_ImageA);
+    CPPUNIT_ASSERT_THROW(tiledClassifier->Update(), mitk::Exception);
+
+    // the feature function returns two instead of one feature
+    tiledClassifier->SetClassifier(m_Classifier);
+    tiledClassifier->AddFeatureImage(m_ImageB);
+    tiledClassifier->AddFeatureFunction(0, [](const FeatureImageType *block) {
+      return std::vector<FeatureImageType::Pointer>{ NeighbourhoodSum(block), NeighbourhoodSum(block) }; }, 1, 1);
+    tiledClassifier->SetNumberOfThreads(2);
+    CPPUNIT_ASSERT_THROW(tiledClassifier->Update(), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTiledVoxelClassifier)
@@ -1,5 +1,6 @@
 file(GLOB_RECURSE H_FILES RELATIVE "${CMAKE_CURRENT_SOURCE_DIR}" "${CMAKE_CURRENT_SOURCE_DIR}/include/*")
 
 set(CPP_FILES
+  mitkCommandLineBatchHost.cpp
   mitkCommandLineParser.cpp
 )
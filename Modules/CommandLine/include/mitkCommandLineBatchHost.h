@@ -0,0 +1,121 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkCommandLineBatchHost_h
+#define mitkCommandLineBatchHost_h
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <MitkCommandLineExports.h>
+
+namespace mitk
+{
+  /** \brief Runs many invocations of command line apps inside one process.
+  *
+  * Every command line app is a separate executable, so every invocation pays the start up of the
+  * module system, the registration of all services and the discovery of the file readers. For
+  * pipelines with thousands of small cases this often costs more than the actual work.
+  *
+  * The batch host runs the apps in-process instead: the apps register their entry function (the
+  * former main function) with RegisterApp(), the jobs are read from a JSON lines file and run on the
+  * threads of an itk::MultiThreader. The module system is loaded once and all jobs share the
+  * registered reader and writer services. The file readers are reused across the jobs (see
+  * FileReaderRegistry::SetReaderReuse()).
+  *
+  * Each line of a job file is one JSON object with the app name and its arguments, e.g.
+  * \code
+  * {"app": "FileConverter", "args": ["-i", "case1.dcm", "-o", "case1.nrrd"]}
+  * \endcode
+  * Empty lines and lines starting with '#' are ignored.
+  *
+  * Apps that use global state or need the main thread (e.g. for a QApplication) have to be
+  * registered as not thread safe. Each module provides a host for its own apps, whose main function
+  * registers the apps and calls Execute().
+  */
+  class MITKCOMMANDLINE_EXPORT CommandLineBatchHost
+  {
+  public:
+    using AppFunctionType = std::function<int(int, char *[])>;
+
+    struct Job
+    {
+      /** Line of the job in the job file (starting with 1). */
+      std::size_t Line = 0;
+      std::string App;
+      std::vector<std::string> Arguments;
+    };
+
+    struct JobResult
+    {
+      std::size_t Line = 0;
+      std::string App;
+      int ExitCode = 0;
+      /** Wall clock time of the job in seconds. */
+      double Seconds = 0.0;
+      /** Message of an exception that was thrown by the app. */
+      std::string Error;
+    };
+
+    CommandLineBatchHost();
+
+    /** Registers the entry function of an app under the given name.
+    * @param threadSafe false if the app uses global state or needs the main thread. Its jobs are run one
+    * after another in the calling thread of Run(), after the jobs of the thread safe apps.
+    */
+    void RegisterApp(const std::string &name, const AppFunctionType &function, bool threadSafe = true);
+
+    std::vector<std::string> GetAppNames() const;
+
+    /** Parses the jobs from a JSON lines stream.
+    * @exception mitk::Exception if a line is not a valid job. */
+    static std::vector<Job> ReadJobs(std::istream &stream);
+
+    /** Reuse the file readers across the jobs (default). */
+    void SetReuseReaders(bool reuseReaders);
+    bool GetReuseReaders() const;
+
+    /** Runs all jobs and returns their results in the order of the jobs.
+    * Jobs of unknown apps fail with exit code EXIT_FAILURE. Exceptions of the apps are caught and
+    * reported as failed jobs.
+    * @param numberOfThreads number of concurrently running jobs, 0 to use the default number of threads of ITK.
+    */
+    std::vector<JobResult> Run(const std::vector<Job> &jobs, unsigned int numberOfThreads = 0) const;
+
+    /** Writes the results as CSV (one line per job). */
+    static void WriteReport(std::ostream &stream, const std::vector<JobResult> &results);
+
+    /** Main function of a batch host executable. Parses the arguments (job file, optional report file and
+    * number of threads), runs the jobs and writes the report.
+    * @param title title of the executable in the help text.
+    * @return EXIT_SUCCESS if all jobs succeeded.
+    */
+    int Execute(int argc, char *argv[], const std::string &title) const;
+
+  private:
+    struct App
+    {
+      AppFunctionType Function;
+      bool ThreadSafe;
+    };
+
+    JobResult RunJob(const Job &job) const;
+
+    std::map<std::string, App> m_Apps;
+    bool m_ReuseReaders;
+  };
+}
+
+#endif
@@ -0,0 +1,318 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCommandLineBatchHost.h"
+#include "mitkCommandLineParser.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkFileReaderRegistry.h>
+#include <mitkLogMacros.h>
+#include <mitkParallelFor.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+  /** Sets the reuse of the file readers and restores the previous setting when it is destroyed */
+  class ReaderReuseGuard
+  {
+  public:
+    explicit ReaderReuseGuard(bool reuse) : m_PreviousReuse(mitk::FileReaderRegistry::GetReaderReuse())
+    {
+      if (reuse != m_PreviousReuse)
+        mitk::FileReaderRegistry::SetReaderReuse(reuse);
+    }
+
+    ~ReaderReuseGuard()
+    {
+      if (mitk::FileReaderRegistry::GetReaderReuse() != m_PreviousReuse)
+        mitk::FileReaderRegistry::SetReaderReuse(m_PreviousReuse);
+    }
+
+  private:
+    bool m_PreviousReuse;
+  };
+
+  std::string QuoteCSV(const std::string &value)
+  {
+    std::string result = "\"";
+    for (char c : value)
+    {
+      if (c == '"')
+        result += '"';
+      result += c;
+    }
+    return result + "\"";
+  }
+}
+
+mitk::CommandLineBatchHost::CommandLineBatchHost() : m_ReuseReaders(true)
+{
+}
+
+void mitk::CommandLineBatchHost::RegisterApp(const std::string &name,
+                                             const AppFunctionType &function,
+                                             bool threadSafe)
+{
+  App app;
+  app.Function = function;
+  app.ThreadSafe = threadSafe;
+  m_Apps[name] = app;
+}
+
+std::vector<std::string> mitk::CommandLineBatchHost::GetAppNames() const
+{
+  std::vector<std::string> names;
+  for (const auto &app : m_Apps)
+    names.push_back(app.first);
+
+  return names;
+}
+
+void mitk::CommandLineBatchHost::SetReuseReaders(bool reuseReaders)
+{
+  m_ReuseReaders = reuseReaders;
+}
+
+bool mitk::CommandLineBatchHost::GetReuseReaders() const
+{
+  return m_ReuseReaders;
+}
+
+std::vector<mitk::CommandLineBatchHost::Job> mitk::CommandLineBatchHost::ReadJobs(std::istream &stream)
+{
+  std::vector<Job> jobs;
+  std::string line;
+  std::size_t lineNumber = 0;
+
+  while (std::getline(stream, line))
+  {
+    ++lineNumber;
+
+    const auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#')
+      continue;
+
+    Job job;
+    job.Line = lineNumber;
+
+    try
+    {
+      std::istringstream lineStream(line);
+      boost::property_tree::ptree root;
+      boost::property_tree::read_json(lineStream, root);
+
+      job.App = root.get<std::string>("app");
+
+      auto arguments = root.get_child_optional("args");
+      if (arguments)
+      {
+        for (const auto &argument : *arguments)
+          job.Arguments.push_back(argument.second.get_value<std::string>());
+      }
+    }
+    catch (const boost::property_tree::ptree_error &e)
+    {
+      mitkThrow() << "Invalid job in line " << lineNumber << ": " << e.what();
+    }
+
+    jobs.push_back(job);
+  }
+
+  return jobs;
+}
+
+std::vector<mitk::CommandLineBatchHost::JobResult> mitk::CommandLineBatchHost::Run(const std::vector<Job> &jobs,
+                                                                                 unsigned int numberOfThreads) const
+{
+  std::vector<std::size_t> parallelJobs;
+  std::vector<std::size_t> serialJobs;
+  for (std::size_t i = 0; i < jobs.size(); ++i)
+  {
+    auto app = m_Apps.find(jobs[i].App);
+    if (app == m_Apps.end() || app->second.ThreadSafe)
+      parallelJobs.push_back(i);
+    else
+      serialJobs.push_back(i);
+  }
+
+  ReaderReuseGuard readerReuse(m_ReuseReaders);
+
+  std::vector<JobResult> results(jobs.size());
+  mitk::ParallelFor(parallelJobs.size(), numberOfThreads, [&](std::size_t i) {
+    results[parallelJobs[i]] = this->RunJob(jobs[parallelJobs[i]]);
+  });
+
+  for (auto i : serialJobs)
+    results[i] = this->RunJob(jobs[i]);
+
+  return results;
+}
+
+mitk::CommandLineBatchHost::JobResult mitk::CommandLineBatchHost::RunJob(const Job &job) const
+{
+  JobResult result;
+  result.Line = job.Line;
+  result.App = job.App;
+
+  auto app = m_Apps.find(job.App);
+  if (app == m_Apps.end())
+  {
+    result.ExitCode = EXIT_FAILURE;
+    result.Error = "Unknown app '" + job.App + "'";
+    MITK_ERROR << "Job in line " << job.Line << ": " << result.Error;
+    return result;
+  }
+
+  // the apps expect a mutable, null terminated argv with the app name as first argument
+  std::vector<std::string> arguments;
+  arguments.push_back(job.App);
+  arguments.insert(arguments.end(), job.Arguments.begin(), job.Arguments.end());
+
+  std::vector<char *> argv;
+  for (auto &argument : arguments)
+    argv.push_back(&argument[0]);
+  argv.push_back(nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+
+  try
+  {
+    result.ExitCode = app->second.Function(static_cast<int>(arguments.size()), argv.data());
+  }
+  catch (const std::exception &e)
+  {
+    result.ExitCode = EXIT_FAILURE;
+    result.Error = e.what();
+  }
+  catch (...)
+  {
+    result.ExitCode = EXIT_FAILURE;
+    result.Error = "Unknown exception";
+  }
+
+  result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (result.ExitCode == EXIT_SUCCESS)
+  {
+    MITK_INFO << "Job in line " << job.Line << " (" << job.App << ") finished in " << result.Seconds << " s";
+  }
+  else
+  {
+    MITK_ERROR << "Job in line " << job.Line << " (" << job.App << ") failed with exit code " << result.ExitCode
+               << " after " << result.Seconds << " s. " << result.Error;
+  }
+
+  return result;
+}
+
+void mitk::CommandLineBatchHost::WriteReport(std::ostream &stream, const std::vector<JobResult> &results)
+{
+  stream << "Line,App,Exit code,Time [s],Error" << std::endl;
+
+  for (const auto &result : results)
+  {
+    stream << result.Line << "," << QuoteCSV(result.App) << "," << result.ExitCode << "," << result.Seconds << ","
+           << QuoteCSV(result.Error) << std::endl;
+  }
+}
+
+int mitk::CommandLineBatchHost::Execute(int argc, char *argv[], const std::string &title) const
+{
+  std::string appNames;
+  for (const auto &app : m_Apps)
+    appNames += (appNames.empty() ? "" : ", ") + app.first;
+
+  mitkCommandLineParser parser;
+
+  parser.setTitle(title);
+  parser.setCategory("Batch Processing");
+  parser.setDescription("Runs many jobs of command line apps (" + appNames + ") in one process. "
+    "Each line of the job file is a JSON object like {\"app\": \"<app>\", \"args\": [\"-i\", \"in.dcm\", \"-o\", \"out.nrrd\"]}.");
+  parser.setContributor("German Cancer Research Center (DKFZ)");
+
+  parser.setArgumentPrefix("--","-");
+  // Add command line argument names
+  parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
+  parser.addArgument("jobs", "j", mitkCommandLineParser::File, "Job file:", "JSON lines file with one job per line", us::Any(), false, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("report", "r", mitkCommandLineParser::File, "Report file:", "CSV file with exit code and time of every job", us::Any(), true, false, false, mitkCommandLineParser::Output);
+  parser.addArgument("threads", "t", mitkCommandLineParser::Int, "Threads:", "Number of concurrently running jobs, 0 to use the default number of threads of ITK", us::Any(1), true);
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+
+  if (parsedArgs.size()==0)
+      return EXIT_FAILURE;
+
+  // Show a help message
+  if ( parsedArgs.count("help") || parsedArgs.count("h"))
+  {
+    std::cout << parser.helpText();
+    return EXIT_SUCCESS;
+  }
+
+  std::string jobsFilename = us::any_cast<std::string>(parsedArgs["jobs"]);
+
+  int numberOfThreads = 1;
+  if (parsedArgs.count("threads"))
+  {
+    numberOfThreads = us::any_cast<int>(parsedArgs["threads"]);
+  }
+
+  std::ifstream jobsFile(jobsFilename);
+  if (!jobsFile)
+  {
+    MITK_ERROR << "Cannot open job file " << jobsFilename;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Job> jobs;
+  try
+  {
+    jobs = ReadJobs(jobsFile);
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_ERROR << e.GetDescription();
+    return EXIT_FAILURE;
+  }
+
+  MITK_INFO << "Running " << jobs.size() << " jobs";
+
+  auto start = std::chrono::steady_clock::now();
+  auto results = this->Run(jobs, static_cast<unsigned int>(std::max(0, numberOfThreads)));
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::size_t numberOfFailedJobs = 0;
+  for (const auto &result : results)
+  {
+    if (result.ExitCode != EXIT_SUCCESS)
+      ++numberOfFailedJobs;
+  }
+
+  MITK_INFO << "Finished " << results.size() << " jobs in " << seconds << " s, " << numberOfFailedJobs << " failed";
+
+  if (parsedArgs.count("report"))
+  {
+    std::ofstream report(us::any_cast<std::string>(parsedArgs["report"]));
+    WriteReport(report, results);
+  }
+
+  return numberOfFailedJobs == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
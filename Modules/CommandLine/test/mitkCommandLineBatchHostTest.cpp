@@ -0,0 +1,210 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkCommandLineBatchHost.h>
+#include <mitkException.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+class mitkCommandLineBatchHostTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCommandLineBatchHostTestSuite);
+  MITK_TEST(ReadJobs_ValidJobs_ReturnsJobs);
+  MITK_TEST(ReadJobs_InvalidJson_Throws);
+  MITK_TEST(ReadJobs_MissingApp_Throws);
+  MITK_TEST(Run_Jobs_PassesArgumentsAndKeepsOrder);
+  MITK_TEST(Run_UnknownApp_Fails);
+  MITK_TEST(Run_AppThrows_Fails);
+  MITK_TEST(Run_NotThreadSafeApp_RunsSeriallyInCallingThread);
+  MITK_TEST(WriteReport_Results_QuotesFields);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static mitk::CommandLineBatchHost::Job CreateJob(const std::string &app, const std::vector<std::string> &arguments)
+  {
+    mitk::CommandLineBatchHost::Job job;
+    job.App = app;
+    job.Arguments = arguments;
+    return job;
+  }
+
+public:
+  void ReadJobs_ValidJobs_ReturnsJobs()
+  {
+    std::istringstream stream("# comment\n"
+                              "{\"app\": \"FileConverter\", \"args\": [\"-i\", \"in file.dcm\", \"-o\", \"out.nrrd\"]}\n"
+                              "\n"
+                              "  \t\r\n"
+                              "{\"app\": \"RectifyImage\"}\n");
+
+    auto jobs = mitk::CommandLineBatchHost::ReadJobs(stream);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), jobs.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), jobs[0].Line);
+    CPPUNIT_ASSERT_EQUAL(std::string("FileConverter"), jobs[0].App);
+    CPPUNIT_ASSERT(jobs[0].Arguments == std::vector<std::string>({"-i", "in file.dcm", "-o", "out.nrrd"}));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), jobs[1].Line);
+    CPPUNIT_ASSERT_EQUAL(std::string("RectifyImage"), jobs[1].App);
+    CPPUNIT_ASSERT(jobs[1].Arguments.empty());
+  }
+
+  void ReadJobs_InvalidJson_Throws()
+  {
+    std::istringstream stream("{\"app\": \"FileConverter\", \"args\": [\"-i\"]}\n"
+                              "{\"app\": \"FileConverter\", \"args\": [\"-i\"\n");
+
+    CPPUNIT_ASSERT_THROW(mitk::CommandLineBatchHost::ReadJobs(stream), mitk::Exception);
+  }
+
+  void ReadJobs_MissingApp_Throws()
+  {
+    std::istringstream stream("{\"args\": [\"-i\", \"in.dcm\"]}\n");
+
+    CPPUNIT_ASSERT_THROW(mitk::CommandLineBatchHost::ReadJobs(stream), mitk::Exception);
+  }
+
+  void Run_Jobs_PassesArgumentsAndKeepsOrder()
+  {
+    // returns the number of arguments if argv is valid
+    mitk::CommandLineBatchHost host;
+    host.RegisterApp("Count", [](int argc, char *argv[]) {
+      if (std::string(argv[0]) != "Count" || argv[argc] != nullptr)
+        return -1;
+
+      for (int i = 1; i < argc; ++i)
+      {
+        if (argv[i] != std::to_string(i))
+          return -1;
+      }
+      return argc - 1;
+    });
+
+    std::vector<mitk::CommandLineBatchHost::Job> jobs;
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+      std::vector<std::string> arguments;
+      for (std::size_t j = 1; j <= i % 5; ++j)
+        arguments.push_back(std::to_string(j));
+
+      jobs.push_back(CreateJob("Count", arguments));
+      jobs.back().Line = i + 1;
+    }
+
+    auto results = host.Run(jobs, 4);
+
+    CPPUNIT_ASSERT_EQUAL(jobs.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(i + 1, results[i].Line);
+      CPPUNIT_ASSERT_EQUAL(std::string("Count"), results[i].App);
+      CPPUNIT_ASSERT_EQUAL(static_cast<int>(i % 5), results[i].ExitCode);
+      CPPUNIT_ASSERT(results[i].Error.empty());
+      CPPUNIT_ASSERT(results[i].Seconds >= 0.0);
+    }
+  }
+
+  void Run_UnknownApp_Fails()
+  {
+    mitk::CommandLineBatchHost host;
+    host.RegisterApp("Succeed", [](int, char *[]) { return EXIT_SUCCESS; });
+
+    auto results = host.Run({CreateJob("Unknown", {}), CreateJob("Succeed", {})}, 2);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(EXIT_FAILURE, results[0].ExitCode);
+    CPPUNIT_ASSERT(results[0].Error.find("Unknown app") != std::string::npos);
+    CPPUNIT_ASSERT_EQUAL(EXIT_SUCCESS, results[1].ExitCode);
+  }
+
+  void Run_AppThrows_Fails()
+  {
+    mitk::CommandLineBatchHost host;
+    host.RegisterApp("Throw", [](int, char *[]) -> int { throw std::runtime_error("Cannot read input"); });
+    host.RegisterApp("ThrowUnknown", [](int, char *[]) -> int { throw 42; });
+    host.RegisterApp("Succeed", [](int, char *[]) { return EXIT_SUCCESS; });
+
+    auto results =
+      host.Run({CreateJob("Throw", {}), CreateJob("ThrowUnknown", {}), CreateJob("Succeed", {})}, 3);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), results.size());
+    CPPUNIT_ASSERT_EQUAL(EXIT_FAILURE, results[0].ExitCode);
+    CPPUNIT_ASSERT_EQUAL(std::string("Cannot read input"), results[0].Error);
+    CPPUNIT_ASSERT_EQUAL(EXIT_FAILURE, results[1].ExitCode);
+    CPPUNIT_ASSERT(!results[1].Error.empty());
+    CPPUNIT_ASSERT_EQUAL(EXIT_SUCCESS, results[2].ExitCode);
+  }
+
+  void Run_NotThreadSafeApp_RunsSeriallyInCallingThread()
+  {
+    const std::thread::id callingThread = std::this_thread::get_id();
+    std::atomic<int> runningJobs(0);
+    std::atomic<bool> concurrent(false);
+    std::atomic<bool> otherThread(false);
+
+    mitk::CommandLineBatchHost host;
+    host.RegisterApp("Global",
+                     [&](int, char *[]) {
+                       if (++runningJobs > 1)
+                         concurrent = true;
+                       if (std::this_thread::get_id() != callingThread)
+                         otherThread = true;
+                       std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                       --runningJobs;
+                       return EXIT_SUCCESS;
+                     },
+                     false);
+
+    std::vector<mitk::CommandLineBatchHost::Job> jobs(8, CreateJob("Global", {}));
+    auto results = host.Run(jobs, 4);
+
+    CPPUNIT_ASSERT_EQUAL(jobs.size(), results.size());
+    for (const auto &result : results)
+      CPPUNIT_ASSERT_EQUAL(EXIT_SUCCESS, result.ExitCode);
+
+    CPPUNIT_ASSERT(!concurrent);
+    CPPUNIT_ASSERT(!otherThread);
+  }
+
+  void WriteReport_Results_QuotesFields()
+  {
+    mitk::CommandLineBatchHost::JobResult success;
+    success.Line = 1;
+    success.App = "FileConverter";
+    success.ExitCode = EXIT_SUCCESS;
+    success.Seconds = 0.5;
+
+    mitk::CommandLineBatchHost::JobResult failure;
+    failure.Line = 3;
+    failure.App = "Rectify, \"Image\"";
+    failure.ExitCode = 2;
+    failure.Seconds = 1.25;
+    failure.Error = "Cannot read \"in.dcm\",\nskipped";
+
+    std::ostringstream stream;
+    mitk::CommandLineBatchHost::WriteReport(stream, {success, failure});
+
+    CPPUNIT_ASSERT_EQUAL(std::string("Line,App,Exit code,Time [s],Error\n"
+                                     "1,\"FileConverter\",0,0.5,\"\"\n"
+                                     "3,\"Rectify, \"\"Image\"\"\",2,1.25,\"Cannot read \"\"in.dcm\"\",\nskipped\"\n"),
+                         stream.str());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCommandLineBatchHost)
@@ -64,12 +64,32 @@ namespace mitk
     void UngetReader(mitk::IFileReader *reader);
     void UngetReaders(const std::vector<mitk::IFileReader *> &readers);
 
+    /**
+     * @brief Enables or disables the reuse of readers.
+     *
+     * The readers are prototype scoped services, so each FileReaderRegistry creates new reader
+     * instances. If the reuse is enabled, readers that are released by UngetReader() or the
+     * destructor are kept and handed out again by GetReader() and GetReaders() of any
+     * FileReaderRegistry, with the options they had when they were created. This saves the
+     * creation of the readers if many files are loaded, e.g. by batch processing.
+     *
+     * Disabling the reuse releases all kept readers. It must be disabled before the modules
+     * providing the kept readers are unloaded.
+     */
+    static void SetReaderReuse(bool reuse);
+    static bool GetReaderReuse();
+
   private:
     // purposely not implemented
     FileReaderRegistry(const FileReaderRegistry &);
     FileReaderRegistry &operator=(const FileReaderRegistry &);
 
+    mitk::IFileReader *CreateReader(const ReaderReference &ref, us::ModuleContext *context);
+    void ReleaseReader(mitk::IFileReader *reader, us::ServiceObjects<mitk::IFileReader> &serviceObjects);
+
     std::map<mitk::IFileReader *, us::ServiceObjects<mitk::IFileReader>> m_ServiceObjects;
+    // options of the readers when they were created, restored when a reader is reused
+    std::map<mitk::IFileReader *, IFileReader::Options> m_InitialOptions;
   };
 
 } // namespace mitk
@@ -31,6 +31,8 @@ found in the LICENSE file.
 #include <itkHistogram.h>
 #endif
 
+#include <deque>
+
 class vtkImageData;
 
 namespace itk
@@ -531,6 +533,40 @@ namespace mitk
       */
     void SetGeometry(BaseGeometry *aGeometry3D) override;
 
+    /** \brief Region of voxels of one time step, see ModifiedRegion(). */
+    typedef itk::ImageRegion<3> VolumeRegionType;
+
+    /**
+    * \brief Marks a region of a time step as modified.
+    *
+    * Calls Modified() and remembers the region, so that consumers which processed the image at an
+    * earlier modified time can update only the voxels that changed, see GetModifiedRegionSince().
+    * Code that writes into the image memory directly, e.g. the segmentation tools, should call this
+    * instead of Modified() if it knows the region it has written.
+    */
+    void ModifiedRegion(unsigned int t, const VolumeRegionType &region);
+
+    /**
+    * \brief Returns the bounding region of all regions of time step @a t that were marked by
+    * ModifiedRegion() after the modified time @a mtime.
+    *
+    * The region is empty if time step @a t was not modified. Returns false if the image was changed
+    * in another way after @a mtime (e.g. by Modified() or a new time geometry) or if the modifications
+    * are not remembered anymore. The consumer then has to process the whole image.
+    */
+    bool GetModifiedRegionSince(unsigned long mtime, unsigned int t, VolumeRegionType &region) const;
+
+    /**
+    * \brief Returns the region of voxels of time step @a t that contribute to a slice of the image along @a plane.
+    *
+    * The region is the bounding box of the plane in index coordinates, including the neighbors needed
+    * for interpolation, and clipped to the image. It is empty if the plane does not cut the image.
+    */
+    VolumeRegionType GetRegionOfPlane(const PlaneGeometry *plane, unsigned int t = 0) const;
+
+    /** \brief Forgets the regions remembered by ModifiedRegion(), see GetModifiedRegionSince(). */
+    void Modified() const override;
+
     /**
     * @warning for internal use only
     */
@@ -739,6 +775,27 @@ namespace mitk
     itk::SimpleFastMutexLock m_ReadWriteLock;
     /** A mutex, which needs to be locked to manage m_VtkReaders */
     itk::SimpleFastMutexLock m_VtkReadersLock;
+
+    struct ModifiedRegionRecord
+    {
+      unsigned long MTime;
+      unsigned int TimeStep;
+      VolumeRegionType Region;
+    };
+
+    /** Regions marked by ModifiedRegion(), oldest first */
+    mutable std::deque<ModifiedRegionRecord> m_ModifiedRegions;
+    /** Modifications after this time are completely described by m_ModifiedRegions */
+    mutable unsigned long m_ModifiedRegionsStartTime;
+    /** A mutex, which needs to be locked to manage m_ModifiedRegions */
+    mutable itk::SimpleFastMutexLock m_ModifiedRegionsLock;
+
+    /** Number of Modified() and ModifiedRegion() calls that are updating the modified time */
+    mutable unsigned int m_NumberOfPendingModifications;
+
+    /** Sets the time of the recorded modifications to the current modified time once no modification is
+     *  pending anymore, m_ModifiedRegionsLock has to be locked */
+    void ResolvePendingModifiedTimes() const;
   };
 
   /**
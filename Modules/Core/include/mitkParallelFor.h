@@ -0,0 +1,56 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkParallelFor_h
+#define mitkParallelFor_h
+
+#include <MitkCoreExports.h>
+
+#include <itkMultiThreader.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace mitk
+{
+  /**
+  * \brief Calls function(index, threadId) for every index in [0, count) on the threads of an itk::MultiThreader.
+  *
+  * The indices are handed out one by one to the threads, so the work items may take different times. threadId
+  * is smaller than numberOfThreads and can be used to select per-thread buffers. A numberOfThreads of 0 uses
+  * itk::MultiThreader::GetGlobalDefaultNumberOfThreads(). With one thread or one index, the function is called
+  * in the calling thread.
+  *
+  * If a call throws, the remaining indices are skipped and the first exception is rethrown after all threads
+  * finished.
+  *
+  * @param threader threader to run on, e.g. the one of a filter, so that repeated calls can use its thread pool.
+  * If nullptr, a new threader is created.
+  */
+  MITKCORE_EXPORT void ParallelFor(std::size_t count,
+                                   unsigned int numberOfThreads,
+                                   const std::function<void(std::size_t index, unsigned int threadId)> &function,
+                                   itk::MultiThreader *threader = nullptr);
+
+  /** \brief Calls function(index) for every index in [0, count) on the threads of an itk::MultiThreader.
+  * \sa ParallelFor(std::size_t, unsigned int, const std::function<void(std::size_t, unsigned int)>&, itk::MultiThreader*) */
+  MITKCORE_EXPORT void ParallelFor(std::size_t count,
+                                   unsigned int numberOfThreads,
+                                   const std::function<void(std::size_t index)> &function,
+                                   itk::MultiThreader *threader = nullptr);
+
+  /** \brief Number of threads ParallelFor() uses for count indices and the given number of threads (0 for the
+  * default). Use it to size per-thread buffers. */
+  MITKCORE_EXPORT unsigned int GetParallelForNumberOfThreads(std::size_t count, unsigned int numberOfThreads);
+}
+
+#endif
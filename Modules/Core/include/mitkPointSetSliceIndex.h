@@ -0,0 +1,102 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkPointSetSliceIndex_h
+#define mitkPointSetSliceIndex_h
+
+#include <MitkCoreExports.h>
+#include <mitkPointSet.h>
+
+#include <deque>
+#include <vector>
+
+namespace mitk
+{
+  class PlaneGeometry;
+
+  /**
+   * \brief Finds the points of a PointSet that lie near a plane without visiting every point.
+   *
+   * The index keeps the world coordinates of all points of one time step in the order of the
+   * point set. For each plane normal that is queried, the points are sorted once by their signed
+   * distance along the normal, so that the points within a slab around a plane are found by two
+   * binary searches.
+   *
+   * When the point set is modified without changing its point IDs (e.g. a point was moved or
+   * (de)selected), only the changed points are updated and moved within the sorted orders.
+   * Adding or removing points and changing the geometry rebuild the index.
+   */
+  class MITKCORE_EXPORT PointSetSliceIndex
+  {
+  public:
+    PointSetSliceIndex();
+    ~PointSetSliceIndex();
+
+    /** \brief Brings the index up to date with the given time step of the point set. */
+    void Update(const PointSet *pointSet, int timeStep);
+
+    /** \brief Number of points in the index. */
+    std::size_t GetNumberOfPoints() const;
+
+    /** \brief World coordinates of the points, in the order of the point set. */
+    const std::vector<Point3D> &GetWorldPoints() const;
+
+    /** \brief IDs of the points, in the order of the point set. */
+    const std::vector<PointSet::PointIdentifier> &GetPointIds() const;
+
+    /** \brief Selection state of the point at the given position. */
+    bool IsSelected(std::size_t position) const;
+
+    /**
+     * \brief Collects the positions of all points whose distance to the plane is below maxDistance.
+     *
+     * The positions refer to GetWorldPoints() and are sorted ascending, i.e. in the order of the point set.
+     */
+    void FindPointsNearPlane(const PlaneGeometry *plane, double maxDistance, std::vector<std::size_t> &positions);
+
+    /** \brief Number of points that were updated incrementally by the last Update(). */
+    std::size_t GetNumberOfUpdatedPoints() const;
+
+  private:
+    PointSetSliceIndex(const PointSetSliceIndex &) = delete;
+    PointSetSliceIndex &operator=(const PointSetSliceIndex &) = delete;
+
+    /** \brief Positions of all points sorted by their signed distance along a normal. */
+    struct SortedOrder
+    {
+      Vector3D Normal;
+      std::vector<double> Distances;
+      std::vector<std::size_t> Positions;
+    };
+
+    void Rebuild(const PointSet::DataType *itkPointSet, const BaseGeometry *geometry);
+    bool UpdateChangedPoints(const PointSet::DataType *itkPointSet, const BaseGeometry *geometry);
+    SortedOrder &GetSortedOrder(const Vector3D &normal);
+    void SortPoints(SortedOrder &order) const;
+    void MovePoint(SortedOrder &order, std::size_t position, double oldDistance) const;
+
+    const PointSet *m_PointSet;
+    int m_TimeStep;
+    unsigned long m_PointSetMTime;
+    unsigned long m_GeometryMTime;
+
+    std::vector<PointSet::PointIdentifier> m_PointIds;
+    std::vector<PointSet::PointType> m_IndexPoints;
+    std::vector<Point3D> m_WorldPoints;
+    std::vector<bool> m_Selected;
+
+    std::deque<SortedOrder> m_SortedOrders;
+    std::size_t m_NumberOfUpdatedPoints;
+  };
+}
+
+#endif
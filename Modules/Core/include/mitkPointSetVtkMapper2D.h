@@ -19,9 +19,14 @@ found in the LICENSE file.
 #include <MitkCoreExports.h>
 #include <mitkPointSetShapeProperty.h>
 
+#include <memory>
+
 // VTK
 #include <vtkSmartPointer.h>
 class vtkActor;
+class vtkActor2D;
+class vtkLabeledDataMapper;
+class vtkStringArray;
 class vtkPropAssembly;
 class vtkPolyData;
 class vtkPolyDataMapper;
@@ -33,6 +38,7 @@ class vtkCellArray;
 namespace mitk
 {
   class PointSet;
+  class PointSetSliceIndex;
 
   /**
   * @brief Vtk-based 2D mapper for PointSet
@@ -64,6 +70,10 @@ namespace mitk
   * object is returned in GetProp() and so hooked up into the rendering
   * pipeline.
   *
+  * The points near the current plane are looked up in a PointSetSliceIndex, so
+  * that only these points are visited when the slice changes. Labels are drawn
+  * by a single actor for all points, distances and angles by a second one.
+  *
   * @section mitkPointSetVtkMapper2D_propertires Applicable Properties
   *
   * Properties that can be set for point sets and influence the PointSetVTKMapper2D are:
@@ -173,11 +183,20 @@ namespace mitk
       vtkSmartPointer<vtkActor> m_UnselectedActor;
       vtkSmartPointer<vtkActor> m_SelectedActor;
       vtkSmartPointer<vtkActor> m_ContourActor;
-      vtkSmartPointer<vtkTextActor> m_VtkTextActor;
 
-      std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextLabelActors;
-      std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextDistanceActors;
-      std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextAngleActors;
+      // texts of the labels and of the distances and angles, placed in display coordinates
+      vtkSmartPointer<vtkPolyData> m_VtkTextLabelPolyData;
+      vtkSmartPointer<vtkStringArray> m_TextLabels;
+      vtkSmartPointer<vtkLabeledDataMapper> m_VtkTextLabelMapper;
+      vtkSmartPointer<vtkActor2D> m_VtkTextLabelActor;
+
+      vtkSmartPointer<vtkPolyData> m_VtkTextMeasurementPolyData;
+      vtkSmartPointer<vtkStringArray> m_TextMeasurements;
+      vtkSmartPointer<vtkLabeledDataMapper> m_VtkTextMeasurementMapper;
+      vtkSmartPointer<vtkActor2D> m_VtkTextMeasurementActor;
+
+      // positions of the points near the current plane, see PointSetSliceIndex
+      std::vector<std::size_t> m_PointsNearPlane;
 
       // mappers
       vtkSmartPointer<vtkPolyDataMapper> m_VtkUnselectedPolyDataMapper;
@@ -206,7 +225,7 @@ namespace mitk
     void ResetMapper(BaseRenderer *renderer) override;
 
     /* \brief Fills the vtk objects, thus it is only called when the point set has been changed.
-   * This function iterates over the input point set and determines the glyphs which lie in a specific
+   * This function queries the points of the input point set which lie in a specific
    * range around the current slice. Those glyphs are rendered using a specific shape defined in vtk glyph source
    * to mark each point. The shape can be changed in MITK using the property "PointSet.2D.shape".
    *
@@ -231,6 +250,10 @@ namespace mitk
     int m_IDShapeProperty;        // ID for mitkPointSetShape Enumeration Property "Pointset.2D.shape"
     bool m_FillShape;             // "Pointset.2D.fill shape" property
     float m_DistanceToPlane;      // "Pointset.2D.distance to plane" property
+
+  private:
+    /** \brief World coordinates of the input points, shared by all renderers */
+    std::unique_ptr<PointSetSliceIndex> m_SliceIndex;
   };
 
 } // namespace mitk
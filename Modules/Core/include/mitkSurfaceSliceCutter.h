@@ -0,0 +1,117 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkSurfaceSliceCutter_h
+#define mitkSurfaceSliceCutter_h
+
+#include <MitkCoreExports.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+#include <vtkWeakPointer.h>
+
+#include <deque>
+#include <vector>
+
+class vtkCutter;
+class vtkPlane;
+class vtkPolyData;
+
+namespace mitk
+{
+  /**
+   * \brief Cuts a surface with planes, touching only the cells that can intersect the plane.
+   *
+   * For each plane normal that is used, the cells of the surface are sorted once into
+   * bins along the normal by the interval of their signed distances. A cut then only
+   * hands the cells of the bin containing the plane to a vtkCutter instead of the whole
+   * surface. The index is rebuilt when the input or its modified time changes.
+   *
+   * The last cuts are kept, so that scrolling back to a previous slice does not cut
+   * the surface again.
+   *
+   * The output of Cut() is equal to the output of a vtkCutter applied to the whole input,
+   * except for the order of its points and cells.
+   */
+  class MITKCORE_EXPORT SurfaceSliceCutter
+  {
+  public:
+    SurfaceSliceCutter();
+    ~SurfaceSliceCutter();
+
+    /**
+     * \brief Returns the cut of the given surface with the plane through origin with the given normal.
+     *
+     * The returned poly data must not be modified, it may be returned again for the same plane.
+     */
+    vtkSmartPointer<vtkPolyData> Cut(vtkPolyData *input, const double origin[3], const double normal[3]);
+
+    /** \brief Number of cuts that are kept for the same surface. Default is 32. */
+    void SetMaximumNumberOfCachedCuts(unsigned int number);
+    unsigned int GetMaximumNumberOfCachedCuts() const;
+
+    /** \brief Number of cells handed to the vtkCutter by the last Cut() that was not cached. */
+    vtkIdType GetNumberOfCandidateCells() const;
+
+  private:
+    SurfaceSliceCutter(const SurfaceSliceCutter &) = delete;
+    SurfaceSliceCutter &operator=(const SurfaceSliceCutter &) = delete;
+
+    /** \brief A cell of the input with the range of its signed distances along the normal of an index. */
+    struct IndexedCell
+    {
+      vtkIdType CellId;
+      vtkIdType Location; ///< location of the cell in its vtkCellArray
+      double Min;
+      double Max;
+      unsigned char CellArray; ///< 0 = lines, 1 = polys, 2 = strips
+    };
+
+    /** \brief Cells of the input binned along a normal (compressed row storage). */
+    struct NormalIndex
+    {
+      double Normal[3];
+      double Min;
+      double BinWidth;
+      std::vector<IndexedCell> Cells;
+      std::vector<std::size_t> BinStart;
+      std::vector<std::size_t> BinCells;
+    };
+
+    struct CachedCut
+    {
+      double Normal[3];
+      double Offset;
+      vtkSmartPointer<vtkPolyData> Output;
+    };
+
+    void SetInput(vtkPolyData *input);
+    NormalIndex &GetIndex(const double normal[3]);
+    void BuildIndex(NormalIndex &index) const;
+    vtkSmartPointer<vtkPolyData> ExtractCandidateCells(const NormalIndex &index, double offset);
+
+    vtkWeakPointer<vtkPolyData> m_Input;
+    vtkMTimeType m_InputMTime;
+
+    std::deque<NormalIndex> m_Indices;
+    std::deque<CachedCut> m_CachedCuts;
+    unsigned int m_MaximumNumberOfCachedCuts;
+
+    std::vector<vtkIdType> m_PointMap; ///< maps input point IDs to IDs of the candidate poly data, -1 if unused
+
+    vtkSmartPointer<vtkPlane> m_Plane;
+    vtkSmartPointer<vtkCutter> m_Cutter;
+    vtkIdType m_NumberOfCandidateCells;
+  };
+}
+
+#endif
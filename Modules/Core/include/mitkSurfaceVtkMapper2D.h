@@ -20,9 +20,13 @@ found in the LICENSE file.
 
 // VTK
 #include <vtkSmartPointer.h>
+
+// STL
+#include <memory>
+
 class vtkAssembly;
-class vtkCutter;
 class vtkPlane;
+class vtkTransformPolyDataFilter;
 class vtkLookupTable;
 class vtkGlyph3D;
 class vtkArrowSource;
@@ -31,6 +35,7 @@ class vtkReverseSense;
 namespace mitk
 {
   class Surface;
+  class SurfaceSliceCutter;
 
   /**
     * @brief Vtk-based mapper for cutting 2D slices out of Surfaces.
@@ -102,9 +107,9 @@ namespace mitk
          */
       vtkSmartPointer<vtkPolyDataMapper> m_Mapper;
       /**
-         * @brief m_Cutter Filter to cut out the 2D slice.
+         * @brief m_CutTransformFilter Transforms the cut of the surface according to the geometry of the data.
          */
-      vtkSmartPointer<vtkCutter> m_Cutter;
+      vtkSmartPointer<vtkTransformPolyDataFilter> m_CutTransformFilter;
       /**
          * @brief m_CuttingPlane The plane where to cut off the 2D slice.
          */
@@ -210,6 +215,12 @@ namespace mitk
        * @param renderer The respective renderer of the mitkRenderWindow.
        */
     void Update(BaseRenderer *renderer) override;
+
+    /**
+       * @brief m_SliceCutter Cuts the surface using a cell index along the plane normal.
+       * It is shared by all renderers and keeps the cuts of recently shown slices.
+       */
+    std::unique_ptr<SurfaceSliceCutter> m_SliceCutter;
   };
 } // namespace mitk
 #endif /* mitkSurfaceVtkMapper2D_h */
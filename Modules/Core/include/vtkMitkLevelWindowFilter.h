@@ -18,6 +18,8 @@ class vtkPiecewiseFunction;
 #include <vtkImageData.h>
 #include <vtkThreadedImageAlgorithm.h>
 
+#include <vector>
+
 #include <MitkCoreExports.h>
 /** Documentation
 * \brief Applies the grayvalue or color/opacity level window to scalar or RGB(A) images.
@@ -28,6 +30,10 @@ class vtkPiecewiseFunction;
 *
 * The filter is also able to apply an opacity level window to RGBA images.
 *
+* For 8 and 16 bit integer scalar images, the colors of all possible input values are
+* precomputed once per lookup table change, so that mapping a pixel is a single table
+* access. Rows are split into their clipped and unclipped parts before mapping.
+*
 * \ingroup Renderer
 */
 class MITKCORE_EXPORT vtkMitkLevelWindowFilter : public vtkThreadedImageAlgorithm
@@ -75,6 +81,11 @@ protected:
    */
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int id) override;
 
+  /** \brief Builds the lookup table and the scalar color table before the threaded execution. */
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
   //  /** Standard VTK filter method to apply the filter. See VTK documentation.*/
   int RequestInformation(vtkInformation *request,
                          vtkInformationVector **inputVector,
@@ -93,5 +104,14 @@ private:
   double m_MaxOpacity;
 
   double m_ClippingBounds[4];
+
+  /** \brief Updates m_ScalarTable for the given input scalar type if necessary. */
+  void UpdateScalarTable(int scalarType);
+
+  /** Precomputed RGBA colors (one int per color) for all values of an 8 or 16 bit scalar type.*/
+  std::vector<int> m_ScalarTable;
+  /** The scalar type m_ScalarTable was computed for or -1 if the table is invalid.*/
+  int m_ScalarTableType;
+  vtkTimeStamp m_ScalarTableBuildTime;
 };
 #endif
@@ -0,0 +1,111 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+namespace
+{
+  struct ParallelForData
+  {
+    std::size_t Count;
+    const std::function<void(std::size_t, unsigned int)> *Function;
+    std::atomic<std::size_t> Next;
+    std::atomic<bool> Failed;
+    std::exception_ptr Exception;
+    std::mutex ExceptionMutex;
+  };
+
+  ITK_THREAD_RETURN_TYPE ParallelForCallback(void *arg)
+  {
+    auto *threadInfo = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+    auto *data = static_cast<ParallelForData *>(threadInfo->UserData);
+    const auto threadId = static_cast<unsigned int>(threadInfo->ThreadID);
+
+    try
+    {
+      for (std::size_t i = data->Next++; i < data->Count && !data->Failed; i = data->Next++)
+        (*data->Function)(i, threadId);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(data->ExceptionMutex);
+      if (!data->Exception)
+        data->Exception = std::current_exception();
+
+      data->Failed = true;
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
+
+unsigned int mitk::GetParallelForNumberOfThreads(std::size_t count, unsigned int numberOfThreads)
+{
+  if (numberOfThreads == 0)
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  numberOfThreads = std::min(numberOfThreads, static_cast<unsigned int>(itk::MultiThreader::GetGlobalMaximumNumberOfThreads()));
+
+  return static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, count)));
+}
+
+void mitk::ParallelFor(std::size_t count,
+                       unsigned int numberOfThreads,
+                       const std::function<void(std::size_t, unsigned int)> &function,
+                       itk::MultiThreader *threader)
+{
+  if (count == 0)
+    return;
+
+  numberOfThreads = GetParallelForNumberOfThreads(count, numberOfThreads);
+
+  if (numberOfThreads == 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      function(i, 0);
+
+    return;
+  }
+
+  ParallelForData data;
+  data.Count = count;
+  data.Function = &function;
+  data.Next = 0;
+  data.Failed = false;
+
+  itk::MultiThreader::Pointer newThreader;
+  if (threader == nullptr)
+  {
+    newThreader = itk::MultiThreader::New();
+    threader = newThreader;
+  }
+
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(ParallelForCallback, &data);
+  threader->SingleMethodExecute();
+
+  if (data.Exception)
+    std::rethrow_exception(data.Exception);
+}
+
+void mitk::ParallelFor(std::size_t count,
+                       unsigned int numberOfThreads,
+                       const std::function<void(std::size_t)> &function,
+                       itk::MultiThreader *threader)
+{
+  ParallelFor(count, numberOfThreads, [&function](std::size_t index, unsigned int) { function(index); }, threader);
+}
@@ -0,0 +1,308 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSurfaceSliceCutter.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCutter.h>
+#include <vtkMath.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  /** \brief Maximum number of normals an index is kept for (e.g. axial, sagittal, coronal and one oblique plane). */
+  const std::size_t MAXIMUM_NUMBER_OF_INDICES = 4;
+
+  /** \brief Average number of cells per bin of an index. */
+  const std::size_t CELLS_PER_BIN = 8;
+
+  const std::size_t MAXIMUM_NUMBER_OF_BINS = 1 << 16;
+
+  bool IsEqual(const double a[3], const double b[3])
+  {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+  }
+}
+
+mitk::SurfaceSliceCutter::SurfaceSliceCutter()
+  : m_Input(nullptr),
+    m_InputMTime(0),
+    m_MaximumNumberOfCachedCuts(32),
+    m_Plane(vtkSmartPointer<vtkPlane>::New()),
+    m_Cutter(vtkSmartPointer<vtkCutter>::New()),
+    m_NumberOfCandidateCells(0)
+{
+  m_Cutter->SetCutFunction(m_Plane);
+}
+
+mitk::SurfaceSliceCutter::~SurfaceSliceCutter()
+{
+}
+
+void mitk::SurfaceSliceCutter::SetMaximumNumberOfCachedCuts(unsigned int number)
+{
+  m_MaximumNumberOfCachedCuts = number;
+  while (m_CachedCuts.size() > m_MaximumNumberOfCachedCuts)
+    m_CachedCuts.pop_front();
+}
+
+unsigned int mitk::SurfaceSliceCutter::GetMaximumNumberOfCachedCuts() const
+{
+  return m_MaximumNumberOfCachedCuts;
+}
+
+vtkIdType mitk::SurfaceSliceCutter::GetNumberOfCandidateCells() const
+{
+  return m_NumberOfCandidateCells;
+}
+
+void mitk::SurfaceSliceCutter::SetInput(vtkPolyData *input)
+{
+  if (m_Input == input && m_InputMTime == input->GetMTime())
+    return;
+
+  m_Input = input;
+  m_InputMTime = input->GetMTime();
+  m_Indices.clear();
+  m_CachedCuts.clear();
+  m_PointMap.assign(input->GetNumberOfPoints(), -1);
+}
+
+vtkSmartPointer<vtkPolyData> mitk::SurfaceSliceCutter::Cut(vtkPolyData *input,
+                                                           const double origin[3],
+                                                           const double normal[3])
+{
+  this->SetInput(input);
+
+  double unitNormal[3] = {normal[0], normal[1], normal[2]};
+  vtkMath::Normalize(unitNormal);
+  const double offset = vtkMath::Dot(unitNormal, origin);
+
+  for (const auto &cachedCut : m_CachedCuts)
+  {
+    if (cachedCut.Offset == offset && IsEqual(cachedCut.Normal, unitNormal))
+      return cachedCut.Output;
+  }
+
+  NormalIndex &index = this->GetIndex(unitNormal);
+  vtkSmartPointer<vtkPolyData> candidates = this->ExtractCandidateCells(index, offset);
+
+  m_Plane->SetOrigin(const_cast<double *>(origin));
+  m_Plane->SetNormal(unitNormal);
+  m_Cutter->SetInputData(candidates);
+  m_Cutter->Update();
+
+  // the cutter creates new arrays on every execution, so a shallow copy is safe to keep
+  CachedCut cut;
+  std::copy(unitNormal, unitNormal + 3, cut.Normal);
+  cut.Offset = offset;
+  cut.Output = vtkSmartPointer<vtkPolyData>::New();
+  cut.Output->ShallowCopy(m_Cutter->GetOutput());
+  m_Cutter->SetInputData(nullptr);
+
+  if (m_MaximumNumberOfCachedCuts > 0)
+  {
+    if (m_CachedCuts.size() >= m_MaximumNumberOfCachedCuts)
+      m_CachedCuts.pop_front();
+    m_CachedCuts.push_back(cut);
+  }
+
+  return cut.Output;
+}
+
+mitk::SurfaceSliceCutter::NormalIndex &mitk::SurfaceSliceCutter::GetIndex(const double normal[3])
+{
+  for (auto &index : m_Indices)
+  {
+    if (IsEqual(index.Normal, normal))
+      return index;
+  }
+
+  if (m_Indices.size() >= MAXIMUM_NUMBER_OF_INDICES)
+    m_Indices.pop_front();
+
+  m_Indices.emplace_back();
+  NormalIndex &index = m_Indices.back();
+  std::copy(normal, normal + 3, index.Normal);
+  this->BuildIndex(index);
+  return index;
+}
+
+void mitk::SurfaceSliceCutter::BuildIndex(NormalIndex &index) const
+{
+  vtkPoints *points = m_Input->GetPoints();
+  vtkCellArray *cellArrays[3] = {m_Input->GetLines(), m_Input->GetPolys(), m_Input->GetStrips()};
+
+  // cell IDs of vtkPolyData are numbered verts, lines, polys, strips
+  vtkIdType cellId = m_Input->GetNumberOfVerts();
+
+  index.Cells.clear();
+  index.Cells.reserve(m_Input->GetNumberOfCells() - cellId);
+
+  double min = 0.0;
+  double max = 0.0;
+  for (unsigned char cellArray = 0; cellArray < 3; ++cellArray)
+  {
+    vtkCellArray *cells = cellArrays[cellArray];
+    if (cells == nullptr)
+      continue;
+
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++cellId)
+    {
+      IndexedCell cell;
+      cell.CellId = cellId;
+      cell.Location = cells->GetTraversalLocation(npts);
+      cell.CellArray = cellArray;
+      cell.Min = std::numeric_limits<double>::max();
+      cell.Max = std::numeric_limits<double>::lowest();
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        double point[3];
+        points->GetPoint(pts[i], point);
+        const double distance = vtkMath::Dot(index.Normal, point);
+        cell.Min = std::min(cell.Min, distance);
+        cell.Max = std::max(cell.Max, distance);
+      }
+      if (npts == 0)
+        continue;
+
+      if (index.Cells.empty())
+      {
+        min = cell.Min;
+        max = cell.Max;
+      }
+      min = std::min(min, cell.Min);
+      max = std::max(max, cell.Max);
+      index.Cells.push_back(cell);
+    }
+  }
+
+  // sort the cells into bins of equal width, a cell is added to every bin its range overlaps
+  const std::size_t numberOfBins =
+    std::max<std::size_t>(1, std::min(MAXIMUM_NUMBER_OF_BINS, index.Cells.size() / CELLS_PER_BIN));
+  index.Min = min;
+  index.BinWidth = (max > min) ? (max - min) / numberOfBins : 1.0;
+
+  auto binOf = [&index, numberOfBins](double distance) {
+    const double bin = std::floor((distance - index.Min) / index.BinWidth);
+    return static_cast<std::size_t>(std::min(std::max(bin, 0.0), static_cast<double>(numberOfBins - 1)));
+  };
+
+  index.BinStart.assign(numberOfBins + 1, 0);
+  for (const auto &cell : index.Cells)
+  {
+    for (std::size_t bin = binOf(cell.Min); bin <= binOf(cell.Max); ++bin)
+      ++index.BinStart[bin + 1];
+  }
+  for (std::size_t bin = 0; bin < numberOfBins; ++bin)
+    index.BinStart[bin + 1] += index.BinStart[bin];
+
+  index.BinCells.resize(index.BinStart[numberOfBins]);
+  std::vector<std::size_t> binFill(index.BinStart.begin(), index.BinStart.end() - 1);
+  for (std::size_t i = 0; i < index.Cells.size(); ++i)
+  {
+    for (std::size_t bin = binOf(index.Cells[i].Min); bin <= binOf(index.Cells[i].Max); ++bin)
+      index.BinCells[binFill[bin]++] = i;
+  }
+}
+
+vtkSmartPointer<vtkPolyData> mitk::SurfaceSliceCutter::ExtractCandidateCells(const NormalIndex &index, double offset)
+{
+  auto candidates = vtkSmartPointer<vtkPolyData>::New();
+  auto candidatePoints = vtkSmartPointer<vtkPoints>::New();
+  candidatePoints->SetDataType(m_Input->GetPoints()->GetDataType());
+  candidates->SetPoints(candidatePoints);
+
+  vtkSmartPointer<vtkCellArray> candidateCellArrays[3] = {
+    vtkSmartPointer<vtkCellArray>::New(), vtkSmartPointer<vtkCellArray>::New(), vtkSmartPointer<vtkCellArray>::New()};
+  candidates->SetLines(candidateCellArrays[0]);
+  candidates->SetPolys(candidateCellArrays[1]);
+  candidates->SetStrips(candidateCellArrays[2]);
+
+  m_NumberOfCandidateCells = 0;
+
+  const std::size_t numberOfBins = index.BinStart.size() - 1;
+  if (index.Cells.empty() || offset < index.Min || offset > index.Min + index.BinWidth * numberOfBins)
+    return candidates;
+
+  const std::size_t bin =
+    std::min(numberOfBins - 1, static_cast<std::size_t>(std::floor((offset - index.Min) / index.BinWidth)));
+
+  vtkCellArray *cellArrays[3] = {m_Input->GetLines(), m_Input->GetPolys(), m_Input->GetStrips()};
+  vtkPointData *inputPointData = m_Input->GetPointData();
+  vtkPointData *candidatePointData = candidates->GetPointData();
+  vtkCellData *inputCellData = m_Input->GetCellData();
+  vtkCellData *candidateCellData = candidates->GetCellData();
+
+  const std::size_t numberOfCandidates = index.BinStart[bin + 1] - index.BinStart[bin];
+  candidatePointData->CopyAllocate(inputPointData, 3 * numberOfCandidates);
+  candidateCellData->CopyAllocate(inputCellData, numberOfCandidates);
+
+  // the cells are inserted per cell array, the cell data has to follow the same order
+  std::vector<vtkIdType> candidateCellIds[3];
+  std::vector<const IndexedCell *> selectedCells;
+  selectedCells.reserve(numberOfCandidates);
+
+  for (std::size_t i = index.BinStart[bin]; i < index.BinStart[bin + 1]; ++i)
+  {
+    const IndexedCell &cell = index.Cells[index.BinCells[i]];
+    if (cell.Min > offset || cell.Max < offset)
+      continue;
+    selectedCells.push_back(&cell);
+  }
+  std::stable_sort(selectedCells.begin(), selectedCells.end(), [](const IndexedCell *a, const IndexedCell *b) {
+    return a->CellArray < b->CellArray;
+  });
+
+  std::vector<vtkIdType> usedPoints;
+  std::vector<vtkIdType> cellPoints;
+  for (const IndexedCell *cell : selectedCells)
+  {
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    cellArrays[cell->CellArray]->GetCell(cell->Location, npts, pts);
+
+    cellPoints.resize(npts);
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      vtkIdType &candidateId = m_PointMap[pts[i]];
+      if (candidateId < 0)
+      {
+        candidateId = candidatePoints->InsertNextPoint(m_Input->GetPoint(pts[i]));
+        candidatePointData->CopyData(inputPointData, pts[i], candidateId);
+        usedPoints.push_back(pts[i]);
+      }
+      cellPoints[i] = candidateId;
+    }
+
+    candidateCellArrays[cell->CellArray]->InsertNextCell(npts, cellPoints.data());
+    candidateCellData->CopyData(inputCellData, cell->CellId, m_NumberOfCandidateCells++);
+  }
+
+  // reset the point map for the next cut
+  for (vtkIdType pointId : usedPoints)
+    m_PointMap[pointId] = -1;
+
+  candidatePointData->Squeeze();
+  candidateCellData->Squeeze();
+  return candidates;
+}
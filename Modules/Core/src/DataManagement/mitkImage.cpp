@@ -12,6 +12,7 @@ found in the LICENSE file.
 
 // MITK
 #include "mitkImage.h"
+#include "mitkAbstractTransformGeometry.h"
 #include "mitkCompareImageDataFilter.h"
 #include "mitkImageStatisticsHolder.h"
 #include "mitkImageVtkReadAccessor.h"
@@ -26,7 +27,9 @@ found in the LICENSE file.
 #include <itkMutexLockHolder.h>
 
 // Other
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #define FILL_C_ARRAY(_arr, _size, _value)                                                                              \
   for (unsigned int i = 0u; i < _size; i++)                                                                            \
@@ -41,7 +44,9 @@ mitk::Image::Image()
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_ModifiedRegionsStartTime(0),
+    m_NumberOfPendingModifications(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -56,7 +61,9 @@ mitk::Image::Image(const Image &other)
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_ModifiedRegionsStartTime(0),
+    m_NumberOfPendingModifications(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -1333,6 +1340,173 @@ void mitk::Image::SetGeometry(BaseGeometry *aGeometry3D)
     GetTimeGeometry()->GetGeometryForTimeStep(step)->ImageGeometryOn();
 }
 
+namespace
+{
+  // number of regions remembered by ModifiedRegion(), older modifications are only known as "something changed"
+  const std::size_t MAXIMUM_NUMBER_OF_MODIFIED_REGIONS = 64;
+
+  // modified time of a recorded modification while the modified time is being updated. It is newer than any
+  // time a consumer can ask for.
+  const unsigned long PENDING_MODIFIED_TIME = std::numeric_limits<unsigned long>::max();
+}
+
+void mitk::Image::ModifiedRegion(unsigned int t, const VolumeRegionType &region)
+{
+  // The region is recorded before the modified event is sent, so that observers already see it. Image::Modified()
+  // is not called, because it forgets all regions; the superclass only updates the modified time and sends the event.
+  {
+    MutexHolder lock(m_ModifiedRegionsLock);
+
+    ModifiedRegionRecord record = {PENDING_MODIFIED_TIME, t, region};
+    m_ModifiedRegions.push_back(record);
+    ++m_NumberOfPendingModifications;
+
+    if (m_ModifiedRegions.size() > MAXIMUM_NUMBER_OF_MODIFIED_REGIONS)
+    {
+      m_ModifiedRegionsStartTime = std::max(m_ModifiedRegionsStartTime, m_ModifiedRegions.front().MTime);
+      m_ModifiedRegions.pop_front();
+    }
+  }
+
+  Superclass::Modified();
+
+  MutexHolder lock(m_ModifiedRegionsLock);
+  if (--m_NumberOfPendingModifications == 0)
+    this->ResolvePendingModifiedTimes();
+}
+
+void mitk::Image::Modified() const
+{
+  // Until the new modified time is known, no modification is described by regions.
+  {
+    MutexHolder lock(m_ModifiedRegionsLock);
+    m_ModifiedRegions.clear();
+    m_ModifiedRegionsStartTime = PENDING_MODIFIED_TIME;
+    ++m_NumberOfPendingModifications;
+  }
+
+  Superclass::Modified();
+
+  MutexHolder lock(m_ModifiedRegionsLock);
+  if (--m_NumberOfPendingModifications == 0)
+    this->ResolvePendingModifiedTimes();
+}
+
+void mitk::Image::ResolvePendingModifiedTimes() const
+{
+  // All pending modifications updated the modified time, so the current time is not older than any of them.
+  const unsigned long mtime = this->itk::Object::GetMTime();
+  for (auto &record : m_ModifiedRegions)
+  {
+    if (record.MTime == PENDING_MODIFIED_TIME)
+      record.MTime = mtime;
+  }
+  if (m_ModifiedRegionsStartTime == PENDING_MODIFIED_TIME)
+    m_ModifiedRegionsStartTime = mtime;
+}
+
+bool mitk::Image::GetModifiedRegionSince(unsigned long mtime, unsigned int t, VolumeRegionType &region) const
+{
+  region = VolumeRegionType();
+
+  // a new geometry changes the position of all voxels, see BaseData::GetMTime()
+  const TimeGeometry *timeGeometry = this->GetTimeGeometry();
+  if (timeGeometry == nullptr || timeGeometry->GetMTime() > mtime)
+    return false;
+
+  MutexHolder lock(m_ModifiedRegionsLock);
+
+  if (mtime < m_ModifiedRegionsStartTime)
+    return false;
+
+  for (const auto &record : m_ModifiedRegions)
+  {
+    if (record.MTime <= mtime || record.TimeStep != t || record.Region.GetNumberOfPixels() == 0)
+      continue;
+
+    if (region.GetNumberOfPixels() == 0)
+    {
+      region = record.Region;
+      continue;
+    }
+
+    // bounding region of both regions
+    VolumeRegionType::IndexType index;
+    VolumeRegionType::SizeType size;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const auto begin = std::min(region.GetIndex(i), record.Region.GetIndex(i));
+      const auto end = std::max(region.GetUpperIndex()[i], record.Region.GetUpperIndex()[i]);
+      index[i] = begin;
+      size[i] = static_cast<VolumeRegionType::SizeValueType>(end - begin + 1);
+    }
+    region.SetIndex(index);
+    region.SetSize(size);
+  }
+
+  return true;
+}
+
+mitk::Image::VolumeRegionType mitk::Image::GetRegionOfPlane(const PlaneGeometry *plane, unsigned int t) const
+{
+  VolumeRegionType region;
+
+  const BaseGeometry *geometry = this->GetGeometry(t);
+  if (plane == nullptr || geometry == nullptr || !this->IsInitialized())
+    return region;
+
+  // a curved plane may touch any voxel
+  if (dynamic_cast<const AbstractTransformGeometry *>(plane) != nullptr)
+  {
+    region.SetSize(0, m_Dimensions[0]);
+    region.SetSize(1, m_Dimension > 1 ? m_Dimensions[1] : 1);
+    region.SetSize(2, m_Dimension > 2 ? m_Dimensions[2] : 1);
+    return region;
+  }
+
+  // bounding box of the corners of the plane in continuous index coordinates of the image
+  const BoundingBox::BoundsArrayType planeBounds = plane->GetBounds();
+  double minIndex[3] = {0.0, 0.0, 0.0};
+  double maxIndex[3] = {0.0, 0.0, 0.0};
+
+  for (int corner = 0; corner < 4; ++corner)
+  {
+    Point3D planeIndex;
+    FillVector3D(planeIndex, planeBounds[(corner & 1) ? 1 : 0], planeBounds[(corner & 2) ? 3 : 2], 0.0);
+
+    Point3D worldPoint;
+    plane->IndexToWorld(planeIndex, worldPoint);
+
+    Point3D indexPoint;
+    geometry->WorldToIndex(worldPoint, indexPoint);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      minIndex[i] = corner == 0 ? indexPoint[i] : std::min(minIndex[i], indexPoint[i]);
+      maxIndex[i] = corner == 0 ? indexPoint[i] : std::max(maxIndex[i], indexPoint[i]);
+    }
+  }
+
+  // voxel centers are at integer indices, floor and ceil include the neighbors used for interpolation
+  VolumeRegionType::IndexType index;
+  VolumeRegionType::SizeType size;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double dimension = i < m_Dimension ? m_Dimensions[i] : 1;
+    const double begin = std::max(0.0, std::floor(minIndex[i]));
+    const double end = std::min(dimension - 1, std::ceil(maxIndex[i]));
+    if (begin > end)
+      return VolumeRegionType();
+
+    index[i] = static_cast<VolumeRegionType::IndexValueType>(begin);
+    size[i] = static_cast<VolumeRegionType::SizeValueType>(end - begin + 1);
+  }
+
+  region.SetIndex(index);
+  region.SetSize(size);
+  return region;
+}
+
 void mitk::Image::PrintSelf(std::ostream &os, itk::Indent indent) const
 {
   if (m_Initialized)
@@ -0,0 +1,299 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkPointSetSliceIndex.h"
+
+#include <mitkPlaneGeometry.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+  // number of sorted orders that are kept, e.g. one for each standard render window
+  const std::size_t MAXIMUM_NUMBER_OF_SORTED_ORDERS = 4;
+
+  // points are searched in a slightly wider slab and then checked against the plane itself,
+  // so that the result equals PlaneGeometry::Distance() regardless of rounding
+  const double SLAB_MARGIN = 1e-6;
+
+  unsigned long GetGeometryMTime(const mitk::BaseGeometry *geometry)
+  {
+    return std::max(geometry->GetMTime(), geometry->GetIndexToWorldTransform()->GetMTime());
+  }
+}
+
+mitk::PointSetSliceIndex::PointSetSliceIndex()
+  : m_PointSet(nullptr), m_TimeStep(-1), m_PointSetMTime(0), m_GeometryMTime(0), m_NumberOfUpdatedPoints(0)
+{
+}
+
+mitk::PointSetSliceIndex::~PointSetSliceIndex()
+{
+}
+
+void mitk::PointSetSliceIndex::Update(const PointSet *pointSet, int timeStep)
+{
+  m_NumberOfUpdatedPoints = 0;
+
+  if (pointSet == nullptr)
+  {
+    m_PointSet = nullptr;
+    m_PointIds.clear();
+    m_IndexPoints.clear();
+    m_WorldPoints.clear();
+    m_Selected.clear();
+    m_SortedOrders.clear();
+    return;
+  }
+
+  const BaseGeometry *geometry = pointSet->GetGeometry();
+  const unsigned long geometryMTime = GetGeometryMTime(geometry);
+  const bool sameInput = pointSet == m_PointSet && timeStep == m_TimeStep && geometryMTime == m_GeometryMTime;
+
+  if (sameInput && pointSet->GetMTime() == m_PointSetMTime)
+    return;
+
+  PointSet::DataType::Pointer itkPointSet = pointSet->GetPointSet(timeStep);
+
+  if (!sameInput || itkPointSet.IsNull() || !this->UpdateChangedPoints(itkPointSet, geometry))
+    this->Rebuild(itkPointSet, geometry);
+
+  m_PointSet = pointSet;
+  m_TimeStep = timeStep;
+  m_PointSetMTime = pointSet->GetMTime();
+  m_GeometryMTime = geometryMTime;
+}
+
+std::size_t mitk::PointSetSliceIndex::GetNumberOfPoints() const
+{
+  return m_WorldPoints.size();
+}
+
+const std::vector<mitk::Point3D> &mitk::PointSetSliceIndex::GetWorldPoints() const
+{
+  return m_WorldPoints;
+}
+
+const std::vector<mitk::PointSet::PointIdentifier> &mitk::PointSetSliceIndex::GetPointIds() const
+{
+  return m_PointIds;
+}
+
+bool mitk::PointSetSliceIndex::IsSelected(std::size_t position) const
+{
+  return m_Selected[position];
+}
+
+std::size_t mitk::PointSetSliceIndex::GetNumberOfUpdatedPoints() const
+{
+  return m_NumberOfUpdatedPoints;
+}
+
+void mitk::PointSetSliceIndex::FindPointsNearPlane(const PlaneGeometry *plane,
+                                                   double maxDistance,
+                                                   std::vector<std::size_t> &positions)
+{
+  positions.clear();
+
+  if (plane == nullptr || m_WorldPoints.empty())
+    return;
+
+  Vector3D normal = plane->GetNormal();
+  if (normal.GetNorm() == 0.0)
+    return;
+  normal.Normalize();
+
+  const SortedOrder &order = this->GetSortedOrder(normal);
+  const double offset = normal * plane->GetOrigin().GetVectorFromOrigin();
+
+  auto first = std::lower_bound(order.Distances.begin(), order.Distances.end(), offset - maxDistance - SLAB_MARGIN);
+  auto last = std::upper_bound(first, order.Distances.end(), offset + maxDistance + SLAB_MARGIN);
+
+  for (auto iter = first; iter != last; ++iter)
+  {
+    const std::size_t position = order.Positions[iter - order.Distances.begin()];
+    if (plane->Distance(m_WorldPoints[position]) < maxDistance)
+      positions.push_back(position);
+  }
+
+  std::sort(positions.begin(), positions.end());
+}
+
+void mitk::PointSetSliceIndex::Rebuild(const PointSet::DataType *itkPointSet, const BaseGeometry *geometry)
+{
+  m_PointIds.clear();
+  m_IndexPoints.clear();
+  m_WorldPoints.clear();
+  m_Selected.clear();
+  m_SortedOrders.clear();
+
+  if (itkPointSet == nullptr)
+    return;
+
+  const PointSet::PointsContainer *points = itkPointSet->GetPoints();
+  const PointSet::PointDataContainer *pointData = itkPointSet->GetPointData();
+
+  m_PointIds.reserve(points->Size());
+  m_IndexPoints.reserve(points->Size());
+  m_WorldPoints.reserve(points->Size());
+  m_Selected.reserve(points->Size());
+
+  // the point data is matched to the points by their order, like in the point set mappers
+  auto pointDataIter = pointData->Begin();
+  for (auto pointsIter = points->Begin(); pointsIter != points->End(); ++pointsIter)
+  {
+    Point3D worldPoint;
+    geometry->IndexToWorld(pointsIter->Value(), worldPoint);
+
+    m_PointIds.push_back(pointsIter->Index());
+    m_IndexPoints.push_back(pointsIter->Value());
+    m_WorldPoints.push_back(worldPoint);
+
+    if (pointDataIter != pointData->End())
+    {
+      m_Selected.push_back(pointDataIter->Value().selected);
+      ++pointDataIter;
+    }
+    else
+    {
+      m_Selected.push_back(false);
+    }
+  }
+}
+
+bool mitk::PointSetSliceIndex::UpdateChangedPoints(const PointSet::DataType *itkPointSet,
+                                                   const BaseGeometry *geometry)
+{
+  const PointSet::PointsContainer *points = itkPointSet->GetPoints();
+  const PointSet::PointDataContainer *pointData = itkPointSet->GetPointData();
+
+  if (points->Size() != m_PointIds.size())
+    return false;
+
+  std::vector<std::size_t> changedPositions;
+  std::vector<Point3D> oldWorldPoints;
+
+  std::size_t position = 0;
+  auto pointDataIter = pointData->Begin();
+  for (auto pointsIter = points->Begin(); pointsIter != points->End(); ++pointsIter, ++position)
+  {
+    // points were added and removed, the positions of the sorted orders are invalid
+    if (pointsIter->Index() != m_PointIds[position])
+      return false;
+
+    if (pointDataIter != pointData->End())
+    {
+      m_Selected[position] = pointDataIter->Value().selected;
+      ++pointDataIter;
+    }
+
+    if (pointsIter->Value() != m_IndexPoints[position])
+    {
+      changedPositions.push_back(position);
+      oldWorldPoints.push_back(m_WorldPoints[position]);
+
+      m_IndexPoints[position] = pointsIter->Value();
+      geometry->IndexToWorld(pointsIter->Value(), m_WorldPoints[position]);
+    }
+  }
+
+  m_NumberOfUpdatedPoints = changedPositions.size();
+
+  for (auto &order : m_SortedOrders)
+  {
+    // moving single entries shifts the sorted arrays, sorting again is cheaper for many changes
+    if (changedPositions.size() > 16)
+    {
+      this->SortPoints(order);
+      continue;
+    }
+
+    for (std::size_t i = 0; i < changedPositions.size(); ++i)
+      this->MovePoint(order, changedPositions[i], order.Normal * oldWorldPoints[i].GetVectorFromOrigin());
+  }
+
+  return true;
+}
+
+mitk::PointSetSliceIndex::SortedOrder &mitk::PointSetSliceIndex::GetSortedOrder(const Vector3D &normal)
+{
+  for (auto &order : m_SortedOrders)
+  {
+    if (Equal(order.Normal, normal, 1e-12))
+      return order;
+  }
+
+  if (m_SortedOrders.size() >= MAXIMUM_NUMBER_OF_SORTED_ORDERS)
+    m_SortedOrders.pop_front();
+
+  m_SortedOrders.emplace_back();
+  SortedOrder &order = m_SortedOrders.back();
+  order.Normal = normal;
+  this->SortPoints(order);
+
+  return order;
+}
+
+void mitk::PointSetSliceIndex::SortPoints(SortedOrder &order) const
+{
+  const std::size_t numberOfPoints = m_WorldPoints.size();
+
+  std::vector<double> distances(numberOfPoints);
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+    distances[i] = order.Normal * m_WorldPoints[i].GetVectorFromOrigin();
+
+  order.Positions.resize(numberOfPoints);
+  std::iota(order.Positions.begin(), order.Positions.end(), 0);
+  std::sort(order.Positions.begin(), order.Positions.end(), [&distances](std::size_t a, std::size_t b) {
+    return distances[a] < distances[b];
+  });
+
+  order.Distances.resize(numberOfPoints);
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+    order.Distances[i] = distances[order.Positions[i]];
+}
+
+void mitk::PointSetSliceIndex::MovePoint(SortedOrder &order, std::size_t position, double oldDistance) const
+{
+  auto range = std::equal_range(order.Distances.begin(), order.Distances.end(), oldDistance);
+  auto entry = range.first;
+  while (entry != range.second && order.Positions[entry - order.Distances.begin()] != position)
+    ++entry;
+
+  if (entry == range.second)
+  {
+    // should not happen, the distances are computed the same way
+    this->SortPoints(order);
+    return;
+  }
+
+  const double newDistance = order.Normal * m_WorldPoints[position].GetVectorFromOrigin();
+  std::size_t from = entry - order.Distances.begin();
+  std::size_t to = std::lower_bound(order.Distances.begin(), order.Distances.end(), newDistance) - order.Distances.begin();
+
+  // shift the entries in between by one and put the point at its new place
+  if (to > from)
+  {
+    --to;
+    std::move(order.Distances.begin() + from + 1, order.Distances.begin() + to + 1, order.Distances.begin() + from);
+    std::move(order.Positions.begin() + from + 1, order.Positions.begin() + to + 1, order.Positions.begin() + from);
+  }
+  else if (to < from)
+  {
+    std::move_backward(order.Distances.begin() + to, order.Distances.begin() + from, order.Distances.begin() + from + 1);
+    std::move_backward(order.Positions.begin() + to, order.Positions.begin() + from, order.Positions.begin() + from + 1);
+  }
+
+  order.Distances[to] = newDistance;
+  order.Positions[to] = position;
+}
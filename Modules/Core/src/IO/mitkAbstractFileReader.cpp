@@ -258,6 +258,8 @@ namespace mitk
   {
     d->m_Location = location;
     d->m_Stream = nullptr;
+    // a reused reader must not report the files of its previous input
+    m_ReadFiles.clear();
   }
 
   void AbstractFileReader::SetInput(const std::string &location, std::istream *is)
@@ -269,6 +271,7 @@ namespace mitk
     }
     d->m_Location = location;
     d->m_Stream = is;
+    m_ReadFiles.clear();
   }
 
   std::string AbstractFileReader::GetInputLocation() const { return d->m_Location; }
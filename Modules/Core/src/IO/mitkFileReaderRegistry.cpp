@@ -14,8 +14,10 @@ found in the LICENSE file.
 
 #include "mitkCoreServices.h"
 #include "mitkIMimeTypeProvider.h"
+#include "mitkLazyModuleActivation.h"
 
 // Microservices
+#include <usAny.h>
 #include <usGetModuleContext.h>
 #include <usLDAPProp.h>
 #include <usModuleContext.h>
@@ -23,6 +25,48 @@ found in the LICENSE file.
 
 #include "itksys/SystemTools.hxx"
 
+#include <mutex>
+
+namespace
+{
+  struct ReusableReader
+  {
+    ReusableReader(mitk::IFileReader *reader,
+                   const us::ServiceObjects<mitk::IFileReader> &serviceObjects,
+                   const mitk::IFileReader::Options &options)
+      : Reader(reader), ServiceObjects(serviceObjects), Options(options)
+    {
+    }
+
+    mitk::IFileReader *Reader;
+    us::ServiceObjects<mitk::IFileReader> ServiceObjects;
+    mitk::IFileReader::Options Options;
+  };
+
+  /** Readers that are kept for reuse, by the id of their service */
+  struct ReaderPool
+  {
+    ReaderPool() : Enabled(false) {}
+
+    std::mutex Mutex;
+    bool Enabled;
+    std::multimap<long, ReusableReader> Readers;
+  };
+
+  ReaderPool &GetReaderPool()
+  {
+    static ReaderPool pool;
+    return pool;
+  }
+
+  /** Returns -1 if the service is not registered (anymore) */
+  long GetServiceId(const mitk::FileReaderRegistry::ReaderReference &ref)
+  {
+    us::Any id = ref.GetProperty(us::ServiceConstants::SERVICE_ID());
+    return id.Empty() ? -1 : us::any_cast<long>(id);
+  }
+}
+
 mitk::FileReaderRegistry::FileReaderRegistry()
 {
 }
@@ -31,8 +75,77 @@ mitk::FileReaderRegistry::~FileReaderRegistry()
 {
   for (auto &elem : m_ServiceObjects)
   {
-    elem.second.UngetService(elem.first);
+    this->ReleaseReader(elem.first, elem.second);
+  }
+}
+
+void mitk::FileReaderRegistry::SetReaderReuse(bool reuse)
+{
+  std::multimap<long, ReusableReader> readers;
+  {
+    ReaderPool &pool = GetReaderPool();
+    std::lock_guard<std::mutex> lock(pool.Mutex);
+    pool.Enabled = reuse;
+    if (!reuse)
+      readers.swap(pool.Readers);
   }
+
+  for (auto &elem : readers)
+  {
+    elem.second.ServiceObjects.UngetService(elem.second.Reader);
+  }
+}
+
+bool mitk::FileReaderRegistry::GetReaderReuse()
+{
+  ReaderPool &pool = GetReaderPool();
+  std::lock_guard<std::mutex> lock(pool.Mutex);
+  return pool.Enabled;
+}
+
+mitk::IFileReader *mitk::FileReaderRegistry::CreateReader(const ReaderReference &ref, us::ModuleContext *context)
+{
+  {
+    ReaderPool &pool = GetReaderPool();
+    std::lock_guard<std::mutex> lock(pool.Mutex);
+    auto reusableReader = pool.Readers.find(GetServiceId(ref));
+    if (reusableReader != pool.Readers.end())
+    {
+      mitk::IFileReader *reader = reusableReader->second.Reader;
+      reader->SetOptions(reusableReader->second.Options);
+      m_ServiceObjects.insert(std::make_pair(reader, reusableReader->second.ServiceObjects));
+      m_InitialOptions.insert(std::make_pair(reader, reusableReader->second.Options));
+      pool.Readers.erase(reusableReader);
+      return reader;
+    }
+  }
+
+  us::ServiceObjects<mitk::IFileReader> serviceObjects = context->GetServiceObjects(ref);
+  mitk::IFileReader *reader = serviceObjects.GetService();
+  if (reader != nullptr)
+  {
+    m_ServiceObjects.insert(std::make_pair(reader, serviceObjects));
+    m_InitialOptions.insert(std::make_pair(reader, reader->GetOptions()));
+  }
+  return reader;
+}
+
+void mitk::FileReaderRegistry::ReleaseReader(mitk::IFileReader *reader,
+                                             us::ServiceObjects<mitk::IFileReader> &serviceObjects)
+{
+  {
+    ReaderPool &pool = GetReaderPool();
+    std::lock_guard<std::mutex> lock(pool.Mutex);
+    auto options = m_InitialOptions.find(reader);
+    const long id = GetServiceId(serviceObjects.GetServiceReference());
+    if (pool.Enabled && options != m_InitialOptions.end() && id != -1)
+    {
+      pool.Readers.insert(std::make_pair(id, ReusableReader(reader, serviceObjects, options->second)));
+      return;
+    }
+  }
+
+  serviceObjects.UngetService(reader);
 }
 
 mitk::MimeType mitk::FileReaderRegistry::GetMimeTypeForFile(const std::string &path, us::ModuleContext *context)
@@ -61,6 +174,9 @@ std::vector<mitk::FileReaderRegistry::ReaderReference> mitk::FileReaderRegistry:
   if (context == nullptr)
     context = us::GetModuleContext();
 
+  // Modules providing readers for this mime type may not be activated yet
+  LazyModuleActivation::ActivateModulesForMimeType(mimeType.GetName());
+
   std::string filter = us::LDAPProp(us::ServiceConstants::OBJECTCLASS()) == us_service_interface_iid<IFileReader>() &&
                        us::LDAPProp(IFileReader::PROP_MIMETYPE()) == mimeType.GetName();
   return context->GetServiceReferences<IFileReader>(filter);
@@ -72,10 +188,7 @@ mitk::IFileReader *mitk::FileReaderRegistry::GetReader(const mitk::FileReaderReg
   if (context == nullptr)
     context = us::GetModuleContext();
 
-  us::ServiceObjects<mitk::IFileReader> serviceObjects = context->GetServiceObjects(ref);
-  mitk::IFileReader *reader = serviceObjects.GetService();
-  m_ServiceObjects.insert(std::make_pair(reader, serviceObjects));
-  return reader;
+  return this->CreateReader(ref, context);
 }
 
 std::vector<mitk::IFileReader *> mitk::FileReaderRegistry::GetReaders(const MimeType &mimeType,
@@ -99,10 +212,7 @@ std::vector<mitk::IFileReader *> mitk::FileReaderRegistry::GetReaders(const Mime
        iter != end;
        ++iter)
   {
-    us::ServiceObjects<mitk::IFileReader> serviceObjects = context->GetServiceObjects(*iter);
-    mitk::IFileReader *reader = serviceObjects.GetService();
-    m_ServiceObjects.insert(std::make_pair(reader, serviceObjects));
-    result.push_back(reader);
+    result.push_back(this->CreateReader(*iter, context));
   }
 
   return result;
@@ -114,8 +224,9 @@ void mitk::FileReaderRegistry::UngetReader(mitk::IFileReader *reader)
     m_ServiceObjects.find(reader);
   if (readerIter != m_ServiceObjects.end())
   {
-    readerIter->second.UngetService(reader);
+    this->ReleaseReader(reader, readerIter->second);
     m_ServiceObjects.erase(readerIter);
+    m_InitialOptions.erase(reader);
   }
 }
 
@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include "mitkBaseData.h"
 #include "mitkCoreServices.h"
 #include "mitkIMimeTypeProvider.h"
+#include "mitkLazyModuleActivation.h"
 
 // Microservices
 #include <usGetModuleContext.h>
@@ -54,6 +55,17 @@ std::vector<mitk::FileWriterRegistry::WriterReference> mitk::FileWriterRegistry:
   if (context == nullptr)
     context = us::GetModuleContext();
 
+  // Modules providing writers may not be activated yet. Without a mime type,
+  // all of them are candidates.
+  if (mimeType.empty())
+  {
+    LazyModuleActivation::ActivateAllModules();
+  }
+  else
+  {
+    LazyModuleActivation::ActivateModulesForMimeType(mimeType);
+  }
+
   std::vector<WriterReference> result;
 
   // loop over the class hierarchy of baseData and get all writers
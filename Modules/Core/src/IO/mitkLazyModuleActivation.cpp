@@ -0,0 +1,245 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkLazyModuleActivation.h"
+
+#include <mitkCustomMimeType.h>
+#include <mitkLogMacros.h>
+
+#include <usAny.h>
+#include <usModule.h>
+#include <usModuleContext.h>
+#include <usModuleRegistry.h>
+#include <usServiceProperties.h>
+#include <usServiceRegistration.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  const std::string PROP_MIMETYPES = "mitk.io.mimetypes";
+
+  struct MimeTypeStub
+  {
+    std::unique_ptr<mitk::CustomMimeType> mimeType;
+    us::ServiceRegistration<mitk::CustomMimeType> registration;
+  };
+
+  struct PendingModule
+  {
+    std::vector<std::string> mimeTypeNames;
+    std::vector<std::unique_ptr<MimeTypeStub>> stubs;
+  };
+
+  // Pending modules are identified by their module id. The module pointers
+  // are looked up from the module registry when they are activated.
+  std::mutex s_Mutex;
+  std::map<long, PendingModule> s_PendingModules;
+
+  std::string GetStringValue(const std::map<std::string, us::Any> &map, const std::string &key)
+  {
+    auto iter = map.find(key);
+    if (iter == map.end() || iter->second.Type() != typeid(std::string))
+      return std::string();
+    return us::ref_any_cast<std::string>(iter->second);
+  }
+
+  std::vector<std::string> GetStringList(const std::map<std::string, us::Any> &map, const std::string &key)
+  {
+    std::vector<std::string> result;
+    auto iter = map.find(key);
+    if (iter == map.end())
+      return result;
+
+    if (iter->second.Type() == typeid(std::string))
+    {
+      result.push_back(us::ref_any_cast<std::string>(iter->second));
+    }
+    else if (iter->second.Type() == typeid(std::vector<us::Any>))
+    {
+      for (const auto &value : us::ref_any_cast<std::vector<us::Any>>(iter->second))
+      {
+        if (value.Type() == typeid(std::string))
+          result.push_back(us::ref_any_cast<std::string>(value));
+      }
+    }
+    return result;
+  }
+
+  void UnregisterStubs(PendingModule &pendingModule)
+  {
+    for (auto &stub : pendingModule.stubs)
+    {
+      try
+      {
+        stub->registration.Unregister();
+      }
+      catch (const std::logic_error &)
+      {
+        // the module context is already invalid
+      }
+    }
+    pendingModule.stubs.clear();
+  }
+
+  void Activate(const std::vector<long> &moduleIds)
+  {
+    for (long id : moduleIds)
+    {
+      us::Module *module = us::ModuleRegistry::GetModule(id);
+      if (module == nullptr || !module->IsLoaded())
+        continue;
+
+      MITK_DEBUG << "Activating module " << module->GetName() << " on demand";
+      module->Activate();
+    }
+  }
+
+  // Removes the given modules from the pending list. Their stubs are
+  // unregistered after the modules registered their real mime types.
+  void ActivateAndRemove(const std::vector<long> &moduleIds, std::vector<PendingModule> &removed)
+  {
+    Activate(moduleIds);
+    for (auto &pendingModule : removed)
+    {
+      UnregisterStubs(pendingModule);
+    }
+  }
+}
+
+void mitk::LazyModuleActivation::AddModule(us::Module *module)
+{
+  if (module == nullptr || !module->IsLoaded() || module->IsActivated())
+    return;
+
+  us::Any mimeTypesAny = module->GetProperty(PROP_MIMETYPES);
+  if (mimeTypesAny.Type() != typeid(std::vector<us::Any>))
+  {
+    // Without any declared mime types the module could never be activated
+    // through the file reader and writer registries.
+    module->Activate();
+    return;
+  }
+
+  PendingModule pendingModule;
+  us::ServiceProperties props;
+  props[us::ServiceConstants::SERVICE_RANKING()] = std::numeric_limits<int>::min();
+
+  for (const auto &entry : us::ref_any_cast<std::vector<us::Any>>(mimeTypesAny))
+  {
+    if (entry.Type() != typeid(std::map<std::string, us::Any>))
+      continue;
+
+    const auto &map = us::ref_any_cast<std::map<std::string, us::Any>>(entry);
+    const std::string name = GetStringValue(map, "name");
+    if (name.empty())
+      continue;
+
+    pendingModule.mimeTypeNames.push_back(name);
+
+    // Mime types without extensions are provided by other modules (e.g. MitkCore)
+    // and only need to trigger the activation.
+    const std::vector<std::string> extensions = GetStringList(map, "extensions");
+    if (extensions.empty())
+      continue;
+
+    std::unique_ptr<MimeTypeStub> stub(new MimeTypeStub);
+    stub->mimeType.reset(new CustomMimeType(name));
+    stub->mimeType->SetCategory(GetStringValue(map, "category"));
+    stub->mimeType->SetComment(GetStringValue(map, "comment"));
+    for (const auto &extension : extensions)
+    {
+      stub->mimeType->AddExtension(extension);
+    }
+    stub->registration = module->GetModuleContext()->RegisterService(stub->mimeType.get(), props);
+    pendingModule.stubs.push_back(std::move(stub));
+  }
+
+  if (pendingModule.mimeTypeNames.empty())
+  {
+    module->Activate();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  s_PendingModules[module->GetModuleId()] = std::move(pendingModule);
+}
+
+void mitk::LazyModuleActivation::RemoveModule(us::Module *module)
+{
+  if (module == nullptr)
+    return;
+
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  auto iter = s_PendingModules.find(module->GetModuleId());
+  if (iter != s_PendingModules.end())
+  {
+    UnregisterStubs(iter->second);
+    s_PendingModules.erase(iter);
+  }
+}
+
+void mitk::LazyModuleActivation::ActivateModulesForMimeType(const std::string &mimeTypeName)
+{
+  std::vector<long> moduleIds;
+  std::vector<PendingModule> removed;
+  {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (auto iter = s_PendingModules.begin(); iter != s_PendingModules.end();)
+    {
+      const auto &names = iter->second.mimeTypeNames;
+      if (std::find(names.begin(), names.end(), mimeTypeName) != names.end())
+      {
+        moduleIds.push_back(iter->first);
+        removed.push_back(std::move(iter->second));
+        iter = s_PendingModules.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
+  // The modules are activated without holding the lock, since
+  // their activators may use the file reader and writer registries.
+  ActivateAndRemove(moduleIds, removed);
+}
+
+void mitk::LazyModuleActivation::ActivateAllModules()
+{
+  std::vector<long> moduleIds;
+  std::vector<PendingModule> removed;
+  {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (auto &pendingModule : s_PendingModules)
+    {
+      moduleIds.push_back(pendingModule.first);
+      removed.push_back(std::move(pendingModule.second));
+    }
+    s_PendingModules.clear();
+  }
+
+  ActivateAndRemove(moduleIds, removed);
+}
+
+bool mitk::LazyModuleActivation::HasPendingModules()
+{
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  return !s_PendingModules.empty();
+}
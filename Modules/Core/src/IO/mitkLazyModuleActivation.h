@@ -0,0 +1,81 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKLAZYMODULEACTIVATION_H
+#define MITKLAZYMODULEACTIVATION_H
+
+#include <string>
+
+namespace us
+{
+  class Module;
+}
+
+namespace mitk
+{
+  /**
+   * @brief Registers mime-type stubs for lazily activated modules and activates
+   * these modules on demand.
+   *
+   * IO modules may declare the mime types of their readers and writers in the
+   * "mitk.io.mimetypes" property of their manifest.json file:
+   *
+   * \code
+   * {
+   *   "module.activation_policy" : "lazy",
+   *   "mitk.io.mimetypes" : [
+   *     { "name" : "application/vnd.mitk.vtu", "category" : "Vtk Unstructured Grid",
+   *       "comment" : "Vtk Unstructured Grid Files", "extensions" : [ "vtu" ] }
+   *   ]
+   * }
+   * \endcode
+   *
+   * If lazy activation is enabled (see us::ModuleSettings::SetLazyActivationEnabled),
+   * the module activator of such a module is not called on load. Instead, a low ranked
+   * CustomMimeType stub is registered for each declared mime type. The module is
+   * activated (and its stubs are removed) as soon as readers or writers for one of
+   * its mime types are requested from the FileReaderRegistry or FileWriterRegistry.
+   */
+  class LazyModuleActivation
+  {
+  public:
+    /**
+     * @brief Registers the mime-type stubs of a loaded but not yet activated module.
+     */
+    static void AddModule(us::Module *module);
+
+    /**
+     * @brief Forgets about a module without activating it, e.g. because it is unloaded.
+     */
+    static void RemoveModule(us::Module *module);
+
+    /**
+     * @brief Activates all pending modules which declared the given mime type.
+     */
+    static void ActivateModulesForMimeType(const std::string &mimeTypeName);
+
+    /**
+     * @brief Activates all pending modules.
+     */
+    static void ActivateAllModules();
+
+    /**
+     * @brief Returns true if modules are waiting to be activated.
+     */
+    static bool HasPendingModules();
+
+  private:
+    LazyModuleActivation() = delete;
+  };
+}
+
+#endif // MITKLAZYMODULEACTIVATION_H
@@ -17,25 +17,54 @@ found in the LICENSE file.
 #include <mitkDataNode.h>
 #include <mitkPlaneGeometry.h>
 #include <mitkPointSet.h>
+#include <mitkPointSetSliceIndex.h>
 #include <mitkProperties.h>
 
 // vtk includes
 #include <vtkActor.h>
+#include <vtkActor2D.h>
 #include <vtkCellArray.h>
 #include <vtkFloatArray.h>
 #include <vtkGlyph3D.h>
 #include <vtkGlyphSource2D.h>
-#include <vtkLine.h>
+#include <vtkLabeledDataMapper.h>
 #include <vtkPointData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkPropAssembly.h>
-#include <vtkTextActor.h>
+#include <vtkStringArray.h>
 #include <vtkTextProperty.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
 
 #include <cstdlib>
 
+// draws the strings of the given array at the points of the poly data, which are given in display coordinates
+static void InitializeTextActor(vtkPolyData *polyData,
+                                vtkStringArray *texts,
+                                vtkLabeledDataMapper *mapper,
+                                vtkActor2D *actor)
+{
+  polyData->SetPoints(vtkSmartPointer<vtkPoints>::New());
+  texts->SetName("texts");
+  polyData->GetPointData()->AddArray(texts);
+
+  mapper->SetInputData(polyData);
+  mapper->SetLabelModeToLabelFieldData();
+  mapper->SetFieldDataName("texts");
+  mapper->SetCoordinateSystem(vtkLabeledDataMapper::DISPLAY);
+
+  // same appearance as a vtkTextActor placed at the display position
+  vtkTextProperty *textProperty = mapper->GetLabelTextProperty();
+  textProperty->BoldOff();
+  textProperty->ItalicOff();
+  textProperty->ShadowOff();
+  textProperty->SetJustificationToLeft();
+  textProperty->SetVerticalJustificationToBottom();
+  textProperty->SetOpacity(1.0);
+
+  actor->SetMapper(mapper);
+}
+
 // constructor LocalStorage
 mitk::PointSetVtkMapper2D::LocalStorage::LocalStorage()
 {
@@ -72,6 +101,21 @@ mitk::PointSetVtkMapper2D::LocalStorage::LocalStorage()
   m_SelectedActor = vtkSmartPointer<vtkActor>::New();
   m_ContourActor = vtkSmartPointer<vtkActor>::New();
 
+  // texts
+  m_VtkTextLabelPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_TextLabels = vtkSmartPointer<vtkStringArray>::New();
+  m_VtkTextLabelMapper = vtkSmartPointer<vtkLabeledDataMapper>::New();
+  m_VtkTextLabelActor = vtkSmartPointer<vtkActor2D>::New();
+  InitializeTextActor(m_VtkTextLabelPolyData, m_TextLabels, m_VtkTextLabelMapper, m_VtkTextLabelActor);
+
+  m_VtkTextMeasurementPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_TextMeasurements = vtkSmartPointer<vtkStringArray>::New();
+  m_VtkTextMeasurementMapper = vtkSmartPointer<vtkLabeledDataMapper>::New();
+  m_VtkTextMeasurementActor = vtkSmartPointer<vtkActor2D>::New();
+  InitializeTextActor(
+    m_VtkTextMeasurementPolyData, m_TextMeasurements, m_VtkTextMeasurementMapper, m_VtkTextMeasurementActor);
+  m_VtkTextMeasurementMapper->GetLabelTextProperty()->SetColor(0.0, 1.0, 0.0);
+
   // mappers
   m_VtkUnselectedPolyDataMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
   m_VtkSelectedPolyDataMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -105,7 +149,8 @@ mitk::PointSetVtkMapper2D::PointSetVtkMapper2D()
     m_Point2DSize(6),
     m_IDShapeProperty(mitk::PointSetShapeProperty::CROSS),
     m_FillShape(false),
-    m_DistanceToPlane(4.0f)
+    m_DistanceToPlane(4.0f),
+    m_SliceIndex(new PointSetSliceIndex)
 {
 }
 
@@ -156,30 +201,6 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 {
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
 
-  unsigned i = 0;
-
-  // The vtk text actors need to be removed manually from the propassembly
-  // since the same vtk text actors are not overwriten within this function,
-  // but new actors are added to the propassembly each time this function is executed.
-  // Thus, the actors from the last call must be removed in the beginning.
-  for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
-  {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextLabelActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextLabelActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextDistanceActors.size(); i++)
-  {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextDistanceActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextDistanceActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextAngleActors.size(); i++)
-  {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextAngleActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextAngleActors.at(i));
-  }
-
   // initialize polydata here, otherwise we have update problems when
   // executing this function again
   ls->m_VtkUnselectedPointListPolyData = vtkSmartPointer<vtkPolyData>::New();
@@ -204,14 +225,6 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
     return;
   }
 
-  // iterator for point set
-  mitk::PointSet::PointsContainer::Iterator pointsIter = itkPointSet->GetPoints()->Begin();
-
-  // PointDataContainer has additional information to each point, e.g. whether
-  // it is selected or not
-  mitk::PointSet::PointDataContainer::Iterator pointDataIter;
-  pointDataIter = itkPointSet->GetPointData()->Begin();
-
   // check if the list for the PointDataContainer is the same size as the PointsContainer.
   // If not, then the points were inserted manually and can not be visualized according to the PointData
   // (selected/unselected)
@@ -237,231 +250,169 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 
   ls->m_DistancesBetweenPoints->Reset();
 
-  ls->m_VtkTextLabelActors.clear();
-  ls->m_VtkTextDistanceActors.clear();
-  ls->m_VtkTextAngleActors.clear();
+  ls->m_VtkTextLabelPolyData->GetPoints()->Reset();
+  ls->m_TextLabels->Reset();
+  ls->m_VtkTextMeasurementPolyData->GetPoints()->Reset();
+  ls->m_TextMeasurements->Reset();
 
   ls->m_UnselectedScales->SetNumberOfComponents(3);
   ls->m_SelectedScales->SetNumberOfComponents(3);
 
-  int NumberContourPoints = 0;
-  bool pointsOnSameSideOfPlane = false;
-
   const int text2dDistance = 10;
 
-  // initialize points with a random start value
-
-  // current point in point set
-  itk::Point<ScalarType> point = pointsIter->Value();
+  const mitk::PlaneGeometry *geo2D = renderer->GetCurrentWorldPlaneGeometry();
 
-  mitk::Point3D p = point;     // currently visited point
-  mitk::Point3D lastP = point; // last visited point (predecessor in point set of "point")
-  mitk::Vector3D vec;          // p - lastP
-  mitk::Vector3D lastVec;      // lastP - point before lastP
-  vec.Fill(0.0);
-  lastVec.Fill(0.0);
+  // world coordinates of all points, in the order of the point set
+  m_SliceIndex->Update(input, timestep);
+  const std::vector<mitk::Point3D> &points = m_SliceIndex->GetWorldPoints();
 
-  mitk::Point2D pt2d;
-  pt2d[0] = point[0]; // projected_p in display coordinates
-  pt2d[1] = point[1];
-  mitk::Point2D lastPt2d = pt2d;    // last projected_p in display coordinates (predecessor in point set of "pt2d")
-  mitk::Point2D preLastPt2d = pt2d; // projected_p in display coordinates before lastPt2
+  //---- POINTS AND LABELS -----//
 
-  const mitk::PlaneGeometry *geo2D = renderer->GetCurrentWorldPlaneGeometry();
+  // draw markers on slices a certain distance away from the points
+  // location according to the tolerance threshold (m_DistanceToPlane)
+  m_SliceIndex->FindPointsNearPlane(geo2D, m_DistanceToPlane, ls->m_PointsNearPlane);
 
-  vtkLinearTransform *dataNodeTransform = input->GetGeometry()->GetVtkTransform();
+  const auto *labelProperty = dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"));
 
-  int count = 0;
-
-  for (pointsIter = itkPointSet->GetPoints()->Begin(); pointsIter != itkPointSet->GetPoints()->End(); pointsIter++)
+  for (std::size_t position : ls->m_PointsNearPlane)
   {
-    lastP = p;              // valid for number of points count > 0
-    preLastPt2d = lastPt2d; // valid only for count > 1
-    lastPt2d = pt2d;        // valid for number of points count > 0
-
-    lastVec = vec; // valid only for counter > 1
+    const mitk::Point3D &point = points[position];
 
-    // get current point in point set
-    point = pointsIter->Value();
+    // compute distance to current plane
+    float dist = geo2D->Distance(point);
 
-    // transform point
+    // is point selected or not?
+    if (m_SliceIndex->IsSelected(position))
     {
-      float vtkp[3];
-      itk2vtk(point, vtkp);
-      dataNodeTransform->TransformPoint(vtkp, vtkp);
-      vtk2itk(vtkp, point);
+      ls->m_SelectedPoints->InsertNextPoint(point[0], point[1], point[2]);
+      // point is scaled according to its distance to the plane
+      ls->m_SelectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
+    }
+    else
+    {
+      ls->m_UnselectedPoints->InsertNextPoint(point[0], point[1], point[2]);
+      // point is scaled according to its distance to the plane
+      ls->m_UnselectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
     }
 
-    p[0] = point[0];
-    p[1] = point[1];
-    p[2] = point[2];
-
-    renderer->WorldToDisplay(p, pt2d);
-
-    vec = p - lastP; // valid only for counter > 0
-
-    // compute distance to current plane
-    float dist = geo2D->Distance(point);
-
-    // draw markers on slices a certain distance away from the points
-    // location according to the tolerance threshold (m_DistanceToPlane)
-    if (dist < m_DistanceToPlane)
+    //---- LABEL -----//
+    // paint label for each point if available
+    if (labelProperty != nullptr)
     {
-      // is point selected or not?
-      if (pointDataIter->Value().selected)
-      {
-        ls->m_SelectedPoints->InsertNextPoint(point[0], point[1], point[2]);
-        // point is scaled according to its distance to the plane
-        ls->m_SelectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
-      }
-      else
+      std::string l = labelProperty->GetValue();
+      if (input->GetSize() > 1)
       {
-        ls->m_UnselectedPoints->InsertNextPoint(point[0], point[1], point[2]);
-        // point is scaled according to its distance to the plane
-        ls->m_UnselectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
+        std::stringstream ss;
+        ss << m_SliceIndex->GetPointIds()[position];
+        l.append(ss.str());
       }
 
-      //---- LABEL -----//
-      // paint label for each point if available
-      if (dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")) != nullptr)
-      {
-        const char *pointLabel =
-          dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"))->GetValue();
-        std::string l = pointLabel;
-        if (input->GetSize() > 1)
-        {
-          std::stringstream ss;
-          ss << pointsIter->Index();
-          l.append(ss.str());
-        }
-
-        ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+      mitk::Point2D pt2d;
+      renderer->WorldToDisplay(point, pt2d);
 
-        ls->m_VtkTextActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
-        ls->m_VtkTextActor->SetInput(l.c_str());
-        ls->m_VtkTextActor->GetTextProperty()->SetOpacity(100);
+      ls->m_VtkTextLabelPolyData->GetPoints()->InsertNextPoint(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance, 0.0);
+      ls->m_TextLabels->InsertNextValue(l);
+    }
+  }
 
-        float unselectedColor[4] = {1.0, 1.0, 0.0, 1.0};
+  float unselectedColor[4] = {1.0, 1.0, 0.0, 1.0};
 
-        // check if there is a color property
-        GetDataNode()->GetColor(unselectedColor);
+  // check if there is a color property
+  GetDataNode()->GetColor(unselectedColor);
 
-        ls->m_VtkTextActor->GetTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
+  ls->m_VtkTextLabelMapper->GetLabelTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
 
-        ls->m_VtkTextLabelActors.push_back(ls->m_VtkTextActor);
-      }
-    }
+  //---- CONTOUR -----//
 
-    // draw contour, distance text and angle text in render window
+  // draw contour, distance text and angle text in render window
+  if (m_ShowContour)
+  {
+    int NumberContourPoints = 0;
+    ScalarType lastDistance = points.empty() ? 0.0 : geo2D->SignedDistance(points[0]);
 
     // lines between points, which intersect the current plane, are drawn
-    if (m_ShowContour && count > 0)
+    for (std::size_t count = 1; count < points.size(); ++count)
     {
-      ScalarType distance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(point);
-      ScalarType lastDistance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(lastP);
+      const mitk::Point3D &point = points[count];
+      const mitk::Point3D &lastP = points[count - 1];
 
-      pointsOnSameSideOfPlane = (distance * lastDistance) > 0.5;
+      ScalarType distance = geo2D->SignedDistance(point);
+      bool pointsOnSameSideOfPlane = (distance * lastDistance) > 0.5;
+      lastDistance = distance;
 
       // Points must be on different side of plane in order to draw a contour.
       // If "show distant lines" is enabled this condition is disregarded.
-      if (!pointsOnSameSideOfPlane || m_ShowDistantLines)
-      {
-        vtkSmartPointer<vtkLine> line = vtkSmartPointer<vtkLine>::New();
-
-        ls->m_ContourPoints->InsertNextPoint(lastP[0], lastP[1], lastP[2]);
-        line->GetPointIds()->SetId(0, NumberContourPoints);
-        NumberContourPoints++;
+      if (pointsOnSameSideOfPlane && !m_ShowDistantLines)
+        continue;
 
-        ls->m_ContourPoints->InsertNextPoint(point[0], point[1], point[2]);
-        line->GetPointIds()->SetId(1, NumberContourPoints);
-        NumberContourPoints++;
+      ls->m_ContourPoints->InsertNextPoint(lastP[0], lastP[1], lastP[2]);
+      ls->m_ContourPoints->InsertNextPoint(point[0], point[1], point[2]);
 
-        ls->m_ContourLines->InsertNextCell(line);
+      ls->m_ContourLines->InsertNextCell(2);
+      ls->m_ContourLines->InsertCellPoint(NumberContourPoints++);
+      ls->m_ContourLines->InsertCellPoint(NumberContourPoints++);
 
-        if (m_ShowDistances) // calculate and print distance between adjacent points
-        {
-          float distancePoints = point.EuclideanDistanceTo(lastP);
+      const bool showAngle = m_ShowAngles && count > 1;
+      if (!m_ShowDistances && !showAngle)
+        continue;
 
-          std::stringstream buffer;
-          buffer << std::fixed << std::setprecision(m_DistancesDecimalDigits) << distancePoints << " mm";
+      // projected points in display coordinates
+      mitk::Point2D pt2d;
+      mitk::Point2D lastPt2d;
+      renderer->WorldToDisplay(point, pt2d);
+      renderer->WorldToDisplay(lastP, lastPt2d);
 
-          // compute desired display position of text
-          Vector2D vec2d = pt2d - lastPt2d;
-          makePerpendicularVector2D(vec2d,
-                                    vec2d); // text is rendered within text2dDistance perpendicular to current line
-          Vector2D pos2d = (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
+      if (m_ShowDistances) // calculate and print distance between adjacent points
+      {
+        float distancePoints = point.EuclideanDistanceTo(lastP);
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+        std::stringstream buffer;
+        buffer << std::fixed << std::setprecision(m_DistancesDecimalDigits) << distancePoints << " mm";
 
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
+        // compute desired display position of text
+        Vector2D vec2d = pt2d - lastPt2d;
+        makePerpendicularVector2D(vec2d,
+                                  vec2d); // text is rendered within text2dDistance perpendicular to current line
+        Vector2D pos2d = (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
 
-          ls->m_VtkTextDistanceActors.push_back(ls->m_VtkTextActor);
-        }
+        ls->m_VtkTextMeasurementPolyData->GetPoints()->InsertNextPoint(pos2d[0], pos2d[1], 0.0);
+        ls->m_TextMeasurements->InsertNextValue(buffer.str());
+      }
 
-        if (m_ShowAngles && count > 1) // calculate and print angle between connected lines
-        {
-          std::stringstream buffer;
-          buffer << angle(vec.GetVnlVector(), -lastVec.GetVnlVector()) * 180 / vnl_math::pi << "°";
+      if (showAngle) // calculate and print angle between connected lines
+      {
+        const mitk::Point3D &preLastP = points[count - 2];
+        mitk::Vector3D vec = point - lastP;        // current line
+        mitk::Vector3D lastVec = lastP - preLastP; // line before the current one
 
-          // compute desired display position of text
-          Vector2D vec2d = pt2d - lastPt2d; // first arm enclosing the angle
-          vec2d.Normalize();
-          Vector2D lastVec2d = lastPt2d - preLastPt2d; // second arm enclosing the angle
-          lastVec2d.Normalize();
-          vec2d = vec2d - lastVec2d; // vector connecting both arms
-          vec2d.Normalize();
+        std::stringstream buffer;
+        buffer << angle(vec.GetVnlVector(), -lastVec.GetVnlVector()) * 180 / vnl_math::pi << "°";
 
-          // middle between two vectors that enclose the angle
-          Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
+        mitk::Point2D preLastPt2d;
+        renderer->WorldToDisplay(preLastP, preLastPt2d);
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+        // compute desired display position of text
+        Vector2D vec2d = pt2d - lastPt2d; // first arm enclosing the angle
+        vec2d.Normalize();
+        Vector2D lastVec2d = lastPt2d - preLastPt2d; // second arm enclosing the angle
+        lastVec2d.Normalize();
+        vec2d = vec2d - lastVec2d; // vector connecting both arms
+        vec2d.Normalize();
 
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
+        // middle between two vectors that enclose the angle
+        Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
 
-          ls->m_VtkTextAngleActors.push_back(ls->m_VtkTextActor);
-        }
+        ls->m_VtkTextMeasurementPolyData->GetPoints()->InsertNextPoint(pos2d[0], pos2d[1], 0.0);
+        ls->m_TextMeasurements->InsertNextValue(buffer.str());
       }
     }
 
-    if (pointDataIter != itkPointSet->GetPointData()->End())
-    {
-      pointDataIter++;
-      count++;
-    }
-  }
-
-  // add each single text actor to the assembly
-  for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextLabelActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextDistanceActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextDistanceActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextAngleActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextAngleActors.at(i));
-  }
-
-  //---- CONTOUR -----//
-
-  // create lines between the points which intersect the plane
-  if (m_ShowContour)
-  {
     // draw line between first and last point which is rendered
     if (m_CloseContour && NumberContourPoints > 1)
     {
-      vtkSmartPointer<vtkLine> closingLine = vtkSmartPointer<vtkLine>::New();
-      closingLine->GetPointIds()->SetId(0, 0);                       // index of first point
-      closingLine->GetPointIds()->SetId(1, NumberContourPoints - 1); // index of last point
-      ls->m_ContourLines->InsertNextCell(closingLine);
+      ls->m_ContourLines->InsertNextCell(2);
+      ls->m_ContourLines->InsertCellPoint(0);                       // index of first point
+      ls->m_ContourLines->InsertCellPoint(NumberContourPoints - 1); // index of last point
     }
 
     ls->m_VtkContourPolyData->SetPoints(ls->m_ContourPoints);
@@ -474,6 +425,13 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
     ls->m_PropAssembly->AddPart(ls->m_ContourActor);
   }
 
+  // all texts are drawn by one actor each
+  ls->m_VtkTextLabelPolyData->Modified();
+  ls->m_VtkTextMeasurementPolyData->Modified();
+
+  ls->m_PropAssembly->AddPart(ls->m_VtkTextLabelActor);
+  ls->m_PropAssembly->AddPart(ls->m_VtkTextMeasurementActor);
+
   // the point set must be transformed in order to obtain the appropriate glyph orientation
   // according to the current view
   vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
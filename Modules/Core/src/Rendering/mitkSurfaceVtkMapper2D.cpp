@@ -21,6 +21,7 @@ found in the LICENSE file.
 #include <mitkLookupTableProperty.h>
 #include <mitkProperties.h>
 #include <mitkSurface.h>
+#include <mitkSurfaceSliceCutter.h>
 #include <mitkTransferFunctionProperty.h>
 #include <mitkVtkScalarModeProperty.h>
 
@@ -28,9 +29,10 @@ found in the LICENSE file.
 #include <vtkActor.h>
 #include <vtkArrowSource.h>
 #include <vtkAssembly.h>
-#include <vtkCutter.h>
 #include <vtkGlyph3D.h>
+#include <vtkLinearTransform.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
@@ -46,9 +48,8 @@ mitk::SurfaceVtkMapper2D::LocalStorage::LocalStorage()
   m_PropAssembly = vtkSmartPointer<vtkAssembly>::New();
   m_PropAssembly->AddPart(m_Actor);
   m_CuttingPlane = vtkSmartPointer<vtkPlane>::New();
-  m_Cutter = vtkSmartPointer<vtkCutter>::New();
-  m_Cutter->SetCutFunction(m_CuttingPlane);
-  m_Mapper->SetInputConnection(m_Cutter->GetOutputPort());
+  m_CutTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  m_Mapper->SetInputConnection(m_CutTransformFilter->GetOutputPort());
 
   m_NormalGlyph = vtkSmartPointer<vtkGlyph3D>::New();
 
@@ -99,7 +100,7 @@ const mitk::Surface *mitk::SurfaceVtkMapper2D::GetInput() const
 }
 
 // constructor PointSetVtkMapper2D
-mitk::SurfaceVtkMapper2D::SurfaceVtkMapper2D()
+mitk::SurfaceVtkMapper2D::SurfaceVtkMapper2D() : m_SliceCutter(new SurfaceSliceCutter)
 {
 }
 
@@ -210,20 +211,31 @@ void mitk::SurfaceVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rende
 
   localStorage->m_CuttingPlane->SetOrigin(origin);
   localStorage->m_CuttingPlane->SetNormal(normal);
-  // Transform the data according to its geometry.
-  // See UpdateVtkTransform documentation for details.
+
+  // Instead of transforming the whole surface according to its geometry, the
+  // plane is transformed into the coordinate system of the surface and only
+  // the cut is transformed. See UpdateVtkTransform documentation for details.
   vtkSmartPointer<vtkLinearTransform> vtktransform = GetDataNode()->GetVtkTransform(this->GetTimestep());
-  vtkSmartPointer<vtkTransformPolyDataFilter> filter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  filter->SetTransform(vtktransform);
-  filter->SetInputData(inputPolyData);
-  localStorage->m_Cutter->SetInputConnection(filter->GetOutputPort());
-  localStorage->m_Cutter->Update();
+  vtkSmartPointer<vtkMatrix4x4> matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  vtktransform->GetMatrix(matrix);
+
+  // a plane n * (A x + t - o) = 0 in world coordinates is (A^T n) * (x - A^-1 (o - t)) = 0 in surface coordinates
+  double localNormal[3];
+  for (int i = 0; i < 3; ++i)
+    localNormal[i] = matrix->GetElement(0, i) * normal[0] + matrix->GetElement(1, i) * normal[1] +
+                     matrix->GetElement(2, i) * normal[2];
+  double localOrigin[3];
+  vtktransform->GetLinearInverse()->TransformPoint(origin, localOrigin);
+
+  localStorage->m_CutTransformFilter->SetTransform(vtktransform);
+  localStorage->m_CutTransformFilter->SetInputData(m_SliceCutter->Cut(inputPolyData, localOrigin, localNormal));
+  localStorage->m_CutTransformFilter->Update();
 
   bool generateNormals = false;
   node->GetBoolProperty("draw normals 2D", generateNormals);
   if (generateNormals)
   {
-    localStorage->m_NormalGlyph->SetInputConnection(localStorage->m_Cutter->GetOutputPort());
+    localStorage->m_NormalGlyph->SetInputConnection(localStorage->m_CutTransformFilter->GetOutputPort());
     localStorage->m_NormalGlyph->Update();
 
     localStorage->m_NormalMapper->SetInputConnection(localStorage->m_NormalGlyph->GetOutputPort());
@@ -240,7 +252,7 @@ void mitk::SurfaceVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rende
   node->GetBoolProperty("invert normals", generateInverseNormals);
   if (generateInverseNormals)
   {
-    localStorage->m_ReverseSense->SetInputConnection(localStorage->m_Cutter->GetOutputPort());
+    localStorage->m_ReverseSense->SetInputConnection(localStorage->m_CutTransformFilter->GetOutputPort());
     localStorage->m_ReverseSense->ReverseCellsOff();
     localStorage->m_ReverseSense->ReverseNormalsOn();
 
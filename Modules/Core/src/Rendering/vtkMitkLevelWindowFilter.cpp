@@ -22,6 +22,9 @@ found in the LICENSE file.
 
 #include <vtkStreamingDemandDrivenPipeline.h>
 
+#include <algorithm>
+#include <limits>
+
 // used for acos etc.
 #include <cmath>
 
@@ -35,7 +38,7 @@ static const double PI = itk::Math::pi;
 vtkStandardNewMacro(vtkMitkLevelWindowFilter);
 
 vtkMitkLevelWindowFilter::vtkMitkLevelWindowFilter()
-  : m_LookupTable(nullptr), m_OpacityFunction(nullptr), m_MinOpacity(0.0), m_MaxOpacity(255.0)
+  : m_LookupTable(nullptr), m_OpacityFunction(nullptr), m_MinOpacity(0.0), m_MaxOpacity(255.0), m_ScalarTableType(-1)
 {
   // MITK_INFO << "mitk level/window filter uses " << GetNumberOfThreads() << " thread(s)";
 }
@@ -275,14 +278,92 @@ void vtkApplyLookupTableOnRGBA(vtkMitkLevelWindowFilter *self,
 
 // Internal method which should never be used anywhere else and should not be in th header.
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
-template <class T>
-void vtkApplyLookupTableOnScalarsFast(
-  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], T *)
+// Computes the part [begin, end) of the output row y (relative to outExt[0]) which lies
+// within the clipping bounds. The range is empty if the whole row is clipped.
+static void vtkGetUnclippedRowRange(int y, const int outExt[6], const double *clippingBounds, int &begin, int &end)
+{
+  const int width = outExt[1] - outExt[0] + 1;
+
+  if (!(y >= clippingBounds[2] && y < clippingBounds[3]))
+  {
+    begin = end = width;
+    return;
+  }
+
+  // x >= clippingBounds[0] && x < clippingBounds[1] for integer x
+  const double first = std::ceil(clippingBounds[0]) - outExt[0];
+  const double last = std::ceil(clippingBounds[1]) - outExt[0];
+
+  begin = first <= 0.0 ? 0 : (first >= width ? width : static_cast<int>(first));
+  end = last <= begin ? begin : (last >= width ? width : static_cast<int>(last));
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Iterates over the output rows and calls mapSpan(input, output, count) for the unclipped
+// part of each row. Clipped pixels are set to transparent black.
+template <class T, class TSpanFunctor>
+void vtkApplyOnUnclippedSpans(
+  vtkImageData *inData, vtkImageData *outData, int outExt[6], double *clippingBounds, TSpanFunctor mapSpan)
 {
   vtkImageIterator<T> inputIt(inData, outExt);
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
 
+  int y = outExt[2];
+
+  // Loop through ouput pixels
+  while (!outputIt.IsAtEnd())
+  {
+    auto *outputSI = reinterpret_cast<int *>(outputIt.BeginSpan());
+    auto *outputSIEnd = reinterpret_cast<int *>(outputIt.EndSpan());
+    T *inputSI = inputIt.BeginSpan();
+
+    const auto spanLength = static_cast<int>(outputSIEnd - outputSI);
+    int begin, end;
+    vtkGetUnclippedRowRange(y, outExt, clippingBounds, begin, end);
+
+    if (end > spanLength)
+      end = spanLength;
+
+    if (begin > end)
+      begin = end;
+
+    // outer clipping bounds - write transparent RGBA pixels as single ints
+    std::fill(outputSI, outputSI + begin, 0);
+
+    mapSpan(inputSI + begin, outputSI + begin, end - begin);
+
+    std::fill(outputSI + end, outputSIEnd, 0);
+
+    inputIt.NextSpan();
+    outputIt.NextSpan();
+    y++;
+  }
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Maps 8 and 16 bit integer scalars through the precomputed color table.
+template <class T>
+void vtkApplyScalarTable(
+  vtkImageData *inData, vtkImageData *outData, int outExt[6], double *clippingBounds, const int *table, T *)
+{
+  const int offset = std::numeric_limits<T>::min();
+
+  vtkApplyOnUnclippedSpans<T>(inData, outData, outExt, clippingBounds, [table, offset](const T *in, int *out, int count) {
+    for (int i = 0; i < count; ++i)
+      out[i] = table[static_cast<int>(in[i]) - offset];
+  });
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Maps scalars through a linear vtkLookupTable. The table indices are computed for
+// blocks of pixels first, which allows the compiler to vectorize the index computation.
+template <class T>
+void vtkApplyLookupTableOnScalarsFast(
+  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], double *clippingBounds, T *)
+{
   double tableRange[2];
 
   // access vtkLookupTable
@@ -299,33 +380,32 @@ void vtkApplyLookupTableOnScalarsFast(
   // due to later conversion to int for rounding
   bias += 0.5f;
 
-  // Loop through ouput pixels
-  while (!outputIt.IsAtEnd())
-  {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+  const auto maxIndexF = static_cast<float>(maxIndex);
 
-    T *inputSI = inputIt.BeginSpan();
+  vtkApplyOnUnclippedSpans<T>(inData, outData, outExt, clippingBounds, [=](const T *in, int *out, int count) {
+    const int blockSize = 256;
+    int indices[blockSize];
 
-    while (outputSI != outputSIEnd)
+    for (int blockStart = 0; blockStart < count; blockStart += blockSize)
     {
-      // map to an index
-      auto idx = static_cast<int>(*inputSI * scale + bias);
+      const int blockCount = std::min(blockSize, count - blockStart);
+      const T *blockIn = in + blockStart;
 
-      if (idx < 0)
-        idx = 0;
-      else if (idx > maxIndex)
-        idx = maxIndex;
+      // map to an index; the clamping is done in float to avoid integer overflows (NaN maps to 0)
+      for (int i = 0; i < blockCount; ++i)
+      {
+        float idx = static_cast<float>(blockIn[i]) * scale + bias;
+        idx = idx >= 0.0f ? idx : 0.0f;
+        idx = idx <= maxIndexF ? idx : maxIndexF;
+        indices[i] = static_cast<int>(idx);
+      }
 
-      *reinterpret_cast<int *>(outputSI) = realLookupTable[idx];
+      int *blockOut = out + blockStart;
 
-      inputSI++;
-      outputSI += 4;
+      for (int i = 0; i < blockCount; ++i)
+        blockOut[i] = realLookupTable[indices[i]];
     }
-
-    inputIt.NextSpan();
-    outputIt.NextSpan();
-  }
+  });
 }
 
 // Internal method which should never be used anywhere else and should not be in th header.
@@ -339,60 +419,39 @@ void vtkApplyLookupTableOnScalars(vtkMitkLevelWindowFilter *self,
                                   double *clippingBounds,
                                   T *)
 {
-  vtkImageIterator<T> inputIt(inData, outExt);
-  vtkImageIterator<unsigned char> outputIt(outData, outExt);
   vtkScalarsToColors *lookupTable = self->GetLookupTable();
 
-  int y = outExt[2];
-
-  // Loop through ouput pixels
-  while (!outputIt.IsAtEnd())
-  {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
-
-    // do we iterate over the inner vertical clipping bounds
-    if (y >= clippingBounds[2] && y < clippingBounds[3])
-    {
-      T *inputSI = inputIt.BeginSpan();
-
-      int x = outExt[0];
-
-      while (outputSI != outputSIEnd)
-      {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-          // applying lookuptable - copy the 4 (RGBA) chars as a single int
-          *reinterpret_cast<int *>(outputSI) = *reinterpret_cast<int *>(lookupTable->MapValue(grayValue));
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
-
-        inputSI++;
-        outputSI += 4;
-        x++;
-      }
-    }
-    else
+  vtkApplyOnUnclippedSpans<T>(inData, outData, outExt, clippingBounds, [lookupTable](const T *in, int *out, int count) {
+    for (int i = 0; i < count; ++i)
     {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
-      {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
-      }
+      // applying lookuptable - copy the 4 (RGBA) chars as a single int
+      out[i] = *reinterpret_cast<const int *>(lookupTable->MapValue(static_cast<double>(in[i])));
     }
+  });
+}
 
-    inputIt.NextSpan();
-    outputIt.NextSpan();
-    y++;
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Maps a single value through a vtkColorTransferFunction and an optional opacity function.
+static int vtkMapValueCTF(vtkColorTransferFunction *lookupTable, vtkPiecewiseFunction *opacityFunction, double grayValue)
+{
+  // applying directly colortransferfunction
+  // because vtkColorTransferFunction::MapValue is not threadsafe
+  double rgba[4];
+  lookupTable->GetColor(grayValue, rgba); // RGB mapping
+  rgba[3] = 1.0;
+  if (opacityFunction)
+    rgba[3] = opacityFunction->GetValue(grayValue); // Alpha mapping
+
+  int color;
+  auto *colorChars = reinterpret_cast<unsigned char *>(&color);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    colorChars[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
   }
+
+  return color;
 }
 
 // Internal method which should never be used anywhere else and should not be in th header.
@@ -406,71 +465,42 @@ void vtkApplyLookupTableOnScalarsCTF(vtkMitkLevelWindowFilter *self,
                                      double *clippingBounds,
                                      T *)
 {
-  vtkImageIterator<T> inputIt(inData, outExt);
-  vtkImageIterator<unsigned char> outputIt(outData, outExt);
   auto *lookupTable = dynamic_cast<vtkColorTransferFunction *>(self->GetLookupTable());
   vtkPiecewiseFunction *opacityFunction = self->GetOpacityPiecewiseFunction();
 
-  int y = outExt[2];
+  vtkApplyOnUnclippedSpans<T>(
+    inData, outData, outExt, clippingBounds, [lookupTable, opacityFunction](const T *in, int *out, int count) {
+      for (int i = 0; i < count; ++i)
+        out[i] = vtkMapValueCTF(lookupTable, opacityFunction, static_cast<double>(in[i]));
+    });
+}
 
-  // Loop through ouput pixels
-  while (!outputIt.IsAtEnd())
-  {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Computes the colors of all values of an 8 or 16 bit integer type.
+template <class T>
+void vtkBuildScalarTable(vtkMitkLevelWindowFilter *self, std::vector<int> &table, T *)
+{
+  const int minValue = std::numeric_limits<T>::min();
+  const int maxValue = std::numeric_limits<T>::max();
 
-    // do we iterate over the inner vertical clipping bounds
-    if (y >= clippingBounds[2] && y < clippingBounds[3])
-    {
-      T *inputSI = inputIt.BeginSpan();
+  table.resize(static_cast<std::size_t>(maxValue - minValue + 1));
 
-      int x = outExt[0];
+  auto *ctf = dynamic_cast<vtkColorTransferFunction *>(self->GetLookupTable());
 
-      while (outputSI != outputSIEnd)
-      {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-
-          // applying directly colortransferfunction
-          // because vtkColorTransferFunction::MapValue is not threadsafe
-          double rgba[4];
-          lookupTable->GetColor(grayValue, rgba); // RGB mapping
-          rgba[3] = 1.0;
-          if (opacityFunction)
-            rgba[3] = opacityFunction->GetValue(grayValue); // Alpha mapping
-
-          for (int i = 0; i < 4; ++i)
-          {
-            outputSI[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
-          }
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
+  if (ctf)
+  {
+    vtkPiecewiseFunction *opacityFunction = self->GetOpacityPiecewiseFunction();
 
-        inputSI++;
-        outputSI += 4;
-        x++;
-      }
-    }
-    else
-    {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
-      {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
-      }
-    }
+    for (int value = minValue; value <= maxValue; ++value)
+      table[value - minValue] = vtkMapValueCTF(ctf, opacityFunction, value);
+  }
+  else
+  {
+    vtkScalarsToColors *lookupTable = self->GetLookupTable();
 
-    inputIt.NextSpan();
-    outputIt.NextSpan();
-    y++;
+    for (int value = minValue; value <= maxValue; ++value)
+      table[value - minValue] = *reinterpret_cast<const int *>(lookupTable->MapValue(value));
   }
 }
 
@@ -488,6 +518,70 @@ int vtkMitkLevelWindowFilter::RequestInformation(vtkInformation *request,
   return 1;
 }
 
+int vtkMitkLevelWindowFilter::RequestData(vtkInformation *request,
+                                          vtkInformationVector **inputVector,
+                                          vtkInformationVector *outputVector)
+{
+  // Prepare the lookup table once instead of in every thread
+  vtkImageData *input = vtkImageData::GetData(inputVector[0]);
+
+  if (input != nullptr && input->GetNumberOfScalarComponents() <= 2 && this->GetLookupTable())
+  {
+    this->GetLookupTable()->Build();
+    this->UpdateScalarTable(input->GetScalarType());
+  }
+
+  return Superclass::RequestData(request, inputVector, outputVector);
+}
+
+void vtkMitkLevelWindowFilter::UpdateScalarTable(int scalarType)
+{
+  switch (scalarType)
+  {
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_UNSIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_UNSIGNED_SHORT:
+      break;
+    default:
+      // a table would be too large or would not cover all values
+      m_ScalarTable.clear();
+      m_ScalarTableType = -1;
+      return;
+  }
+
+  vtkMTimeType mTime = this->GetMTime();
+
+  if (m_OpacityFunction != nullptr && m_OpacityFunction->GetMTime() > mTime)
+    mTime = m_OpacityFunction->GetMTime();
+
+  if (m_ScalarTableType == scalarType && m_ScalarTableBuildTime.GetMTime() > mTime)
+    return;
+
+  switch (scalarType)
+  {
+    case VTK_CHAR:
+      vtkBuildScalarTable(this, m_ScalarTable, static_cast<char *>(nullptr));
+      break;
+    case VTK_SIGNED_CHAR:
+      vtkBuildScalarTable(this, m_ScalarTable, static_cast<signed char *>(nullptr));
+      break;
+    case VTK_UNSIGNED_CHAR:
+      vtkBuildScalarTable(this, m_ScalarTable, static_cast<unsigned char *>(nullptr));
+      break;
+    case VTK_SHORT:
+      vtkBuildScalarTable(this, m_ScalarTable, static_cast<short *>(nullptr));
+      break;
+    case VTK_UNSIGNED_SHORT:
+      vtkBuildScalarTable(this, m_ScalarTable, static_cast<unsigned short *>(nullptr));
+      break;
+  }
+
+  m_ScalarTableType = scalarType;
+  m_ScalarTableBuildTime.Modified();
+}
+
 // Method to run the filter in different threads.
 void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int /*id*/)
 {
@@ -502,21 +596,36 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
         return;
     }
   }
-  else
+  else if (m_ScalarTableType != -1 && m_ScalarTableType == inData->GetScalarType())
   {
-    bool dontClip = extent[2] >= m_ClippingBounds[2] && extent[3] <= m_ClippingBounds[3] &&
-                    extent[0] >= m_ClippingBounds[0] && extent[1] <= m_ClippingBounds[1];
-
-    if (this->GetLookupTable())
-      this->GetLookupTable()->Build();
+    const int *table = m_ScalarTable.data();
 
+    switch (inData->GetScalarType())
+    {
+      case VTK_CHAR:
+        vtkApplyScalarTable(inData, outData, extent, m_ClippingBounds, table, static_cast<char *>(nullptr));
+        break;
+      case VTK_SIGNED_CHAR:
+        vtkApplyScalarTable(inData, outData, extent, m_ClippingBounds, table, static_cast<signed char *>(nullptr));
+        break;
+      case VTK_UNSIGNED_CHAR:
+        vtkApplyScalarTable(inData, outData, extent, m_ClippingBounds, table, static_cast<unsigned char *>(nullptr));
+        break;
+      case VTK_SHORT:
+        vtkApplyScalarTable(inData, outData, extent, m_ClippingBounds, table, static_cast<short *>(nullptr));
+        break;
+      case VTK_UNSIGNED_SHORT:
+        vtkApplyScalarTable(inData, outData, extent, m_ClippingBounds, table, static_cast<unsigned short *>(nullptr));
+        break;
+    }
+  }
+  else
+  {
     auto *vlt = dynamic_cast<vtkLookupTable *>(this->GetLookupTable());
     auto *ctf = dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable());
 
     bool linearLookupTable = vlt && vlt->GetScale() == VTK_SCALE_LINEAR;
 
-    bool useFast = dontClip && linearLookupTable;
-
     if (ctf)
     {
       switch (inData->GetScalarType())
@@ -528,12 +637,12 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
           return;
       }
     }
-    else if (useFast)
+    else if (linearLookupTable)
     {
       switch (inData->GetScalarType())
       {
-        vtkTemplateMacro(
-          vtkApplyLookupTableOnScalarsFast(this, inData, outData, extent, static_cast<VTK_TT *>(nullptr)));
+        vtkTemplateMacro(vtkApplyLookupTableOnScalarsFast(
+          this, inData, outData, extent, m_ClippingBounds, static_cast<VTK_TT *>(nullptr)));
         default:
           vtkErrorMacro(<< "Execute: Unknown ScalarType");
           return;
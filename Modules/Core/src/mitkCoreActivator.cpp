@@ -32,6 +32,7 @@ found in the LICENSE file.
 #include <mitkSurfaceVtkLegacyIO.h>
 #include <mitkSurfaceVtkXmlIO.h>
 
+#include "mitkLazyModuleActivation.h"
 #include "mitkLegacyFileWriterService.h"
 #include <mitkFileWriter.h>
 
@@ -45,6 +46,7 @@ found in the LICENSE file.
 #include <usModuleContext.h>
 #include <usModuleEvent.h>
 #include <usModuleInitialization.h>
+#include <usModuleRegistry.h>
 #include <usModuleResource.h>
 #include <usModuleResourceStream.h>
 #include <usModuleSettings.h>
@@ -224,6 +226,16 @@ void MitkCoreActivator::Load(us::ModuleContext *context)
     */
 
   this->RegisterLegacyWriter();
+
+  // Modules with a lazy activation policy are only activated on demand
+  context->AddModuleListener(this, &MitkCoreActivator::HandleModuleEvent);
+  for (auto module : us::ModuleRegistry::GetLoadedModules())
+  {
+    if (module != context->GetModule() && !module->IsActivated())
+    {
+      mitk::LazyModuleActivation::AddModule(module);
+    }
+  }
 }
 
 void MitkCoreActivator::Unload(us::ModuleContext *)
@@ -269,6 +281,22 @@ void MitkCoreActivator::Unload(us::ModuleContext *)
   }
 }
 
+void MitkCoreActivator::HandleModuleEvent(const us::ModuleEvent moduleEvent)
+{
+  us::Module *module = moduleEvent.GetModule();
+  if (moduleEvent.GetType() == us::ModuleEvent::LOADED)
+  {
+    if (!module->IsActivated())
+    {
+      mitk::LazyModuleActivation::AddModule(module);
+    }
+  }
+  else if (moduleEvent.GetType() == us::ModuleEvent::UNLOADING)
+  {
+    mitk::LazyModuleActivation::RemoveModule(module);
+  }
+}
+
 void MitkCoreActivator::RegisterDefaultMimeTypes()
 {
   // Register some default mime-types
@@ -17,10 +17,14 @@ found in the LICENSE file.
 #include <mitkBaseData.h>
 #include <mitkCustomMimeType.h>
 #include <mitkImage.h>
+#include <mitkMimeType.h>
 
 class DummyReader : public mitk::AbstractFileReader
 {
 public:
+  /** number of readers created from the reader services */
+  static int s_NumberOfClones;
+
   DummyReader(const DummyReader &other) : mitk::AbstractFileReader(other) {}
   DummyReader(const std::string &mimeTypeName, const std::string &extension, int priority) : mitk::AbstractFileReader()
   {
@@ -30,6 +34,10 @@ public:
 
     this->SetMimeType(mimeType);
 
+    mitk::IFileReader::Options options;
+    options["isANiceGuy"] = true;
+    this->SetDefaultOptions(options);
+
     this->SetRanking(priority);
     m_ServiceReg = this->RegisterService();
   }
@@ -49,10 +57,16 @@ public:
   }
 
 private:
-  DummyReader *Clone() const override { return new DummyReader(*this); }
+  DummyReader *Clone() const override
+  {
+    ++s_NumberOfClones;
+    return new DummyReader(*this);
+  }
   us::ServiceRegistration<mitk::IFileReader> m_ServiceReg;
 }; // End of internal dummy reader
 
+int DummyReader::s_NumberOfClones = 0;
+
 class DummyReader2 : public mitk::AbstractFileReader
 {
 public:
@@ -207,6 +221,56 @@ int mitkFileReaderRegistryTest(int /*argc*/, char * /*argv*/ [])
   // of the dummy readers.
   // delete readerRegistry;
 
+  // Reuse of readers
+  {
+    DummyReader dummyReader("application/dummy", "test", 1);
+    mitk::MimeType mimeType(mitk::CustomMimeType("application/dummy"), 0, -1);
+    std::vector<mitk::FileReaderRegistry::ReaderReference> refs = mitk::FileReaderRegistry::GetReferences(mimeType);
+    MITK_TEST_CONDITION_REQUIRED(refs.size() == 1, "Testing retrieval of the dummy reader service");
+
+    MITK_TEST_CONDITION_REQUIRED(!mitk::FileReaderRegistry::GetReaderReuse(),
+                                 "Testing that readers are not reused by default");
+    DummyReader::s_NumberOfClones = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+      mitk::FileReaderRegistry readerRegistry;
+      readerRegistry.GetReader(refs.front());
+    }
+    MITK_TEST_CONDITION(DummyReader::s_NumberOfClones == 2, "Testing that each registry creates a new reader");
+
+    mitk::FileReaderRegistry::SetReaderReuse(true);
+    DummyReader::s_NumberOfClones = 0;
+    mitk::IFileReader *reader = nullptr;
+    {
+      mitk::FileReaderRegistry readerRegistry;
+      reader = readerRegistry.GetReader(refs.front());
+      reader->SetOption("isANiceGuy", false);
+    }
+    {
+      mitk::FileReaderRegistry readerRegistry;
+      mitk::IFileReader *reusedReader = readerRegistry.GetReader(refs.front());
+      MITK_TEST_CONDITION(reusedReader == reader && DummyReader::s_NumberOfClones == 1,
+                          "Testing that a released reader is reused");
+      MITK_TEST_CONDITION(us::any_cast<bool>(reusedReader->GetOption("isANiceGuy")),
+                          "Testing that the options of a reused reader are restored");
+
+      readerRegistry.UngetReader(reusedReader);
+      MITK_TEST_CONDITION(readerRegistry.GetReader(refs.front()) == reader && DummyReader::s_NumberOfClones == 1,
+                          "Testing that a reader released by UngetReader() is reused");
+      MITK_TEST_CONDITION(readerRegistry.GetReader(refs.front()) != reader && DummyReader::s_NumberOfClones == 2,
+                          "Testing that a reader in use is not handed out again");
+    }
+    mitk::FileReaderRegistry::SetReaderReuse(false);
+    MITK_TEST_CONDITION(!mitk::FileReaderRegistry::GetReaderReuse(), "Testing that the reuse of readers is disabled");
+
+    DummyReader::s_NumberOfClones = 0;
+    {
+      mitk::FileReaderRegistry readerRegistry;
+      readerRegistry.GetReader(refs.front());
+    }
+    MITK_TEST_CONDITION(DummyReader::s_NumberOfClones == 1, "Testing that the kept readers are released");
+  }
+
   // always end with this!
   MITK_TEST_END();
 }
@@ -0,0 +1,132 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImage.h>
+#include <mitkPlaneGeometry.h>
+
+/**
+ * Tests the reporting of modified regions by mitk::Image::ModifiedRegion() and
+ * mitk::Image::GetModifiedRegionSince().
+ */
+class mitkImageModifiedRegionTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageModifiedRegionTestSuite);
+  MITK_TEST(GetModifiedRegionSince_NoModification_IsEmpty);
+  MITK_TEST(GetModifiedRegionSince_TwoRegions_IsBoundingRegion);
+  MITK_TEST(GetModifiedRegionSince_Modified_IsUnknown);
+  MITK_TEST(GetModifiedRegionSince_NewGeometry_IsUnknown);
+  MITK_TEST(GetRegionOfPlane_AxialPlane_IsSlice);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+
+  static mitk::Image::VolumeRegionType CreateRegion(long x, long y, long z, unsigned long sx, unsigned long sy, unsigned long sz)
+  {
+    mitk::Image::VolumeRegionType::IndexType index = {{x, y, z}};
+    mitk::Image::VolumeRegionType::SizeType size = {{sx, sy, sz}};
+    return mitk::Image::VolumeRegionType(index, size);
+  }
+
+public:
+  void setUp() override
+  {
+    unsigned int dimensions[3] = {10, 20, 30};
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void GetModifiedRegionSince_NoModification_IsEmpty()
+  {
+    mitk::Image::VolumeRegionType region = CreateRegion(1, 1, 1, 1, 1, 1);
+    CPPUNIT_ASSERT(m_Image->GetModifiedRegionSince(m_Image->GetMTime(), 0, region));
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::SizeValueType(0), region.GetNumberOfPixels());
+  }
+
+  void GetModifiedRegionSince_TwoRegions_IsBoundingRegion()
+  {
+    const unsigned long mtime = m_Image->GetMTime();
+
+    m_Image->ModifiedRegion(0, CreateRegion(0, 0, 5, 10, 20, 1));
+    CPPUNIT_ASSERT(m_Image->GetMTime() > mtime);
+    const unsigned long mtimeAfterFirstRegion = m_Image->GetMTime();
+
+    m_Image->ModifiedRegion(0, CreateRegion(2, 3, 8, 4, 4, 2));
+
+    mitk::Image::VolumeRegionType region;
+    CPPUNIT_ASSERT(m_Image->GetModifiedRegionSince(mtime, 0, region));
+    CPPUNIT_ASSERT_EQUAL(CreateRegion(0, 0, 5, 10, 20, 5), region);
+
+    CPPUNIT_ASSERT(m_Image->GetModifiedRegionSince(mtimeAfterFirstRegion, 0, region));
+    CPPUNIT_ASSERT_EQUAL(CreateRegion(2, 3, 8, 4, 4, 2), region);
+
+    // other time steps are not modified
+    CPPUNIT_ASSERT(m_Image->GetModifiedRegionSince(mtime, 1, region));
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::SizeValueType(0), region.GetNumberOfPixels());
+  }
+
+  void GetModifiedRegionSince_Modified_IsUnknown()
+  {
+    const unsigned long mtime = m_Image->GetMTime();
+    m_Image->ModifiedRegion(0, CreateRegion(0, 0, 5, 10, 20, 1));
+    m_Image->Modified();
+
+    mitk::Image::VolumeRegionType region;
+    CPPUNIT_ASSERT(!m_Image->GetModifiedRegionSince(mtime, 0, region));
+
+    // regions after the last Modified() are known again
+    const unsigned long mtimeAfterModified = m_Image->GetMTime();
+    m_Image->ModifiedRegion(0, CreateRegion(0, 0, 7, 10, 20, 1));
+    CPPUNIT_ASSERT(m_Image->GetModifiedRegionSince(mtimeAfterModified, 0, region));
+    CPPUNIT_ASSERT_EQUAL(CreateRegion(0, 0, 7, 10, 20, 1), region);
+  }
+
+  void GetModifiedRegionSince_NewGeometry_IsUnknown()
+  {
+    const unsigned long mtime = m_Image->GetMTime();
+
+    mitk::BaseGeometry::Pointer geometry = m_Image->GetGeometry()->Clone();
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, 1.0, 2.0, 3.0);
+    geometry->SetOrigin(origin);
+    m_Image->SetGeometry(geometry);
+
+    mitk::Image::VolumeRegionType region;
+    CPPUNIT_ASSERT(!m_Image->GetModifiedRegionSince(mtime, 0, region));
+  }
+
+  void GetRegionOfPlane_AxialPlane_IsSlice()
+  {
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial, 5);
+
+    mitk::Image::VolumeRegionType region = m_Image->GetRegionOfPlane(plane);
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::IndexValueType(0), region.GetIndex(0));
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::IndexValueType(0), region.GetIndex(1));
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::SizeValueType(10), region.GetSize(0));
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::SizeValueType(20), region.GetSize(1));
+    CPPUNIT_ASSERT(region.GetIndex(2) <= 5 && region.GetUpperIndex()[2] >= 5);
+    CPPUNIT_ASSERT(region.GetSize(2) <= 2);
+
+    // a plane outside of the image does not touch any voxel
+    plane->InitializeStandardPlane(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial, 100);
+    CPPUNIT_ASSERT_EQUAL(mitk::Image::VolumeRegionType::SizeValueType(0),
+                         m_Image->GetRegionOfPlane(plane).GetNumberOfPixels());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageModifiedRegion)
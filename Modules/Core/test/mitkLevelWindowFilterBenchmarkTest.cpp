@@ -0,0 +1,100 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <vtkMitkLevelWindowFilter.h>
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkSmartPointer.h>
+
+#include <chrono>
+
+/** Measures the level window filter on 4K frames. It is not part of the regular tests,
+ * run it with the test driver of the module: MitkCoreTestDriver mitkLevelWindowFilterBenchmarkTest */
+class mitkLevelWindowFilterBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLevelWindowFilterBenchmarkTestSuite);
+  MITK_TEST(Benchmark4K);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkLookupTable> m_LookupTable;
+
+  template <class T>
+  static vtkSmartPointer<vtkImageData> CreateImage(int width, int height, int scalarType, double minValue, double maxValue)
+  {
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(width, height, 1);
+    image->AllocateScalars(scalarType, 1);
+
+    auto *pixels = static_cast<T *>(image->GetScalarPointer());
+    const long long numberOfPixels = static_cast<long long>(width) * height;
+    const double step = (maxValue - minValue) / numberOfPixels;
+
+    // a permutation of the value range, so that neighboring pixels differ
+    for (long long i = 0; i < numberOfPixels; ++i)
+      pixels[i] = static_cast<T>(minValue + ((i * 7919) % numberOfPixels) * step);
+
+    return image;
+  }
+
+public:
+  void setUp() override
+  {
+    m_LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    m_LookupTable->SetTableRange(100, 3000);
+    m_LookupTable->SetHueRange(0.0, 0.66);
+    m_LookupTable->Build();
+  }
+
+  void tearDown() override { m_LookupTable = nullptr; }
+
+  void Benchmark4K()
+  {
+    const int width = 3840;
+    const int height = 2160;
+    const int frames = 10;
+
+    auto input = CreateImage<unsigned short>(width, height, VTK_UNSIGNED_SHORT, 0, 4000);
+    auto floatInput = CreateImage<float>(width, height, VTK_FLOAT, 0, 4000);
+    double clippingBounds[4] = {100.0, width - 100.0, 0.0, static_cast<double>(height)};
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetLookupTable(m_LookupTable);
+    filter->SetClippingBounds(clippingBounds);
+
+    for (auto image : {input, floatInput})
+    {
+      filter->SetInputData(image);
+      filter->Update();
+
+      auto start = std::chrono::steady_clock::now();
+
+      for (int i = 0; i < frames; ++i)
+      {
+        filter->Modified();
+        filter->Update();
+      }
+
+      auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      MITK_INFO << "Level window filter (" << image->GetScalarTypeAsString() << ", " << width << "x" << height
+                << "): " << elapsed / frames << " ms per frame";
+    }
+
+    CPPUNIT_ASSERT(filter->GetOutput()->GetNumberOfScalarComponents() == 4);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLevelWindowFilterBenchmark)
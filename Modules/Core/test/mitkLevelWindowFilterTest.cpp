@@ -0,0 +1,201 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <vtkMitkLevelWindowFilter.h>
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkSmartPointer.h>
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+class mitkLevelWindowFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLevelWindowFilterTestSuite);
+  MITK_TEST(TestUnsignedShortWithClipping);
+  MITK_TEST(TestSignedCharWithColorTransferFunction);
+  MITK_TEST(TestFloatWithClipping);
+  MITK_TEST(TestLookupTableChange);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkLookupTable> m_LookupTable;
+
+  template <class T>
+  static vtkSmartPointer<vtkImageData> CreateImage(int width, int height, int scalarType, double minValue, double maxValue)
+  {
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(width, height, 1);
+    image->AllocateScalars(scalarType, 1);
+
+    auto *pixels = static_cast<T *>(image->GetScalarPointer());
+    const long long numberOfPixels = static_cast<long long>(width) * height;
+    const double step = (maxValue - minValue) / numberOfPixels;
+
+    // a permutation of the value range, so that neighboring pixels differ
+    for (long long i = 0; i < numberOfPixels; ++i)
+      pixels[i] = static_cast<T>(minValue + ((i * 7919) % numberOfPixels) * step);
+
+    return image;
+  }
+
+  template <class T>
+  static void CheckOutput(vtkImageData *input,
+                          vtkImageData *output,
+                          const double *clippingBounds,
+                          const std::function<int(double)> &expectedColor)
+  {
+    int dims[3];
+    input->GetDimensions(dims);
+
+    const auto *inPixels = static_cast<const T *>(input->GetScalarPointer());
+    const auto *outPixels = static_cast<const int *>(output->GetScalarPointer());
+
+    for (int y = 0; y < dims[1]; ++y)
+    {
+      for (int x = 0; x < dims[0]; ++x)
+      {
+        const int i = y * dims[0] + x;
+        const bool inside = x >= clippingBounds[0] && x < clippingBounds[1] && y >= clippingBounds[2] &&
+                            y < clippingBounds[3];
+        const int expected = inside ? expectedColor(static_cast<double>(inPixels[i])) : 0;
+
+        if (outPixels[i] != expected)
+        {
+          CPPUNIT_FAIL("Wrong color at pixel (" + std::to_string(x) + ", " + std::to_string(y) + ")");
+        }
+      }
+    }
+  }
+
+  static int MapValue(vtkScalarsToColors *lookupTable, double value)
+  {
+    int color;
+    std::memcpy(&color, lookupTable->MapValue(value), sizeof(int));
+    return color;
+  }
+
+public:
+  void setUp() override
+  {
+    m_LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    m_LookupTable->SetTableRange(100, 3000);
+    m_LookupTable->SetHueRange(0.0, 0.66);
+    m_LookupTable->Build();
+  }
+
+  void tearDown() override { m_LookupTable = nullptr; }
+
+  void TestUnsignedShortWithClipping()
+  {
+    auto input = CreateImage<unsigned short>(64, 48, VTK_UNSIGNED_SHORT, 0, 4000);
+    double clippingBounds[4] = {3.5, 60.0, 2.0, 40.2};
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(input);
+    filter->SetLookupTable(m_LookupTable);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+
+    auto lookupTable = m_LookupTable.GetPointer();
+    CheckOutput<unsigned short>(
+      input, filter->GetOutput(), clippingBounds, [lookupTable](double value) { return MapValue(lookupTable, value); });
+  }
+
+  void TestSignedCharWithColorTransferFunction()
+  {
+    auto input = CreateImage<signed char>(33, 17, VTK_SIGNED_CHAR, -128, 127);
+    double clippingBounds[4] = {-10.0, 100.0, -10.0, 100.0};
+
+    auto ctf = vtkSmartPointer<vtkColorTransferFunction>::New();
+    ctf->AddRGBPoint(-100, 0.0, 0.0, 1.0);
+    ctf->AddRGBPoint(100, 1.0, 0.0, 0.0);
+
+    auto opacity = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    opacity->AddPoint(-128, 0.0);
+    opacity->AddPoint(127, 1.0);
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(input);
+    filter->SetLookupTable(ctf);
+    filter->SetOpacityPiecewiseFunction(opacity);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+
+    CheckOutput<signed char>(input, filter->GetOutput(), clippingBounds, [&](double value) {
+      double rgba[4];
+      ctf->GetColor(value, rgba);
+      rgba[3] = opacity->GetValue(value);
+
+      int color;
+      auto *colorChars = reinterpret_cast<unsigned char *>(&color);
+      for (int i = 0; i < 4; ++i)
+        colorChars[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
+      return color;
+    });
+  }
+
+  void TestFloatWithClipping()
+  {
+    auto input = CreateImage<float>(64, 48, VTK_FLOAT, -500, 4500);
+    double clippingBounds[4] = {0.0, 30.5, 10.0, 48.0};
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(input);
+    filter->SetLookupTable(m_LookupTable);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+
+    double tableRange[2];
+    m_LookupTable->GetTableRange(tableRange);
+    const int maxIndex = m_LookupTable->GetNumberOfColors() - 1;
+    const int *table = reinterpret_cast<int *>(m_LookupTable->GetTable()->GetPointer(0));
+    const float scale = (maxIndex + 1) / (tableRange[1] - tableRange[0]);
+    float bias = -tableRange[0] * scale;
+    bias += 0.5f;
+
+    CheckOutput<float>(input, filter->GetOutput(), clippingBounds, [&](double value) {
+      const auto idx = static_cast<int>(static_cast<float>(value) * scale + bias);
+      return table[idx < 0 ? 0 : (idx > maxIndex ? maxIndex : idx)];
+    });
+  }
+
+  void TestLookupTableChange()
+  {
+    auto input = CreateImage<short>(16, 16, VTK_SHORT, -1000, 1000);
+    double clippingBounds[4] = {0.0, 16.0, 0.0, 16.0};
+
+    auto filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    filter->SetInputData(input);
+    filter->SetLookupTable(m_LookupTable);
+    filter->SetClippingBounds(clippingBounds);
+    filter->Update();
+
+    // the precomputed colors have to be updated
+    m_LookupTable->SetTableRange(-1000, 0);
+    m_LookupTable->Build();
+    filter->Update();
+
+    auto lookupTable = m_LookupTable.GetPointer();
+    CheckOutput<short>(
+      input, filter->GetOutput(), clippingBounds, [lookupTable](double value) { return MapValue(lookupTable, value); });
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLevelWindowFilter)
@@ -0,0 +1,94 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkParallelFor.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+class mitkParallelForTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkParallelForTestSuite);
+  MITK_TEST(ParallelFor_ManyIndices_EachIndexCalledOnce);
+  MITK_TEST(ParallelFor_ThreadId_SmallerThanNumberOfThreads);
+  MITK_TEST(ParallelFor_OwnThreader_EachIndexCalledOnce);
+  MITK_TEST(ParallelFor_NoIndex_NotCalled);
+  MITK_TEST(ParallelFor_FunctionThrows_ExceptionRethrown);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void ParallelFor_ManyIndices_EachIndexCalledOnce()
+  {
+    std::vector<std::atomic<int>> calls(1000);
+    for (auto &call : calls)
+      call = 0;
+
+    mitk::ParallelFor(calls.size(), 4, [&](std::size_t i) { ++calls[i]; });
+
+    for (const auto &call : calls)
+      CPPUNIT_ASSERT_EQUAL(1, call.load());
+  }
+
+  void ParallelFor_ThreadId_SmallerThanNumberOfThreads()
+  {
+    const unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads(100, 3);
+    CPPUNIT_ASSERT(numberOfThreads >= 1 && numberOfThreads <= 3);
+
+    std::atomic<bool> invalidThreadId(false);
+    mitk::ParallelFor(100, 3, [&](std::size_t, unsigned int threadId) {
+      if (threadId >= numberOfThreads)
+        invalidThreadId = true;
+    });
+
+    CPPUNIT_ASSERT(!invalidThreadId);
+    CPPUNIT_ASSERT_EQUAL(1u, mitk::GetParallelForNumberOfThreads(1, 8));
+  }
+
+  void ParallelFor_OwnThreader_EachIndexCalledOnce()
+  {
+    auto threader = itk::MultiThreader::New();
+    std::vector<std::atomic<int>> calls(50);
+    for (auto &call : calls)
+      call = 0;
+
+    // the threader can be used repeatedly
+    for (int run = 0; run < 3; ++run)
+      mitk::ParallelFor(calls.size(), 2, [&](std::size_t i) { ++calls[i]; }, threader);
+
+    for (const auto &call : calls)
+      CPPUNIT_ASSERT_EQUAL(3, call.load());
+  }
+
+  void ParallelFor_NoIndex_NotCalled()
+  {
+    bool called = false;
+    mitk::ParallelFor(0, 4, [&](std::size_t) { called = true; });
+    CPPUNIT_ASSERT(!called);
+  }
+
+  void ParallelFor_FunctionThrows_ExceptionRethrown()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::ParallelFor(100, 4, [](std::size_t i) {
+      if (i == 42)
+        throw std::runtime_error("index 42");
+    }), std::runtime_error);
+
+    CPPUNIT_ASSERT_THROW(mitk::ParallelFor(1, 1, [](std::size_t) { throw std::runtime_error("serial"); }),
+                         std::runtime_error);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkParallelFor)
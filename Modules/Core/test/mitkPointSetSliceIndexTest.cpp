@@ -0,0 +1,181 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkPlaneGeometry.h>
+#include <mitkPointSet.h>
+#include <mitkPointSetSliceIndex.h>
+
+#include <random>
+
+/**
+ * Compares the points found by PointSetSliceIndex with the points found by
+ * checking every point of the point set against the plane.
+ */
+class mitkPointSetSliceIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPointSetSliceIndexTestSuite);
+  MITK_TEST(Update_TranslatedGeometry_WorldPointsEqualPointSet);
+  MITK_TEST(FindPointsNearPlane_AxisAlignedAndObliquePlanes_EqualsBruteForce);
+  MITK_TEST(Update_MovedPoint_IsUpdatedIncrementally);
+  MITK_TEST(Update_InsertedAndRemovedPoints_RebuildsIndex);
+  MITK_TEST(Update_SelectedPoint_IsSelected);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::PointSet::Pointer m_PointSet;
+  std::vector<mitk::PlaneGeometry::Pointer> m_Planes;
+
+  static mitk::PlaneGeometry::Pointer CreatePlane(double x, double y, double z, double nx, double ny, double nz)
+  {
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, x, y, z);
+    mitk::Vector3D normal;
+    mitk::FillVector3D(normal, nx, ny, nz);
+
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializePlane(origin, normal);
+    return plane;
+  }
+
+  std::vector<std::size_t> FindPointsNearPlaneBruteForce(const mitk::PlaneGeometry *plane, double maxDistance) const
+  {
+    std::vector<std::size_t> positions;
+    std::size_t position = 0;
+    for (auto iter = m_PointSet->Begin(); iter != m_PointSet->End(); ++iter, ++position)
+    {
+      if (plane->Distance(m_PointSet->GetPoint(iter->Index())) < maxDistance)
+        positions.push_back(position);
+    }
+    return positions;
+  }
+
+  void CheckAllPlanes(mitk::PointSetSliceIndex &index)
+  {
+    std::vector<std::size_t> positions;
+    for (const auto &plane : m_Planes)
+    {
+      index.FindPointsNearPlane(plane, 4.0, positions);
+      CPPUNIT_ASSERT(positions == this->FindPointsNearPlaneBruteForce(plane, 4.0));
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_PointSet = mitk::PointSet::New();
+
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, 10.0, -20.0, 30.0);
+    m_PointSet->GetGeometry()->SetOrigin(origin);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+      mitk::Point3D point;
+      mitk::FillVector3D(point, distribution(generator), distribution(generator), distribution(generator));
+      m_PointSet->InsertPoint(2 * i, point);
+    }
+
+    m_Planes.push_back(CreatePlane(0.0, 0.0, 0.0, 0.0, 0.0, 1.0));
+    m_Planes.push_back(CreatePlane(0.0, 25.0, 0.0, 0.0, 1.0, 0.0));
+    m_Planes.push_back(CreatePlane(-60.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+    m_Planes.push_back(CreatePlane(10.0, 20.0, -5.0, 0.3, -0.5, 0.8));
+    m_Planes.push_back(CreatePlane(0.0, 0.0, 500.0, 0.0, 0.0, 1.0));
+  }
+
+  void tearDown() override
+  {
+    m_Planes.clear();
+    m_PointSet = nullptr;
+  }
+
+  void Update_TranslatedGeometry_WorldPointsEqualPointSet()
+  {
+    mitk::PointSetSliceIndex index;
+    index.Update(m_PointSet, 0);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(m_PointSet->GetSize()), index.GetNumberOfPoints());
+
+    std::size_t position = 0;
+    for (auto iter = m_PointSet->Begin(); iter != m_PointSet->End(); ++iter, ++position)
+    {
+      CPPUNIT_ASSERT_EQUAL(iter->Index(), index.GetPointIds()[position]);
+      CPPUNIT_ASSERT(mitk::Equal(m_PointSet->GetPoint(iter->Index()), index.GetWorldPoints()[position], 1e-9));
+    }
+  }
+
+  void FindPointsNearPlane_AxisAlignedAndObliquePlanes_EqualsBruteForce()
+  {
+    mitk::PointSetSliceIndex index;
+    index.Update(m_PointSet, 0);
+    this->CheckAllPlanes(index);
+
+    // the sorted orders of more normals than the index keeps are replaced
+    this->CheckAllPlanes(index);
+  }
+
+  void Update_MovedPoint_IsUpdatedIncrementally()
+  {
+    mitk::PointSetSliceIndex index;
+    index.Update(m_PointSet, 0);
+    this->CheckAllPlanes(index);
+
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 1.0, 25.5, -60.5);
+    m_PointSet->SetPoint(1000, point);
+    index.Update(m_PointSet, 0);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), index.GetNumberOfUpdatedPoints());
+    CPPUNIT_ASSERT(mitk::Equal(point, index.GetWorldPoints()[500], 1e-9));
+    this->CheckAllPlanes(index);
+
+    // unchanged point set
+    index.Update(m_PointSet, 0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), index.GetNumberOfUpdatedPoints());
+  }
+
+  void Update_InsertedAndRemovedPoints_RebuildsIndex()
+  {
+    mitk::PointSetSliceIndex index;
+    index.Update(m_PointSet, 0);
+    this->CheckAllPlanes(index);
+
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 0.5, 0.5, 0.5);
+    m_PointSet->InsertPoint(1, point);
+    m_PointSet->RemovePointIfExists(4000);
+    index.Update(m_PointSet, 0);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(m_PointSet->GetSize()), index.GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), index.GetNumberOfUpdatedPoints());
+    this->CheckAllPlanes(index);
+  }
+
+  void Update_SelectedPoint_IsSelected()
+  {
+    mitk::PointSetSliceIndex index;
+    index.Update(m_PointSet, 0);
+    CPPUNIT_ASSERT(!index.IsSelected(3));
+
+    m_PointSet->SetSelectInfo(6, true);
+    index.Update(m_PointSet, 0);
+
+    CPPUNIT_ASSERT(index.IsSelected(3));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), index.GetNumberOfUpdatedPoints());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPointSetSliceIndex)
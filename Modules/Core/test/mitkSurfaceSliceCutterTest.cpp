@@ -0,0 +1,153 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include "mitkTestFixture.h"
+#include <mitkTestingMacros.h>
+
+// MITK includes
+#include <mitkSurfaceSliceCutter.h>
+
+// VTK includes
+#include <vtkCutter.h>
+#include <vtkMath.h>
+#include <vtkPlane.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+class mitkSurfaceSliceCutterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSurfaceSliceCutterTestSuite);
+  MITK_TEST(Cut_AxisAlignedAndObliquePlanes_EqualsVtkCutter);
+  MITK_TEST(Cut_PlaneOutsideOfSurface_IsEmpty);
+  MITK_TEST(Cut_SamePlaneAgain_ReturnsCachedCut);
+  MITK_TEST(Cut_ModifiedSurface_IsUpdated);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkPolyData> m_Sphere;
+
+  static vtkSmartPointer<vtkPolyData> CutWithVtkCutter(vtkPolyData *input, const double origin[3], const double normal[3])
+  {
+    auto plane = vtkSmartPointer<vtkPlane>::New();
+    plane->SetOrigin(const_cast<double *>(origin));
+    plane->SetNormal(const_cast<double *>(normal));
+    auto cutter = vtkSmartPointer<vtkCutter>::New();
+    cutter->SetCutFunction(plane);
+    cutter->SetInputData(input);
+    cutter->Update();
+    return cutter->GetOutput();
+  }
+
+  static double GetContourLength(vtkPolyData *contour)
+  {
+    double length = 0.0;
+    for (vtkIdType i = 0; i < contour->GetNumberOfCells(); ++i)
+    {
+      vtkIdType npts = 0;
+      vtkIdType *pts = nullptr;
+      contour->GetCellPoints(i, npts, pts);
+      for (vtkIdType j = 1; j < npts; ++j)
+        length += std::sqrt(vtkMath::Distance2BetweenPoints(contour->GetPoint(pts[j - 1]), contour->GetPoint(pts[j])));
+    }
+    return length;
+  }
+
+public:
+  void setUp() override
+  {
+    auto sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(50.0);
+    sphereSource->SetThetaResolution(200);
+    sphereSource->SetPhiResolution(200);
+    sphereSource->Update();
+    m_Sphere = sphereSource->GetOutput();
+  }
+
+  void tearDown() override { m_Sphere = nullptr; }
+
+  void Cut_AxisAlignedAndObliquePlanes_EqualsVtkCutter()
+  {
+    mitk::SurfaceSliceCutter cutter;
+    const double normals[4][3] = {{0, 0, 1}, {0, 1, 0}, {1, 0, 0}, {0.3, -0.5, 0.8}};
+
+    for (const auto &normal : normals)
+    {
+      for (double offset = -45.0; offset <= 45.0; offset += 7.5)
+      {
+        double unitNormal[3] = {normal[0], normal[1], normal[2]};
+        vtkMath::Normalize(unitNormal);
+        double origin[3] = {offset * unitNormal[0], offset * unitNormal[1], offset * unitNormal[2]};
+
+        vtkSmartPointer<vtkPolyData> expected = CutWithVtkCutter(m_Sphere, origin, normal);
+        vtkSmartPointer<vtkPolyData> result = cutter.Cut(m_Sphere, origin, normal);
+
+        CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfPoints(), result->GetNumberOfPoints());
+        CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfLines(), result->GetNumberOfLines());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(GetContourLength(expected), GetContourLength(result), 1e-6);
+        CPPUNIT_ASSERT_MESSAGE("Cutter should only touch a small part of the surface",
+                               cutter.GetNumberOfCandidateCells() < m_Sphere->GetNumberOfCells() / 10);
+      }
+    }
+  }
+
+  void Cut_PlaneOutsideOfSurface_IsEmpty()
+  {
+    mitk::SurfaceSliceCutter cutter;
+    const double origin[3] = {0, 0, 100};
+    const double normal[3] = {0, 0, 1};
+    CPPUNIT_ASSERT_EQUAL(vtkIdType(0), cutter.Cut(m_Sphere, origin, normal)->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(vtkIdType(0), cutter.GetNumberOfCandidateCells());
+  }
+
+  void Cut_SamePlaneAgain_ReturnsCachedCut()
+  {
+    mitk::SurfaceSliceCutter cutter;
+    const double origin[3] = {0, 0, 10};
+    const double nextOrigin[3] = {0, 0, 11};
+    const double normal[3] = {0, 0, 1};
+
+    vtkSmartPointer<vtkPolyData> first = cutter.Cut(m_Sphere, origin, normal);
+    vtkSmartPointer<vtkPolyData> next = cutter.Cut(m_Sphere, nextOrigin, normal);
+    CPPUNIT_ASSERT(first != next);
+    CPPUNIT_ASSERT(first == cutter.Cut(m_Sphere, origin, normal));
+
+    cutter.SetMaximumNumberOfCachedCuts(0);
+    CPPUNIT_ASSERT(first != cutter.Cut(m_Sphere, origin, normal));
+  }
+
+  void Cut_ModifiedSurface_IsUpdated()
+  {
+    mitk::SurfaceSliceCutter cutter;
+    const double origin[3] = {0, 0, 10};
+    const double normal[3] = {0, 0, 1};
+    double lengthBefore = GetContourLength(cutter.Cut(m_Sphere, origin, normal));
+
+    // move the sphere along the normal
+    vtkPoints *points = m_Sphere->GetPoints();
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+      double point[3];
+      points->GetPoint(i, point);
+      point[2] += 10.0;
+      points->SetPoint(i, point);
+    }
+    points->Modified();
+
+    double lengthAfter = GetContourLength(cutter.Cut(m_Sphere, origin, normal));
+    double expectedLength = GetContourLength(CutWithVtkCutter(m_Sphere, origin, normal));
+    CPPUNIT_ASSERT(std::abs(lengthAfter - lengthBefore) > 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLength, lengthAfter, 1e-6);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSurfaceSliceCutter)
@@ -0,0 +1,29 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCommandLineBatchHost.h"
+
+// Entry functions of the apps of this directory. They are compiled into the batch host with
+// MITK_COMMANDLINE_BATCH_HOST defined, which removes their main functions.
+int FileConverterMain(int argc, char* argv[]);
+int ImageTypeConverterMain(int argc, char* argv[]);
+int RectifyImageMain(int argc, char* argv[]);
+
+int main(int argc, char* argv[])
+{
+  mitk::CommandLineBatchHost host;
+  host.RegisterApp("FileConverter", &FileConverterMain);
+  host.RegisterApp("ImageTypeConverter", &ImageTypeConverterMain);
+  host.RegisterApp("RectifyImage", &RectifyImageMain);
+
+  return host.Execute(argc, argv, "Core Command Line Apps Batch Host");
+}
@@ -20,7 +20,7 @@ found in the LICENSE file.
 #include "mitkPreferenceListReaderOptionsFunctor.h"
 
 
-int main(int argc, char* argv[])
+int FileConverterMain(int argc, char* argv[])
 {
   mitkCommandLineParser parser;
 
@@ -110,3 +110,10 @@ int main(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return FileConverterMain(argc, argv);
+}
+#endif
@@ -39,7 +39,7 @@ found in the LICENSE file.
   }
 
 
-int main(int argc, char* argv[])
+int ImageTypeConverterMain(int argc, char* argv[])
 {
   mitkCommandLineParser parser;
 
@@ -121,3 +121,10 @@ int main(int argc, char* argv[])
   }
   return EXIT_SUCCESS;
 }
+
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return ImageTypeConverterMain(argc, argv);
+}
+#endif
@@ -46,7 +46,7 @@ void RectifyImage(mitk::Image::Pointer inputImage, mitk::Image::Pointer outputIm
   }
 }
 
-int main(int argc, char* argv[])
+int RectifyImageMain(int argc, char* argv[])
 {
   mitkCommandLineParser parser;
 
@@ -192,3 +192,10 @@ int main(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return RectifyImageMain(argc, argv);
+}
+#endif
@@ -152,6 +152,49 @@ public:
    */
   static const std::string& PROP_AUTOLOADED_MODULES();
 
+  /**
+   * Returns the property key with a value of \c module.activation_policy for
+   * looking up this module's activation policy.
+   * The property value is of type \c std::string. If it is \c "lazy" and
+   * lazy activation is enabled, the module activator is not called when the
+   * module is loaded but only when Activate() is called.
+   *
+   * @return The activation policy property key.
+   *
+   * @sa ModuleSettings::IsLazyActivationEnabled()
+   */
+  static const std::string& PROP_ACTIVATION_POLICY();
+
+  /**
+   * Returns the property key with a value of \c module.startup.init_time for
+   * looking up the time it took to set up this module's resources and
+   * to parse its manifest.
+   * The property value is of type \c long \c long and given in microseconds.
+   *
+   * @return The initialization time property key.
+   */
+  static const std::string& PROP_STARTUP_INIT_TIME();
+
+  /**
+   * Returns the property key with a value of \c module.startup.activator_time for
+   * looking up the time spent in this module's activator Load() method.
+   * The property value is of type \c long \c long and given in microseconds.
+   * It is only available after the module was activated.
+   *
+   * @return The activator time property key.
+   */
+  static const std::string& PROP_STARTUP_ACTIVATOR_TIME();
+
+  /**
+   * Returns the property key with a value of \c module.startup.autoload_time for
+   * looking up the time spent auto-loading the modules triggered by this module.
+   * The property value is of type \c long \c long and given in microseconds.
+   * It includes the load and activation times of the auto-loaded modules.
+   *
+   * @return The auto-load time property key.
+   */
+  static const std::string& PROP_STARTUP_AUTOLOAD_TIME();
+
   ~Module();
 
   /**
@@ -165,6 +208,28 @@ public:
    */
   bool IsLoaded() const;
 
+  /**
+   * Returns whether the activator of this module has been called.
+   *
+   * A loaded module is always activated, unless it declares a lazy
+   * activation policy and lazy activation is enabled.
+   *
+   * @return <code>true</code> if the module is <code>LOADED</code> and activated,
+   *         <code>false</code> otherwise.
+   *
+   * @sa PROP_ACTIVATION_POLICY()
+   */
+  bool IsActivated() const;
+
+  /**
+   * Calls the activator of a lazily loaded module and auto-loads its
+   * dependent modules. Calling this method for a module which is
+   * already activated has no effect.
+   *
+   * @throws std::logic_error if the module is not loaded.
+   */
+  void Activate();
+
   /**
    * Returns this module's {@link ModuleContext}. The returned
    * <code>ModuleContext</code> can be used by the caller to act on behalf
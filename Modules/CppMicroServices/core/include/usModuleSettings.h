@@ -41,6 +41,7 @@ US_BEGIN_NAMESPACE
  * - \e US_DISABLE_AUTOLOADING If set, auto-loading of modules is disabled.
  * - \e US_AUTOLOAD_PATHS A ':' (Unix) or ';' (Windows) separated list of paths
  *   from which modules should be auto-loaded.
+ * - \e US_ENABLE_LAZY_ACTIVATION If set, lazy activation of modules is enabled.
  *
  * \remarks This class is thread safe.
  */
@@ -118,6 +119,26 @@ public:
    */
   static void AddAutoLoadPath(const std::string& path);
 
+  /**
+   * \return \c true if modules declaring a lazy activation policy are
+   * loaded without calling their activator, \c false otherwise.
+   *
+   * \remarks Lazy activation is disabled by default, unless the
+   * US_ENABLE_LAZY_ACTIVATION environment variable is defined.
+   *
+   * \sa Module::PROP_ACTIVATION_POLICY()
+   */
+  static bool IsLazyActivationEnabled();
+
+  /**
+   * Enable or disable lazy activation of modules.
+   *
+   * \param enable If \c true, enable lazy activation, disable it otherwise.
+   *
+   * \remarks Only modules loaded after this call are affected.
+   */
+  static void SetLazyActivationEnabled(bool enable);
+
   /**
    * Set a local storage path for persistend module data.
    *
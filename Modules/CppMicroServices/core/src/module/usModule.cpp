@@ -31,6 +31,9 @@
 
 #include "usCoreConfig.h"
 
+#include <chrono>
+#include <stdexcept>
+
 US_BEGIN_NAMESPACE
 
 const std::string& Module::PROP_ID()
@@ -78,6 +81,30 @@ const std::string&Module::PROP_AUTOLOADED_MODULES()
   return s;
 }
 
+const std::string& Module::PROP_ACTIVATION_POLICY()
+{
+  static const std::string s("module.activation_policy");
+  return s;
+}
+
+const std::string& Module::PROP_STARTUP_INIT_TIME()
+{
+  static const std::string s("module.startup.init_time");
+  return s;
+}
+
+const std::string& Module::PROP_STARTUP_ACTIVATOR_TIME()
+{
+  static const std::string s("module.startup.activator_time");
+  return s;
+}
+
+const std::string& Module::PROP_STARTUP_AUTOLOAD_TIME()
+{
+  static const std::string s("module.startup.autoload_time");
+  return s;
+}
+
 Module::Module()
 : d(nullptr)
 {
@@ -92,7 +119,10 @@ Module::~Module()
 void Module::Init(CoreModuleContext* coreCtx,
                   ModuleInfo* info)
 {
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
   ModulePrivate* mp = new ModulePrivate(this, coreCtx, info);
+  mp->moduleManifest.SetValue(PROP_STARTUP_INIT_TIME(), Any(static_cast<long long>(
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count())));
   std::swap(mp, d);
   delete mp;
 }
@@ -108,6 +138,7 @@ void Module::Uninit()
     d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::UNLOADED, this));
 
     d->moduleActivator = nullptr;
+    d->activated = false;
   }
 }
 
@@ -137,6 +168,10 @@ void Module::Start()
   d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::LOADING, this));
   // try to get a ModuleActivator instance
 
+  // The activator instance is always created here, even if the activation
+  // is deferred. It is a function-local static in the module library and
+  // must be constructed while the library initializer is still running,
+  // otherwise it would be destroyed before the module is stopped.
   if (activatorHook)
   {
     try
@@ -148,28 +183,70 @@ void Module::Start()
       US_ERROR << "Creating the module activator of " << d->info.name << " failed";
       throw;
     }
-
-    // This method should be "noexcept" and by not catching exceptions
-    // here we semantically treat it that way since any exception during
-    // static initialization will either terminate the program or cause
-    // the dynamic loader to report an error.
-    d->moduleActivator->Load(d->moduleContext);
   }
 
-#ifdef US_ENABLE_AUTOLOADING_SUPPORT
-  if (ModuleSettings::IsAutoLoadingEnabled())
+  if (d->IsLazyActivation())
   {
-    const std::vector<std::string> loadedPaths = AutoLoadModules(d->info);
-    if (!loadedPaths.empty())
-    {
-      d->moduleManifest.SetValue(PROP_AUTOLOADED_MODULES(), Any(loadedPaths));
-    }
+    US_DEBUG << "Deferring activation of module " << d->info.name;
+  }
+  else
+  {
+    d->Activate();
   }
-#endif
 
   d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::LOADED, this));
 }
 
+void Module::Activate()
+{
+  if (d->moduleContext == nullptr)
+  {
+    throw std::logic_error("Module " + d->info.name + " is not loaded.");
+  }
+
+  std::unique_lock<std::mutex> lock(d->activationMutex);
+
+  // The activator of this module may activate it again, e.g. through a
+  // service lookup. Waiting for the running activation would deadlock.
+  if (d->activatingThread == std::this_thread::get_id())
+  {
+    return;
+  }
+
+  d->activationFinished.wait(lock, [this] { return d->activatingThread == std::thread::id(); });
+  if (d->activated)
+  {
+    return;
+  }
+
+  // The activator is called without holding the lock
+  d->activatingThread = std::this_thread::get_id();
+  lock.unlock();
+
+  try
+  {
+    d->Activate();
+  }
+  catch (...)
+  {
+    lock.lock();
+    d->activatingThread = std::thread::id();
+    lock.unlock();
+    d->activationFinished.notify_all();
+    throw;
+  }
+
+  lock.lock();
+  d->activatingThread = std::thread::id();
+  lock.unlock();
+  d->activationFinished.notify_all();
+}
+
+bool Module::IsActivated() const
+{
+  return d->moduleContext != nullptr && d->activated;
+}
+
 void Module::Stop()
 {
   if (d->moduleContext == nullptr)
@@ -182,7 +259,7 @@ void Module::Stop()
   {
     d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::UNLOADING, this));
 
-    if (d->moduleActivator)
+    if (d->moduleActivator && d->activated)
     {
       d->moduleActivator->Unload(d->moduleContext);
     }
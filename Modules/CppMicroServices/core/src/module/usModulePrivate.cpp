@@ -25,6 +25,7 @@
 #include "usModuleContext.h"
 #include "usModuleActivator.h"
 #include "usModuleUtils_p.h"
+#include "usUtils_p.h"
 #include "usModuleSettings.h"
 #include "usModuleResource.h"
 #include "usModuleResourceStream.h"
@@ -33,6 +34,7 @@
 #include "usServiceReferenceBasePrivate.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <cassert>
 #include <cstring>
@@ -48,6 +50,7 @@ ModulePrivate::ModulePrivate(Module* qq, CoreModuleContext* coreCtx,
   , resourceContainer(info)
   , moduleContext(nullptr)
   , moduleActivator(nullptr)
+  , activated(false)
   , q(qq)
 {
   // Check if the module provides a manifest.json file and if yes, parse it.
@@ -115,6 +118,45 @@ ModulePrivate::~ModulePrivate()
   delete moduleContext;
 }
 
+bool ModulePrivate::IsLazyActivation() const
+{
+  return ModuleSettings::IsLazyActivationEnabled() &&
+      moduleManifest.GetValue(Module::PROP_ACTIVATION_POLICY()).ToString() == "lazy";
+}
+
+void ModulePrivate::Activate()
+{
+  typedef std::chrono::steady_clock Clock;
+
+  activated = true;
+
+  if (moduleActivator)
+  {
+    // This method should be "noexcept" and by not catching exceptions
+    // here we semantically treat it that way since any exception during
+    // static initialization will either terminate the program or cause
+    // the dynamic loader to report an error.
+    const Clock::time_point start = Clock::now();
+    moduleActivator->Load(moduleContext);
+    moduleManifest.SetValue(Module::PROP_STARTUP_ACTIVATOR_TIME(), Any(static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count())));
+  }
+
+#ifdef US_ENABLE_AUTOLOADING_SUPPORT
+  if (ModuleSettings::IsAutoLoadingEnabled())
+  {
+    const Clock::time_point start = Clock::now();
+    const std::vector<std::string> loadedPaths = AutoLoadModules(info);
+    moduleManifest.SetValue(Module::PROP_STARTUP_AUTOLOAD_TIME(), Any(static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count())));
+    if (!loadedPaths.empty())
+    {
+      moduleManifest.SetValue(Module::PROP_AUTOLOADED_MODULES(), Any(loadedPaths));
+    }
+  }
+#endif
+}
+
 void ModulePrivate::RemoveModuleResources()
 {
   coreCtx->listeners.RemoveAllListeners(moduleContext);
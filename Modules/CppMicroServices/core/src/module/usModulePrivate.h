@@ -24,6 +24,10 @@
 
 #include <map>
 #include <list>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "usModuleRegistry.h"
 #include "usModuleVersion.h"
@@ -55,6 +59,18 @@ public:
 
   void RemoveModuleResources();
 
+  /**
+   * Returns true if the module declares a lazy activation
+   * policy and lazy activation is enabled.
+   */
+  bool IsLazyActivation() const;
+
+  /**
+   * Calls the module activator and auto-loads dependent modules,
+   * recording the time spent in both as module properties.
+   */
+  void Activate();
+
   CoreModuleContext* const coreCtx;
 
   /**
@@ -73,6 +89,19 @@ public:
 
   ModuleActivator* moduleActivator;
 
+  /**
+   * True if the module activator has been called
+   */
+  std::atomic<bool> activated;
+
+  /**
+   * Guards activatingThread, which is the thread currently running
+   * Activate() or a default constructed id
+   */
+  std::mutex activationMutex;
+  std::condition_variable activationFinished;
+  std::thread::id activatingThread;
+
   ModuleManifest moduleManifest;
 
   std::string baseStoragePath;
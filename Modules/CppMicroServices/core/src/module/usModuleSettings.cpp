@@ -67,6 +67,7 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
     , autoLoadingEnabled(false)
   #endif
     , autoLoadingDisabled(false)
+    , lazyActivationEnabled(false)
     , logLevel(DebugMsg)
   {
     autoLoadPaths.insert(ModuleSettings::CURRENT_MODULE_PATH());
@@ -95,12 +96,18 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
     {
       autoLoadingDisabled = true;
     }
+
+    if (getenv("US_ENABLE_LAZY_ACTIVATION"))
+    {
+      lazyActivationEnabled = true;
+    }
   }
 
   std::set<std::string> autoLoadPaths;
   std::set<std::string> extraPaths;
   bool autoLoadingEnabled;
   bool autoLoadingDisabled;
+  bool lazyActivationEnabled;
   std::string storagePath;
   MsgType logLevel;
 };
@@ -162,6 +169,18 @@ void ModuleSettings::AddAutoLoadPath(const std::string& path)
   moduleSettingsPrivate()->autoLoadPaths.insert(RemoveTrailingPathSeparator(path));
 }
 
+bool ModuleSettings::IsLazyActivationEnabled()
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  return moduleSettingsPrivate()->lazyActivationEnabled;
+}
+
+void ModuleSettings::SetLazyActivationEnabled(bool enable)
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  moduleSettingsPrivate()->lazyActivationEnabled = enable;
+}
+
 void ModuleSettings::SetStoragePath(const std::string &path)
 {
   US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
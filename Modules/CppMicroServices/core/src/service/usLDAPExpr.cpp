@@ -252,6 +252,29 @@ std::string LDAPExpr::ToLower(const std::string& str)
   return lowerStr;
 }
 
+bool LDAPExpr::GetRequiredEqualities(AttributeValueList& eqs) const
+{
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find(LDAPExprConstants::WILDCARD()) == std::string::npos)
+    {
+      eqs.push_back(std::make_pair(d->m_attrName, d->m_attrValue));
+      return true;
+    }
+    return false;
+  }
+  else if (d->m_operator == AND)
+  {
+    bool result = false;
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      result = d->m_args[i].GetRequiredEqualities(eqs) || result;
+    }
+    return result;
+  }
+  return false;
+}
+
 bool LDAPExpr::IsSimple(const StringList& keywords, LocalCache& cache,
                         bool matchCase ) const
 {
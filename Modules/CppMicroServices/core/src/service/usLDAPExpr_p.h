@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 
 US_BEGIN_NAMESPACE
 
@@ -57,6 +58,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef std::vector<std::pair<std::string, std::string> > AttributeValueList;
 
 
   /**
@@ -83,6 +85,16 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the equality terms which every property set matching this LDAP expression
+   * must satisfy. Only plain <code>(<it>name</it>=<it>value</it>)</code> terms without
+   * wildcards, either standing alone or nested in AND expressions, are considered.
+   *
+   * \param eqs The (attribute name, attribute value) pairs will be added to eqs.
+   * \return <code>true</code> if at least one such term was found, <code>false</code> otherwise.
+   */
+  bool GetRequiredEqualities(AttributeValueList& eqs) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
@@ -19,7 +19,10 @@
 
 ============================================================================*/
 
+#include <algorithm>
+#include <cctype>
 #include <iterator>
+#include <list>
 #include <stdexcept>
 #include <cassert>
 
@@ -34,6 +37,30 @@
 
 US_BEGIN_NAMESPACE
 
+namespace {
+
+// Upper bound for the number of cached filter expressions. Filter strings
+// are usually built from a small set of constants, so the cache is simply
+// reset when it grows beyond this size.
+const std::size_t MAX_CACHED_FILTERS = 1024;
+
+std::string ToLowerKey(const std::string& key)
+{
+  std::string result(key);
+  for (std::string::iterator i = result.begin(); i != result.end(); ++i)
+  {
+    *i = static_cast<char>(::tolower(*i));
+  }
+  return result;
+}
+
+void RemoveRegistration(std::vector<ServiceRegistrationBase>& regs, const ServiceRegistrationBase& sr)
+{
+  regs.erase(std::remove(regs.begin(), regs.end(), sr), regs.end());
+}
+
+}
+
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
                                                                const std::vector<std::string>& classes,
                                                                bool isFactory, bool isPrototypeFactory,
@@ -81,6 +108,12 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  propertyIndex.clear();
+  indexedProperties.clear();
+  {
+    MutexLock lock(filterCacheMutex);
+    filterCache.clear();
+  }
   core = nullptr;
 }
 
@@ -112,7 +145,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
   ServiceRegistrationBase res(module, service,
                               CreateServiceProperties(properties, classes, isFactory, isPrototypeFactory));
   {
-    MutexLock lock(mutex);
+    WriteMutexLock lock(mutex);
     services.insert(std::make_pair(res, classes));
     serviceRegistrations.push_back(res);
     for (std::vector<std::string>::const_iterator i = classes.begin();
@@ -123,6 +156,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    AddToPropertyIndex_unlocked(res);
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -137,7 +171,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
 void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                                      const std::vector<std::string>& classes)
 {
-  MutexLock lock(mutex);
+  WriteMutexLock lock(mutex);
   for (std::vector<std::string>::const_iterator i = classes.begin();
        i != classes.end(); ++i)
   {
@@ -147,10 +181,18 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
   }
 }
 
+void ServiceRegistry::UpdateServicePropertyIndex(const ServiceRegistrationBase& sr)
+{
+  WriteMutexLock lock(mutex);
+  if (services.find(sr) == services.end()) return;
+  RemoveFromPropertyIndex_unlocked(sr);
+  AddToPropertyIndex_unlocked(sr);
+}
+
 void ServiceRegistry::Get(const std::string& clazz,
                           std::vector<ServiceRegistrationBase>& serviceRegs) const
 {
-  MutexLock lock(mutex);
+  ReadMutexLock lock(mutex);
   Get_unlocked(clazz, serviceRegs);
 }
 
@@ -166,7 +208,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz,
 
 ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::string& clazz) const
 {
-  MutexLock lock(mutex);
+  ReadMutexLock lock(mutex);
   try
   {
     std::vector<ServiceReferenceBase> srs;
@@ -188,7 +230,7 @@ ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::stri
 void ServiceRegistry::Get(const std::string& clazz, const std::string& filter,
                           ModulePrivate* module, std::vector<ServiceReferenceBase>& res) const
 {
-  MutexLock lock(mutex);
+  ReadMutexLock lock(mutex);
   Get_unlocked(clazz, filter, module, res);
 }
 
@@ -203,7 +245,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   {
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetCompiledFilter(filter);
       LDAPExpr::ObjectClassSet matched;
       if (ldap.GetMatchedObjectClasses(matched))
       {
@@ -253,7 +295,12 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
     }
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetCompiledFilter(filter);
+      if (GetIndexedCandidates_unlocked(clazz, it->second.size(), ldap, v))
+      {
+        s = v.begin();
+        send = v.end();
+      }
     }
   }
 
@@ -280,13 +327,177 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   }
 }
 
+LDAPExpr ServiceRegistry::GetCompiledFilter(const std::string& filter) const
+{
+  {
+    MutexLock lock(filterCacheMutex);
+    MapFilterCache::const_iterator i = filterCache.find(filter);
+    if (i != filterCache.end())
+    {
+      return i->second;
+    }
+  }
+
+  // parse outside the lock, invalid filters throw and are not cached
+  LDAPExpr ldap(filter);
+
+  MutexLock lock(filterCacheMutex);
+  if (filterCache.size() >= MAX_CACHED_FILTERS)
+  {
+    filterCache.clear();
+  }
+  filterCache.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
+bool ServiceRegistry::GetIndexedCandidates_unlocked(const std::string& clazz, std::size_t classSize,
+                                                    const LDAPExpr& ldap,
+                                                    std::vector<ServiceRegistrationBase>& candidates) const
+{
+  LDAPExpr::AttributeValueList eqs;
+  if (!ldap.GetRequiredEqualities(eqs)) return false;
+
+  static const std::vector<ServiceRegistrationBase> emptyRegs;
+  const std::vector<ServiceRegistrationBase>* bestValues = nullptr;
+  const std::vector<ServiceRegistrationBase>* bestUnindexed = nullptr;
+  std::size_t bestSize = classSize;
+
+  for (LDAPExpr::AttributeValueList::const_iterator eq = eqs.begin(); eq != eqs.end(); ++eq)
+  {
+    const std::string key = ToLowerKey(eq->first);
+
+    // Property keys are looked up by case-insensitive prefix if there is no
+    // exact match, so keys which extend this key make the index ambiguous.
+    MapPropertyIndex::const_iterator keyIter = propertyIndex.lower_bound(key);
+    MapPropertyIndex::const_iterator nextIter = keyIter;
+    if (nextIter != propertyIndex.end() && nextIter->first == key) ++nextIter;
+    if (nextIter != propertyIndex.end() && nextIter->first.compare(0, key.size(), key) == 0) continue;
+
+    const std::vector<ServiceRegistrationBase>* values = &emptyRegs;
+    const std::vector<ServiceRegistrationBase>* unindexed = &emptyRegs;
+    if (keyIter != propertyIndex.end() && keyIter->first == key)
+    {
+      PropertyIndexEntry::MapValueServices::const_iterator valueIter = keyIter->second.values.find(eq->second);
+      if (valueIter != keyIter->second.values.end())
+      {
+        values = &valueIter->second;
+      }
+      unindexed = &keyIter->second.unindexed;
+    }
+
+    const std::size_t size = values->size() + unindexed->size();
+    if (size < bestSize)
+    {
+      bestValues = values;
+      bestUnindexed = unindexed;
+      bestSize = size;
+    }
+  }
+
+  if (bestValues == nullptr) return false;
+
+  candidates.reserve(bestSize);
+  const std::vector<ServiceRegistrationBase>* lists[] = { bestValues, bestUnindexed };
+  for (std::size_t l = 0; l < 2; ++l)
+  {
+    for (std::vector<ServiceRegistrationBase>::const_iterator i = lists[l]->begin();
+         i != lists[l]->end(); ++i)
+    {
+      MapServiceClasses::const_iterator classes = services.find(*i);
+      if (classes != services.end() &&
+          std::find(classes->second.begin(), classes->second.end(), clazz) != classes->second.end())
+      {
+        candidates.push_back(*i);
+      }
+    }
+  }
+
+  // keep the ranking order of classServices
+  std::sort(candidates.begin(), candidates.end());
+  return true;
+}
+
+void ServiceRegistry::AddToPropertyIndex_unlocked(const ServiceRegistrationBase& sr)
+{
+  IndexedProperties& indexed = indexedProperties[sr];
+  const ServicePropertiesImpl& props = sr.d->properties;
+  const std::vector<std::string>& keys = props.Keys();
+  for (std::size_t k = 0; k < keys.size(); ++k)
+  {
+    const std::string key = ToLowerKey(keys[k]);
+    const Any& value = props.Value(static_cast<int>(k));
+    PropertyIndexEntry& entry = propertyIndex[key];
+
+    std::vector<std::string> strValues;
+    if (value.Type() == typeid(std::string))
+    {
+      strValues.push_back(ref_any_cast<std::string>(value));
+    }
+    else if (value.Type() == typeid(std::vector<std::string>))
+    {
+      strValues = ref_any_cast<std::vector<std::string> >(value);
+    }
+    else if (value.Type() == typeid(std::list<std::string>))
+    {
+      const std::list<std::string>& l = ref_any_cast<std::list<std::string> >(value);
+      strValues.assign(l.begin(), l.end());
+    }
+    else
+    {
+      entry.unindexed.push_back(sr);
+      indexed.unindexedKeys.push_back(key);
+      continue;
+    }
+
+    std::sort(strValues.begin(), strValues.end());
+    strValues.erase(std::unique(strValues.begin(), strValues.end()), strValues.end());
+    for (std::vector<std::string>::const_iterator v = strValues.begin(); v != strValues.end(); ++v)
+    {
+      entry.values[*v].push_back(sr);
+      indexed.values.push_back(std::make_pair(key, *v));
+    }
+  }
+}
+
+void ServiceRegistry::RemoveFromPropertyIndex_unlocked(const ServiceRegistrationBase& sr)
+{
+  MapServiceIndexedProperties::iterator indexed = indexedProperties.find(sr);
+  if (indexed == indexedProperties.end()) return;
+
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator i = indexed->second.values.begin();
+       i != indexed->second.values.end(); ++i)
+  {
+    MapPropertyIndex::iterator entry = propertyIndex.find(i->first);
+    if (entry == propertyIndex.end()) continue;
+    PropertyIndexEntry::MapValueServices::iterator valueIter = entry->second.values.find(i->second);
+    if (valueIter != entry->second.values.end())
+    {
+      RemoveRegistration(valueIter->second, sr);
+      if (valueIter->second.empty()) entry->second.values.erase(valueIter);
+    }
+    if (entry->second.values.empty() && entry->second.unindexed.empty()) propertyIndex.erase(entry);
+  }
+
+  for (std::vector<std::string>::const_iterator i = indexed->second.unindexedKeys.begin();
+       i != indexed->second.unindexedKeys.end(); ++i)
+  {
+    MapPropertyIndex::iterator entry = propertyIndex.find(*i);
+    if (entry == propertyIndex.end()) continue;
+    RemoveRegistration(entry->second.unindexed, sr);
+    if (entry->second.values.empty() && entry->second.unindexed.empty()) propertyIndex.erase(entry);
+  }
+
+  indexedProperties.erase(indexed);
+}
+
 void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& sr)
 {
-  MutexLock lock(mutex);
+  WriteMutexLock lock(mutex);
 
   assert(sr.d->properties.Value(ServiceConstants::OBJECTCLASS()).Type() == typeid(std::vector<std::string>));
   const std::vector<std::string>& classes = ref_any_cast<std::vector<std::string> >(
         sr.d->properties.Value(ServiceConstants::OBJECTCLASS()));
+  RemoveFromPropertyIndex_unlocked(sr);
   services.erase(sr);
   serviceRegistrations.erase(std::remove(serviceRegistrations.begin(), serviceRegistrations.end(), sr),
                              serviceRegistrations.end());
@@ -308,7 +519,7 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
 void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
                                             std::vector<ServiceRegistrationBase>& res) const
 {
-  MutexLock lock(mutex);
+  ReadMutexLock lock(mutex);
 
   for (std::vector<ServiceRegistrationBase>::const_iterator i = serviceRegistrations.begin();
        i != serviceRegistrations.end(); ++i)
@@ -323,7 +534,7 @@ void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
 void ServiceRegistry::GetUsedByModule(Module* p,
                                       std::vector<ServiceRegistrationBase>& res) const
 {
-  MutexLock lock(mutex);
+  ReadMutexLock lock(mutex);
 
   for (std::vector<ServiceRegistrationBase>::const_iterator i = serviceRegistrations.begin();
        i != serviceRegistrations.end(); ++i)
@@ -26,8 +26,11 @@
 #include "usServiceInterface.h"
 #include "usServiceRegistration.h"
 
+#include "usLDAPExpr_p.h"
 #include "usThreads_p.h"
 
+#include <map>
+
 US_BEGIN_NAMESPACE
 
 class CoreModuleContext;
@@ -43,8 +46,12 @@ class ServiceRegistry
 
 public:
 
-  typedef Mutex MutexType;
+  typedef ReadWriteMutex MutexType;
 
+  /**
+   * Lookups only need a read lock, so concurrent queries
+   * do not serialize. Modifications need a write lock.
+   */
   mutable MutexType mutex;
 
   /**
@@ -79,6 +86,43 @@ public:
    */
   MapClassServices classServices;
 
+  /**
+   * Registered services for one (lower case) property key. String values
+   * (and the elements of string lists) are mapped to the registrations
+   * having them; registrations with any other value type for this key are
+   * kept in <code>unindexed</code>, because LDAP equality may still match them.
+   */
+  struct PropertyIndexEntry
+  {
+    typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > MapValueServices;
+
+    MapValueServices values;
+    std::vector<ServiceRegistrationBase> unindexed;
+  };
+
+  /**
+   * The (key, value) pairs and keys under which a registration
+   * was entered into the property index.
+   */
+  struct IndexedProperties
+  {
+    std::vector<std::pair<std::string, std::string> > values;
+    std::vector<std::string> unindexedKeys;
+  };
+
+  typedef std::map<std::string, PropertyIndexEntry> MapPropertyIndex;
+  typedef US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, IndexedProperties> MapServiceIndexedProperties;
+  typedef US_UNORDERED_MAP_TYPE<std::string, LDAPExpr> MapFilterCache;
+
+  /**
+   * Mapping of lower case property keys to the registered services
+   * having that property, used to narrow down filtered lookups.
+   * The map is ordered to detect keys which are prefixes of other keys.
+   */
+  MapPropertyIndex propertyIndex;
+
+  MapServiceIndexedProperties indexedProperties;
+
   CoreModuleContext* core;
 
   ServiceRegistry(CoreModuleContext* coreCtx);
@@ -116,6 +160,13 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed, update the property index.
+   *
+   * @param sr The ServiceRegistration object whose properties changed.
+   */
+  void UpdateServicePropertyIndex(const ServiceRegistrationBase& sr);
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -178,6 +229,32 @@ private:
   void Get_unlocked(const std::string& clazz, const std::string& filter,
                     ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
+  /**
+   * Get the parsed LDAP expression for a filter string. Parsed expressions
+   * are cached by filter string.
+   *
+   * @throws std::invalid_argument if the filter string is not valid.
+   */
+  LDAPExpr GetCompiledFilter(const std::string& filter) const;
+
+  /**
+   * Use the property index to collect the services registered under
+   * <code>clazz</code> which may match <code>ldap</code>, in the same order
+   * as in <code>classServices</code>.
+   *
+   * @return <code>false</code> if the index cannot narrow down
+   *         the <code>classSize</code> services registered under <code>clazz</code>.
+   */
+  bool GetIndexedCandidates_unlocked(const std::string& clazz, std::size_t classSize, const LDAPExpr& ldap,
+                                     std::vector<ServiceRegistrationBase>& candidates) const;
+
+  void AddToPropertyIndex_unlocked(const ServiceRegistrationBase& sr);
+
+  void RemoveFromPropertyIndex_unlocked(const ServiceRegistrationBase& sr);
+
+  mutable Mutex filterCacheMutex;
+  mutable MapFilterCache filterCache;
+
   // purposely not implemented
   ServiceRegistry(const ServiceRegistry&);
   ServiceRegistry& operator=(const ServiceRegistry&);
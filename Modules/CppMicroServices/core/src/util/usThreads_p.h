@@ -67,6 +67,14 @@
     #define US_THREADS_MUTEX_UNLOCK(x)    ::ReleaseMutex (x)
     #define US_THREADS_LONG               LONG
 
+    #define US_THREADS_RWLOCK(x)          SRWLOCK x;
+    #define US_THREADS_RWLOCK_INIT(x)     ::InitializeSRWLock(&x)
+    #define US_THREADS_RWLOCK_DELETE(x)
+    #define US_THREADS_RWLOCK_RDLOCK(x)   ::AcquireSRWLockShared(&x)
+    #define US_THREADS_RWLOCK_RDUNLOCK(x) ::ReleaseSRWLockShared(&x)
+    #define US_THREADS_RWLOCK_WRLOCK(x)   ::AcquireSRWLockExclusive(&x)
+    #define US_THREADS_RWLOCK_WRUNLOCK(x) ::ReleaseSRWLockExclusive(&x)
+
     #define US_ATOMIC_OPTIMIZATION
     #define US_ATOMIC_INCREMENT(x)        IntType n = InterlockedIncrement(x)
     #define US_ATOMIC_DECREMENT(x)        IntType n = InterlockedDecrement(x)
@@ -83,6 +91,14 @@
     #define US_THREADS_MUTEX_LOCK(x)      ::pthread_mutex_lock (&x)
     #define US_THREADS_MUTEX_UNLOCK(x)    ::pthread_mutex_unlock (&x)
 
+    #define US_THREADS_RWLOCK(x)          pthread_rwlock_t x;
+    #define US_THREADS_RWLOCK_INIT(x)     ::pthread_rwlock_init(&x, 0)
+    #define US_THREADS_RWLOCK_DELETE(x)   ::pthread_rwlock_destroy (&x)
+    #define US_THREADS_RWLOCK_RDLOCK(x)   ::pthread_rwlock_rdlock (&x)
+    #define US_THREADS_RWLOCK_RDUNLOCK(x) ::pthread_rwlock_unlock (&x)
+    #define US_THREADS_RWLOCK_WRLOCK(x)   ::pthread_rwlock_wrlock (&x)
+    #define US_THREADS_RWLOCK_WRUNLOCK(x) ::pthread_rwlock_unlock (&x)
+
     #define US_ATOMIC_OPTIMIZATION
     #if defined(US_ATOMIC_OPTIMIZATION_APPLE)
       #if defined (__LP64__) && __LP64__
@@ -128,6 +144,14 @@
   #define US_THREADS_MUTEX_UNLOCK(x)
   #define US_THREADS_LONG int
 
+  #define US_THREADS_RWLOCK(x)
+  #define US_THREADS_RWLOCK_INIT(x)
+  #define US_THREADS_RWLOCK_DELETE(x)
+  #define US_THREADS_RWLOCK_RDLOCK(x)
+  #define US_THREADS_RWLOCK_RDUNLOCK(x)
+  #define US_THREADS_RWLOCK_WRLOCK(x)
+  #define US_THREADS_RWLOCK_WRUNLOCK(x)
+
   #define US_ATOMIC_INCREMENT(x)        IntType n = ++(*x);
   #define US_ATOMIC_DECREMENT(x)        IntType n = --(*x);
   #define US_ATOMIC_ASSIGN(l, r)        *l = r;
@@ -188,6 +212,84 @@ private:
   MutexLock& operator=(const MutexLock&);
 };
 
+/**
+ * A mutex which allows concurrent readers but only a single writer.
+ * Recursive locking is not supported.
+ */
+class ReadWriteMutex
+{
+public:
+
+  ReadWriteMutex()
+  {
+    US_THREADS_RWLOCK_INIT(m_RwLock);
+  }
+
+  ~ReadWriteMutex()
+  {
+    US_THREADS_RWLOCK_DELETE(m_RwLock);
+  }
+
+  void LockRead()
+  {
+    US_THREADS_RWLOCK_RDLOCK(m_RwLock);
+  }
+  void UnlockRead()
+  {
+    US_THREADS_RWLOCK_RDUNLOCK(m_RwLock);
+  }
+
+  void LockWrite()
+  {
+    US_THREADS_RWLOCK_WRLOCK(m_RwLock);
+  }
+  void UnlockWrite()
+  {
+    US_THREADS_RWLOCK_WRUNLOCK(m_RwLock);
+  }
+
+private:
+
+  // Copy-constructor not implemented.
+  ReadWriteMutex(const ReadWriteMutex &);
+  // Copy-assignement operator not implemented.
+  ReadWriteMutex & operator = (const ReadWriteMutex &);
+
+  US_THREADS_RWLOCK(m_RwLock)
+};
+
+class ReadMutexLock
+{
+public:
+  typedef ReadWriteMutex MutexType;
+
+  ReadMutexLock(MutexType& mtx) : m_Mtx(&mtx) { m_Mtx->LockRead(); }
+  ~ReadMutexLock() { m_Mtx->UnlockRead(); }
+
+private:
+  MutexType* m_Mtx;
+
+  // purposely not implemented
+  ReadMutexLock(const ReadMutexLock&);
+  ReadMutexLock& operator=(const ReadMutexLock&);
+};
+
+class WriteMutexLock
+{
+public:
+  typedef ReadWriteMutex MutexType;
+
+  WriteMutexLock(MutexType& mtx) : m_Mtx(&mtx) { m_Mtx->LockWrite(); }
+  ~WriteMutexLock() { m_Mtx->UnlockWrite(); }
+
+private:
+  MutexType* m_Mtx;
+
+  // purposely not implemented
+  WriteMutexLock(const WriteMutexLock&);
+  WriteMutexLock& operator=(const WriteMutexLock&);
+};
+
 class AtomicCounter
 {
 public:
@@ -0,0 +1,91 @@
+/*============================================================================
+
+  Library: CppMicroServices
+
+  Copyright (c) German Cancer Research Center (DKFZ)
+  All rights reserved.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+============================================================================*/
+
+#include <usModule.h>
+#include <usModuleContext.h>
+#include <usModuleRegistry.h>
+#include <usModuleSettings.h>
+#include <usSharedLibrary.h>
+
+#include "usTestingMacros.h"
+#include "usTestingConfig.h"
+
+#include <stdexcept>
+
+US_USE_NAMESPACE
+
+namespace {
+
+#ifdef US_PLATFORM_WINDOWS
+  static const std::string LIB_PATH = US_RUNTIME_OUTPUT_DIRECTORY;
+#else
+  static const std::string LIB_PATH = US_LIBRARY_OUTPUT_DIRECTORY;
+#endif
+
+} // end unnamed namespace
+
+int usModuleLazyActivationTest(int /*argc*/, char* /*argv*/[])
+{
+  US_TEST_BEGIN("ModuleLazyActivationTest");
+
+  ModuleSettings::SetLazyActivationEnabled(true);
+  US_TEST_CONDITION(ModuleSettings::IsLazyActivationEnabled(), "Lazy activation enabled")
+
+  SharedLibrary target(LIB_PATH, "TestModuleLazy");
+
+  try
+  {
+    target.Load();
+  }
+  catch (const std::exception& e)
+  {
+    US_TEST_FAILED_MSG( << "Failed to load module, got exception: " << e.what() );
+  }
+
+  Module* moduleLazy = ModuleRegistry::GetModule("TestModuleLazy");
+  US_TEST_CONDITION_REQUIRED(moduleLazy != nullptr, "Test for existing module TestModuleLazy")
+
+  US_TEST_CONDITION(moduleLazy->IsLoaded(), "Module is loaded")
+  US_TEST_CONDITION(!moduleLazy->IsActivated(), "Module is not activated")
+  US_TEST_CONDITION(moduleLazy->GetProperty(Module::PROP_ACTIVATION_POLICY()).ToString() == "lazy", "Activation policy")
+  US_TEST_CONDITION(moduleLazy->GetRegisteredServices().empty(), "No services registered before activation")
+  US_TEST_CONDITION(moduleLazy->GetProperty(Module::PROP_STARTUP_INIT_TIME()).Type() == typeid(long long), "Init time recorded")
+  US_TEST_CONDITION(moduleLazy->GetProperty(Module::PROP_STARTUP_ACTIVATOR_TIME()).Empty(), "No activator time before activation")
+
+  moduleLazy->Activate();
+
+  US_TEST_CONDITION(moduleLazy->IsActivated(), "Module is activated")
+  US_TEST_CONDITION(moduleLazy->GetRegisteredServices().size() == 1, "Service registered after activation")
+  US_TEST_CONDITION(moduleLazy->GetProperty(Module::PROP_STARTUP_ACTIVATOR_TIME()).Type() == typeid(long long), "Activator time recorded")
+
+  // a second call has no effect
+  moduleLazy->Activate();
+  US_TEST_CONDITION(moduleLazy->GetRegisteredServices().size() == 1, "Repeated activation")
+
+  target.Unload();
+
+  US_TEST_CONDITION(!moduleLazy->IsActivated(), "Unloaded module is not activated")
+  US_TEST_FOR_EXCEPTION(std::logic_error, moduleLazy->Activate())
+
+  ModuleSettings::SetLazyActivationEnabled(false);
+
+  US_TEST_END()
+}
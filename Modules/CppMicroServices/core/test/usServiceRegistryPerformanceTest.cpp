@@ -46,6 +46,7 @@ US_USE_NAMESPACE
 #error High precision timer support nod available on this platform
 #endif
 
+#include <sstream>
 #include <vector>
 
 class HighPrecisionTimer
@@ -185,6 +186,8 @@ private:
 
   int nListeners;
   int nServices;
+  int nMimeTypes;
+  int nLookups;
 
   std::size_t nRegistered;
   std::size_t nUnregistering;
@@ -204,6 +207,7 @@ public:
   void TestAddListeners();
   void TestRegisterServices();
 
+  void TestGetServiceReferences();
   void TestModifyServices();
   void TestUnregisterServices();
 
@@ -216,6 +220,7 @@ private:
 
   void AddListeners(int n);
   void RegisterServices(int n);
+  std::size_t GetServiceReferences(int n);
   void ModifyServices();
   void UnregisterServices();
 
@@ -259,6 +264,8 @@ ServiceRegistryPerformanceTest::ServiceRegistryPerformanceTest(ModuleContext* co
   : mc(context)
   , nListeners(100)
   , nServices(1000)
+  , nMimeTypes(50)
+  , nLookups(10000)
   , nRegistered(0)
   , nUnregistering(0)
   , nModified(0)
@@ -349,6 +356,9 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
     ss << pid << i;
     props["service.pid"] = ss.str();
     props["perf.service.value"] = i+1;
+    ss.str(std::string());
+    ss << "perf/type" << (i % nMimeTypes);
+    props["perf.service.mimetype"] = ss.str();
 
     PerfTestService* service = new PerfTestService();
     services.push_back(service);
@@ -358,6 +368,39 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestGetServiceReferences()
+{
+  Log() << "Get filtered service references " << nLookups << " times, and check that each lookup returns #of services ("
+        << nServices << ") / #of mime types (" << nMimeTypes << ") references\n";
+
+  HighPrecisionTimer t;
+  t.Start();
+  std::size_t nFound = GetServiceReferences(nLookups);
+  long long us = t.ElapsedMicro();
+  Log() << "get service references took " << us << "us (" << static_cast<double>(us) / nLookups << "us per lookup)\n";
+  US_TEST_CONDITION_REQUIRED(static_cast<std::size_t>(nLookups) * (nServices / nMimeTypes) == nFound,
+                             "# found references must be same as # of lookups * # of services per mime type");
+}
+
+std::size_t ServiceRegistryPerformanceTest::GetServiceReferences(int n)
+{
+  std::vector<std::string> filters;
+  for (int i = 0; i < nMimeTypes; ++i)
+  {
+    std::stringstream ss;
+    ss << "(&(objectclass=" << us_service_interface_iid<IPerfTestService>()
+       << ")(perf.service.mimetype=perf/type" << i << "))";
+    filters.push_back(ss.str());
+  }
+
+  std::size_t nFound = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    nFound += mc->GetServiceReferences<IPerfTestService>(filters[i % nMimeTypes]).size();
+  }
+  return nFound;
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -420,6 +463,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestGetServiceReferences();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
@@ -127,6 +127,66 @@ void TestServicePropertiesUpdate()
   US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>().empty(), "Testing service count")
 }
 
+void TestFilteredServiceLookup()
+{
+  struct TestServiceA : public ITestServiceA
+  {
+  };
+
+  ModuleContext* context = GetModuleContext();
+
+  TestServiceA s1;
+  TestServiceA s2;
+  TestServiceA s3;
+
+  ServiceProperties props1;
+  props1["mimetype"] = std::string("application/a");
+  ServiceProperties props2;
+  props2["mimetype"] = std::string("application/a");
+  props2[ServiceConstants::SERVICE_RANKING()] = 10;
+  ServiceProperties props3;
+  props3["mimetype"] = 5;
+
+  ServiceRegistration<ITestServiceA> reg1 = context->RegisterService<ITestServiceA>(&s1, props1);
+  ServiceRegistration<ITestServiceA> reg2 = context->RegisterService<ITestServiceA>(&s2, props2);
+  ServiceRegistration<ITestServiceA> reg3 = context->RegisterService<ITestServiceA>(&s3, props3);
+
+  std::vector<ServiceReference<ITestServiceA> > refs =
+      context->GetServiceReferences<ITestServiceA>("(mimetype=application/a)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Testing filtered service count")
+  US_TEST_CONDITION(context->GetService(refs.front()) == &s1 && context->GetService(refs.back()) == &s2,
+                    "Testing filtered service order")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(MIMETYPE=application/a)");
+  US_TEST_CONDITION(refs.size() == 2, "Testing case insensitive property key")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(&(mimetype=5)(objectclass=ITestServiceA))");
+  US_TEST_CONDITION(refs.size() == 1 && context->GetService(refs.front()) == &s3, "Testing non-string property value")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(mime=application/a)");
+  US_TEST_CONDITION(refs.size() == 2, "Testing property key prefix")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/b)");
+  US_TEST_CONDITION(refs.empty(), "Testing unmatched property value")
+
+  props1["mimetype"] = std::string("application/b");
+  reg1.SetProperties(props1);
+
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/a)");
+  US_TEST_CONDITION(refs.size() == 1 && context->GetService(refs.front()) == &s2, "Testing updated property value")
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/b)");
+  US_TEST_CONDITION(refs.size() == 1 && context->GetService(refs.front()) == &s1, "Testing updated property value")
+
+  reg2.Unregister();
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/a)");
+  US_TEST_CONDITION(refs.empty(), "Testing unregistered service")
+
+  US_TEST_FOR_EXCEPTION(std::invalid_argument,
+                        context->GetServiceReferences<ITestServiceA>("(mimetype=application/a"))
+
+  reg1.Unregister();
+  reg3.Unregister();
+}
 
 int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
 {
@@ -135,6 +195,7 @@ int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
   TestServiceInterfaceId();
   TestMultipleServiceRegistrations();
   TestServicePropertiesUpdate();
+  TestFilteredServiceLookup();
 
   US_TEST_END()
 }
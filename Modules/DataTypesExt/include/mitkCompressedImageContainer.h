@@ -30,6 +30,11 @@ namespace mitk
 
     Uses zlib to compress the data of an mitk::Image.
 
+    The data of each time step is split into blocks of BlockSize bytes, which
+    are compressed and decompressed independently and in parallel. Parts of
+    the image (e.g. single slices) can be restored without decompressing the
+    remaining blocks.
+
     $Author$
   */
   class MITKDATATYPESEXT_EXPORT CompressedImageContainer : public itk::Object
@@ -53,13 +58,57 @@ namespace mitk
      * This Method hold no buffer, so the uncompression algorithm will be
      * executed every time you call this method. Don't overdo it.
      *
+     * @exception mitk::Exception if the compressed data cannot be uncompressed.
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Uncompresses a part of the data of one time step into buffer.
+     *
+     * Only the blocks overlapping the requested byte range are uncompressed.
+     *
+     * \return false if the range is outside the image or the data could not be uncompressed.
+     */
+    bool GetVolumeData(unsigned int timeStep, unsigned long offset, unsigned long size, void *buffer) const;
+
+    /**
+     * \brief Uncompresses the data of one (axial) slice into buffer.
+     *
+     * The buffer has to hold GetSliceSizeInBytes() bytes.
+     */
+    bool GetSliceData(unsigned int sliceIndex, unsigned int timeStep, void *buffer) const;
+
+    /** \brief Size of one slice of the image in bytes. */
+    unsigned long GetSliceSizeInBytes() const;
+
+    /**
+     * \brief Size of the uncompressed blocks in bytes (default: 256 KiB).
+     *
+     * Smaller blocks speed up the access to parts of the image at the
+     * cost of a slightly worse compression ratio. Takes effect on the next
+     * call of SetImage().
+     */
+    itkSetMacro(BlockSize, unsigned long);
+    itkGetConstMacro(BlockSize, unsigned long);
+
+    /**
+     * \brief The zlib compression level from 1 (fastest) to 9 (best compression)
+     * or -1 for the zlib default. Takes effect on the next call of SetImage().
+     */
+    itkSetClampMacro(CompressionLevel, int, -1, 9);
+    itkGetConstMacro(CompressionLevel, int);
+
+    /** \brief Number of threads used for (un)compression; 0 uses all available cores. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
 
+    /** \brief Uncompresses the overlap of [offset, offset + size) with the blocks of a time step into buffer. */
+    bool UncompressRange(unsigned int timeStep, unsigned long offset, unsigned long size, unsigned char *buffer) const;
+
     PixelType *m_PixelType;
 
     unsigned int m_ImageDimension;
@@ -69,10 +118,17 @@ namespace mitk
 
     unsigned int m_NumberOfTimeSteps;
 
-    /// one for each timestep. first = pointer to compressed data; second = size of buffer in bytes
-    std::vector<std::pair<unsigned char *, unsigned long>> m_ByteBuffers;
+    /// compressed blocks of m_BlockSize bytes (the last one may be smaller), one vector for each timestep
+    std::vector<std::vector<std::vector<unsigned char>>> m_CompressedBlocks;
 
     BaseGeometry::Pointer m_ImageGeometry;
+
+    unsigned long m_BlockSize;
+    int m_CompressionLevel;
+    unsigned int m_NumberOfThreads;
+
+    /// block size used for the current compressed data
+    unsigned long m_CompressedBlockSize;
   };
 
 } // namespace
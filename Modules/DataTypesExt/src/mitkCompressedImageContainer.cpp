@@ -11,40 +11,63 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkCompressedImageContainer.h"
+#include "mitkExceptionMacro.h"
 #include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkParallelFor.h"
 
 #include "itk_zlib.h"
 
-#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
-mitk::CompressedImageContainer::CompressedImageContainer() : m_PixelType(nullptr), m_ImageGeometry(nullptr)
+namespace
 {
+  const char *GetZlibErrorString(int zlibRetVal)
+  {
+    switch (zlibRetVal)
+    {
+      case Z_DATA_ERROR:
+        return "compressed data corrupted";
+      case Z_MEM_ERROR:
+        return "not enough memory";
+      case Z_BUF_ERROR:
+        return "output buffer too small";
+      default:
+        return "other, unspecified error";
+    }
+  }
 }
 
-mitk::CompressedImageContainer::~CompressedImageContainer()
+mitk::CompressedImageContainer::CompressedImageContainer()
+  : m_PixelType(nullptr),
+    m_ImageDimension(0),
+    m_OneTimeStepImageSizeInBytes(0),
+    m_NumberOfTimeSteps(0),
+    m_ImageGeometry(nullptr),
+    m_BlockSize(1 << 18),
+    m_CompressionLevel(Z_DEFAULT_COMPRESSION),
+    m_NumberOfThreads(0),
+    m_CompressedBlockSize(0)
 {
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
-  {
-    free(iter->first);
-  }
+}
 
+mitk::CompressedImageContainer::~CompressedImageContainer()
+{
   delete m_PixelType;
 }
 
 void mitk::CompressedImageContainer::SetImage(Image *image)
 {
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
-  {
-    free(iter->first);
-  }
-
-  m_ByteBuffers.clear();
+  m_CompressedBlocks.clear();
 
   // Compress diff image using zlib (will be restored on demand)
   // determine memory size occupied by voxel data
   m_ImageDimension = image->GetDimension();
   m_ImageDimensions.clear();
 
+  delete m_PixelType;
   m_PixelType = new mitk::PixelType(image->GetPixelType());
 
   m_OneTimeStepImageSizeInBytes = m_PixelType->GetSize(); // bits per element divided by 8
@@ -66,64 +89,62 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
     m_NumberOfTimeSteps = image->GetDimension(3);
   }
 
-  for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
+  m_CompressedBlockSize = std::max(1ul, m_BlockSize);
+  const unsigned long numberOfBlocks = (m_OneTimeStepImageSizeInBytes + m_CompressedBlockSize - 1) / m_CompressedBlockSize;
+
+  if (itk::Object::GetDebug())
   {
-    // allocate a buffer as specified by zlib
-    unsigned long bufferSize =
-      m_OneTimeStepImageSizeInBytes + static_cast<unsigned long>(m_OneTimeStepImageSizeInBytes * 0.2) + 12;
-    auto *byteBuffer = (unsigned char *)malloc(bufferSize);
+    MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
+              << "Attempting to compress " << m_OneTimeStepImageSizeInBytes << " image bytes per time step in "
+              << numberOfBlocks << " blocks (compression level " << m_CompressionLevel << ")" << std::endl;
+  }
 
-    if (itk::Object::GetDebug())
-    {
-      // compress image here into a buffer
-      MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
-                << "Attempting to compress " << m_OneTimeStepImageSizeInBytes << " image bytes into a buffer of size "
-                << bufferSize << std::endl;
-    }
+  m_CompressedBlocks.resize(m_NumberOfTimeSteps);
 
+  for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
+  {
     ImageReadAccessor imgAcc(image, image->GetVolumeData(timestep));
-    ::Bytef *dest(byteBuffer);
-    ::uLongf destLen(bufferSize);
-    auto *source((unsigned char *)imgAcc.GetData());
-    ::uLongf sourceLen(m_OneTimeStepImageSizeInBytes);
-    int zlibRetVal = ::compress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
-    {
-      if (zlibRetVal == Z_OK)
-      {
-        MITK_INFO << "Success, using " << destLen << " bytes of the buffer (ratio "
-                  << ((double)destLen / (double)sourceLen) << ")" << std::endl;
-      }
-      else
+    auto *source((const unsigned char *)imgAcc.GetData());
+
+    auto &blocks = m_CompressedBlocks[timestep];
+    blocks.resize(numberOfBlocks);
+
+    std::atomic<unsigned long> compressedSize(0);
+
+    mitk::ParallelFor(numberOfBlocks, m_NumberOfThreads, [&](std::size_t block) {
+      const unsigned long blockOffset = block * m_CompressedBlockSize;
+      const ::uLong sourceLen(std::min(m_CompressedBlockSize, m_OneTimeStepImageSizeInBytes - blockOffset));
+
+      // allocate a buffer as specified by zlib
+      auto &byteBuffer = blocks[block];
+      byteBuffer.resize(::compressBound(sourceLen));
+
+      ::uLongf destLen(byteBuffer.size());
+      int zlibRetVal = ::compress2(byteBuffer.data(), &destLen, source + blockOffset, sourceLen, m_CompressionLevel);
+
+      if (zlibRetVal != Z_OK)
       {
-        switch (zlibRetVal)
-        {
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
-        }
+        MITK_ERROR << "Compressing block " << block << " of time step " << timestep
+                   << " failed: " << GetZlibErrorString(zlibRetVal) << std::endl;
       }
-    }
 
-    // only use the neccessary amount of memory, realloc the buffer!
-    byteBuffer = (unsigned char *)realloc(byteBuffer, destLen);
-    bufferSize = destLen;
-    // MITK_INFO << "Using " << bufferSize << " bytes to store compressed image (" << destLen << " needed)" <<
-    // std::endl;
+      // only use the neccessary amount of memory
+      byteBuffer.resize(destLen);
+      byteBuffer.shrink_to_fit();
+      compressedSize += destLen;
+    });
 
-    m_ByteBuffers.push_back(std::pair<unsigned char *, unsigned long>(byteBuffer, bufferSize));
+    if (itk::Object::GetDebug())
+    {
+      MITK_INFO << "Time step " << timestep << " uses " << compressedSize << " bytes (ratio "
+                << ((double)compressedSize / (double)m_OneTimeStepImageSizeInBytes) << ")" << std::endl;
+    }
   }
 }
 
 mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 {
-  if (m_ByteBuffers.empty())
+  if (m_CompressedBlocks.empty())
     return nullptr;
 
   // uncompress image data, create an Image
@@ -135,40 +156,13 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
   image->Initialize(*m_PixelType, m_ImageDimension, dims); // this IS needed, right ?? But it does allocate memory ->
                                                            // does create one big lump of memory (also in windows)
 
-  unsigned int timeStep(0);
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter, ++timeStep)
+  for (unsigned int timeStep = 0; timeStep < m_NumberOfTimeSteps; ++timeStep)
   {
-    ImageReadAccessor imgAcc(image, image->GetVolumeData(timeStep));
+    ImageWriteAccessor imgAcc(image, image->GetVolumeData(timeStep));
     auto *dest((unsigned char *)imgAcc.GetData());
-    ::uLongf destLen(m_OneTimeStepImageSizeInBytes);
-    ::Bytef *source(iter->first);
-    ::uLongf sourceLen(iter->second);
-    int zlibRetVal = ::uncompress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
-    {
-      if (zlibRetVal == Z_OK)
-      {
-        MITK_INFO << "Success, destLen now " << destLen << " bytes" << std::endl;
-      }
-      else
-      {
-        switch (zlibRetVal)
-        {
-          case Z_DATA_ERROR:
-            MITK_ERROR << "compressed data corrupted" << std::endl;
-            break;
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
-        }
-      }
-    }
+
+    if (!this->UncompressRange(timeStep, 0, m_OneTimeStepImageSizeInBytes, dest))
+      mitkThrow() << "Uncompressing time step " << timeStep << " of the compressed image failed.";
   }
 
   image->SetGeometry(m_ImageGeometry);
@@ -176,3 +170,84 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 
   return image;
 }
+
+bool mitk::CompressedImageContainer::GetVolumeData(unsigned int timeStep,
+                                                   unsigned long offset,
+                                                   unsigned long size,
+                                                   void *buffer) const
+{
+  if (timeStep >= m_CompressedBlocks.size() || offset > m_OneTimeStepImageSizeInBytes ||
+      size > m_OneTimeStepImageSizeInBytes - offset)
+  {
+    MITK_ERROR << "Requested data is outside of the compressed image." << std::endl;
+    return false;
+  }
+
+  return this->UncompressRange(timeStep, offset, size, static_cast<unsigned char *>(buffer));
+}
+
+bool mitk::CompressedImageContainer::GetSliceData(unsigned int sliceIndex, unsigned int timeStep, void *buffer) const
+{
+  const unsigned long sliceSize = this->GetSliceSizeInBytes();
+  return this->GetVolumeData(timeStep, sliceIndex * sliceSize, sliceSize, buffer);
+}
+
+unsigned long mitk::CompressedImageContainer::GetSliceSizeInBytes() const
+{
+  if (m_ImageDimensions.empty())
+    return 0;
+
+  const unsigned long numberOfSlices = m_ImageDimension > 2 ? m_ImageDimensions[2] : 1;
+  return numberOfSlices > 0 ? m_OneTimeStepImageSizeInBytes / numberOfSlices : 0;
+}
+
+bool mitk::CompressedImageContainer::UncompressRange(unsigned int timeStep,
+                                                     unsigned long offset,
+                                                     unsigned long size,
+                                                     unsigned char *buffer) const
+{
+  if (0 == size)
+    return true;
+
+  const auto &blocks = m_CompressedBlocks[timeStep];
+  const unsigned long firstBlock = offset / m_CompressedBlockSize;
+  const unsigned long lastBlock = (offset + size - 1) / m_CompressedBlockSize;
+
+  std::atomic<bool> success(true);
+
+  mitk::ParallelFor(lastBlock - firstBlock + 1, m_NumberOfThreads, [&](std::size_t i) {
+    const unsigned long block = firstBlock + i;
+    const unsigned long blockOffset = block * m_CompressedBlockSize;
+    const unsigned long blockSize = std::min(m_CompressedBlockSize, m_OneTimeStepImageSizeInBytes - blockOffset);
+
+    // the part of the block which was requested
+    const unsigned long begin = std::max(offset, blockOffset);
+    const unsigned long end = std::min(offset + size, blockOffset + blockSize);
+
+    // blocks which are requested completely are uncompressed directly into the buffer
+    std::vector<unsigned char> blockBuffer;
+    unsigned char *dest = buffer + (begin - offset);
+
+    if (begin != blockOffset || end != blockOffset + blockSize)
+    {
+      blockBuffer.resize(blockSize);
+      dest = blockBuffer.data();
+    }
+
+    ::uLongf destLen(blockSize);
+    int zlibRetVal = ::uncompress(dest, &destLen, blocks[block].data(), blocks[block].size());
+
+    if (zlibRetVal != Z_OK)
+    {
+      MITK_ERROR << "Uncompressing block " << block << " of time step " << timeStep
+                 << " failed: " << GetZlibErrorString(zlibRetVal) << std::endl;
+      success = false;
+      return;
+    }
+
+    if (!blockBuffer.empty())
+      std::memcpy(buffer + (begin - offset), blockBuffer.data() + (begin - blockOffset), end - begin);
+  });
+
+  return success;
+}
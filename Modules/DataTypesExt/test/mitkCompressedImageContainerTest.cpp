@@ -16,6 +16,9 @@ found in the LICENSE file.
 #include "mitkImageDataItem.h"
 #include "mitkImageReadAccessor.h"
 
+#include <cstring>
+#include <vector>
+
 class mitkCompressedImageContainerTestClass
 {
 public:
@@ -107,6 +110,46 @@ public:
       }
     }
   }
+
+  static void TestSliceAccess(mitk::CompressedImageContainer *container, mitk::Image *image, unsigned int &numberFailed)
+  {
+    // use small blocks, so that slices span several blocks and blocks span several slices
+    container->SetBlockSize(1000);
+    container->SetCompressionLevel(1);
+    container->SetImage(image);
+
+    unsigned int numberOfSlices = image->GetDimension() > 2 ? image->GetDimension(2) : 1;
+    unsigned int numberOfTimeSteps = image->GetDimension() > 3 ? image->GetDimension(3) : 1;
+
+    std::vector<unsigned char> slice(container->GetSliceSizeInBytes());
+
+    for (unsigned int timeStep = 0; timeStep < numberOfTimeSteps; ++timeStep)
+    {
+      mitk::ImageReadAccessor origImgAcc(image, image->GetVolumeData(timeStep));
+      auto *originalData((unsigned char *)origImgAcc.GetData());
+
+      for (unsigned int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+      {
+        if (!container->GetSliceData(sliceIndex, timeStep, slice.data()) ||
+            0 != memcmp(slice.data(), originalData + sliceIndex * slice.size(), slice.size()))
+        {
+          ++numberFailed;
+          std::cerr << "  (EE) Slice " << sliceIndex << " in timestep " << timeStep
+                    << " not identical after uncompression." << std::endl;
+          return;
+        }
+      }
+    }
+
+    if (container->GetSliceData(numberOfSlices, 0, slice.data()))
+    {
+      ++numberFailed;
+      std::cerr << "  (EE) Slice outside of the image could be uncompressed." << std::endl;
+    }
+
+    // the whole image is restored from the blocks as well
+    Test(container, image, numberFailed);
+  }
 };
 
 /// ctest entry point
@@ -161,6 +204,7 @@ int mitkCompressedImageContainerTest(int argc, char *argv[])
 
   // some real work
   mitkCompressedImageContainerTestClass::Test(container, image, numberFailed);
+  mitkCompressedImageContainerTestClass::TestSliceAccess(container, image, numberFailed);
 
   std::cout << "Testing destruction" << std::endl;
 
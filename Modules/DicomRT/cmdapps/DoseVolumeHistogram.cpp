@@ -0,0 +1,176 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCommandLineParser.h"
+#include "mitkIOUtil.h"
+
+#include <mitkDoseVolumeHistogramCalculator.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+static std::vector<std::string> SplitMetrics(const std::string &metrics)
+{
+  std::vector<std::string> result;
+  std::istringstream stream(metrics);
+  std::string metric;
+  while (std::getline(stream, metric, ','))
+  {
+    if (!metric.empty())
+    {
+      result.push_back(metric);
+    }
+  }
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+
+  parser.setTitle("Dose Volume Histogram");
+  parser.setCategory("DicomRT");
+  parser.setDescription("Computes the dose volume histograms of all structures of a RT structure set and exports dose/volume metrics.");
+  parser.setContributor("German Cancer Research Center (DKFZ)");
+
+  parser.setArgumentPrefix("--","-");
+  // Add command line argument names
+  parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
+  parser.addArgument("dose", "d", mitkCommandLineParser::File, "Dose file:", "RT dose file", us::Any(), false, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("structures", "s", mitkCommandLineParser::File, "Structure set file:", "RT structure set file", us::Any(), false, false, false, mitkCommandLineParser::Input);
+  parser.addArgument("output", "o", mitkCommandLineParser::File, "Output file:", "CSV file with one line of metrics per structure", us::Any(), false, false, false, mitkCommandLineParser::Output);
+  parser.addArgument("dvh", "c", mitkCommandLineParser::File, "DVH file:", "CSV file with the cumulative dose volume histograms (cm^3) of all structures", us::Any(), true, false, false, mitkCommandLineParser::Output);
+  parser.addArgument("metrics", "m", mitkCommandLineParser::String, "Metrics:", "Comma separated metrics, e.g. Dmean,D95,D2cc,V20 (see mitk::DoseVolumeHistogram::GetMetric())", us::Any(std::string("Dmin,Dmean,Dmax,D98,D95,D50,D2,V20")), true);
+  parser.addArgument("bin-width", "b", mitkCommandLineParser::Float, "Bin width:", "Width of the histogram bins in Gy", us::Any(0.01f), true);
+  parser.addArgument("threads", "t", mitkCommandLineParser::Int, "Threads:", "Number of threads, 0 to use all cores", us::Any(0), true);
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+
+  if (parsedArgs.size()==0)
+      return EXIT_FAILURE;
+
+  // Show a help message
+  if ( parsedArgs.count("help") || parsedArgs.count("h"))
+  {
+    std::cout << parser.helpText();
+    return EXIT_SUCCESS;
+  }
+
+  std::string doseFilename = us::any_cast<std::string>(parsedArgs["dose"]);
+  std::string structuresFilename = us::any_cast<std::string>(parsedArgs["structures"]);
+  std::string outputFilename = us::any_cast<std::string>(parsedArgs["output"]);
+
+  std::string metrics = "Dmin,Dmean,Dmax,D98,D95,D50,D2,V20";
+  if (parsedArgs.count("metrics"))
+  {
+    metrics = us::any_cast<std::string>(parsedArgs["metrics"]);
+  }
+
+  float binWidth = 0.01f;
+  if (parsedArgs.count("bin-width"))
+  {
+    binWidth = us::any_cast<float>(parsedArgs["bin-width"]);
+  }
+
+  int numberOfThreads = 0;
+  if (parsedArgs.count("threads"))
+  {
+    numberOfThreads = us::any_cast<int>(parsedArgs["threads"]);
+  }
+
+  mitk::Image::Pointer doseImage = mitk::IOUtil::Load<mitk::Image>(doseFilename);
+
+  auto structureData = mitk::IOUtil::Load(structuresFilename);
+
+  mitk::DoseVolumeHistogramCalculator::Pointer calculator = mitk::DoseVolumeHistogramCalculator::New();
+  calculator->SetDoseImage(doseImage);
+  calculator->SetBinWidth(binWidth);
+  calculator->SetNumberOfThreads(std::max(0, numberOfThreads));
+
+  for (const auto &data : structureData)
+  {
+    auto structure = dynamic_cast<mitk::ContourModelSet *>(data.GetPointer());
+    if (structure != nullptr && structure->GetSize() > 0)
+    {
+      calculator->AddStructure(structure);
+    }
+  }
+
+  if (calculator->GetNumberOfStructures() == 0)
+  {
+    MITK_INFO << "No structures loaded";
+    return EXIT_FAILURE;
+  }
+
+  MITK_INFO << "Computing dose volume histograms of " << calculator->GetNumberOfStructures() << " structures";
+
+  try
+  {
+    calculator->Compute();
+
+    const std::vector<std::string> metricNames = SplitMetrics(metrics);
+
+    std::ofstream output(outputFilename);
+    output << "Structure,Volume [cm^3]";
+    for (const auto &metricName : metricNames)
+    {
+      output << "," << metricName;
+    }
+    output << std::endl;
+
+    for (const auto &histogram : calculator->GetHistograms())
+    {
+      output << "\"" << histogram->GetStructureName() << "\"," << histogram->GetTotalVolume();
+      for (const auto &metricName : metricNames)
+      {
+        output << "," << histogram->GetMetric(metricName);
+      }
+      output << std::endl;
+    }
+
+    if (parsedArgs.count("dvh"))
+    {
+      const auto &histograms = calculator->GetHistograms();
+
+      std::vector<mitk::DoseVolumeHistogram::VolumeVectorType> cumulativeVolumes;
+      std::size_t numberOfBins = 0;
+
+      std::ofstream dvhOutput(us::any_cast<std::string>(parsedArgs["dvh"]));
+      dvhOutput << "Dose [Gy]";
+      for (const auto &histogram : histograms)
+      {
+        dvhOutput << ",\"" << histogram->GetStructureName() << "\"";
+        cumulativeVolumes.push_back(histogram->GetCumulativeVolumes());
+        numberOfBins = std::max(numberOfBins, cumulativeVolumes.back().size());
+      }
+      dvhOutput << std::endl;
+
+      for (std::size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        dvhOutput << bin * calculator->GetBinWidth();
+        for (const auto &volumes : cumulativeVolumes)
+        {
+          dvhOutput << "," << (bin < volumes.size() ? volumes[bin] : 0.0);
+        }
+        dvhOutput << std::endl;
+      }
+    }
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_ERROR << e.GetDescription();
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
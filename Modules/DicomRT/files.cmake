@@ -10,6 +10,8 @@ SET(CPP_FILES
   mitkIsoLevelsGenerator.cpp
   mitkDoseNodeHelper.cpp
   mitkDicomRTMimeTypes.cpp
+  mitkDoseVolumeHistogram.cpp
+  mitkDoseVolumeHistogramCalculator.cpp
 )
 
 set(TPP_FILES
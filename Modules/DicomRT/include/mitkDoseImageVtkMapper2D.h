@@ -27,6 +27,9 @@ found in the LICENSE file.
 #include <vtkPropAssembly.h>
 #include <vtkCellArray.h>
 
+#include <deque>
+#include <vector>
+
 class vtkActor;
 class vtkPolyDataMapper;
 class vtkPlaneSource;
@@ -134,6 +137,15 @@ namespace mitk {
     vtkProp* GetVtkProp(mitk::BaseRenderer* renderer) override;
     //### end of methods of MITK-VTK rendering pipeline
 
+    /** \brief Iso line of a visible dose level with its absolute dose value and its color (0-255). */
+    struct IsoLine
+    {
+      double DoseValue;
+      unsigned char Color[3];
+
+      bool operator==(const IsoLine &other) const;
+      bool operator!=(const IsoLine &other) const { return !(*this == other); }
+    };
 
     /** \brief Internal class holding the mapper, actor, etc. for each of the 3 2D render windows */
     /**
@@ -179,6 +191,22 @@ namespace mitk {
       For instance, if you zoom or pann, there is no need to recompute the contour. */
       vtkSmartPointer<vtkPolyData> m_OutlinePolyData;
 
+      /** \brief Outline of a resliced image together with the reslicing it depends on. */
+      struct CachedOutline
+      {
+        double ResliceAxes[16];
+        int Extent[6];
+        double Spacing[2];
+        float Depth;
+        vtkSmartPointer<vtkPolyData> OutlinePolyData;
+      };
+      /** \brief Outlines of the last slices, e.g. for scrolling back and forth. They are dropped as soon as
+      the image, the properties or the visible iso lines change (see GetOutlinePolyData()). */
+      std::deque<CachedOutline> m_CachedOutlines;
+      std::vector<IsoLine> m_CachedOutlinesIsoLines;
+      unsigned long m_CachedOutlinesMTime;
+      int m_CachedOutlinesTimeStep;
+
       /** \brief Timestamp of last update of stored data. */
       itk::TimeStamp m_LastUpdateTime;
 
@@ -231,11 +259,29 @@ namespace mitk {
     */
     void GeneratePlane(mitk::BaseRenderer* renderer, double planeBounds[6]);
 
-    /** \brief Generates a vtkPolyData object containing the outline of a given binary slice.
+    /** \brief Returns the visible iso lines of the iso dose level set and the free iso dose levels, sorted
+    * ascending by their dose value.
+    */
+    std::vector<IsoLine> GetVisibleIsoLines();
+
+    /** \brief Returns the outline of the current resliced image for the visible iso lines.
+    * The outline is taken from the cache of the local storage if the same slice was outlined before
+    * and neither the image, the properties nor the iso lines changed since. Otherwise it is created
+    * by CreateOutlinePolyData() and added to the cache.
     \param renderer: Pointer to the renderer containing the needed information
+    */
+    vtkSmartPointer<vtkPolyData> GetOutlinePolyData(mitk::BaseRenderer* renderer);
+
+    /** \brief Generates a vtkPolyData object containing the outlines of all given iso lines in the current
+    * resliced image.
+    * All iso lines are created in one pass over the slice: each pixel edge is added once for each iso line
+    * whose dose value is reached by the pixel on one side but not by the pixel on the other side. The line
+    * cells are colored by the iso lines and share the points at the pixel corners.
+    \param renderer: Pointer to the renderer containing the needed information
+    \param isoLines: Iso lines sorted ascending by their dose value (see GetVisibleIsoLines())
     \note This code is based on code from the iil library.
     */
-    vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer* renderer);
+    vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer* renderer, const std::vector<IsoLine> &isoLines);
 
     /** Default constructor */
     DoseImageVtkMapper2D();
@@ -299,9 +345,6 @@ namespace mitk {
     **/
     bool RenderingGeometryIntersectsImage( const PlaneGeometry* renderingGeometry, SlicedGeometry3D* imageGeometry );
 
-  private:
-    void CreateLevelOutline(mitk::BaseRenderer* renderer, const mitk::IsoDoseLevel* level, float pref, vtkSmartPointer<vtkPoints> points, vtkSmartPointer<vtkCellArray> lines,  vtkSmartPointer<vtkUnsignedCharArray> colors);
-
   };
 
 } // namespace mitk
@@ -0,0 +1,106 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef _MITK_DOSE_VOLUME_HISTOGRAM_H_
+#define _MITK_DOSE_VOLUME_HISTOGRAM_H_
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include "mitkCommon.h"
+#include "mitkDoseValueType.h"
+#include "MitkDicomRTExports.h"
+
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+
+  /**
+  \brief Dose volume histogram (DVH) of one structure, see DoseVolumeHistogramCalculator.
+  *
+  * The differential histogram stores for each bin i the volume (in cm^3) of the structure that receives
+  * a dose in [i*BinWidth, (i+1)*BinWidth). Within a bin the dose is assumed to be distributed uniformly,
+  * so the cumulative histogram and the dose/volume metrics are interpolated linearly between the bin
+  * boundaries and limited to the minimum and maximum dose of the structure.
+  */
+  class MITKDICOMRT_EXPORT DoseVolumeHistogram : public itk::Object
+  {
+  public:
+    typedef std::vector<double> VolumeVectorType;
+
+    mitkClassMacroItkParent(DoseVolumeHistogram, itk::Object);
+    itkNewMacro(Self);
+
+    itkSetMacro(StructureName, std::string);
+    itkGetConstMacro(StructureName, std::string);
+
+    /** Sets the differential histogram and the dose statistics of the structure.*/
+    void Initialize(DoseValueAbs binWidth,
+                    const VolumeVectorType &differentialVolumes,
+                    DoseValueAbs minimumDose,
+                    DoseValueAbs maximumDose,
+                    DoseValueAbs meanDose);
+
+    itkGetConstMacro(BinWidth, DoseValueAbs);
+    itkGetConstMacro(MinimumDose, DoseValueAbs);
+    itkGetConstMacro(MaximumDose, DoseValueAbs);
+    itkGetConstMacro(MeanDose, DoseValueAbs);
+
+    /** Volume (in cm^3) per dose bin.*/
+    const VolumeVectorType &GetDifferentialVolumes() const;
+
+    /** Volume (in cm^3) that receives at least the lower boundary of each dose bin.*/
+    VolumeVectorType GetCumulativeVolumes() const;
+
+    /** Volume (in cm^3) of the structure.*/
+    double GetTotalVolume() const;
+
+    /** Returns the volume that receives at least the given dose (e.g. V20 for 20 Gy).
+    @param relativeVolume If true, the volume is returned in % of the total volume, otherwise in cm^3.*/
+    double GetVolumeAtDose(DoseValueAbs dose, bool relativeVolume = true) const;
+
+    /** Returns the minimum dose that the given volume with the highest dose receives (e.g. D95 for 95%).
+    @param relativeVolume If true, the volume is given in % of the total volume, otherwise in cm^3.*/
+    DoseValueAbs GetDoseAtVolume(double volume, bool relativeVolume = true) const;
+
+    /** Evaluates a metric given by its common name:
+    - "Dmin", "Dmean", "Dmax": dose statistics in Gy
+    - "D<v>" or "D<v>%": dose in Gy received by v % of the volume (e.g. "D95")
+    - "D<v>cc": dose in Gy received by v cm^3 of the volume (e.g. "D2cc")
+    - "V<d>" or "V<d>Gy": volume in % receiving at least d Gy (e.g. "V20")
+    - "V<d>cc" or "V<d>Gycc": volume in cm^3 receiving at least d Gy
+    @exception mitk::Exception if the metric is not supported.*/
+    double GetMetric(const std::string &metric) const;
+
+  protected:
+    DoseVolumeHistogram();
+    ~DoseVolumeHistogram() override;
+
+    void PrintSelf(std::ostream &os, itk::Indent indent) const override;
+
+  private:
+    std::string m_StructureName;
+    DoseValueAbs m_BinWidth;
+    DoseValueAbs m_MinimumDose;
+    DoseValueAbs m_MaximumDose;
+    DoseValueAbs m_MeanDose;
+
+    VolumeVectorType m_DifferentialVolumes;
+    /** cumulative volumes with one more entry (0) than bins, so that bin i covers m_CumulativeVolumes[i]..[i+1]*/
+    VolumeVectorType m_CumulativeVolumes;
+  };
+
+} // namespace mitk
+
+#endif //_MITK_DOSE_VOLUME_HISTOGRAM_H_
@@ -0,0 +1,114 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef _MITK_DOSE_VOLUME_HISTOGRAM_CALCULATOR_H_
+#define _MITK_DOSE_VOLUME_HISTOGRAM_CALCULATOR_H_
+
+#include <itkImage.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <mitkContourModelSet.h>
+#include <mitkImage.h>
+
+#include "mitkCommon.h"
+#include "mitkDoseValueType.h"
+#include "mitkDoseVolumeHistogram.h"
+#include "MitkDicomRTExports.h"
+
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+
+  /**
+  \brief Computes the dose volume histograms (DVHs) of several structures in one pass over a dose image.
+  *
+  * The structures are given as planar contours like the ROIs read by the RTStructureSetReaderService. The
+  * contours are expected to be parallel to the slices of the dose image. Each contour slice of a structure
+  * represents a slab whose thickness is the smallest distance between two contour slices of the structure
+  * (or one dose slice if there is only one). Contours of the same slice are combined by the even-odd rule,
+  * so inner contours cut holes.
+  *
+  * Voxels on the border of a structure are weighted by the fraction of their volume that lies inside the
+  * structure. In plane the fraction is estimated by SubsamplingFactor x SubsamplingFactor samples per voxel,
+  * through plane it is the overlap of the voxel with the slabs of the structure. Parts of the structures
+  * outside of the dose image are ignored.
+  *
+  * The slices of the dose image are distributed to NumberOfThreads threads, each thread accumulates the
+  * histograms of all structures for its slices. Only the first time step of the dose image is used.
+  */
+  class MITKDICOMRT_EXPORT DoseVolumeHistogramCalculator : public itk::Object
+  {
+  public:
+    typedef std::vector<DoseVolumeHistogram::Pointer> HistogramVectorType;
+
+    mitkClassMacroItkParent(DoseVolumeHistogramCalculator, itk::Object);
+    itkNewMacro(Self);
+
+    /** Dose image with absolute dose values in Gy, e.g. read by the RTDoseReaderService.*/
+    itkSetConstObjectMacro(DoseImage, Image);
+    itkGetConstObjectMacro(DoseImage, Image);
+
+    /** Adds a structure. If no name is given, the "name" property of the structure is used.*/
+    void AddStructure(const ContourModelSet *structure, const std::string &name = "");
+    void ClearStructures();
+    std::size_t GetNumberOfStructures() const;
+
+    /** Width of the histogram bins in Gy. Default is 0.01 Gy.*/
+    itkSetMacro(BinWidth, DoseValueAbs);
+    itkGetConstMacro(BinWidth, DoseValueAbs);
+
+    /** Number of samples per voxel and in-plane direction used to estimate the fraction of a voxel covered by a
+    structure (1-16). Default is 8.*/
+    itkSetClampMacro(SubsamplingFactor, unsigned int, 1, 16);
+    itkGetConstMacro(SubsamplingFactor, unsigned int);
+
+    /** Number of threads, 0 (default) to use the default number of threads of ITK.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Computes the histograms of all structures.
+    @exception mitk::Exception if no 3D dose image is set or the bin width is not positive.*/
+    void Compute();
+
+    /** Histograms of the structures in the order in which they were added.*/
+    const HistogramVectorType &GetHistograms() const;
+    DoseVolumeHistogram *GetHistogram(std::size_t index) const;
+
+  protected:
+    DoseVolumeHistogramCalculator();
+    ~DoseVolumeHistogramCalculator() override;
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void ComputeInternal(const itk::Image<TPixel, VImageDimension> *doseImage);
+
+  private:
+    struct Structure
+    {
+      ContourModelSet::ConstPointer ContourSet;
+      std::string Name;
+    };
+
+    Image::ConstPointer m_DoseImage;
+    std::vector<Structure> m_Structures;
+    HistogramVectorType m_Histograms;
+
+    DoseValueAbs m_BinWidth;
+    unsigned int m_SubsamplingFactor;
+    unsigned int m_NumberOfThreads;
+  };
+
+} // namespace mitk
+
+#endif //_MITK_DOSE_VOLUME_HISTOGRAM_CALCULATOR_H_
@@ -58,6 +58,15 @@ found in the LICENSE file.
 // ITK
 #include <itkRGBAPixel.h>
 
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  // number of outlines that are kept per render window, e.g. for scrolling back and forth
+  const std::size_t MAXIMUM_NUMBER_OF_CACHED_OUTLINES = 16;
+}
+
 mitk::DoseImageVtkMapper2D::DoseImageVtkMapper2D()
 {
 }
@@ -328,7 +337,7 @@ void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *ren
   if (showIsoLines) // contour rendering
   {
     // generate contours/outlines
-    localStorage->m_OutlinePolyData = CreateOutlinePolyData(renderer);
+    localStorage->m_OutlinePolyData = this->GetOutlinePolyData(renderer);
 
     float binaryOutlineWidth(1.0);
     if (datanode->GetFloatProperty("outline width", binaryOutlineWidth, renderer))
@@ -842,223 +851,271 @@ mitk::DoseImageVtkMapper2D::LocalStorage *mitk::DoseImageVtkMapper2D::GetLocalSt
   return m_LSH.GetLocalStorage(renderer);
 }
 
-vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer)
+bool mitk::DoseImageVtkMapper2D::IsoLine::operator==(const IsoLine &other) const
 {
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
-  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
-  vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
-  colors->SetNumberOfComponents(3);
-  colors->SetName("Colors");
+  return DoseValue == other.DoseValue && std::equal(Color, Color + 3, other.Color);
+}
+
+std::vector<mitk::DoseImageVtkMapper2D::IsoLine> mitk::DoseImageVtkMapper2D::GetVisibleIsoLines()
+{
+  std::vector<IsoLine> isoLines;
 
-  float pref;
+  float pref = 0.0;
   this->GetDataNode()->GetFloatProperty(mitk::RTConstants::REFERENCE_DOSE_PROPERTY_NAME.c_str(), pref);
 
+  auto addIsoLine = [&isoLines, pref](const mitk::IsoDoseLevel *level) {
+    const mitk::IsoDoseLevel::ColorType isoColor = level->GetColor();
+
+    IsoLine isoLine;
+    isoLine.DoseValue = level->GetDoseValue() * pref;
+    isoLine.Color[0] = static_cast<unsigned char>(isoColor.GetRed() * 255);
+    isoLine.Color[1] = static_cast<unsigned char>(isoColor.GetGreen() * 255);
+    isoLine.Color[2] = static_cast<unsigned char>(isoColor.GetBlue() * 255);
+    isoLines.push_back(isoLine);
+  };
+
   mitk::IsoDoseLevelSetProperty::Pointer propIsoSet = dynamic_cast<mitk::IsoDoseLevelSetProperty *>(
     GetDataNode()->GetProperty(mitk::RTConstants::DOSE_ISO_LEVELS_PROPERTY_NAME.c_str()));
-  mitk::IsoDoseLevelSet::Pointer isoDoseLevelSet = propIsoSet->GetValue();
 
-  for (mitk::IsoDoseLevelSet::ConstIterator doseIT = isoDoseLevelSet->Begin(); doseIT != isoDoseLevelSet->End();
-       ++doseIT)
+  if (propIsoSet.IsNotNull())
   {
-    if (doseIT->GetVisibleIsoLine())
+    mitk::IsoDoseLevelSet::Pointer isoDoseLevelSet = propIsoSet->GetValue();
+
+    for (mitk::IsoDoseLevelSet::ConstIterator doseIT = isoDoseLevelSet->Begin(); doseIT != isoDoseLevelSet->End();
+         ++doseIT)
     {
-      this->CreateLevelOutline(renderer, &(doseIT.Value()), pref, points, lines, colors);
-    } // end of if visible dose value
-  }   // end of loop over all does values
+      if (doseIT->GetVisibleIsoLine())
+      {
+        addIsoLine(&(doseIT.Value()));
+      }
+    }
+  }
 
   mitk::IsoDoseLevelVectorProperty::Pointer propfreeIsoVec = dynamic_cast<mitk::IsoDoseLevelVectorProperty *>(
     GetDataNode()->GetProperty(mitk::RTConstants::DOSE_FREE_ISO_VALUES_PROPERTY_NAME.c_str()));
-  mitk::IsoDoseLevelVector::Pointer frereIsoDoseLevelVec = propfreeIsoVec->GetValue();
 
-  for (mitk::IsoDoseLevelVector::ConstIterator freeDoseIT = frereIsoDoseLevelVec->Begin();
-       freeDoseIT != frereIsoDoseLevelVec->End();
-       ++freeDoseIT)
+  if (propfreeIsoVec.IsNotNull())
   {
-    if (freeDoseIT->Value()->GetVisibleIsoLine())
+    mitk::IsoDoseLevelVector::Pointer freeIsoDoseLevelVec = propfreeIsoVec->GetValue();
+
+    for (mitk::IsoDoseLevelVector::ConstIterator freeDoseIT = freeIsoDoseLevelVec->Begin();
+         freeDoseIT != freeIsoDoseLevelVec->End();
+         ++freeDoseIT)
     {
-      this->CreateLevelOutline(renderer, freeDoseIT->Value(), pref, points, lines, colors);
-    } // end of if visible dose value
-  }   // end of loop over all does values
+      if (freeDoseIT->Value()->GetVisibleIsoLine())
+      {
+        addIsoLine(freeDoseIT->Value());
+      }
+    }
+  }
 
-  // Create a polydata to store everything in
-  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-  // Add the points to the dataset
-  polyData->SetPoints(points);
-  // Add the lines to the dataset
-  polyData->SetLines(lines);
-  polyData->GetCellData()->SetScalars(colors);
-  return polyData;
+  // stable, so that iso lines with equal dose values keep the order in which they were drawn before
+  std::stable_sort(isoLines.begin(), isoLines.end(), [](const IsoLine &a, const IsoLine &b) {
+    return a.DoseValue < b.DoseValue;
+  });
+
+  return isoLines;
 }
 
-void mitk::DoseImageVtkMapper2D::CreateLevelOutline(mitk::BaseRenderer *renderer,
-                                                    const mitk::IsoDoseLevel *level,
-                                                    float pref,
-                                                    vtkSmartPointer<vtkPoints> points,
-                                                    vtkSmartPointer<vtkCellArray> lines,
-                                                    vtkSmartPointer<vtkUnsignedCharArray> colors)
+vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::GetOutlinePolyData(mitk::BaseRenderer *renderer)
 {
   LocalStorage *localStorage = this->GetLocalStorage(renderer);
+  const mitk::Image *input = this->GetInput();
+  const mitk::DataNode *node = this->GetDataNode();
+
+  const std::vector<IsoLine> isoLines = this->GetVisibleIsoLines();
 
-  // get the min and max index values of each direction
-  int *extent = localStorage->m_ReslicedImage->GetExtent();
-  int xMin = extent[0];
-  int xMax = extent[1];
-  int yMin = extent[2];
-  int yMax = extent[3];
-
-  int *dims = localStorage->m_ReslicedImage->GetDimensions(); // dimensions of the image
-  int line = dims[0];                                         // how many pixels per line?
-  // get the depth for each contour
-  float depth = CalculateLayerDepth(renderer);
-
-  double doseValue = level->GetDoseValue() * pref;
-  mitk::IsoDoseLevel::ColorType isoColor = level->GetColor();
-  unsigned char colorLine[3] = {static_cast<unsigned char>(isoColor.GetRed() * 255),
-                                static_cast<unsigned char>(isoColor.GetGreen() * 255),
-                                static_cast<unsigned char>(isoColor.GetBlue() * 255)};
-
-  int x = xMin; // pixel index x
-  int y = yMin; // pixel index y
-  float *currentPixel;
-
-  // We take the pointer to the first pixel of the image
-  currentPixel = static_cast<float *>(localStorage->m_ReslicedImage->GetScalarPointer());
-
-  if (!currentPixel){
-    mitkThrow() << "currentPixel invalid";
+  // the outline of a slice depends on the pixels and the reslicing parameters, which are set by
+  // the image, the properties of the image node and the properties of the plane node (thick slices)
+  unsigned long modifiedTime = std::max(input->GetMTime(), input->GetPipelineMTime());
+  modifiedTime = std::max(modifiedTime, node->GetMTime());
+  modifiedTime = std::max(modifiedTime, node->GetPropertyList()->GetMTime());
+  modifiedTime = std::max(modifiedTime, node->GetPropertyList(renderer)->GetMTime());
+
+  const mitk::DataNode *planeNode = renderer->GetCurrentWorldPlaneGeometryNode();
+  if (planeNode != nullptr)
+  {
+    modifiedTime = std::max(modifiedTime, planeNode->GetPropertyList()->GetMTime());
   }
 
-  while (y <= yMax)
+  if (modifiedTime != localStorage->m_CachedOutlinesMTime ||
+      this->GetTimestep() != localStorage->m_CachedOutlinesTimeStep ||
+      isoLines != localStorage->m_CachedOutlinesIsoLines)
   {
-    // if the current pixel value is set to something
-    if ((currentPixel) && (*currentPixel >= doseValue))
+    localStorage->m_CachedOutlines.clear();
+    localStorage->m_CachedOutlinesMTime = modifiedTime;
+    localStorage->m_CachedOutlinesTimeStep = this->GetTimestep();
+    localStorage->m_CachedOutlinesIsoLines = isoLines;
+  }
+
+  LocalStorage::CachedOutline outline;
+  vtkMatrix4x4 *resliceAxes = localStorage->m_Reslicer->GetResliceAxes();
+  for (int i = 0; i < 16; ++i)
+  {
+    outline.ResliceAxes[i] = resliceAxes->GetElement(i / 4, i % 4);
+  }
+  const int *extent = localStorage->m_ReslicedImage->GetExtent();
+  std::copy(extent, extent + 6, outline.Extent);
+  outline.Spacing[0] = localStorage->m_mmPerPixel[0];
+  outline.Spacing[1] = localStorage->m_mmPerPixel[1];
+  outline.Depth = this->CalculateLayerDepth(renderer);
+
+  for (const auto &cachedOutline : localStorage->m_CachedOutlines)
+  {
+    if (std::equal(outline.ResliceAxes, outline.ResliceAxes + 16, cachedOutline.ResliceAxes) &&
+        std::equal(outline.Extent, outline.Extent + 6, cachedOutline.Extent) &&
+        std::equal(outline.Spacing, outline.Spacing + 2, cachedOutline.Spacing) && outline.Depth == cachedOutline.Depth)
     {
-      // check in which direction a line is necessary
-      // a line is added if the neighbor of the current pixel has the value 0
-      // and if the pixel is located at the edge of the image
-
-      // if   vvvvv  not the first line vvvvv
-      if (y > yMin && *(currentPixel - line) < doseValue)
-      { // x direction - bottom edge of the pixel
-        // add the 2 points
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        // add the line between both points
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
+      return cachedOutline.OutlinePolyData;
+    }
+  }
 
-      // if   vvvvv  not the last line vvvvv
-      if (y < yMax && *(currentPixel + line) < doseValue)
-      { // x direction - top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
+  outline.OutlinePolyData = this->CreateOutlinePolyData(renderer, isoLines);
 
-      // if   vvvvv  not the first pixel vvvvv
-      if ((x > xMin || y > yMin) && *(currentPixel - 1) < doseValue)
-      { // y direction - left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
+  if (localStorage->m_CachedOutlines.size() >= MAXIMUM_NUMBER_OF_CACHED_OUTLINES)
+  {
+    localStorage->m_CachedOutlines.pop_front();
+  }
+  localStorage->m_CachedOutlines.push_back(outline);
 
-      // if   vvvvv  not the last pixel vvvvv
-      if ((y < yMax || (x < xMax)) && *(currentPixel + 1) < doseValue)
-      { // y direction - right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
-      }
+  return outline.OutlinePolyData;
+}
 
-      /*  now consider pixels at the edge of the image  */
+vtkSmartPointer<vtkPolyData> mitk::DoseImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer,
+                                                                              const std::vector<IsoLine> &isoLines)
+{
+  LocalStorage *localStorage = this->GetLocalStorage(renderer);
 
-      // if   vvvvv  left edge of image vvvvv
-      if (x == xMin)
-      { // draw left edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
+  vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colors->SetNumberOfComponents(3);
+  colors->SetName("Colors");
+
+  if (!isoLines.empty())
+  {
+    // get the min and max index values of each direction
+    int *extent = localStorage->m_ReslicedImage->GetExtent();
+    const int xMin = extent[0];
+    const int xMax = extent[1];
+    const int yMin = extent[2];
+    const int yMax = extent[3];
+
+    int *dims = localStorage->m_ReslicedImage->GetDimensions(); // dimensions of the image
+    const int line = dims[0];                                   // how many pixels per line?
+    // get the depth for each contour
+    const float depth = CalculateLayerDepth(renderer);
+    const mitk::ScalarType *mmPerPixel = localStorage->m_mmPerPixel;
+
+    // We take the pointer to the first pixel of the image
+    const float *firstPixel = static_cast<float *>(localStorage->m_ReslicedImage->GetScalarPointer());
+
+    if (!firstPixel)
+    {
+      mitkThrow() << "currentPixel invalid";
+    }
+
+    std::vector<double> doseValues;
+    doseValues.reserve(isoLines.size());
+    for (const auto &isoLine : isoLines)
+    {
+      doseValues.push_back(isoLine.DoseValue);
+    }
+
+    // the corners of the pixels are inserted when they are used for the first time, -1 marks unused corners
+    const int cornersPerLine = xMax - xMin + 2;
+    std::vector<vtkIdType> cornerIds(static_cast<std::size_t>(cornersPerLine) * (yMax - yMin + 2), -1);
+
+    auto getCorner = [&](int x, int y) {
+      vtkIdType &id = cornerIds[static_cast<std::size_t>(y - yMin) * cornersPerLine + (x - xMin)];
+      if (id < 0)
+      {
+        id = points->InsertNextPoint(x * mmPerPixel[0], y * mmPerPixel[1], depth);
       }
+      return id;
+    };
 
-      // if   vvvvv  right edge of image vvvvv
-      if (x == xMax)
-      { // draw right edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
+    // adds the edge between two corners for all iso lines whose dose value is reached by the higher
+    // but not by the lower value on both sides of the edge. Edges next to invalid (NaN) values are skipped.
+    auto addEdge = [&](int x1, int y1, int x2, int y2, double lowerValue, double higherValue) {
+      if (!(higherValue > lowerValue) || higherValue < doseValues.front())
+      {
+        return;
       }
 
-      // if   vvvvv  bottom edge of image vvvvv
-      if (y == yMin)
-      { // draw bottom edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
+      auto first = std::upper_bound(doseValues.begin(), doseValues.end(), lowerValue);
+      auto last = std::upper_bound(first, doseValues.end(), higherValue);
+
+      if (first == last)
+      {
+        return;
       }
 
-      // if   vvvvv  top edge of image vvvvv
-      if (y == yMax)
-      { // draw top edge of the pixel
-        vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
-        vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+      const vtkIdType p1 = getCorner(x1, y1);
+      const vtkIdType p2 = getCorner(x2, y2);
+
+      for (auto doseIT = first; doseIT != last; ++doseIT)
+      {
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
-        colors->InsertNextTypedTuple(colorLine);
+        colors->InsertNextTypedTuple(isoLines[doseIT - doseValues.begin()].Color);
       }
-    } // end if currentpixel is set
+    };
 
-    x++;
+    // outside of the image every iso line is closed
+    const double outside = -std::numeric_limits<double>::infinity();
+
+    for (int y = yMin; y <= yMax; ++y)
+    {
+      const float *currentPixel = firstPixel + static_cast<std::size_t>(y - yMin) * line;
+
+      for (int x = xMin; x <= xMax; ++x, ++currentPixel)
+      {
+        const double value = *currentPixel;
 
-    if (x > xMax)
-    { // reached end of line
-      x = xMin;
-      y++;
+        // every edge between two pixels is visited once, from the pixel on its left or bottom side
+        if (x < xMax)
+        { // y direction - right edge of the pixel
+          const double rightValue = *(currentPixel + 1);
+          addEdge(x + 1, y, x + 1, y + 1, std::min(value, rightValue), std::max(value, rightValue));
+        }
+        else
+        { // draw right edge of the image
+          addEdge(x + 1, y, x + 1, y + 1, outside, value);
+        }
+
+        if (y < yMax)
+        { // x direction - top edge of the pixel
+          const double topValue = *(currentPixel + line);
+          addEdge(x, y + 1, x + 1, y + 1, std::min(value, topValue), std::max(value, topValue));
+        }
+        else
+        { // draw top edge of the image
+          addEdge(x, y + 1, x + 1, y + 1, outside, value);
+        }
+
+        if (x == xMin)
+        { // draw left edge of the image
+          addEdge(x, y, x, y + 1, outside, value);
+        }
+
+        if (y == yMin)
+        { // draw bottom edge of the image
+          addEdge(x, y, x + 1, y, outside, value);
+        }
+      }
     }
+  }
 
-    // Increase the pointer-position to the next pixel.
-    // This is safe, as the while-loop and the x-reset logic above makes
-    // sure we do not exceed the bounds of the image
-    currentPixel++;
-  } // end of while
+  // Create a polydata to store everything in
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  // Add the points to the dataset
+  polyData->SetPoints(points);
+  // Add the lines to the dataset
+  polyData->SetLines(lines);
+  polyData->GetCellData()->SetScalars(colors);
+  return polyData;
 }
 
 void mitk::DoseImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
@@ -1131,6 +1188,8 @@ mitk::DoseImageVtkMapper2D::LocalStorage::LocalStorage()
   m_Reslicer = mitk::ExtractSliceFilter::New();
   m_TSFilter = vtkSmartPointer<vtkMitkThickSlicesFilter>::New();
   m_OutlinePolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_CachedOutlinesMTime = 0;
+  m_CachedOutlinesTimeStep = -1;
   m_ReslicedImage = vtkSmartPointer<vtkImageData>::New();
   m_EmptyPolyData = vtkSmartPointer<vtkPolyData>::New();
 
@@ -0,0 +1,203 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDoseVolumeHistogram.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <algorithm>
+#include <functional>
+
+mitk::DoseVolumeHistogram::DoseVolumeHistogram()
+  : m_BinWidth(1.0), m_MinimumDose(0.0), m_MaximumDose(0.0), m_MeanDose(0.0), m_CumulativeVolumes(1, 0.0)
+{
+}
+
+mitk::DoseVolumeHistogram::~DoseVolumeHistogram()
+{
+}
+
+void mitk::DoseVolumeHistogram::Initialize(DoseValueAbs binWidth,
+                                           const VolumeVectorType &differentialVolumes,
+                                           DoseValueAbs minimumDose,
+                                           DoseValueAbs maximumDose,
+                                           DoseValueAbs meanDose)
+{
+  if (!(binWidth > 0.0))
+  {
+    mitkThrow() << "Cannot initialize dose volume histogram. Bin width must be positive; passed value: " << binWidth;
+  }
+
+  m_BinWidth = binWidth;
+  m_MinimumDose = minimumDose;
+  m_MaximumDose = maximumDose;
+  m_MeanDose = meanDose;
+  m_DifferentialVolumes = differentialVolumes;
+
+  m_CumulativeVolumes.assign(m_DifferentialVolumes.size() + 1, 0.0);
+  for (std::size_t i = m_DifferentialVolumes.size(); i > 0; --i)
+  {
+    m_CumulativeVolumes[i - 1] = m_CumulativeVolumes[i] + m_DifferentialVolumes[i - 1];
+  }
+
+  this->Modified();
+}
+
+const mitk::DoseVolumeHistogram::VolumeVectorType &mitk::DoseVolumeHistogram::GetDifferentialVolumes() const
+{
+  return m_DifferentialVolumes;
+}
+
+mitk::DoseVolumeHistogram::VolumeVectorType mitk::DoseVolumeHistogram::GetCumulativeVolumes() const
+{
+  return VolumeVectorType(m_CumulativeVolumes.begin(), m_CumulativeVolumes.end() - 1);
+}
+
+double mitk::DoseVolumeHistogram::GetTotalVolume() const
+{
+  return m_CumulativeVolumes.front();
+}
+
+double mitk::DoseVolumeHistogram::GetVolumeAtDose(DoseValueAbs dose, bool relativeVolume) const
+{
+  const double totalVolume = this->GetTotalVolume();
+  if (totalVolume <= 0.0)
+  {
+    return 0.0;
+  }
+
+  double volume = 0.0;
+
+  if (dose <= m_MinimumDose)
+  {
+    volume = totalVolume;
+  }
+  else if (dose <= m_MaximumDose)
+  {
+    const double position = std::max(0.0, dose / m_BinWidth);
+    const std::size_t bin = static_cast<std::size_t>(position);
+
+    if (bin < m_DifferentialVolumes.size())
+    {
+      volume = m_CumulativeVolumes[bin] - (position - bin) * m_DifferentialVolumes[bin];
+    }
+  }
+
+  return relativeVolume ? volume / totalVolume * 100.0 : volume;
+}
+
+mitk::DoseValueAbs mitk::DoseVolumeHistogram::GetDoseAtVolume(double volume, bool relativeVolume) const
+{
+  const double totalVolume = this->GetTotalVolume();
+  if (totalVolume <= 0.0)
+  {
+    return 0.0;
+  }
+
+  const double absoluteVolume = relativeVolume ? volume / 100.0 * totalVolume : volume;
+
+  if (absoluteVolume >= totalVolume)
+  {
+    return m_MinimumDose;
+  }
+
+  if (absoluteVolume <= 0.0)
+  {
+    return m_MaximumDose;
+  }
+
+  // the cumulative volumes are descending; search the last bin whose lower boundary is reached by the volume
+  auto upper = std::upper_bound(
+    m_CumulativeVolumes.begin(), m_CumulativeVolumes.end(), absoluteVolume, std::greater<double>());
+  const std::size_t bin = (upper - m_CumulativeVolumes.begin()) - 1;
+
+  DoseValueAbs dose = bin * m_BinWidth;
+  if (m_DifferentialVolumes[bin] > 0.0)
+  {
+    dose += (m_CumulativeVolumes[bin] - absoluteVolume) / m_DifferentialVolumes[bin] * m_BinWidth;
+  }
+
+  return std::min(std::max(dose, m_MinimumDose), m_MaximumDose);
+}
+
+double mitk::DoseVolumeHistogram::GetMetric(const std::string &metric) const
+{
+  if (metric == "Dmin")
+  {
+    return m_MinimumDose;
+  }
+  if (metric == "Dmax")
+  {
+    return m_MaximumDose;
+  }
+  if (metric == "Dmean")
+  {
+    return m_MeanDose;
+  }
+
+  if (metric.size() > 1 && (metric[0] == 'D' || metric[0] == 'V'))
+  {
+    std::size_t end = 0;
+    double value = 0.0;
+
+    try
+    {
+      value = std::stod(metric.substr(1), &end);
+    }
+    catch (const std::exception &)
+    {
+      end = 0;
+    }
+
+    if (end > 0)
+    {
+      const std::string unit = metric.substr(1 + end);
+
+      if (metric[0] == 'D')
+      {
+        if (unit.empty() || unit == "%")
+        {
+          return this->GetDoseAtVolume(value, true);
+        }
+        if (unit == "cc")
+        {
+          return this->GetDoseAtVolume(value, false);
+        }
+      }
+      else
+      {
+        if (unit.empty() || unit == "Gy")
+        {
+          return this->GetVolumeAtDose(value, true);
+        }
+        if (unit == "cc" || unit == "Gycc")
+        {
+          return this->GetVolumeAtDose(value, false);
+        }
+      }
+    }
+  }
+
+  mitkThrow() << "Unsupported dose volume histogram metric: " << metric;
+}
+
+void mitk::DoseVolumeHistogram::PrintSelf(std::ostream &os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "StructureName: " << m_StructureName << std::endl;
+  os << indent << "BinWidth: " << m_BinWidth << std::endl;
+  os << indent << "NumberOfBins: " << m_DifferentialVolumes.size() << std::endl;
+  os << indent << "TotalVolume: " << this->GetTotalVolume() << std::endl;
+  os << indent << "MinimumDose: " << m_MinimumDose << std::endl;
+  os << indent << "MaximumDose: " << m_MaximumDose << std::endl;
+  os << indent << "MeanDose: " << m_MeanDose << std::endl;
+}
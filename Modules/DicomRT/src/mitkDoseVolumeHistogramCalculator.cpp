@@ -0,0 +1,419 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDoseVolumeHistogramCalculator.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // contours whose planes are closer than this (in voxels of the dose image) belong to the same contour slice
+  const double CONTOUR_SLICE_TOLERANCE = 0.01;
+
+  /** Closed polygon in continuous indices of the dose image */
+  struct Polygon
+  {
+    std::vector<double> X;
+    std::vector<double> Y;
+    double Z;
+  };
+
+  /** Contours of a structure in one plane and the dose voxels of a slice they may cover */
+  struct ContourSlice
+  {
+    std::vector<Polygon> Polygons;
+    int Region[4]; // x0, x1, y0, y1
+  };
+
+  /** Contour slice overlapping a dose slice, weighted by the fraction of the dose slice it covers */
+  struct SliceOverlap
+  {
+    std::size_t ContourSlice;
+    double Weight;
+  };
+
+  struct PreparedStructure
+  {
+    std::vector<ContourSlice> ContourSlices;
+    std::vector<std::vector<SliceOverlap>> OverlapsOfDoseSlice;
+  };
+
+  struct StructureAccumulator
+  {
+    std::vector<double> Volumes;
+    double Volume = 0.0;
+    double DoseVolume = 0.0;
+    double MinimumDose = std::numeric_limits<double>::max();
+    double MaximumDose = std::numeric_limits<double>::lowest();
+  };
+
+  struct ThreadAccumulator
+  {
+    std::vector<StructureAccumulator> Structures;
+    std::vector<unsigned short> Counts;
+    std::vector<double> Crossings;
+  };
+
+  PreparedStructure PrepareStructure(const mitk::ContourModelSet *contourSet,
+                                     const mitk::BaseGeometry *geometry,
+                                     const int dimensions[3])
+  {
+    PreparedStructure structure;
+    structure.OverlapsOfDoseSlice.resize(dimensions[2]);
+
+    std::vector<Polygon> polygons;
+    for (int i = 0; i < contourSet->GetSize(); ++i)
+    {
+      const mitk::ContourModel *contour = contourSet->GetContourModelAt(i);
+      const int numberOfVertices = contour != nullptr ? contour->GetNumberOfVertices() : 0;
+
+      if (numberOfVertices < 3)
+        continue;
+
+      Polygon polygon;
+      polygon.Z = 0.0;
+      for (int vertex = 0; vertex < numberOfVertices; ++vertex)
+      {
+        mitk::Point3D index;
+        geometry->WorldToIndex(contour->GetVertexAt(vertex)->Coordinates, index);
+        polygon.X.push_back(index[0]);
+        polygon.Y.push_back(index[1]);
+        polygon.Z += index[2];
+      }
+      polygon.Z /= numberOfVertices;
+
+      polygons.push_back(std::move(polygon));
+    }
+
+    if (polygons.empty())
+      return structure;
+
+    std::sort(polygons.begin(), polygons.end(), [](const Polygon &a, const Polygon &b) { return a.Z < b.Z; });
+
+    std::vector<double> sliceZ;
+    for (auto &polygon : polygons)
+    {
+      if (sliceZ.empty() || polygon.Z - sliceZ.back() > CONTOUR_SLICE_TOLERANCE)
+      {
+        sliceZ.push_back(polygon.Z);
+        structure.ContourSlices.emplace_back();
+      }
+      structure.ContourSlices.back().Polygons.push_back(std::move(polygon));
+    }
+
+    // every contour slice represents a slab of the distance between neighbouring contour slices
+    double thickness = 1.0;
+    if (sliceZ.size() > 1)
+    {
+      thickness = std::numeric_limits<double>::max();
+      for (std::size_t i = 1; i < sliceZ.size(); ++i)
+        thickness = std::min(thickness, sliceZ[i] - sliceZ[i - 1]);
+    }
+
+    for (std::size_t i = 0; i < structure.ContourSlices.size(); ++i)
+    {
+      ContourSlice &contourSlice = structure.ContourSlices[i];
+
+      double bounds[4] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+                          std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+      for (const auto &polygon : contourSlice.Polygons)
+      {
+        const auto x = std::minmax_element(polygon.X.begin(), polygon.X.end());
+        const auto y = std::minmax_element(polygon.Y.begin(), polygon.Y.end());
+        bounds[0] = std::min(bounds[0], *x.first);
+        bounds[1] = std::max(bounds[1], *x.second);
+        bounds[2] = std::min(bounds[2], *y.first);
+        bounds[3] = std::max(bounds[3], *y.second);
+      }
+
+      // voxel v covers the continuous indices [v-0.5, v+0.5)
+      contourSlice.Region[0] = std::max(0, static_cast<int>(std::floor(bounds[0] + 0.5)));
+      contourSlice.Region[1] = std::min(dimensions[0] - 1, static_cast<int>(std::floor(bounds[1] + 0.5)));
+      contourSlice.Region[2] = std::max(0, static_cast<int>(std::floor(bounds[2] + 0.5)));
+      contourSlice.Region[3] = std::min(dimensions[1] - 1, static_cast<int>(std::floor(bounds[3] + 0.5)));
+
+      if (contourSlice.Region[0] > contourSlice.Region[1] || contourSlice.Region[2] > contourSlice.Region[3])
+        continue;
+
+      const double slabBegin = sliceZ[i] - 0.5 * thickness;
+      const double slabEnd = sliceZ[i] + 0.5 * thickness;
+      const int firstDoseSlice = std::max(0, static_cast<int>(std::floor(slabBegin + 0.5)));
+      const int lastDoseSlice = std::min(dimensions[2] - 1, static_cast<int>(std::floor(slabEnd + 0.5)));
+
+      for (int doseSlice = firstDoseSlice; doseSlice <= lastDoseSlice; ++doseSlice)
+      {
+        const double overlap = std::min(slabEnd, doseSlice + 0.5) - std::max(slabBegin, doseSlice - 0.5);
+        if (overlap > 0.0)
+          structure.OverlapsOfDoseSlice[doseSlice].push_back({i, overlap});
+      }
+    }
+
+    return structure;
+  }
+
+  /** Counts for each voxel of the region of the contour slice the samples inside of the polygons (even-odd rule).
+   * The samples lie on a regular grid of factor x factor samples per voxel. */
+  void RasterizeContourSlice(const ContourSlice &contourSlice,
+                             int factor,
+                             std::vector<unsigned short> &counts,
+                             std::vector<double> &crossings)
+  {
+    const int *region = contourSlice.Region;
+    const int width = region[1] - region[0] + 1;
+    const int height = region[3] - region[2] + 1;
+    const int firstColumn = region[0] * factor;
+    const int endColumn = (region[1] + 1) * factor;
+
+    counts.assign(static_cast<std::size_t>(width) * height, 0);
+
+    for (int row = region[2] * factor; row < (region[3] + 1) * factor; ++row)
+    {
+      const double y = (row + 0.5) / factor - 0.5;
+
+      crossings.clear();
+      for (const auto &polygon : contourSlice.Polygons)
+      {
+        const std::size_t numberOfVertices = polygon.X.size();
+        for (std::size_t i = 0, j = numberOfVertices - 1; i < numberOfVertices; j = i++)
+        {
+          // half open, so that a vertex on the row is counted once
+          if ((polygon.Y[i] <= y) != (polygon.Y[j] <= y))
+          {
+            crossings.push_back(polygon.X[i] +
+                                (y - polygon.Y[i]) * (polygon.X[j] - polygon.X[i]) / (polygon.Y[j] - polygon.Y[i]));
+          }
+        }
+      }
+
+      if (crossings.size() < 2)
+        continue;
+
+      std::sort(crossings.begin(), crossings.end());
+
+      unsigned short *countsOfRow = &counts[static_cast<std::size_t>(row / factor - region[2]) * width];
+
+      for (std::size_t i = 0; i + 1 < crossings.size(); i += 2)
+      {
+        // columns whose samples lie in [crossings[i], crossings[i+1])
+        const int begin = std::max(firstColumn, static_cast<int>(std::ceil((crossings[i] + 0.5) * factor - 0.5)));
+        const int end = std::min(endColumn, static_cast<int>(std::ceil((crossings[i + 1] + 0.5) * factor - 0.5)));
+
+        for (int column = begin; column < end;)
+        {
+          const int voxel = column / factor;
+          const int voxelEnd = std::min(end, (voxel + 1) * factor);
+          countsOfRow[voxel - region[0]] += static_cast<unsigned short>(voxelEnd - column);
+          column = voxelEnd;
+        }
+      }
+    }
+  }
+}
+
+mitk::DoseVolumeHistogramCalculator::DoseVolumeHistogramCalculator()
+  : m_BinWidth(0.01), m_SubsamplingFactor(8), m_NumberOfThreads(0)
+{
+}
+
+mitk::DoseVolumeHistogramCalculator::~DoseVolumeHistogramCalculator()
+{
+}
+
+void mitk::DoseVolumeHistogramCalculator::AddStructure(const ContourModelSet *structure, const std::string &name)
+{
+  if (structure == nullptr)
+  {
+    mitkThrow() << "Cannot add structure. Passed structure is null.";
+  }
+
+  Structure entry;
+  entry.ContourSet = structure;
+  entry.Name = name;
+
+  if (entry.Name.empty() && structure->GetProperty("name").IsNotNull())
+  {
+    entry.Name = structure->GetProperty("name")->GetValueAsString();
+  }
+
+  m_Structures.push_back(entry);
+  this->Modified();
+}
+
+void mitk::DoseVolumeHistogramCalculator::ClearStructures()
+{
+  m_Structures.clear();
+  m_Histograms.clear();
+  this->Modified();
+}
+
+std::size_t mitk::DoseVolumeHistogramCalculator::GetNumberOfStructures() const
+{
+  return m_Structures.size();
+}
+
+void mitk::DoseVolumeHistogramCalculator::Compute()
+{
+  if (m_DoseImage.IsNull())
+  {
+    mitkThrow() << "Cannot compute dose volume histograms. No dose image is set.";
+  }
+
+  if (m_DoseImage->GetDimension() != 3)
+  {
+    mitkThrow() << "Cannot compute dose volume histograms. Dose image must be 3D; dimension of passed image: "
+                << m_DoseImage->GetDimension();
+  }
+
+  if (!(m_BinWidth > 0.0))
+  {
+    mitkThrow() << "Cannot compute dose volume histograms. Bin width must be positive; set value: " << m_BinWidth;
+  }
+
+  AccessFixedDimensionByItk(m_DoseImage.GetPointer(), ComputeInternal, 3);
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void mitk::DoseVolumeHistogramCalculator::ComputeInternal(const itk::Image<TPixel, VImageDimension> *doseImage)
+{
+  const auto size = doseImage->GetLargestPossibleRegion().GetSize();
+  const int dimensions[3] = {static_cast<int>(size[0]), static_cast<int>(size[1]), static_cast<int>(size[2])};
+  const std::size_t sliceSize = static_cast<std::size_t>(dimensions[0]) * dimensions[1];
+  const TPixel *dose = doseImage->GetBufferPointer();
+
+  const BaseGeometry *geometry = m_DoseImage->GetGeometry();
+  const Vector3D spacing = geometry->GetSpacing();
+  // volume of a voxel in cm^3
+  const double voxelVolume = spacing[0] * spacing[1] * spacing[2] / 1000.0;
+
+  std::vector<PreparedStructure> structures;
+  for (const auto &structure : m_Structures)
+  {
+    structures.push_back(PrepareStructure(structure.ContourSet, geometry, dimensions));
+  }
+
+  const unsigned int numberOfThreads = mitk::GetParallelForNumberOfThreads(dimensions[2], m_NumberOfThreads);
+
+  std::vector<ThreadAccumulator> accumulators(numberOfThreads);
+  for (auto &accumulator : accumulators)
+  {
+    accumulator.Structures.resize(structures.size());
+  }
+
+  const int factor = static_cast<int>(m_SubsamplingFactor);
+  const double sampleVolume = voxelVolume / (factor * factor);
+  const double inverseBinWidth = 1.0 / m_BinWidth;
+
+  mitk::ParallelFor(dimensions[2], numberOfThreads, [&](std::size_t doseSlice, unsigned int thread) {
+    ThreadAccumulator &accumulator = accumulators[thread];
+    const TPixel *sliceDose = dose + doseSlice * sliceSize;
+
+    for (std::size_t i = 0; i < structures.size(); ++i)
+    {
+      StructureAccumulator &structureAccumulator = accumulator.Structures[i];
+
+      for (const auto &overlap : structures[i].OverlapsOfDoseSlice[doseSlice])
+      {
+        const ContourSlice &contourSlice = structures[i].ContourSlices[overlap.ContourSlice];
+        RasterizeContourSlice(contourSlice, factor, accumulator.Counts, accumulator.Crossings);
+
+        const int *region = contourSlice.Region;
+        const double volumePerSample = overlap.Weight * sampleVolume;
+        const unsigned short *count = accumulator.Counts.data();
+
+        for (int y = region[2]; y <= region[3]; ++y)
+        {
+          for (int x = region[0]; x <= region[1]; ++x, ++count)
+          {
+            if (0 == *count)
+              continue;
+
+            const double doseValue = static_cast<double>(sliceDose[static_cast<std::size_t>(y) * dimensions[0] + x]);
+            if (std::isnan(doseValue))
+              continue;
+
+            const double volume = *count * volumePerSample;
+            const std::size_t bin = doseValue > 0.0 ? static_cast<std::size_t>(doseValue * inverseBinWidth) : 0;
+
+            if (bin >= structureAccumulator.Volumes.size())
+              structureAccumulator.Volumes.resize(bin + 1, 0.0);
+
+            structureAccumulator.Volumes[bin] += volume;
+            structureAccumulator.Volume += volume;
+            structureAccumulator.DoseVolume += volume * doseValue;
+            structureAccumulator.MinimumDose = std::min(structureAccumulator.MinimumDose, doseValue);
+            structureAccumulator.MaximumDose = std::max(structureAccumulator.MaximumDose, doseValue);
+          }
+        }
+      }
+    }
+  });
+
+  m_Histograms.clear();
+
+  for (std::size_t i = 0; i < structures.size(); ++i)
+  {
+    StructureAccumulator merged;
+
+    for (const auto &accumulator : accumulators)
+    {
+      const StructureAccumulator &structureAccumulator = accumulator.Structures[i];
+
+      if (structureAccumulator.Volumes.size() > merged.Volumes.size())
+        merged.Volumes.resize(structureAccumulator.Volumes.size(), 0.0);
+
+      for (std::size_t bin = 0; bin < structureAccumulator.Volumes.size(); ++bin)
+        merged.Volumes[bin] += structureAccumulator.Volumes[bin];
+
+      merged.Volume += structureAccumulator.Volume;
+      merged.DoseVolume += structureAccumulator.DoseVolume;
+      merged.MinimumDose = std::min(merged.MinimumDose, structureAccumulator.MinimumDose);
+      merged.MaximumDose = std::max(merged.MaximumDose, structureAccumulator.MaximumDose);
+    }
+
+    DoseVolumeHistogram::Pointer histogram = DoseVolumeHistogram::New();
+    histogram->SetStructureName(m_Structures[i].Name);
+
+    if (merged.Volume > 0.0)
+    {
+      histogram->Initialize(
+        m_BinWidth, merged.Volumes, merged.MinimumDose, merged.MaximumDose, merged.DoseVolume / merged.Volume);
+    }
+    else
+    {
+      histogram->Initialize(m_BinWidth, DoseVolumeHistogram::VolumeVectorType(), 0.0, 0.0, 0.0);
+    }
+
+    m_Histograms.push_back(histogram);
+  }
+}
+
+const mitk::DoseVolumeHistogramCalculator::HistogramVectorType &mitk::DoseVolumeHistogramCalculator::GetHistograms()
+  const
+{
+  return m_Histograms;
+}
+
+mitk::DoseVolumeHistogram *mitk::DoseVolumeHistogramCalculator::GetHistogram(std::size_t index) const
+{
+  if (index >= m_Histograms.size())
+  {
+    mitkThrow() << "Cannot get dose volume histogram. Invalid index: " << index;
+  }
+
+  return m_Histograms[index];
+}
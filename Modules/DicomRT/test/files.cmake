@@ -2,4 +2,11 @@ SET(MODULE_TESTS
   mitkRTStructureSetReaderServiceTest.cpp
   mitkRTDoseReaderServiceTest.cpp
   mitkRTPlanReaderServiceTest.cpp
+  mitkDoseVolumeHistogramCalculatorTest.cpp
+  mitkDoseImageVtkMapper2DTest.cpp
+)
+
+# not run by ctest, the benchmark takes some time and only reports timings
+set(MODULE_CUSTOM_TESTS
+  mitkDoseVolumeHistogramCalculatorBenchmarkTest.cpp
 )
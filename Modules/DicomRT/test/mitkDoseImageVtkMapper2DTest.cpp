@@ -0,0 +1,341 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// MITK
+#include <mitkDoseImageVtkMapper2D.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkIsoDoseLevelCollections.h>
+#include <mitkIsoDoseLevelVectorProperty.h>
+#include <mitkRTConstants.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// VTK
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
+
+// std
+#include <array>
+#include <cmath>
+#include <limits>
+#include <set>
+
+namespace
+{
+  /** Gives the test access to the outline cache of the mapper */
+  class TestDoseImageVtkMapper2D : public mitk::DoseImageVtkMapper2D
+  {
+  public:
+    mitkClassMacro(TestDoseImageVtkMapper2D, mitk::DoseImageVtkMapper2D);
+    itkFactorylessNewMacro(Self);
+
+    using Superclass::GetOutlinePolyData;
+  };
+
+  /** Edge between two pixel corners (x1, y1, x2, y2) with the color (r, g, b) of its iso line */
+  typedef std::array<int, 7> Edge;
+  typedef std::multiset<Edge> EdgeSet;
+
+  Edge MakeEdge(int x1, int y1, int x2, int y2, const unsigned char color[3])
+  {
+    if (x2 < x1 || (x2 == x1 && y2 < y1))
+    {
+      std::swap(x1, x2);
+      std::swap(y1, y2);
+    }
+    return {{x1, y1, x2, y2, color[0], color[1], color[2]}};
+  }
+}
+
+class mitkDoseImageVtkMapper2DTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDoseImageVtkMapper2DTestSuite);
+  MITK_TEST(Render_Outline_MatchesIsoLevelCriterion);
+  MITK_TEST(GetOutlinePolyData_Unchanged_ReusesOutline);
+  MITK_TEST(GetOutlinePolyData_IsoLevelHidden_DropsOutline);
+  MITK_TEST(GetOutlinePolyData_IsoLevelValueChanged_DropsOutline);
+  MITK_TEST(GetOutlinePolyData_ReferenceDoseChanged_DropsOutline);
+  MITK_TEST(GetOutlinePolyData_PropertyChanged_DropsOutline);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  const float m_ReferenceDose = 10.0f;
+
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::Image::Pointer m_Image;
+  mitk::DataNode::Pointer m_Node;
+  TestDoseImageVtkMapper2D::Pointer m_Mapper;
+  mitk::IsoDoseLevel::Pointer m_LowLevel;
+  mitk::IsoDoseLevel::Pointer m_HighLevel;
+
+  mitk::BaseRenderer *GetRenderer()
+  {
+    return mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  }
+
+  static void GetColor(const mitk::IsoDoseLevel *level, unsigned char color[3])
+  {
+    const mitk::IsoDoseLevel::ColorType levelColor = level->GetColor();
+    color[0] = static_cast<unsigned char>(levelColor.GetRed() * 255);
+    color[1] = static_cast<unsigned char>(levelColor.GetGreen() * 255);
+    color[2] = static_cast<unsigned char>(levelColor.GetBlue() * 255);
+  }
+
+  /** Edges of the outline, with the corners in index coordinates of the resliced image */
+  EdgeSet GetEdges(vtkPolyData *outline)
+  {
+    const mitk::ScalarType *mmPerPixel = m_Mapper->GetLocalStorage(this->GetRenderer())->m_mmPerPixel;
+    vtkDataArray *colors = outline->GetCellData()->GetScalars();
+    CPPUNIT_ASSERT(outline->GetNumberOfCells() == 0 || colors != nullptr);
+
+    EdgeSet edges;
+    vtkSmartPointer<vtkIdList> pointIds = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType cell = 0; cell < outline->GetNumberOfCells(); ++cell)
+    {
+      outline->GetCellPoints(cell, pointIds);
+      CPPUNIT_ASSERT_EQUAL(static_cast<vtkIdType>(2), pointIds->GetNumberOfIds());
+
+      int corners[2][2];
+      for (int i = 0; i < 2; ++i)
+      {
+        const double *point = outline->GetPoint(pointIds->GetId(i));
+        corners[i][0] = static_cast<int>(std::lround(point[0] / mmPerPixel[0]));
+        corners[i][1] = static_cast<int>(std::lround(point[1] / mmPerPixel[1]));
+      }
+
+      unsigned char color[3];
+      for (int i = 0; i < 3; ++i)
+        color[i] = static_cast<unsigned char>(colors->GetComponent(cell, i));
+
+      edges.insert(MakeEdge(corners[0][0], corners[0][1], corners[1][0], corners[1][1], color));
+    }
+    return edges;
+  }
+
+  /** Edges between a pixel and its neighbour (or the outside of the slice) for every visible level that the
+   * pixel reaches and the neighbour does not. Edges next to NaN pixels are not drawn. */
+  EdgeSet GetExpectedEdges(float referenceDose)
+  {
+    std::vector<const mitk::IsoDoseLevel *> levels;
+    for (const mitk::IsoDoseLevel *level : {m_LowLevel.GetPointer(), m_HighLevel.GetPointer()})
+    {
+      if (level->GetVisibleIsoLine())
+        levels.push_back(level);
+    }
+
+    vtkImageData *slice = m_Mapper->GetLocalStorage(this->GetRenderer())->m_ReslicedImage;
+    int extent[6];
+    slice->GetExtent(extent);
+
+    const double outside = -std::numeric_limits<double>::infinity();
+    auto getValue = [&](int x, int y) {
+      if (x < extent[0] || x > extent[1] || y < extent[2] || y > extent[3])
+        return outside;
+      return slice->GetScalarComponentAsDouble(x, y, extent[4], 0);
+    };
+
+    EdgeSet edges;
+    auto addEdges = [&](int x1, int y1, int x2, int y2, double pixel, double neighbour) {
+      if (std::isnan(pixel) || std::isnan(neighbour))
+        return;
+
+      for (const mitk::IsoDoseLevel *level : levels)
+      {
+        const double doseValue = level->GetDoseValue() * referenceDose;
+        if ((pixel >= doseValue && neighbour < doseValue) || (neighbour >= doseValue && pixel < doseValue))
+        {
+          unsigned char color[3];
+          GetColor(level, color);
+          edges.insert(MakeEdge(x1, y1, x2, y2, color));
+        }
+      }
+    };
+
+    for (int y = extent[2]; y <= extent[3]; ++y)
+    {
+      for (int x = extent[0]; x <= extent[1]; ++x)
+      {
+        const double value = getValue(x, y);
+
+        // the right and the top edge of every pixel, and the left and bottom edges of the slice
+        addEdges(x + 1, y, x + 1, y + 1, value, getValue(x + 1, y));
+        addEdges(x, y + 1, x + 1, y + 1, value, getValue(x, y + 1));
+        if (x == extent[0])
+          addEdges(x, y, x, y + 1, value, outside);
+        if (y == extent[2])
+          addEdges(x, y, x + 1, y, value, outside);
+      }
+    }
+    return edges;
+  }
+
+  void AssertOutlineMatchesIsoLevelCriterion(vtkPolyData *outline, float referenceDose)
+  {
+    const EdgeSet expected = this->GetExpectedEdges(referenceDose);
+    CPPUNIT_ASSERT(!expected.empty());
+    CPPUNIT_ASSERT(expected == this->GetEdges(outline));
+  }
+
+public:
+  mitkDoseImageVtkMapper2DTestSuite() : m_RenderingTestHelper(300, 300) {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(300, 300);
+
+    // the dose of a voxel is x + y Gy, with invalid voxels inside and at the border of the image
+    unsigned int dimensions[3] = {8, 6, 3};
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+    {
+      mitk::ImagePixelWriteAccessor<float, 3> accessor(m_Image);
+      itk::Index<3> index;
+      for (index[2] = 0; index[2] < 3; ++index[2])
+        for (index[1] = 0; index[1] < 6; ++index[1])
+          for (index[0] = 0; index[0] < 8; ++index[0])
+            accessor.SetPixelByIndex(index, static_cast<float>(index[0] + index[1]));
+
+      for (index[2] = 0; index[2] < 3; ++index[2])
+      {
+        index[0] = 3;
+        index[1] = 2;
+        accessor.SetPixelByIndex(index, std::numeric_limits<float>::quiet_NaN());
+        index[0] = 7;
+        index[1] = 4;
+        accessor.SetPixelByIndex(index, std::numeric_limits<float>::quiet_NaN());
+      }
+    }
+
+    mitk::IsoDoseLevel::ColorType red;
+    red.Set(1.0f, 0.0f, 0.0f);
+    mitk::IsoDoseLevel::ColorType blue;
+    blue.Set(0.0f, 0.0f, 1.0f);
+    m_LowLevel = mitk::IsoDoseLevel::New(0.4, red, true, false);
+    m_HighLevel = mitk::IsoDoseLevel::New(0.7, blue, true, false);
+
+    mitk::IsoDoseLevelVector::Pointer levels = mitk::IsoDoseLevelVector::New();
+    levels->InsertElement(0, m_LowLevel);
+    levels->InsertElement(1, m_HighLevel);
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_Image);
+    m_Mapper = TestDoseImageVtkMapper2D::New();
+    m_Node->SetMapper(mitk::BaseRenderer::Standard2D, m_Mapper);
+    mitk::DoseImageVtkMapper2D::SetDefaultProperties(m_Node);
+    m_Node->SetBoolProperty("dose.showIsoLines", true);
+    m_Node->SetFloatProperty(mitk::RTConstants::REFERENCE_DOSE_PROPERTY_NAME.c_str(), m_ReferenceDose);
+    m_Node->SetProperty(mitk::RTConstants::DOSE_FREE_ISO_VALUES_PROPERTY_NAME.c_str(),
+                        mitk::IsoDoseLevelVectorProperty::New(levels));
+
+    m_RenderingTestHelper.AddNodeToStorage(m_Node);
+    m_RenderingTestHelper.Render();
+  }
+
+  void tearDown() override
+  {
+    m_LowLevel = nullptr;
+    m_HighLevel = nullptr;
+    m_Mapper = nullptr;
+    m_Node = nullptr;
+    m_Image = nullptr;
+  }
+
+  void Render_Outline_MatchesIsoLevelCriterion()
+  {
+    // make sure that the slice covers the invalid voxels
+    vtkImageData *slice = m_Mapper->GetLocalStorage(this->GetRenderer())->m_ReslicedImage;
+    int extent[6];
+    slice->GetExtent(extent);
+    unsigned int numberOfInvalidPixels = 0;
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      for (int x = extent[0]; x <= extent[1]; ++x)
+        numberOfInvalidPixels += std::isnan(slice->GetScalarComponentAsDouble(x, y, extent[4], 0));
+    CPPUNIT_ASSERT_EQUAL(2u, numberOfInvalidPixels);
+
+    vtkPolyData *outline = m_Mapper->GetLocalStorage(this->GetRenderer())->m_OutlinePolyData;
+    this->AssertOutlineMatchesIsoLevelCriterion(outline, m_ReferenceDose);
+
+    // both levels are outlined
+    unsigned char lowColor[3];
+    GetColor(m_LowLevel, lowColor);
+    unsigned char highColor[3];
+    GetColor(m_HighLevel, highColor);
+    unsigned int numberOfLowEdges = 0;
+    unsigned int numberOfHighEdges = 0;
+    for (const Edge &edge : this->GetEdges(outline))
+    {
+      numberOfLowEdges += std::equal(lowColor, lowColor + 3, edge.begin() + 4);
+      numberOfHighEdges += std::equal(highColor, highColor + 3, edge.begin() + 4);
+    }
+    CPPUNIT_ASSERT(numberOfLowEdges > 0);
+    CPPUNIT_ASSERT(numberOfHighEdges > 0);
+  }
+
+  void GetOutlinePolyData_Unchanged_ReusesOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+    CPPUNIT_ASSERT(outline.GetPointer() == m_Mapper->GetLocalStorage(this->GetRenderer())->m_OutlinePolyData);
+    CPPUNIT_ASSERT(outline == m_Mapper->GetOutlinePolyData(this->GetRenderer()));
+  }
+
+  void GetOutlinePolyData_IsoLevelHidden_DropsOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    m_HighLevel->SetVisibleIsoLine(false);
+    vtkSmartPointer<vtkPolyData> newOutline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    CPPUNIT_ASSERT(outline != newOutline);
+    CPPUNIT_ASSERT(outline->GetNumberOfCells() > newOutline->GetNumberOfCells());
+    this->AssertOutlineMatchesIsoLevelCriterion(newOutline, m_ReferenceDose);
+  }
+
+  void GetOutlinePolyData_IsoLevelValueChanged_DropsOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    m_LowLevel->SetDoseValue(0.2);
+    vtkSmartPointer<vtkPolyData> newOutline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    CPPUNIT_ASSERT(outline != newOutline);
+    this->AssertOutlineMatchesIsoLevelCriterion(newOutline, m_ReferenceDose);
+  }
+
+  void GetOutlinePolyData_ReferenceDoseChanged_DropsOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    m_Node->SetFloatProperty(mitk::RTConstants::REFERENCE_DOSE_PROPERTY_NAME.c_str(), 15.0f);
+    vtkSmartPointer<vtkPolyData> newOutline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    CPPUNIT_ASSERT(outline != newOutline);
+    this->AssertOutlineMatchesIsoLevelCriterion(newOutline, 15.0f);
+  }
+
+  void GetOutlinePolyData_PropertyChanged_DropsOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    // any property may change the reslicing, e.g. the reslice interpolation
+    m_Node->SetOpacity(0.5);
+    vtkSmartPointer<vtkPolyData> newOutline = m_Mapper->GetOutlinePolyData(this->GetRenderer());
+
+    CPPUNIT_ASSERT(outline != newOutline);
+    CPPUNIT_ASSERT(this->GetEdges(outline) == this->GetEdges(newOutline));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDoseImageVtkMapper2D)
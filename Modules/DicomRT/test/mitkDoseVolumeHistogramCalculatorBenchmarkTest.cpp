@@ -0,0 +1,120 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkDoseVolumeHistogramCalculator.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <itkMath.h>
+
+#include <chrono>
+#include <cmath>
+
+/** Measures the DVH calculation of many structures on a large dose grid. It is not part of the regular tests,
+ * run it with the test driver of the module: MitkDicomRTTestDriver mitkDoseVolumeHistogramCalculatorBenchmarkTest */
+class mitkDoseVolumeHistogramCalculatorBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDoseVolumeHistogramCalculatorBenchmarkTestSuite);
+  MITK_TEST(Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  const double m_Spacing = 3.0;
+
+  mitk::Image::Pointer m_DoseImage;
+
+public:
+  void setUp() override
+  {
+    // 3 mm dose grid covering 51 cm x 51 cm x 30 cm, the dose of a voxel is its x index in Gy
+    unsigned int dimensions[3] = {170, 170, 100};
+
+    m_DoseImage = mitk::Image::New();
+    m_DoseImage->Initialize(mitk::MakeScalarPixelType<double>(), 3, dimensions);
+
+    mitk::Vector3D spacing;
+    spacing.Fill(m_Spacing);
+    m_DoseImage->SetSpacing(spacing);
+
+    mitk::ImageWriteAccessor accessor(m_DoseImage);
+    double *buffer = static_cast<double *>(accessor.GetData());
+    for (unsigned int z = 0; z < dimensions[2]; ++z)
+      for (unsigned int y = 0; y < dimensions[1]; ++y)
+        for (unsigned int x = 0; x < dimensions[0]; ++x)
+          *(buffer++) = x;
+  }
+
+  void tearDown() override
+  {
+    m_DoseImage = nullptr;
+  }
+
+  void Benchmark()
+  {
+    mitk::DoseVolumeHistogramCalculator::Pointer calculator = mitk::DoseVolumeHistogramCalculator::New();
+    calculator->SetDoseImage(m_DoseImage);
+
+    // 50 spheres of 15 - 40 mm radius, contoured on every dose slice
+    std::vector<double> radii;
+    for (int i = 0; i < 50; ++i)
+    {
+      const double radius = (15.0 + (i % 6) * 5.0) / m_Spacing;
+      const double center[3] = {20.0 + (i % 10) * 14.0, 20.0 + (i / 10) * 30.0, 20.0 + (i % 7) * 10.0};
+
+      mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+      for (int z = static_cast<int>(std::ceil(center[2] - radius)); z < center[2] + radius; ++z)
+      {
+        const double sliceRadius = std::sqrt(radius * radius - (z - center[2]) * (z - center[2]));
+
+        mitk::ContourModel::Pointer contour = mitk::ContourModel::New();
+        for (int vertex = 0; vertex < 64; ++vertex)
+        {
+          const double angle = vertex * 2.0 * itk::Math::pi / 64;
+          mitk::Point3D point;
+          point[0] = (center[0] + sliceRadius * std::cos(angle)) * m_Spacing;
+          point[1] = (center[1] + sliceRadius * std::sin(angle)) * m_Spacing;
+          point[2] = z * m_Spacing;
+          contour->AddVertex(point);
+        }
+        contour->Close();
+        structure->AddContourModel(contour);
+      }
+
+      calculator->AddStructure(structure);
+      radii.push_back(radius * m_Spacing);
+    }
+
+    for (unsigned int numberOfThreads : {1u, 0u})
+    {
+      calculator->SetNumberOfThreads(numberOfThreads);
+
+      const auto start = std::chrono::steady_clock::now();
+      calculator->Compute();
+      const auto duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+      MITK_INFO << "DVHs of 50 structures on a 170x170x100 dose grid with "
+                << (numberOfThreads == 0 ? std::string("the default number of") : std::to_string(numberOfThreads))
+                << " thread(s): " << duration.count() << " ms";
+    }
+
+    for (std::size_t i = 0; i < radii.size(); ++i)
+    {
+      const double sphereVolume = 4.0 / 3.0 * itk::Math::pi * radii[i] * radii[i] * radii[i] / 1000.0;
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(sphereVolume, calculator->GetHistogram(i)->GetTotalVolume(), 0.05 * sphereVolume);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDoseVolumeHistogramCalculatorBenchmark)
@@ -0,0 +1,233 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkDoseVolumeHistogramCalculator.h>
+#include <mitkImageWriteAccessor.h>
+
+class mitkDoseVolumeHistogramCalculatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDoseVolumeHistogramCalculatorTestSuite);
+  MITK_TEST(TestVoxelAlignedStructure);
+  MITK_TEST(TestFractionalCoverage);
+  MITK_TEST(TestThroughPlaneCoverage);
+  MITK_TEST(TestHole);
+  MITK_TEST(TestMetrics);
+  MITK_TEST(TestMultiThreading);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  const double m_Spacing = 3.0;
+  // volume of a voxel in cm^3
+  const double m_VoxelVolume = 0.027;
+
+  mitk::Image::Pointer m_DoseImage;
+
+  /** dose image with 3 mm voxels, the dose of a voxel is its x index in Gy */
+  mitk::Image::Pointer CreateDoseImage(unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ)
+  {
+    unsigned int dimensions[3] = {sizeX, sizeY, sizeZ};
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<double>(), 3, dimensions);
+
+    mitk::Vector3D spacing;
+    spacing.Fill(m_Spacing);
+    image->SetSpacing(spacing);
+
+    mitk::ImageWriteAccessor accessor(image);
+    double *buffer = static_cast<double *>(accessor.GetData());
+    for (unsigned int z = 0; z < sizeZ; ++z)
+      for (unsigned int y = 0; y < sizeY; ++y)
+        for (unsigned int x = 0; x < sizeX; ++x)
+          *(buffer++) = x;
+
+    return image;
+  }
+
+  /** adds a polygon given in continuous indices of the dose image */
+  void AddPolygon(mitk::ContourModelSet *structure, const std::vector<std::pair<double, double>> &indices, double z)
+  {
+    mitk::ContourModel::Pointer contour = mitk::ContourModel::New();
+    for (const auto &index : indices)
+    {
+      mitk::Point3D point;
+      point[0] = index.first * m_Spacing;
+      point[1] = index.second * m_Spacing;
+      point[2] = z * m_Spacing;
+      contour->AddVertex(point);
+    }
+    contour->Close();
+    structure->AddContourModel(contour);
+  }
+
+  void AddRectangle(mitk::ContourModelSet *structure, double x0, double x1, double y0, double y1, double z)
+  {
+    this->AddPolygon(structure, {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}}, z);
+  }
+
+  mitk::DoseVolumeHistogram::Pointer Compute(const mitk::ContourModelSet *structure, double binWidth = 0.5)
+  {
+    mitk::DoseVolumeHistogramCalculator::Pointer calculator = mitk::DoseVolumeHistogramCalculator::New();
+    calculator->SetDoseImage(m_DoseImage);
+    calculator->SetBinWidth(binWidth);
+    calculator->AddStructure(structure, "test");
+    calculator->Compute();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), calculator->GetHistograms().size());
+    return calculator->GetHistogram(0);
+  }
+
+public:
+  void setUp() override { m_DoseImage = this->CreateDoseImage(20, 20, 20); }
+
+  void tearDown() override { m_DoseImage = nullptr; }
+
+  void TestVoxelAlignedStructure()
+  {
+    // 4 x 4 voxels with a dose of 2, 3, 4 and 5 Gy on 10 slices
+    mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+    for (int z = 5; z < 15; ++z)
+      this->AddRectangle(structure, 1.5, 5.5, 1.5, 5.5, z);
+
+    mitk::DoseVolumeHistogram::Pointer histogram = this->Compute(structure);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("test"), histogram->GetStructureName());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(160 * m_VoxelVolume, histogram->GetTotalVolume(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, histogram->GetMinimumDose(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, histogram->GetMaximumDose(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.5, histogram->GetMeanDose(), 1e-9);
+
+    const auto &volumes = histogram->GetDifferentialVolumes();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(11), volumes.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(40 * m_VoxelVolume, volumes[4], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, volumes[5], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(40 * m_VoxelVolume, volumes[10], 1e-9);
+
+    const auto cumulativeVolumes = histogram->GetCumulativeVolumes();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(160 * m_VoxelVolume, cumulativeVolumes[0], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(120 * m_VoxelVolume, cumulativeVolumes[6], 1e-9);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(75.0, histogram->GetVolumeAtDose(3.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(120 * m_VoxelVolume, histogram->GetVolumeAtDose(3.0, false), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, histogram->GetVolumeAtDose(1.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, histogram->GetVolumeAtDose(6.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, histogram->GetDoseAtVolume(100.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.1, histogram->GetDoseAtVolume(70.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, histogram->GetDoseAtVolume(0.0), 1e-9);
+  }
+
+  void TestFractionalCoverage()
+  {
+    // voxel x = 2 is covered completely, voxel x = 3 half
+    mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+    for (int z = 5; z < 15; ++z)
+      this->AddRectangle(structure, 1.5, 3.0, 1.5, 5.5, z);
+
+    mitk::DoseVolumeHistogram::Pointer histogram = this->Compute(structure);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(60 * m_VoxelVolume, histogram->GetTotalVolume(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(40 * m_VoxelVolume, histogram->GetDifferentialVolumes()[4], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(20 * m_VoxelVolume, histogram->GetDifferentialVolumes()[6], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0 / 3.0, histogram->GetMeanDose(), 1e-9);
+  }
+
+  void TestThroughPlaneCoverage()
+  {
+    // contour slices half a voxel apart represent slabs of half a voxel
+    mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+    this->AddRectangle(structure, 1.5, 5.5, 1.5, 5.5, 5.0);
+    this->AddRectangle(structure, 1.5, 5.5, 1.5, 5.5, 5.5);
+
+    mitk::DoseVolumeHistogram::Pointer histogram = this->Compute(structure);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(16 * m_VoxelVolume, histogram->GetTotalVolume(), 1e-9);
+
+    // a single contour slice represents one voxel
+    structure = mitk::ContourModelSet::New();
+    this->AddRectangle(structure, 1.5, 5.5, 1.5, 5.5, 5.0);
+
+    histogram = this->Compute(structure);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(16 * m_VoxelVolume, histogram->GetTotalVolume(), 1e-9);
+  }
+
+  void TestHole()
+  {
+    mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+    this->AddRectangle(structure, 1.5, 9.5, 1.5, 9.5, 5.0);
+    this->AddRectangle(structure, 3.5, 7.5, 3.5, 7.5, 5.0);
+
+    mitk::DoseVolumeHistogram::Pointer histogram = this->Compute(structure);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(48 * m_VoxelVolume, histogram->GetTotalVolume(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.5, histogram->GetMeanDose(), 1e-9);
+  }
+
+  void TestMetrics()
+  {
+    mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+    for (int z = 5; z < 15; ++z)
+      this->AddRectangle(structure, 1.5, 5.5, 1.5, 5.5, z);
+
+    mitk::DoseVolumeHistogram::Pointer histogram = this->Compute(structure, 0.01);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, histogram->GetMetric("Dmin"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.5, histogram->GetMetric("Dmean"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, histogram->GetMetric("Dmax"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(histogram->GetDoseAtVolume(95.0), histogram->GetMetric("D95"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(histogram->GetDoseAtVolume(50.0), histogram->GetMetric("D50%"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(histogram->GetDoseAtVolume(2.0, false), histogram->GetMetric("D2cc"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(75.0, histogram->GetMetric("V3"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(75.0, histogram->GetMetric("V3Gy"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(120 * m_VoxelVolume, histogram->GetMetric("V3cc"), 1e-9);
+    CPPUNIT_ASSERT_THROW(histogram->GetMetric("X95"), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(histogram->GetMetric("D95mm"), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(histogram->GetMetric("V"), mitk::Exception);
+  }
+
+  void TestMultiThreading()
+  {
+    mitk::DoseVolumeHistogramCalculator::Pointer calculator = mitk::DoseVolumeHistogramCalculator::New();
+    calculator->SetDoseImage(m_DoseImage);
+
+    for (int i = 0; i < 5; ++i)
+    {
+      mitk::ContourModelSet::Pointer structure = mitk::ContourModelSet::New();
+      for (int z = i; z < 10 + i; ++z)
+        this->AddPolygon(structure, {{1.2 + i, 2.3}, {14.7, 1.1 + i}, {10.1, 16.9 - i}, {2.2, 12.4}}, z);
+      calculator->AddStructure(structure);
+    }
+
+    calculator->SetNumberOfThreads(1);
+    calculator->Compute();
+    const auto singleThreaded = calculator->GetHistograms();
+
+    calculator->SetNumberOfThreads(4);
+    calculator->Compute();
+    const auto multiThreaded = calculator->GetHistograms();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), multiThreaded.size());
+    for (std::size_t i = 0; i < multiThreaded.size(); ++i)
+    {
+      const auto &expected = singleThreaded[i]->GetDifferentialVolumes();
+      const auto &actual = multiThreaded[i]->GetDifferentialVolumes();
+
+      CPPUNIT_ASSERT(singleThreaded[i]->GetTotalVolume() > 0.0);
+      CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+      for (std::size_t bin = 0; bin < expected.size(); ++bin)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[bin], actual[bin], 1e-9);
+
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(singleThreaded[i]->GetMeanDose(), multiThreaded[i]->GetMeanDose(), 1e-9);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDoseVolumeHistogramCalculator)
@@ -130,6 +130,16 @@ namespace itk
     itkSetMacro(ActivateTimeOut, bool);
     itkGetMacro(ActivateTimeOut, bool);
 
+    // \brief (default=false), Keep the shortest path tree between updates. As long as the start index does not change,
+    // an update only grows the existing tree until the end index is reached and traces the path back, which makes
+    // repeated queries from one seed (e.g. live wire) cheap. Only used for single end point Dijkstra searches
+    // (cost function with GetMinCost() == 0). Call ResetShortestPathTree() whenever the costs change.
+    itkSetMacro(KeepShortestPathTree, bool);
+    itkGetMacro(KeepShortestPathTree, bool);
+
+    // \brief Discard a kept shortest path tree, the next update searches from scratch
+    void ResetShortestPathTree();
+
     // \brief returns shortest Path as vector
     std::vector<IndexType> GetVectorPath();
 
@@ -181,7 +191,12 @@ namespace itk
 
     bool m_ActivateTimeOut; // if true, then i search max. 30 secs. then abort
 
-    bool m_Initialized;
+    bool m_KeepShortestPathTree;
+
+    bool m_Initialized; // m_Nodes and m_OpenList hold a (partial) search from m_Graph_StartNode
+    TimeStamp m_ShortestPathTreeTime;
+
+    std::vector<NodeNumType> m_OpenList; // binary min-heap of discovered nodes, ordered by distAndEst
 
     CostFunctionTypePointer m_CostFunction;
     IndexType m_StartIndex, m_EndIndex;
@@ -211,8 +226,19 @@ namespace itk
     // \brief Convert image coordinate to a indexnumber of a node in m_Nodes
     unsigned int CoordToNode(IndexType);
 
-    // \brief Returns the neighbors of a node
-    std::vector<ShortestPathNode *> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
+    // \brief Writes the numbers of the neighbors of a node to neighbors (room for 3^dim - 1 entries) and returns
+    // their count
+    unsigned int GetNeighbors(NodeNumType nodeNum, bool FullNeighbors, NodeNumType *neighbors);
+
+    // \brief Open list operations
+    void OpenListPush(NodeNumType nodeNum);
+    NodeNumType OpenListPop();
+    void OpenListDecreaseKey(NodeNumType nodeNum);
+    void OpenListSiftUp(NodeNumType heapIndex);
+    void OpenListSiftDown(NodeNumType heapIndex);
+
+    // \brief Whether the search state of the last update can be continued
+    bool CanReuseShortestPathTree();
 
     // \brief Check if coords are in bounds of image
     bool CoordIsInBounds(IndexType);
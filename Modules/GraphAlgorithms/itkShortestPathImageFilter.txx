@@ -27,6 +27,8 @@ namespace itk
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::ShortestPathImageFilter()
     : m_Nodes(nullptr),
       m_Graph_NumberOfNodes(0),
+      m_Graph_StartNode(0),
+      m_Graph_EndNode(0),
       m_Graph_fullNeighbors(false),
       m_FullNeighborsMode(false),
       m_MakeOutputImage(true),
@@ -34,6 +36,7 @@ namespace itk
       m_CalcAllDistances(false),
       multipleEndPoints(false),
       m_ActivateTimeOut(false),
+      m_KeepShortestPathTree(false),
       m_Initialized(false)
   {
     m_endPoints.clear();
@@ -139,235 +142,126 @@ namespace itk
   }
 
   template <class TInputImageType, class TOutputImageType>
-  inline std::vector<ShortestPathNode *> ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNeighbors(
-    unsigned int nodeNum, bool FullNeighbors)
+  inline unsigned int ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNeighbors(
+    NodeNumType nodeNum, bool FullNeighbors, NodeNumType *neighbors)
   {
-    // returns a vector of nodepointers.. these nodes are the neighbors
-    int dim = InputImageType::ImageDimension;
-    IndexType Coord = NodeToCoord(nodeNum);
-    IndexType NeighborCoord;
-    std::vector<ShortestPathNode *> nodeList;
-
-    int neighborDistance = 1; // if i increase that, i might not hit the endnote
+    // N4 / N6 neighbors differ in exactly one coordinate, N8 / N26 include the diagonals
+    const int dim = InputImageType::ImageDimension;
+    const IndexType coord = NodeToCoord(nodeNum);
+    IndexType neighborCoord;
 
-    // maybe use itkNeighborhoodIterator here, might be faster
+    int numberOfOffsets = 1;
+    for (int d = 0; d < dim; ++d)
+      numberOfOffsets *= 3;
 
-    if (dim == 2)
+    unsigned int count = 0;
+    for (int offsetNum = 0; offsetNum < numberOfOffsets; ++offsetNum)
     {
-      // N4
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      if (FullNeighbors)
+      int changedCoordinates = 0;
+      for (int d = 0, rest = offsetNum; d < dim; ++d, rest /= 3)
       {
-        // N8
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        const int offset = rest % 3 - 1;
+        neighborCoord[d] = coord[d] + offset;
+        changedCoordinates += offset != 0 ? 1 : 0;
       }
+
+      if (changedCoordinates == 0 || (!FullNeighbors && changedCoordinates > 1))
+        continue;
+
+      if (CoordIsInBounds(neighborCoord))
+        neighbors[count++] = CoordToNode(neighborCoord);
     }
-    if (dim == 3)
+    return count;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::OpenListPush(NodeNumType nodeNum)
+  {
+    m_Nodes[nodeNum].heapIndex = static_cast<NodeNumType>(m_OpenList.size());
+    m_OpenList.push_back(nodeNum);
+    OpenListSiftUp(m_Nodes[nodeNum].heapIndex);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  NodeNumType ShortestPathImageFilter<TInputImageType, TOutputImageType>::OpenListPop()
+  {
+    const NodeNumType top = m_OpenList.front();
+    m_Nodes[top].heapIndex = -1;
+
+    const NodeNumType last = m_OpenList.back();
+    m_OpenList.pop_back();
+    if (!m_OpenList.empty())
     {
-      // N6
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] + neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] - neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      if (FullNeighbors)
-      {
-        // N26
-        // Middle Slice
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice(Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-      }
+      m_OpenList.front() = last;
+      m_Nodes[last].heapIndex = 0;
+      OpenListSiftDown(0);
+    }
+    return top;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::OpenListDecreaseKey(NodeNumType nodeNum)
+  {
+    OpenListSiftUp(m_Nodes[nodeNum].heapIndex);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::OpenListSiftUp(NodeNumType heapIndex)
+  {
+    const NodeNumType nodeNum = m_OpenList[heapIndex];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+    while (heapIndex > 0)
+    {
+      const NodeNumType parent = (heapIndex - 1) / 2;
+      if (!(key < m_Nodes[m_OpenList[parent]].distAndEst))
+        break;
+      m_OpenList[heapIndex] = m_OpenList[parent];
+      m_Nodes[m_OpenList[heapIndex]].heapIndex = heapIndex;
+      heapIndex = parent;
     }
-    return nodeList;
+    m_OpenList[heapIndex] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapIndex;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::OpenListSiftDown(NodeNumType heapIndex)
+  {
+    const auto size = static_cast<NodeNumType>(m_OpenList.size());
+    const NodeNumType nodeNum = m_OpenList[heapIndex];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+    for (;;)
+    {
+      NodeNumType child = 2 * heapIndex + 1;
+      if (child >= size)
+        break;
+      if (child + 1 < size && m_Nodes[m_OpenList[child + 1]].distAndEst < m_Nodes[m_OpenList[child]].distAndEst)
+        ++child;
+      if (!(m_Nodes[m_OpenList[child]].distAndEst < key))
+        break;
+      m_OpenList[heapIndex] = m_OpenList[child];
+      m_Nodes[m_OpenList[heapIndex]].heapIndex = heapIndex;
+      heapIndex = child;
+    }
+    m_OpenList[heapIndex] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapIndex;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::ResetShortestPathTree()
+  {
+    if (m_Initialized)
+    {
+      m_Initialized = false;
+      this->Modified();
+    }
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  bool ShortestPathImageFilter<TInputImageType, TOutputImageType>::CanReuseShortestPathTree()
+  {
+    // the priorities of an A* search depend on the end point, so only a plain Dijkstra search can be continued
+    return m_Initialized && m_KeepShortestPathTree && !multipleEndPoints && !m_StoreVectorOrder &&
+           m_CostFunction->GetMinCost() == 0.0 && this->GetInput()->GetMTime() < m_ShortestPathTreeTime.GetMTime();
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -378,10 +272,14 @@ namespace itk
     {
       m_StartIndex[i] = StartIndex[i];
     }
-    m_Graph_StartNode = CoordToNode(m_StartIndex);
+    NodeNumType startNode = CoordToNode(m_StartIndex);
     // MITK_INFO << "StartIndex = " << StartIndex;
     // MITK_INFO << "StartNode = " << m_Graph_StartNode;
-    m_Initialized = false;
+    if (!m_KeepShortestPathTree || startNode != m_Graph_StartNode)
+    {
+      m_Initialized = false;
+    }
+    m_Graph_StartNode = startNode;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -427,20 +325,28 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
   {
-    if (!m_Initialized)
+    // Calc Number of nodes
+    auto imageDimensions = TInputImageType::ImageDimension;
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    NodeNumType numberOfNodes = 1;
+    for (NodeNumType i = 0; i < imageDimensions; ++i)
+      numberOfNodes = numberOfNodes * size[i];
+
+    if (m_Nodes == nullptr || numberOfNodes != m_Graph_NumberOfNodes)
     {
       // Clean up previous stuff
       CleanUp();
 
-      // Calc Number of nodes
-      auto imageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i = 0; i < imageDimensions; ++i)
-        m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * size[i];
-
       // Initialize mainNodeList with that number
+      m_Graph_NumberOfNodes = numberOfNodes;
       m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+      m_Initialized = false;
+    }
+
+    if (!CanReuseShortestPathTree())
+    {
+      m_VectorOrder.clear();
+      m_OpenList.clear();
 
       // Initialize each node in nodelist
       for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
@@ -449,16 +355,19 @@ namespace itk
         m_Nodes[i].distance = -1;
         m_Nodes[i].prevNode = -1;
         m_Nodes[i].mainListIndex = i;
+        m_Nodes[i].heapIndex = -1;
         m_Nodes[i].closed = false;
       }
 
+      // In the beginning, the Startnode needs a distance of 0 and is the only discovered node
+      m_Nodes[m_Graph_StartNode].distance = 0;
+      m_Nodes[m_Graph_StartNode].distAndEst = 0;
+      OpenListPush(m_Graph_StartNode);
+
       m_Initialized = true;
+      m_ShortestPathTreeTime.Modified();
     }
 
-    // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
-
     // initalize cost function
     m_CostFunction->Initialize();
   }
@@ -477,43 +386,25 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double, ShortestPathNode *> myMap;
-    std::pair<std::multimap<double, ShortestPathNode *>::iterator, std::multimap<double, ShortestPathNode *>::iterator>
-      ret;
-    std::multimap<double, ShortestPathNode *>::iterator it;
-
-    // At first, only startNote is discovered.
-    myMap.insert(
-      std::pair<double, ShortestPathNode *>(m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]));
+    // enough room for the N26 neighborhood
+    NodeNumType neighborNodes[26];
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while (!myMap.empty())
+    while (!m_OpenList.empty())
     {
-      numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
+      // a continued search may already have reached the end point in an earlier update
+      if (!multipleEndPoints && !m_CalcAllDistances && m_Nodes[m_Graph_EndNode].closed)
       {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size()
-      << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      // MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
-      {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
+        return;
       }
-      */
 
-      // Kicks out element with lowest score
-      myMap.erase(myMap.begin());
+      numberOfNodesChecked++;
+
+      // Get element with lowest score and kick it out of the open list
+      mainNodeListIndex = OpenListPop();
+      curNodeDistance = m_Nodes[mainNodeListIndex].distance;
+      m_Nodes[mainNodeListIndex].closed = true; // close it
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -522,137 +413,36 @@ namespace itk
       }
 
       // Check neighbors
-      std::vector<ShortestPathNode *> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
-      for (NodeNumType i = 0; i < neighborNodes.size(); i++)
+      const IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
+      const unsigned int numberOfNeighbors = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors, neighborNodes);
+      for (unsigned int i = 0; i < numberOfNeighbors; i++)
       {
-        if (neighborNodes[i]->closed)
+        ShortestPathNode &neighbor = m_Nodes[neighborNodes[i]];
+        if (neighbor.closed)
           continue; // this nodes is already closed, go to next neighbor
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
-        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
+        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]);
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
-        if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1))
+        if ((newDistance < neighbor.distance) || (neighbor.distance == -1))
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
+          const bool discovered = neighbor.distance != -1;
+
+          neighbor.distance = newDistance;
+          neighbor.distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighbor.prevNode = mainNodeListIndex;
+
+          // if that neighbornode is not in discoverednodeList yet, Push it there, otherwise update its position
+          if (discovered)
           {
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
+            OpenListDecreaseKey(neighborNodes[i]);
           }
-          // or if is already in discoverednodelist, update
           else
           {
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
-
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              // MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it = ret.first; it != ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              // MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            // myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-
-            // MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            // m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            // MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
+            OpenListPush(neighborNodes[i]);
           }
         }
       }
@@ -859,8 +649,10 @@ namespace itk
     m_VectorPath.clear();
     // TODO: if multiple Path, clear all multiple Paths
 
-    if (m_Nodes)
-      delete[] m_Nodes;
+    delete[] m_Nodes;
+    m_Nodes = nullptr;
+    m_OpenList.clear();
+    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
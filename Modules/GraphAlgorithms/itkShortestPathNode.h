@@ -27,6 +27,7 @@ namespace itk
     DistanceType distAndEst;   // Distance+Estimated Distnace to target
     NodeNumType prevNode;      // previous node. Important to find the Shortest Path
     NodeNumType mainListIndex; // Indexnumber of this node in m_Nodes
+    NodeNumType heapIndex;     // position of this node in the open list heap, -1 if not in the open list
     bool closed;               // determines if this node is closes, so its optimal path to startNode is known
   };
 
@@ -31,7 +31,8 @@ void mitk::NavigationDataSmoothingFilter::GenerateData()
   this->CreateOutputsForAllInputs();
 
   //initialize list if nessesary
-  if ( m_LastValuesList.size() != numberOfInputs )
+  if ( m_LastValuesList.size() != numberOfInputs
+    || m_LastValuesList.front().size() != static_cast<std::size_t>(m_NumerOfValues) )
   {
     this->InitializeLastValuesList();
   }
@@ -61,40 +62,32 @@ void mitk::NavigationDataSmoothingFilter::GenerateData()
 
 void mitk::NavigationDataSmoothingFilter::InitializeLastValuesList()
 {
-  m_LastValuesList = std::map< int, std::map< int , mitk::Point3D> >();
+  mitk::Point3D emptyPoint;
+  emptyPoint.Fill(0);
 
-  for ( unsigned int i = 0; i < this->GetNumberOfOutputs(); ++i )
-  {
-    std::map<int,mitk::Point3D> currentList;
-    for ( int j = 0; j < m_NumerOfValues; ++j )
-    {
-      mitk::Point3D emptyPoint;
-      emptyPoint.Fill(0);
-      currentList.insert(std::pair<int, mitk::Point3D>(j, emptyPoint));
-    }
-    m_LastValuesList.insert(std::pair<int, std::map<int,mitk::Point3D> > (i,currentList));
-  }
+  m_LastValuesList.assign(this->GetNumberOfOutputs(), std::vector<mitk::Point3D>(m_NumerOfValues, emptyPoint));
+  m_NextValueIndices.assign(this->GetNumberOfOutputs(), 0);
 }
 
 void mitk::NavigationDataSmoothingFilter::AddValue(int outputID, mitk::Point3D value)
 {
-  for (int i = 1; i < m_NumerOfValues; ++i)
-  {
-    m_LastValuesList[outputID][i-1] = m_LastValuesList[outputID][i];
-  }
-
-  m_LastValuesList[outputID][m_NumerOfValues-1] = value;
+  // overwrite the oldest value instead of shifting the whole list
+  std::size_t& nextIndex = m_NextValueIndices[outputID];
+  m_LastValuesList[outputID][nextIndex] = value;
+  nextIndex = (nextIndex + 1) % m_LastValuesList[outputID].size();
 }
 
 mitk::Point3D mitk::NavigationDataSmoothingFilter::GetMean(int outputID)
 {
+  const std::vector<mitk::Point3D>& lastValues = m_LastValuesList[outputID];
+
   mitk::Point3D mean;
   mean.Fill(0);
   for (int i=0; i<m_NumerOfValues; i++)
   {
-    mean[0] += m_LastValuesList[outputID][i][0];
-    mean[1] += m_LastValuesList[outputID][i][1];
-    mean[2] += m_LastValuesList[outputID][i][2];
+    mean[0] += lastValues[i][0];
+    mean[1] += lastValues[i][1];
+    mean[2] += lastValues[i][2];
   }
   mean[0] /= m_NumerOfValues;
   mean[1] /= m_NumerOfValues;
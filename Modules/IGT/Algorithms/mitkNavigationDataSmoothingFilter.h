@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include <mitkNavigationDataToNavigationDataFilter.h>
 #include "MitkIGTExports.h"
 
+#include <vector>
+
 
 namespace mitk {
 
@@ -44,7 +46,13 @@ namespace mitk {
 
     void GenerateData() override;
 
-    std::map< int, std::map< int , mitk::Point3D> > m_LastValuesList;
+    /** @brief Ring buffer of the last m_NumerOfValues positions for each output.
+     *         The buffers are allocated once and overwritten on every update.
+     */
+    std::vector< std::vector<mitk::Point3D> > m_LastValuesList;
+
+    /** @brief Index of the oldest value in the ring buffer of each output. */
+    std::vector< std::size_t > m_NextValueIndices;
 
     int m_NumerOfValues;
 
@@ -21,7 +21,10 @@ mitk::NeedleProjectionFilter::NeedleProjectionFilter()
   : m_Projection(mitk::PointSet::New()),
   m_OriginalPoints(mitk::PointSet::New()),
   m_ShowToolAxis(false),
-  m_SelectedInput(0)
+  m_SelectedInput(0),
+  m_ReferenceTransform(mitk::AffineTransform3D::New()),
+  m_QuaternionTransform(itk::QuaternionRigidTransform<double>::New()),
+  m_Plane(mitk::PlaneGeometry::New())
 {
   // Tool Coordinates: z-axis is chosen as default axis when no axis is specified
 
@@ -106,11 +109,10 @@ void mitk::NeedleProjectionFilter::GenerateData()
 
   // Outputs have been updated, now to calculate the Projection
   // 1) Generate Pseudo-Geometry for Input
-  mitk::AffineTransform3D::Pointer refTrans = this->NavigationDataToTransform(this->GetInput(m_SelectedInput));
-  mitk::Geometry3D::Pointer refGeom = this->TransformToGeometry(refTrans);
+  this->UpdateTransformFromNavigationData(this->GetInput(m_SelectedInput), m_ReferenceTransform);
 
-  // 2) Transform Original Pointset
-  m_OriginalPoints->SetGeometry(refGeom);
+  // 2) Transform Original Pointset (in place, SetGeometry() would clone the geometry)
+  m_OriginalPoints->GetGeometry()->SetIndexToWorldTransform(m_ReferenceTransform);
   // Update Projection (We do not clone, since we want to keep properties alive)
   m_Projection->SetPoint(0, m_OriginalPoints->GetPoint(0));
   m_Projection->SetPoint(1, m_OriginalPoints->GetPoint(1));
@@ -121,7 +123,7 @@ void mitk::NeedleProjectionFilter::GenerateData()
     return;
 
   // 3b) else, calculate intersection with plane
-  mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+  mitk::PlaneGeometry* plane = m_Plane;
   plane->SetIndexToWorldTransform(m_TargetPlane);
   //plane->TransferItkToVtkTransform(); //included in SetIndexToWorldTransform
 
@@ -155,22 +157,26 @@ void mitk::NeedleProjectionFilter::GenerateData()
 mitk::AffineTransform3D::Pointer mitk::NeedleProjectionFilter::NavigationDataToTransform(const mitk::NavigationData * nd)
 {
   mitk::AffineTransform3D::Pointer affineTransform = mitk::AffineTransform3D::New();
+  this->UpdateTransformFromNavigationData(nd, affineTransform);
+  return affineTransform;
+}
+
+void mitk::NeedleProjectionFilter::UpdateTransformFromNavigationData(const mitk::NavigationData * nd, mitk::AffineTransform3D * affineTransform)
+{
   affineTransform->SetIdentity();
 
   //calculate the transform from the quaternions
-  static itk::QuaternionRigidTransform<double>::Pointer quatTransform = itk::QuaternionRigidTransform<double>::New();
-
   mitk::NavigationData::OrientationType orientation = nd->GetOrientation();
   // convert mitk::ScalarType quaternion to double quaternion because of itk bug
   vnl_quaternion<double> doubleQuaternion(orientation.x(), orientation.y(), orientation.z(), orientation.r());
-  quatTransform->SetIdentity();
-  quatTransform->SetRotation(doubleQuaternion);
-  quatTransform->Modified();
+  m_QuaternionTransform->SetIdentity();
+  m_QuaternionTransform->SetRotation(doubleQuaternion);
+  m_QuaternionTransform->Modified();
 
   /* because of an itk bug, the transform can not be calculated with float data type.
   To use it in the mitk geometry classes, it has to be transfered to mitk::ScalarType which is float */
-  static AffineTransform3D::MatrixType m;
-  mitk::TransferMatrix(quatTransform->GetMatrix(), m);
+  AffineTransform3D::MatrixType m;
+  mitk::TransferMatrix(m_QuaternionTransform->GetMatrix(), m);
   affineTransform->SetMatrix(m);
 
   /*set the offset by convert from itkPoint to itkVector and setting offset of transform*/
@@ -179,7 +185,6 @@ mitk::AffineTransform3D::Pointer mitk::NeedleProjectionFilter::NavigationDataToT
   affineTransform->SetOffset(pos);
 
   affineTransform->Modified();
-  return affineTransform;
 }
 
 mitk::Geometry3D::Pointer mitk::NeedleProjectionFilter::TransformToGeometry(mitk::AffineTransform3D::Pointer transform){
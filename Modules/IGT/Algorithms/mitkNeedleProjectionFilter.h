@@ -20,6 +20,10 @@ found in the LICENSE file.
 #include <mitkNavigationData.h>
 #include <mitkPointSet.h>
 #include <mitkGeometry3D.h>
+#include <mitkPlaneGeometry.h>
+
+// ITK
+#include <itkQuaternionRigidTransform.h>
 
 namespace mitk {
   /**
@@ -73,6 +77,13 @@ namespace mitk {
 
     int                              m_SelectedInput;
 
+    /** Transform of the selected input and target plane geometry. They are
+     *  kept as members and updated in place on every GenerateData() call to
+     *  avoid allocating new transforms and geometries per tracking frame. */
+    mitk::AffineTransform3D::Pointer                 m_ReferenceTransform;
+    itk::QuaternionRigidTransform<double>::Pointer   m_QuaternionTransform;
+    mitk::PlaneGeometry::Pointer                     m_Plane;
+
     /** Internal method for initialization of the projection / tool axis representation
      *  by the point set m_OriginalPoints. */
     void InitializeOriginalPoints(mitk::Point3D toolAxis, bool showToolAxis);
@@ -83,6 +94,10 @@ namespace mitk {
     */
     mitk::AffineTransform3D::Pointer NavigationDataToTransform(const mitk::NavigationData * nd);
     /**
+    * \brief Sets the given Affine Transformation to the pose of a Navigation Data Object.
+    */
+    void UpdateTransformFromNavigationData(const mitk::NavigationData * nd, mitk::AffineTransform3D * transform);
+    /**
     * \brief Creates an Geometry 3D Object from an AffineTransformation.
     */
     mitk::Geometry3D::Pointer TransformToGeometry(mitk::AffineTransform3D::Pointer transform);
@@ -60,31 +60,34 @@ void mitk::TrackingDeviceSource::GenerateData()
       << m_TrackingDevice->GetToolCount() << " tools available in the tracking device.";
     throw std::out_of_range(ss.str());
   }
-  /* update outputs with tracking data from tools */
+  /* take a snapshot of all tools first, so that the outputs belong together */
   unsigned int toolCount = m_TrackingDevice->GetToolCount();
+  m_ToolSnapshot.resize(toolCount);
   for (unsigned int i = 0; i < toolCount; ++i)
   {
-    mitk::NavigationData* nd = this->GetOutput(i);
-    assert(nd);
     mitk::TrackingTool* t = m_TrackingDevice->GetTool(i);
     assert(t);
+    t->GetTrackingData(m_ToolSnapshot[i]);
+  }
+
+  /* update outputs with tracking data from tools */
+  for (unsigned int i = 0; i < toolCount; ++i)
+  {
+    mitk::NavigationData* nd = this->GetOutput(i);
+    assert(nd);
+    const mitk::TrackingTool::TrackingData& data = m_ToolSnapshot[i];
 
-    if ((t->IsEnabled() == false) || (t->IsDataValid() == false))
+    if ((data.Enabled == false) || (data.DataValid == false))
     {
       nd->SetDataValid(false);
       continue;
     }
     nd->SetDataValid(true);
-    mitk::NavigationData::PositionType p;
-    t->GetPosition(p);
-    nd->SetPosition(p);
-
-    mitk::NavigationData::OrientationType o;
-    t->GetOrientation(o);
-    nd->SetOrientation(o);
-    nd->SetOrientationAccuracy(t->GetTrackingError());
-    nd->SetPositionAccuracy(t->GetTrackingError());
-    nd->SetIGTTimeStamp(t->GetIGTTimeStamp());
+    nd->SetPosition(data.Position);
+    nd->SetOrientation(data.Orientation);
+    nd->SetOrientationAccuracy(data.TrackingError);
+    nd->SetPositionAccuracy(data.TrackingError);
+    nd->SetIGTTimeStamp(data.IGTTimeStamp);
 
     //for backward compatibility: check if the timestamp was set, if not create a default timestamp
     if (nd->GetIGTTimeStamp()==0) nd->SetIGTTimeStamp(mitk::IGTTimeStamp::GetInstance()->GetElapsed());
@@ -15,6 +15,9 @@ found in the LICENSE file.
 
 #include <mitkNavigationDataSource.h>
 #include "mitkTrackingDevice.h"
+#include "mitkTrackingTool.h"
+
+#include <vector>
 
 namespace mitk {
   /**Documentation
@@ -112,7 +115,9 @@ namespace mitk {
     * \brief filter execute method
     *
     * queries the tracking device for new position and orientation data for all tools
-    * and updates its output NavigationData objects with it.
+    * and updates its output NavigationData objects with it. The data of all tools is
+    * copied into one snapshot first, locking each tool only once, before any output
+    * is touched.
     * \warning Will raise a std::out_of_range exception, if tools were added to the
     * tracking device after it was set as input for this filter
     */
@@ -126,6 +131,7 @@ namespace mitk {
     void CreateOutputs();
 
     mitk::TrackingDevice::Pointer m_TrackingDevice;  ///< the tracking device that is used as a source for this filter object
+    std::vector<mitk::TrackingTool::TrackingData> m_ToolSnapshot; ///< tracking data of all tools, reused for every update
   };
 } // namespace mitk
 #endif /* MITKTrackingDeviceSource_H_HEADER_INCLUDED_ */
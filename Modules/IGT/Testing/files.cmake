@@ -22,6 +22,7 @@ set(MODULE_TESTS
    mitkNavigationDataLandmarkTransformFilterTest.cpp
    mitkNavigationDataObjectVisualizationFilterTest.cpp
    mitkNavigationDataSetTest.cpp
+   mitkNavigationDataSmoothingFilterTest.cpp
    mitkNavigationDataTest.cpp
    mitkNavigationDataRecorderTest.cpp
    mitkNavigationDataReferenceTransformFilterTest.cpp
@@ -63,6 +64,8 @@ set(MODULE_CUSTOM_TESTS
   mitkNavigationToolReaderAndWriterTest.cpp #deactivated because of bug 18835
   mitkNavigationToolStorageSerializerAndDeserializerIntegrationTest.cpp # This test was disabled because of bug 17181.
   mitkNavigationToolStorageSerializerTest.cpp # This test was disabled because of bug 18671
+  # not run by ctest, the benchmark takes some time and only reports timings
+  mitkNavigationDataPipelineLatencyTest.cpp
 )
 
 if(MITK_USE_POLHEMUS_TRACKER)
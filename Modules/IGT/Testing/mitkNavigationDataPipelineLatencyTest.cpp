@@ -0,0 +1,113 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkTrackingDeviceSource.h>
+#include <mitkVirtualTrackingDevice.h>
+#include <mitkNavigationDataSmoothingFilter.h>
+#include <mitkNeedleProjectionFilter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+static const unsigned int NUMBER_OF_TOOLS = 6;
+static const unsigned int NUMBER_OF_UPDATES = 2000;
+
+/**
+ * Measures the time of one update of a typical navigation pipeline
+ * (tracking device source, smoothing filter, needle projection filter)
+ * fed by a virtual tracking device and reports the mean and maximum latency.
+ * The smoothing itself is tested in mitkNavigationDataSmoothingFilterTest.
+ * It is not part of the regular tests, run it with the test driver of the module:
+ * MitkIGTTestDriver mitkNavigationDataPipelineLatencyTest
+ */
+class mitkNavigationDataPipelineLatencyTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataPipelineLatencyTestSuite);
+  MITK_TEST(Update_VirtualTrackerSixTools_ProducesValidOutputs);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::VirtualTrackingDevice::Pointer m_Tracker;
+  mitk::TrackingDeviceSource::Pointer m_Source;
+  mitk::NavigationDataSmoothingFilter::Pointer m_SmoothingFilter;
+  mitk::NeedleProjectionFilter::Pointer m_ProjectionFilter;
+
+public:
+  void setUp() override
+  {
+    m_Tracker = mitk::VirtualTrackingDevice::New();
+    for (unsigned int i = 0; i < NUMBER_OF_TOOLS; ++i)
+      m_Tracker->AddTool(("Tool" + std::to_string(i)).c_str());
+
+    m_Source = mitk::TrackingDeviceSource::New();
+    m_Source->SetTrackingDevice(m_Tracker);
+
+    m_SmoothingFilter = mitk::NavigationDataSmoothingFilter::New();
+    m_SmoothingFilter->ConnectTo(m_Source);
+
+    m_ProjectionFilter = mitk::NeedleProjectionFilter::New();
+    m_ProjectionFilter->ConnectTo(m_SmoothingFilter);
+    m_ProjectionFilter->SelectInput(0);
+
+    mitk::AffineTransform3D::Pointer targetPlane = mitk::AffineTransform3D::New();
+    targetPlane->SetIdentity();
+    m_ProjectionFilter->SetTargetPlane(targetPlane);
+  }
+
+  void tearDown() override
+  {
+    if (m_Source.IsNotNull() && m_Source->IsTracking())
+      m_Source->StopTracking();
+    if (m_Source.IsNotNull() && m_Source->IsConnected())
+      m_Source->Disconnect();
+    m_ProjectionFilter = nullptr;
+    m_SmoothingFilter = nullptr;
+    m_Source = nullptr;
+    m_Tracker = nullptr;
+  }
+
+  void Update_VirtualTrackerSixTools_ProducesValidOutputs()
+  {
+    m_Source->Connect();
+    m_Source->StartTracking();
+
+    double totalLatency = 0.0;
+    double maximumLatency = 0.0;
+
+    for (unsigned int i = 0; i < NUMBER_OF_UPDATES; ++i)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      m_Source->Modified();
+      m_ProjectionFilter->Update();
+      auto end = std::chrono::high_resolution_clock::now();
+      double latency = std::chrono::duration<double, std::micro>(end - start).count();
+      totalLatency += latency;
+      maximumLatency = std::max(maximumLatency, latency);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(NUMBER_OF_TOOLS), static_cast<std::size_t>(m_ProjectionFilter->GetNumberOfOutputs()));
+    for (unsigned int i = 0; i < NUMBER_OF_TOOLS; ++i)
+      CPPUNIT_ASSERT_EQUAL(m_Source->GetOutput(i)->GetName(), m_ProjectionFilter->GetOutput(i)->GetName());
+    CPPUNIT_ASSERT_EQUAL(2, m_ProjectionFilter->GetProjection()->GetSize());
+
+    MITK_INFO << "Navigation pipeline update latency with " << NUMBER_OF_TOOLS << " tools over "
+              << NUMBER_OF_UPDATES << " updates [us]:"
+              << " mean " << totalLatency / NUMBER_OF_UPDATES
+              << " max " << maximumLatency;
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataPipelineLatency)
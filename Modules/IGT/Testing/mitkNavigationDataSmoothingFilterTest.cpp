@@ -0,0 +1,132 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkNavigationDataSmoothingFilter.h>
+
+class mitkNavigationDataSmoothingFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataSmoothingFilterTestSuite);
+  MITK_TEST(Update_FewerValuesThanWindow_AveragesWithZeros);
+  MITK_TEST(Update_MoreValuesThanWindow_AveragesLastValues);
+  MITK_TEST(Update_TwoInputs_KeepsSeparateHistories);
+  MITK_TEST(Update_NumberOfValuesChanged_RestartsHistory);
+  MITK_TEST(Update_Orientation_IsPassedThrough);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::NavigationDataSmoothingFilter::Pointer m_Filter;
+  mitk::NavigationData::Pointer m_Input;
+
+  static mitk::Point3D MakePoint(double value)
+  {
+    mitk::Point3D point;
+    mitk::FillVector3D(point, value, 2.0 * value, -value);
+    return point;
+  }
+
+  /** sets the position of the input to MakePoint(value) and updates the filter */
+  void UpdateWith(mitk::NavigationData* input, double value)
+  {
+    input->SetPosition(MakePoint(value));
+    m_Filter->Update();
+  }
+
+  void AssertOutputPosition(double expectedValue, unsigned int output = 0)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Output position is the mean of the last values",
+      mitk::Equal(MakePoint(expectedValue), m_Filter->GetOutput(output)->GetPosition(), mitk::eps, true));
+  }
+
+public:
+  void setUp() override
+  {
+    m_Input = mitk::NavigationData::New();
+    m_Input->SetDataValid(true);
+
+    m_Filter = mitk::NavigationDataSmoothingFilter::New();
+    m_Filter->SetInput(m_Input);
+  }
+
+  void tearDown() override
+  {
+    m_Filter = nullptr;
+    m_Input = nullptr;
+  }
+
+  void Update_FewerValuesThanWindow_AveragesWithZeros()
+  {
+    // the history starts with five zero positions
+    UpdateWith(m_Input, 5.0);
+    AssertOutputPosition(1.0);
+
+    UpdateWith(m_Input, 10.0);
+    AssertOutputPosition(3.0);
+  }
+
+  void Update_MoreValuesThanWindow_AveragesLastValues()
+  {
+    const double expectedMeans[] = { 0.2, 0.6, 1.2, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0 };
+    for (int i = 0; i < 10; ++i)
+    {
+      UpdateWith(m_Input, i + 1.0);
+      AssertOutputPosition(expectedMeans[i]);
+    }
+  }
+
+  void Update_TwoInputs_KeepsSeparateHistories()
+  {
+    mitk::NavigationData::Pointer secondInput = mitk::NavigationData::New();
+    secondInput->SetDataValid(true);
+    m_Filter->SetInput(1, secondInput);
+
+    for (int i = 0; i < 7; ++i)
+    {
+      m_Input->SetPosition(MakePoint(i + 1.0));
+      secondInput->SetPosition(MakePoint(-10.0));
+      m_Filter->Update();
+    }
+
+    AssertOutputPosition(5.0, 0);
+    AssertOutputPosition(-10.0, 1);
+  }
+
+  void Update_NumberOfValuesChanged_RestartsHistory()
+  {
+    for (int i = 0; i < 7; ++i)
+      UpdateWith(m_Input, i + 1.0);
+
+    m_Filter->SetNumerOfValues(2);
+    UpdateWith(m_Input, 8.0);
+    AssertOutputPosition(4.0);
+
+    UpdateWith(m_Input, 10.0);
+    AssertOutputPosition(9.0);
+
+    UpdateWith(m_Input, 20.0);
+    AssertOutputPosition(15.0);
+  }
+
+  void Update_Orientation_IsPassedThrough()
+  {
+    mitk::Quaternion orientation(0.0, 0.0, 0.70710678118654757, 0.70710678118654757);
+    m_Input->SetOrientation(orientation);
+    UpdateWith(m_Input, 5.0);
+
+    CPPUNIT_ASSERT(mitk::Equal(orientation, m_Filter->GetOutput()->GetOrientation()));
+    CPPUNIT_ASSERT(m_Filter->GetOutput()->IsDataValid());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataSmoothingFilter)
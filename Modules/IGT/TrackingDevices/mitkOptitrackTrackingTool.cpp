@@ -405,6 +405,19 @@ float mitk::OptitrackTrackingTool::GetTrackingError() const
   return this->m_TrackingError;
 }
 
+//=======================================================
+// GetTrackingData
+//=======================================================
+void mitk::OptitrackTrackingTool::GetTrackingData(TrackingData& data) const
+{
+  this->GetPosition(data.Position);
+  this->GetOrientation(data.Orientation);
+  data.TrackingError = this->GetTrackingError();
+  data.IGTTimeStamp = this->GetIGTTimeStamp();
+  data.Enabled = this->IsEnabled();
+  data.DataValid = this->IsDataValid();
+}
+
 //=======================================================
 // SetTrackingError
 //=======================================================
@@ -150,6 +150,11 @@ namespace mitk
     */
     float GetTrackingError() const override;
 
+    /**
+    * \brief Get the tracking state of the tool through the getters above
+    */
+    void GetTrackingData(TrackingData& data) const override;
+
     /**
     * \brief Set the FLE (Fiducial Localization Error) for the tool
     * @throw mitk::IGTException Throws an exception if
@@ -194,6 +194,29 @@ void mitk::TrackingTool::GetOrientation(mitk::Quaternion& orientation) const
   }
 }
 
+void mitk::TrackingTool::GetTrackingData(TrackingData& data) const
+{
+  MutexLockHolder lock(*m_MyMutex); // lock and unlock the mutex
+  if (m_ToolTipSet)
+  {
+    // see GetPosition() and GetOrientation()
+    vnl_vector<mitk::ScalarType> pos_vnl = m_Position.GetVnlVector() + m_Orientation.rotate( m_ToolTipPosition.GetVnlVector() ) ;
+    data.Position[0] = pos_vnl[0];
+    data.Position[1] = pos_vnl[1];
+    data.Position[2] = pos_vnl[2];
+    data.Orientation = m_Orientation * m_ToolAxisOrientation;
+  }
+  else
+  {
+    data.Position = m_Position;
+    data.Orientation = m_Orientation;
+  }
+  data.TrackingError = m_TrackingError;
+  data.IGTTimeStamp = m_IGTTimeStamp;
+  data.Enabled = m_Enabled;
+  data.DataValid = m_DataValid;
+}
+
 void mitk::TrackingTool::SetOrientation(mitk::Quaternion orientation)
 {
   itkDebugMacro("setting m_Orientation to " << orientation);
@@ -46,6 +46,22 @@ namespace mitk
     itkFactorylessNewMacro(Self);
     itkCloneMacro(Self);
 
+    /**
+    * \brief Consistent copy of the tracking state of a tool
+    *
+    * Position and orientation are given for the tool tip if one is set, just
+    * like GetPosition() and GetOrientation() return them.
+    */
+    struct TrackingData
+    {
+      Point3D Position;
+      Quaternion Orientation;
+      float TrackingError;
+      double IGTTimeStamp;
+      bool Enabled;
+      bool DataValid;
+    };
+
     void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
     virtual const char* GetToolName() const; ///< every tool has a name thatgit  can be used to identify it.
@@ -76,6 +92,7 @@ namespace mitk
     virtual const char* GetErrorMessage() const; ///< if the data is not valid, ErrorMessage should contain a string explaining why it is invalid (the Set-method should be implemented in subclasses, it should not be accessible by the user)
     virtual void SetErrorMessage(const char* _arg); ///< sets the error message
 
+    virtual void GetTrackingData(TrackingData& data) const; ///< copies position, orientation, tracking error, time stamp, enabled and valid state at once, locking the tool only one time
     itkSetMacro(IGTTimeStamp, double) ///< Sets the IGT timestamp of the tracking tool object (time in milliseconds)
     itkGetConstMacro(IGTTimeStamp, double) ///< Gets the IGT timestamp of the tracking tool object (time in milliseconds). Returns 0 if the timestamp was not set.
 
@@ -58,15 +58,52 @@ void mitk::NavigationData::Graft( const DataObject *data )
       << typeid(const Self *).name() );
     return;
   }
-  // Now copy anything that is needed
-  this->SetPosition(nd->GetPosition());
-  this->SetOrientation(nd->GetOrientation());
-  this->SetDataValid(nd->IsDataValid());
-  this->SetIGTTimeStamp(nd->GetIGTTimeStamp());
-  this->SetHasPosition(nd->GetHasPosition());
-  this->SetHasOrientation(nd->GetHasOrientation());
-  this->SetCovErrorMatrix(nd->GetCovErrorMatrix());
-  this->SetName(nd->GetName());
+  // Now copy anything that is needed. Grafting is done by every filter on
+  // every update, so the members are copied directly and Modified() is called
+  // only once instead of once per changed member.
+  bool modified = false;
+  if (m_Position != nd->m_Position)
+  {
+    m_Position = nd->m_Position;
+    modified = true;
+  }
+  if (m_Orientation != nd->m_Orientation)
+  {
+    m_Orientation = nd->m_Orientation;
+    modified = true;
+  }
+  if (m_DataValid != nd->m_DataValid)
+  {
+    m_DataValid = nd->m_DataValid;
+    modified = true;
+  }
+  if (m_IGTTimeStamp != nd->m_IGTTimeStamp)
+  {
+    m_IGTTimeStamp = nd->m_IGTTimeStamp;
+    modified = true;
+  }
+  if (m_HasPosition != nd->m_HasPosition)
+  {
+    m_HasPosition = nd->m_HasPosition;
+    modified = true;
+  }
+  if (m_HasOrientation != nd->m_HasOrientation)
+  {
+    m_HasOrientation = nd->m_HasOrientation;
+    modified = true;
+  }
+  if (m_CovErrorMatrix != nd->m_CovErrorMatrix)
+  {
+    m_CovErrorMatrix = nd->m_CovErrorMatrix;
+    modified = true;
+  }
+  if (m_Name != nd->m_Name)
+  {
+    m_Name = nd->m_Name;
+    modified = true;
+  }
+  if (modified)
+    this->Modified();
 }
 
 
@@ -15,3 +15,7 @@ set(CPP_FILES
   Internal/mitkVtkVolumeTimeSeriesIOFactory.cpp
   Internal/mitkVtkVolumeTimeSeriesReader.cpp
 )
+
+set(RESOURCE_FILES
+  manifest.json
+)
@@ -11,6 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkLocalVariationImageFilter.h"
 #include "itkTotalVariationDenoisingImageFilter.h"
 #include "itkTotalVariationSingleIterationImageFilter.h"
@@ -104,6 +105,30 @@ VectorImageType::Pointer GenerateVectorTestImage()
   return image;
 }
 
+/**
+* larger image with a non-uniform pattern for comparing TotalVariationDenoisingImageFilter
+* to repeated single iterations
+*/
+ImageType::Pointer GeneratePatternImage()
+{
+  ImageType::Pointer image = ImageType::New();
+
+  ImageType::RegionType largestPossibleRegion;
+  ImageType::SizeType size = {{13, 11, 9}};
+  largestPossibleRegion.SetSize(size);
+  image->SetRegions(largestPossibleRegion);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, largestPossibleRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>((index[0] * 7 + index[1] * 3 + index[2] * 5) % 11) + (index[0] > 6 ? 20.0f : 0.0f));
+  }
+
+  return image;
+}
+
 void PrintImage(ImageType::Pointer image)
 {
   IteratorType it(image, image->GetLargestPossibleRegion());
@@ -200,6 +225,47 @@ int itkTotalVariationDenoisingImageFilterTest(int /*argc*/, char * /*argv*/ [])
     return EXIT_FAILURE;
   }
 
+  try
+  {
+    // the filter has to compute the same iterations as the single iteration filter
+    ImageType::Pointer patternImage = GeneratePatternImage();
+    const int numberOfIterations = 5;
+
+    ImageType::Pointer expected = patternImage;
+    typedef itk::TotalVariationSingleIterationImageFilter<ImageType, ImageType> SingleFilterType;
+    for (int i = 0; i < numberOfIterations; ++i)
+    {
+      SingleFilterType::Pointer sFilter = SingleFilterType::New();
+      sFilter->SetInput(expected);
+      sFilter->SetOriginalImage(patternImage);
+      sFilter->SetLambda(0.1);
+      sFilter->UpdateLargestPossibleRegion();
+      expected = sFilter->GetOutput();
+    }
+
+    typedef itk::TotalVariationDenoisingImageFilter<ImageType, ImageType> TVFilterType;
+    TVFilterType::Pointer tvFilter = TVFilterType::New();
+    tvFilter->SetInput(patternImage);
+    tvFilter->SetNumberIterations(numberOfIterations);
+    tvFilter->SetNumberOfThreads(4);
+    tvFilter->SetLambda(0.1);
+    tvFilter->Update();
+
+    IteratorType expectedIt(expected, expected->GetLargestPossibleRegion());
+    IteratorType tvIt(tvFilter->GetOutput(), expected->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++tvIt)
+    {
+      if (fabs(expectedIt.Get() - tvIt.Get()) > 1e-5)
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (...)
+  {
+    return EXIT_FAILURE;
+  }
+
   VectorImageType::Pointer vecImage = GenerateVectorTestImage();
   PrintVectorImage(vecImage);
 
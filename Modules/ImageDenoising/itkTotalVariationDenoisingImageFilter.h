@@ -16,8 +16,11 @@ found in the LICENSE file.
 #include "itkCastImageFilter.h"
 #include "itkImage.h"
 #include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
 #include "itkTotalVariationSingleIterationImageFilter.h"
 
+#include <vector>
+
 namespace itk
 {
   /** \class TotalVariationDenoisingImageFilter
@@ -25,6 +28,12 @@ namespace itk
    *
    * Reference: Tony F. Chan et al., The digital TV filter and nonlinear denoising
    *
+   * Computes the same iterations as repeatedly applying TotalVariationSingleIterationImageFilter
+   * (including LocalVariationImageFilter), but works directly on the pixel buffers: the local
+   * variation is computed slice by slice into a small rolling buffer right before the update of the
+   * slice, and the solution is double buffered in two images that are allocated only once. The
+   * slices are split into slabs that are processed in parallel.
+   *
    * \sa Image
    * \sa Neighborhood
    * \sa NeighborhoodOperator
@@ -65,6 +74,7 @@ namespace itk
     typedef typename OutputImageType::RegionType OutputImageRegionType;
 
     typedef typename InputImageType::SizeType InputSizeType;
+    typedef typename OutputImageType::SizeType OutputSizeType;
 
     typedef TotalVariationSingleIterationImageFilter<TOutputImage, TOutputImage> SingleIterationFilterType;
 
@@ -83,11 +93,33 @@ namespace itk
 
     void GenerateData() override;
 
+    /** Computes one iteration for the slices [firstSlice, endSlice) of the last dimension from input
+     * into output. localVariation holds the local variation of three slices of the input. */
+    void GenerateSlab(const OutputPixelType *original,
+                      const OutputPixelType *input,
+                      OutputPixelType *output,
+                      const OutputSizeType &size,
+                      SizeValueType firstSlice,
+                      SizeValueType endSlice,
+                      std::vector<float> &localVariation) const;
+
     double m_Lambda;
 
     int m_NumberIterations;
 
   private:
+    struct IterationData
+    {
+      const Self *Filter;
+      OutputSizeType Size;
+      const OutputPixelType *Original;
+      const OutputPixelType *Input;
+      OutputPixelType *Output;
+      std::vector<std::vector<float>> *LocalVariation;
+    };
+
+    static ITK_THREAD_RETURN_TYPE IterationCallback(void *arg);
+
     TotalVariationDenoisingImageFilter(const Self &); // purposely not implemented
     void operator=(const Self &);                     // purposely not implemented
   };
@@ -19,17 +19,10 @@ This file is based heavily on a corresponding ITK filter.
 #define _itkTotalVariationDenoisingImageFilter_txx
 #include "itkTotalVariationDenoisingImageFilter.h"
 
-#include "itkConstShapedNeighborhoodIterator.h"
-#include "itkImageRegionConstIterator.h"
-#include "itkImageRegionIterator.h"
 #include "itkLocalVariationImageFilter.h"
-#include "itkNeighborhoodAlgorithm.h"
-#include "itkNeighborhoodInnerProduct.h"
-#include "itkOffset.h"
-#include "itkProgressReporter.h"
-#include "itkZeroFluxNeumannBoundaryCondition.h"
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace itk
@@ -55,39 +48,206 @@ namespace itk
     infilter->Update();
     typename TOutputImage::Pointer origImage = infilter->GetOutput();
 
-    typename SingleIterationFilterType::Pointer filter;
-    for (int i = 0; i < m_NumberIterations; i++)
-    {
-      filter = SingleIterationFilterType::New();
-      filter->SetInput(image);
-      filter->SetOriginalImage(origImage);
-      filter->SetLambda(m_Lambda);
-      filter->SetNumberOfThreads(this->GetNumberOfThreads());
-      filter->UpdateLargestPossibleRegion();
-      image = filter->GetOutput();
-      std::cout << "Iteration " << i + 1 << "/" << m_NumberIterations << std::endl;
-    }
-
     typename OutputImageType::Pointer output = this->GetOutput();
     output->SetSpacing(image->GetSpacing());
-    typename OutputImageType::RegionType largestPossibleRegion;
-    largestPossibleRegion.SetSize(image->GetLargestPossibleRegion().GetSize());
-    largestPossibleRegion.SetIndex(image->GetLargestPossibleRegion().GetIndex());
     output->SetLargestPossibleRegion(image->GetLargestPossibleRegion());
     output->SetBufferedRegion(image->GetLargestPossibleRegion());
     output->Allocate();
 
-    itk::ImageRegionIterator<OutputImageType> oit(output, output->GetLargestPossibleRegion());
-    oit.GoToBegin();
+    const OutputSizeType size = image->GetLargestPossibleRegion().GetSize();
+    const SizeValueType numberOfSlices = size[OutputImageDimension - 1];
+
+    // the iterations alternate between the buffers of the casted image and the output
+    OutputPixelType *current = image->GetBufferPointer();
+    OutputPixelType *next = output->GetBufferPointer();
+
+    const ThreadIdType numberOfThreads = static_cast<ThreadIdType>(
+      std::min<SizeValueType>(std::max<ThreadIdType>(1, this->GetNumberOfThreads()), numberOfSlices));
+    std::vector<std::vector<float>> localVariation(numberOfThreads);
+
+    IterationData data;
+    data.Filter = this;
+    data.Size = size;
+    data.Original = origImage->GetBufferPointer();
+    data.LocalVariation = &localVariation;
+
+    this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+    this->GetMultiThreader()->SetSingleMethod(this->IterationCallback, &data);
+
+    for (int i = 0; i < m_NumberIterations; i++)
+    {
+      data.Input = current;
+      data.Output = next;
+      this->GetMultiThreader()->SingleMethodExecute();
+      std::swap(current, next);
+
+      this->UpdateProgress(static_cast<float>(i + 1) / m_NumberIterations);
+      std::cout << "Iteration " << i + 1 << "/" << m_NumberIterations << std::endl;
+    }
+
+    if (current != output->GetBufferPointer())
+    {
+      std::copy(current, current + output->GetLargestPossibleRegion().GetNumberOfPixels(), output->GetBufferPointer());
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  ITK_THREAD_RETURN_TYPE TotalVariationDenoisingImageFilter<TInputImage, TOutputImage>::IterationCallback(void *arg)
+  {
+    auto *threadInfo = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+    auto *data = static_cast<IterationData *>(threadInfo->UserData);
+
+    // every thread processes one slab of consecutive slices
+    const SizeValueType numberOfSlices = data->Size[OutputImageDimension - 1];
+    const SizeValueType firstSlice = numberOfSlices * threadInfo->ThreadID / threadInfo->NumberOfThreads;
+    const SizeValueType endSlice = numberOfSlices * (threadInfo->ThreadID + 1) / threadInfo->NumberOfThreads;
+
+    if (firstSlice < endSlice)
+    {
+      data->Filter->GenerateSlab(data->Original,
+                                 data->Input,
+                                 data->Output,
+                                 data->Size,
+                                 firstSlice,
+                                 endSlice,
+                                 (*data->LocalVariation)[threadInfo->ThreadID]);
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void TotalVariationDenoisingImageFilter<TInputImage, TOutputImage>::GenerateSlab(const OutputPixelType *original,
+                                                                                  const OutputPixelType *input,
+                                                                                  OutputPixelType *output,
+                                                                                  const OutputSizeType &size,
+                                                                                  SizeValueType firstSlice,
+                                                                                  SizeValueType endSlice,
+                                                                                  std::vector<float> &localVariation) const
+  {
+    typedef SquaredEuclideanMetric<OutputPixelType> MetricType;
 
-    itk::ImageRegionConstIterator<OutputImageType> iit(image, image->GetLargestPossibleRegion());
-    iit.GoToBegin();
+    const unsigned int sliceDimension = OutputImageDimension - 1;
+    const SizeValueType numberOfSlices = size[sliceDimension];
 
-    while (!oit.IsAtEnd())
+    OffsetValueType strides[OutputImageDimension];
+    SizeValueType sliceSize = 1;
+    for (unsigned int d = 0; d < sliceDimension; ++d)
     {
-      oit.Set(iit.Get());
-      ++iit;
-      ++oit;
+      strides[d] = sliceSize;
+      sliceSize *= size[d];
+    }
+
+    // three slices of local variation, the one of slice z is stored at position z % 3
+    localVariation.resize(3 * sliceSize);
+
+    // Offsets of the neighbours within a slice. Together with the neighbours in the previous and next
+    // slice, they are ordered like the active offsets of the neighborhood iterators of
+    // LocalVariationImageFilter and TotalVariationSingleIterationImageFilter (-z, -y, -x, +x, +y, +z),
+    // so all sums are computed in the same order. Neighbours outside of the image are replaced by the
+    // pixel itself (zero flux Neumann boundary condition).
+    const unsigned int numberOfInSliceNeighbours = 2 * sliceDimension;
+    OffsetValueType neighbourOffsets[2 * OutputImageDimension];
+    SizeValueType index[OutputImageDimension];
+
+    auto updateNeighbourOffsets = [&]() {
+      for (unsigned int d = 0; d < sliceDimension; ++d)
+      {
+        neighbourOffsets[sliceDimension - 1 - d] = index[d] > 0 ? -strides[d] : 0;
+        neighbourOffsets[sliceDimension + d] = index[d] + 1 < size[d] ? strides[d] : 0;
+      }
+    };
+
+    auto incrementIndex = [&]() {
+      for (unsigned int d = 0; d < sliceDimension; ++d)
+      {
+        if (++index[d] < size[d])
+          break;
+
+        index[d] = 0;
+      }
+    };
+
+    // same computation as LocalVariationImageFilter
+    auto computeLocalVariation = [&](SizeValueType z) {
+      const OutputPixelType *slice = input + z * sliceSize;
+      const OutputPixelType *previousSlice = z > 0 ? slice - sliceSize : slice;
+      const OutputPixelType *nextSlice = z + 1 < numberOfSlices ? slice + sliceSize : slice;
+      float *result = &localVariation[(z % 3) * sliceSize];
+
+      std::fill(index, index + OutputImageDimension, 0);
+      for (SizeValueType i = 0; i < sliceSize; ++i)
+      {
+        updateNeighbourOffsets();
+
+        const OutputPixelType center = slice[i];
+        float locVariation = 0;
+        locVariation += MetricType::Calc(previousSlice[i] - center);
+        for (unsigned int n = 0; n < numberOfInSliceNeighbours; ++n)
+          locVariation += MetricType::Calc(slice[i + neighbourOffsets[n]] - center);
+        locVariation += MetricType::Calc(nextSlice[i] - center);
+
+        result[i] = std::sqrt(locVariation + 0.0001);
+        incrementIndex();
+      }
+    };
+
+    if (firstSlice > 0)
+      computeLocalVariation(firstSlice - 1);
+
+    computeLocalVariation(firstSlice);
+
+    double ws[2 * OutputImageDimension];
+
+    for (SizeValueType z = firstSlice; z < endSlice; ++z)
+    {
+      if (z + 1 < numberOfSlices)
+        computeLocalVariation(z + 1);
+
+      const SizeValueType sliceOffset = z * sliceSize;
+      const OutputPixelType *slice = input + sliceOffset;
+      const OutputPixelType *previousSlice = z > 0 ? slice - sliceSize : slice;
+      const OutputPixelType *nextSlice = z + 1 < numberOfSlices ? slice + sliceSize : slice;
+
+      const float *locVarSlice = &localVariation[(z % 3) * sliceSize];
+      const float *locVarPreviousSlice = z > 0 ? &localVariation[((z - 1) % 3) * sliceSize] : locVarSlice;
+      const float *locVarNextSlice = z + 1 < numberOfSlices ? &localVariation[((z + 1) % 3) * sliceSize] : locVarSlice;
+
+      // same computation as TotalVariationSingleIterationImageFilter
+      std::fill(index, index + OutputImageDimension, 0);
+      for (SizeValueType i = 0; i < sliceSize; ++i)
+      {
+        updateNeighbourOffsets();
+
+        //   1 / ||nabla_alpha(u)||_a
+        const double locvar_alpha_inv = 1.0 / locVarSlice[i];
+
+        // w_alphabeta(u) =
+        //   1 / ||nabla_alpha(u)||_a + 1 / ||nabla_beta(u)||_a
+        double wsum = 0;
+        ws[0] = locvar_alpha_inv + (1.0 / (double)locVarPreviousSlice[i]);
+        wsum += ws[0];
+        for (unsigned int n = 0; n < numberOfInSliceNeighbours; ++n)
+        {
+          ws[n + 1] = locvar_alpha_inv + (1.0 / (double)locVarSlice[i + neighbourOffsets[n]]);
+          wsum += ws[n + 1];
+        }
+        ws[numberOfInSliceNeighbours + 1] = locvar_alpha_inv + (1.0 / (double)locVarNextSlice[i]);
+        wsum += ws[numberOfInSliceNeighbours + 1];
+
+        // h_alphaalpha * u_alpha^zero
+        OutputPixelType res =
+          static_cast<OutputPixelType>(original[sliceOffset + i] * (m_Lambda / (m_Lambda + wsum)));
+
+        // add the different h_alphabeta * u_beta
+        res += previousSlice[i] * (ws[0] / (m_Lambda + wsum));
+        for (unsigned int n = 0; n < numberOfInSliceNeighbours; ++n)
+          res += slice[i + neighbourOffsets[n]] * (ws[n + 1] / (m_Lambda + wsum));
+        res += nextSlice[i] * (ws[numberOfInSliceNeighbours + 1] / (m_Lambda + wsum));
+
+        output[sliceOffset + i] = res;
+        incrementIndex();
+      }
     }
   }
 
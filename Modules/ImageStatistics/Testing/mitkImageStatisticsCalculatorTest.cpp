@@ -20,6 +20,7 @@ found in the LICENSE file.
 #include <mitkPlanarFigureMaskGenerator.h>
 #include <mitkImageMaskGenerator.h>
 #include <mitkImageStatisticsConstants.h>
+#include <mitkImagePixelWriteAccessor.h>
 
 /**
  * \brief Test class for mitkImageStatisticsCalculator
@@ -27,6 +28,7 @@ found in the LICENSE file.
  * This test covers:
  * - instantiation of an ImageStatisticsCalculator class
  * - correctness of statistics when using PlanarFigures for masking
+ * - computation of only the time steps that contain a modified region
  */
 class mitkImageStatisticsCalculatorTestSuite : public mitk::TestFixture
 {
@@ -54,6 +56,7 @@ class mitkImageStatisticsCalculatorTestSuite : public mitk::TestFixture
   MITK_TEST(TestUS4DCroppedPlanarFigureTimeStep1);
   MITK_TEST(TestUS4DCroppedAllTimesteps);
   MITK_TEST(TestUS4DCropped3DMask);
+  MITK_TEST(TestModifiedRegionOnlyModifiedTimeStepIsComputed);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -84,6 +87,8 @@ public:
   void TestUS4DCroppedPlanarFigureTimeStep1();
   void TestUS4DCroppedAllTimesteps();
   void TestUS4DCropped3DMask();
+
+  void TestModifiedRegionOnlyModifiedTimeStepIsComputed();
 private:
 	mitk::Image::ConstPointer m_TestImage;
 
@@ -1038,6 +1043,64 @@ mitk::PlanarPolygon::Pointer mitkImageStatisticsCalculatorTestSuite::GeneratePla
 	return figure;
 }
 
+void mitkImageStatisticsCalculatorTestSuite::TestModifiedRegionOnlyModifiedTimeStepIsComputed()
+{
+	MITK_INFO << std::endl << "Test modified region of one timestep:-----------------------------------------------------------------------------------";
+
+	// all voxels of timestep t have the value t
+	unsigned int dimensions[4] = {10, 10, 10, 2};
+	mitk::Image::Pointer image = mitk::Image::New();
+	image->Initialize(mitk::MakeScalarPixelType<short>(), 4, dimensions);
+
+	itk::Index<4> index;
+	{
+		mitk::ImagePixelWriteAccessor<short, 4> writeAccessor(image);
+		for (index[3] = 0; index[3] < 2; ++index[3])
+			for (index[2] = 0; index[2] < 10; ++index[2])
+				for (index[1] = 0; index[1] < 10; ++index[1])
+					for (index[0] = 0; index[0] < 10; ++index[0])
+						writeAccessor.SetPixelByIndex(index, static_cast<short>(index[3]));
+	}
+
+	mitk::ImageStatisticsCalculator::Pointer imgStatCalc = mitk::ImageStatisticsCalculator::New();
+	imgStatCalc->SetInputImage(image);
+
+	mitk::ImageStatisticsContainer::Pointer statisticsContainer;
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = imgStatCalc->GetStatistics());
+	auto meanTimestep0 = statisticsContainer->GetStatisticsForTimeStep(0).GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+	auto meanTimestep1 = statisticsContainer->GetStatisticsForTimeStep(1).GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+	CPPUNIT_ASSERT_MESSAGE("Calculated mean grayvalue is not equal to the desired value.", std::abs(meanTimestep0) < mitk::eps);
+	CPPUNIT_ASSERT_MESSAGE("Calculated mean grayvalue is not equal to the desired value.", std::abs(meanTimestep1 - 1.) < mitk::eps);
+
+	// change one voxel of each timestep, but mark only the voxel of timestep 1 as modified
+	index.Fill(0);
+	{
+		mitk::ImagePixelWriteAccessor<short, 4> writeAccessor(image);
+		writeAccessor.SetPixelByIndex(index, 1001);
+		index[3] = 1;
+		writeAccessor.SetPixelByIndex(index, 1001);
+	}
+
+	mitk::Image::VolumeRegionType region;
+	region.SetSize(0, 1);
+	region.SetSize(1, 1);
+	region.SetSize(2, 1);
+	image->ModifiedRegion(1, region);
+
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = imgStatCalc->GetStatistics());
+	meanTimestep0 = statisticsContainer->GetStatisticsForTimeStep(0).GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+	meanTimestep1 = statisticsContainer->GetStatisticsForTimeStep(1).GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+	CPPUNIT_ASSERT_MESSAGE("Timestep without modified region was computed again.", std::abs(meanTimestep0) < mitk::eps);
+	CPPUNIT_ASSERT_MESSAGE("Timestep with modified region was not computed again.", std::abs(meanTimestep1 - 2.) < mitk::eps);
+
+	// a modification without region requires the computation of all timesteps
+	image->Modified();
+
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = imgStatCalc->GetStatistics());
+	meanTimestep0 = statisticsContainer->GetStatisticsForTimeStep(0).GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+	CPPUNIT_ASSERT_MESSAGE("Timestep was not computed again.", std::abs(meanTimestep0 - 1.001) < mitk::eps);
+}
+
 const mitk::ImageStatisticsContainer::Pointer
 mitkImageStatisticsCalculatorTestSuite::ComputeStatistics(mitk::Image::ConstPointer image,
 	mitk::MaskGenerator::Pointer maskGen,
@@ -105,9 +105,21 @@ namespace mitk
     if (IsUpdateRequired(label))
     {
       auto timeGeometry = m_Image->GetTimeGeometry();
-      // always compute statistics on all timesteps
+      // compute statistics on all timesteps that changed since the last computation, determined before the mask
+      // generators are modified below
+      std::vector<bool> timeStepIsUpToDate(m_Image->GetTimeSteps());
       for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
       {
+        timeStepIsUpToDate[timeStep] = this->IsTimeStepUpToDate(timeStep);
+      }
+
+      for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
+      {
+        if (timeStepIsUpToDate[timeStep])
+        {
+          continue;
+        }
+
         if (m_MaskGenerator.IsNotNull())
         {
           m_MaskGenerator->SetTimeStep(timeStep);
@@ -153,6 +165,9 @@ namespace mitk
           AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
         }
       }
+
+      m_CalculatedImageMTime = m_Image->GetMTime();
+      m_CalculatedInputsMTime = this->GetInputsMTime();
     }
 
     auto it = m_StatisticContainers.find(label);
@@ -549,4 +564,43 @@ namespace mitk
 
     return false;
   }
+
+  bool ImageStatisticsCalculator::IsTimeStepUpToDate(TimeStepType timeStep) const
+  {
+    // the statistics of all time steps have to be computed again if anything else than regions of the image changed
+    if (0 == m_CalculatedImageMTime || this->GetInputsMTime() != m_CalculatedInputsMTime)
+    {
+      return false;
+    }
+
+    // statistics are computed on the reference image of the mask generator, whose changes are not recorded here
+    if (m_MaskGenerator.IsNotNull() && m_MaskGenerator->GetReferenceImage().IsNotNull() &&
+        m_MaskGenerator->GetReferenceImage() != m_Image)
+    {
+      return false;
+    }
+
+    // median, entropy and the histogram depend on all voxels, so a modified region of a time step requires the
+    // computation of the whole time step
+    mitk::Image::VolumeRegionType modifiedRegion;
+    return m_Image->GetModifiedRegionSince(m_CalculatedImageMTime, timeStep, modifiedRegion) &&
+           0 == modifiedRegion.GetNumberOfPixels();
+  }
+
+  unsigned long ImageStatisticsCalculator::GetInputsMTime() const
+  {
+    unsigned long mtime = this->GetMTime();
+
+    if (m_MaskGenerator.IsNotNull())
+    {
+      mtime = std::max(mtime, m_MaskGenerator->GetMTime());
+    }
+
+    if (m_SecondaryMaskGenerator.IsNotNull())
+    {
+      mtime = std::max(mtime, m_SecondaryMaskGenerator->GetMTime());
+    }
+
+    return mtime;
+  }
 } // namespace mitk
@@ -73,6 +73,8 @@ namespace mitk
         /**Documentation
         @brief Returns the statistics for label @a label. If these requested statistics are not computed yet the computation is done as well.
         For performance reasons, statistics for all labels in the image are computed at once.
+        If the image was only changed in regions marked by Image::ModifiedRegion() since the last computation, only the
+        time steps that contain a modified region are computed again.
          */
         ImageStatisticsContainer* GetStatistics(LabelIndex label=1);
 
@@ -81,6 +83,8 @@ namespace mitk
             m_nBinsForHistogramStatistics = 100;
             m_binSizeForHistogramStatistics = 10;
             m_UseBinSizeOverNBins = false;
+            m_CalculatedImageMTime = 0;
+            m_CalculatedInputsMTime = 0;
         };
 
 
@@ -98,6 +102,13 @@ namespace mitk
 
         bool IsUpdateRequired(LabelIndex label) const;
 
+        /** Returns true if the statistics of the time step are still valid because only other time steps of the
+            image were changed by Image::ModifiedRegion() since the last computation. */
+        bool IsTimeStepUpToDate(TimeStepType timeStep) const;
+
+        /** Modified time of the calculator and its mask generators */
+        unsigned long GetInputsMTime() const;
+
         mitk::Image::ConstPointer m_Image;
         mitk::Image::Pointer m_ImageTimeSlice;
         mitk::Image::ConstPointer m_InternalImageForStatistics;
@@ -113,6 +124,10 @@ namespace mitk
         bool m_UseBinSizeOverNBins;
 
         std::map<LabelIndex,ImageStatisticsContainer::Pointer> m_StatisticContainers;
+
+        /** Modified times of the image and of the inputs at the last computation */
+        unsigned long m_CalculatedImageMTime;
+        unsigned long m_CalculatedInputsMTime;
     };
 
 }
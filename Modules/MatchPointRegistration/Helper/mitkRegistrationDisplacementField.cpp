@@ -0,0 +1,495 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkRegistrationDisplacementField.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  /** number of samples of the field by default, i.e. about 48 MB of displacements */
+  const std::size_t DEFAULT_MAXIMUM_NUMBER_OF_POINTS = 4 * 1024 * 1024;
+
+  unsigned long GetGeometryMTime(const mitk::BaseGeometry *geometry)
+  {
+    return std::max(geometry->GetMTime(), geometry->GetIndexToWorldTransform()->GetMTime());
+  }
+
+  /** Samples an affine mapping at its origin and the unit vectors. */
+  template <typename TAffineMapping, typename TFunction>
+  void InitializeAffineMapping(TAffineMapping &mapping, TFunction function)
+  {
+    double in[3] = {0.0, 0.0, 0.0};
+    function(in, mapping.Origin);
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+      in[axis] = 1.0;
+      function(in, mapping.Axes[axis]);
+      in[axis] = 0.0;
+
+      for (unsigned int i = 0; i < 3; ++i)
+        mapping.Axes[axis][i] -= mapping.Origin[i];
+    }
+  }
+
+  template <typename TAffineMapping>
+  void InitializeIndexToWorld(TAffineMapping &mapping, const mitk::BaseGeometry *geometry)
+  {
+    InitializeAffineMapping(mapping, [geometry](const double in[3], double out[3]) {
+      mitk::Point3D index(in);
+      mitk::Point3D world;
+      geometry->IndexToWorld(index, world);
+      std::copy(world.Begin(), world.End(), out);
+    });
+  }
+
+  template <typename TAffineMapping>
+  void InitializeWorldToIndex(TAffineMapping &mapping, const mitk::BaseGeometry *geometry)
+  {
+    InitializeAffineMapping(mapping, [geometry](const double in[3], double out[3]) {
+      mitk::Point3D world(in);
+      mitk::Point3D index;
+      geometry->WorldToIndex(world, index);
+      std::copy(index.Begin(), index.End(), out);
+    });
+  }
+}
+
+mitk::RegistrationDisplacementField::RegistrationDisplacementField()
+  : m_RegistrationMTime(0),
+    m_TargetGeometryMTime(0),
+    m_MaximumNumberOfPoints(DEFAULT_MAXIMUM_NUMBER_OF_POINTS),
+    m_NumberOfThreads(0),
+    m_SampleDistance(1),
+    m_Abort(false),
+    m_Generated(false),
+    m_MultiThreader(itk::MultiThreader::New()),
+    m_GenerationThreadID(-1),
+    m_GenerationFinished(true)
+{
+  std::fill(m_NumberOfSamples, m_NumberOfSamples + 3, 0);
+}
+
+mitk::RegistrationDisplacementField::~RegistrationDisplacementField()
+{
+  this->Abort();
+  this->WaitForGeneration();
+}
+
+void mitk::RegistrationDisplacementField::Initialize(const MAPRegistrationWrapper *registration,
+                                                     const BaseGeometry *targetGeometry)
+{
+  this->Abort();
+  this->WaitForGeneration();
+
+  m_Registration = registration;
+  m_RegistrationMTime = registration != nullptr ? registration->GetMTime() : 0;
+  m_TargetGeometry = targetGeometry;
+  m_TargetGeometryMTime = targetGeometry != nullptr ? GetGeometryMTime(targetGeometry) : 0;
+
+  m_Displacements.clear();
+  m_Abort = false;
+  m_Generated = false;
+}
+
+bool mitk::RegistrationDisplacementField::IsInitializedFor(const MAPRegistrationWrapper *registration,
+                                                           const BaseGeometry *targetGeometry) const
+{
+  return registration != nullptr && targetGeometry != nullptr && m_Registration == registration &&
+         m_RegistrationMTime == registration->GetMTime() && m_TargetGeometry == targetGeometry &&
+         m_TargetGeometryMTime == GetGeometryMTime(targetGeometry);
+}
+
+bool mitk::RegistrationDisplacementField::Generate()
+{
+  m_Generated = false;
+
+  if (m_Registration.IsNull() || m_TargetGeometry.IsNull() || m_Registration->GetRegistration() == nullptr ||
+      m_Registration->GetMovingDimensions() != 3 || m_Registration->GetTargetDimensions() != 3)
+  {
+    return false;
+  }
+
+  InitializeIndexToWorld(m_TargetIndexToWorld, m_TargetGeometry);
+  InitializeWorldToIndex(m_TargetWorldToIndex, m_TargetGeometry);
+
+  // the samples are placed on every m_SampleDistance-th voxel and include the last voxel in each direction
+  unsigned int dimensions[3];
+  for (unsigned int i = 0; i < 3; ++i)
+    dimensions[i] = std::max(1u, static_cast<unsigned int>(m_TargetGeometry->GetExtent(i) + 0.5));
+
+  for (m_SampleDistance = 1;; ++m_SampleDistance)
+  {
+    std::size_t numberOfPoints = 1;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      m_NumberOfSamples[i] = (dimensions[i] - 1 + m_SampleDistance - 1) / m_SampleDistance + 1;
+      numberOfPoints *= m_NumberOfSamples[i];
+    }
+
+    if (numberOfPoints <= m_MaximumNumberOfPoints || m_SampleDistance >= *std::max_element(dimensions, dimensions + 3))
+      break;
+  }
+
+  const std::size_t sliceSize = static_cast<std::size_t>(m_NumberOfSamples[0]) * m_NumberOfSamples[1];
+  m_Displacements.assign(3 * sliceSize * m_NumberOfSamples[2], std::numeric_limits<float>::quiet_NaN());
+
+  // lazy kernels generate their own field when they are used first, this must not happen in several threads at once
+  double movingPoint[3];
+  this->MapPointByRegistration(m_TargetIndexToWorld.Origin, movingPoint);
+
+  mitk::ParallelFor(m_NumberOfSamples[2], m_NumberOfThreads, [&](std::size_t z) {
+    double index[3];
+    double targetPoint[3];
+    double mappedPoint[3];
+
+    index[2] = static_cast<double>(z * m_SampleDistance);
+
+    for (unsigned int y = 0; y < m_NumberOfSamples[1]; ++y)
+    {
+      if (m_Abort)
+        return;
+
+      index[1] = static_cast<double>(y * m_SampleDistance);
+
+      for (unsigned int x = 0; x < m_NumberOfSamples[0]; ++x)
+      {
+        index[0] = static_cast<double>(x * m_SampleDistance);
+        m_TargetIndexToWorld.Map(index, targetPoint);
+
+        if (!this->MapPointByRegistration(targetPoint, mappedPoint))
+          continue;
+
+        float *displacement = &m_Displacements[3 * (z * sliceSize + y * m_NumberOfSamples[0] + x)];
+        for (unsigned int i = 0; i < 3; ++i)
+          displacement[i] = static_cast<float>(mappedPoint[i] - targetPoint[i]);
+      }
+    }
+  });
+
+  if (m_Abort)
+    return false;
+
+  m_Generated = true;
+  return true;
+}
+
+void mitk::RegistrationDisplacementField::Abort()
+{
+  m_Abort = true;
+}
+
+void mitk::RegistrationDisplacementField::GenerateInBackground()
+{
+  this->WaitForGeneration();
+
+  m_GenerationFinished = false;
+  m_GenerationThreadID = m_MultiThreader->SpawnThread(GenerationThread, this);
+}
+
+bool mitk::RegistrationDisplacementField::IsGenerationFinished() const
+{
+  return m_GenerationFinished;
+}
+
+void mitk::RegistrationDisplacementField::WaitForGeneration()
+{
+  if (m_GenerationThreadID < 0)
+    return;
+
+  m_MultiThreader->TerminateThread(m_GenerationThreadID); // waits for the thread to terminate on its own
+  m_GenerationThreadID = -1;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::RegistrationDisplacementField::GenerationThread(void *pInfoStruct)
+{
+  auto *threadInfo = static_cast<itk::MultiThreader::ThreadInfoStruct *>(pInfoStruct);
+  auto *field = static_cast<RegistrationDisplacementField *>(threadInfo->UserData);
+
+  try
+  {
+    field->Generate();
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Displacement field of the registration could not be generated.";
+  }
+
+  field->m_GenerationFinished = true;
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool mitk::RegistrationDisplacementField::IsGenerated() const
+{
+  return m_Generated;
+}
+
+bool mitk::RegistrationDisplacementField::MapPointByRegistration(const double targetPoint[3],
+                                                                 double movingPoint[3]) const
+{
+  Point3D inPoint(targetPoint);
+  Point3D outPoint;
+
+  try
+  {
+    if (!m_Registration->MapPointInverse<3, 3>(inPoint, outPoint))
+      return false;
+  }
+  catch (...)
+  {
+    return false;
+  }
+
+  std::copy(outPoint.Begin(), outPoint.End(), movingPoint);
+  return true;
+}
+
+bool mitk::RegistrationDisplacementField::IsInsideGrid(const double targetIndex[3]) const
+{
+  // like the image, the grid covers half a voxel beyond its outer samples
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (targetIndex[i] < -0.5 || targetIndex[i] > (m_NumberOfSamples[i] - 1) * m_SampleDistance + 0.5)
+      return false;
+  }
+
+  return true;
+}
+
+bool mitk::RegistrationDisplacementField::InterpolateDisplacement(const double targetIndex[3],
+                                                                  double displacement[3]) const
+{
+  unsigned int lower[3];
+  unsigned int upper[3];
+  double weight[3];
+
+  // within half a voxel beyond the outer samples the displacement is extrapolated linearly
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (m_NumberOfSamples[i] < 2)
+    {
+      lower[i] = 0;
+      upper[i] = 0;
+      weight[i] = 0.0;
+      continue;
+    }
+
+    const double position = targetIndex[i] / m_SampleDistance;
+    const double cell = std::min(std::max(std::floor(position), 0.0), static_cast<double>(m_NumberOfSamples[i] - 2));
+
+    lower[i] = static_cast<unsigned int>(cell);
+    upper[i] = lower[i] + 1;
+    weight[i] = position - cell;
+  }
+
+  std::fill(displacement, displacement + 3, 0.0);
+
+  for (unsigned int corner = 0; corner < 8; ++corner)
+  {
+    const unsigned int x = (corner & 1) ? upper[0] : lower[0];
+    const unsigned int y = (corner & 2) ? upper[1] : lower[1];
+    const unsigned int z = (corner & 4) ? upper[2] : lower[2];
+
+    const double cornerWeight = ((corner & 1) ? weight[0] : 1.0 - weight[0]) *
+                                ((corner & 2) ? weight[1] : 1.0 - weight[1]) *
+                                ((corner & 4) ? weight[2] : 1.0 - weight[2]);
+
+    const float *sample =
+      &m_Displacements[3 * ((static_cast<std::size_t>(z) * m_NumberOfSamples[1] + y) * m_NumberOfSamples[0] + x)];
+
+    // a sample that could not be mapped invalidates its neighbourhood, like the mapping error of the registration
+    if (std::isnan(sample[0]))
+      return false;
+
+    for (unsigned int i = 0; i < 3; ++i)
+      displacement[i] += cornerWeight * sample[i];
+  }
+
+  return true;
+}
+
+bool mitk::RegistrationDisplacementField::MapPointInverse(const Point3D &targetPoint, Point3D &movingPoint) const
+{
+  double point[3] = {targetPoint[0], targetPoint[1], targetPoint[2]};
+  double mappedPoint[3];
+
+  if (!m_Generated)
+  {
+    if (m_Registration.IsNull() || !this->MapPointByRegistration(point, mappedPoint))
+      return false;
+
+    movingPoint = Point3D(mappedPoint);
+    return true;
+  }
+
+  double index[3];
+  m_TargetWorldToIndex.Map(point, index);
+
+  if (!this->IsInsideGrid(index))
+  {
+    if (!this->MapPointByRegistration(point, mappedPoint))
+      return false;
+
+    movingPoint = Point3D(mappedPoint);
+    return true;
+  }
+
+  double displacement[3];
+  if (!this->InterpolateDisplacement(index, displacement))
+    return false;
+
+  for (unsigned int i = 0; i < 3; ++i)
+    movingPoint[i] = point[i] + displacement[i];
+
+  return true;
+}
+
+bool mitk::RegistrationDisplacementField::CanMapImage(const Image *input) const
+{
+  return input != nullptr && input->IsInitialized() && input->GetDimension() == 3 && input->GetTimeSteps() == 1 &&
+         input->GetPixelType().GetNumberOfComponents() == 1;
+}
+
+mitk::Image::Pointer mitk::RegistrationDisplacementField::MapImage(const Image *input,
+                                                                   const BaseGeometry *resultGeometry) const
+{
+  if (!m_Generated)
+    mitkThrow() << "Cannot map image. The displacement field is not generated.";
+
+  if (!this->CanMapImage(input) || resultGeometry == nullptr)
+    mitkThrow() << "Cannot map image. The input image is not supported or the result geometry is missing.";
+
+  Image::Pointer result = Image::New();
+  result->Initialize(input->GetPixelType(), *resultGeometry);
+
+  AccessFixedDimensionByItk_2(input, MapImageInternal, 3, resultGeometry, result.GetPointer());
+
+  return result;
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void mitk::RegistrationDisplacementField::MapImageInternal(const itk::Image<TPixel, VImageDimension> *input,
+                                                           const BaseGeometry *resultGeometry,
+                                                           Image *result) const
+{
+  typedef itk::Image<TPixel, VImageDimension> InputImageType;
+
+  AffineMapping resultIndexToWorld;
+  InitializeIndexToWorld(resultIndexToWorld, resultGeometry);
+
+  AffineMapping movingWorldToIndex;
+  InitializeAffineMapping(movingWorldToIndex, [input](const double in[3], double out[3]) {
+    typename InputImageType::PointType point;
+    itk::ContinuousIndex<double, VImageDimension> index;
+    std::copy(in, in + 3, point.Begin());
+    input->TransformPhysicalPointToContinuousIndex(point, index);
+    std::copy(index.Begin(), index.End(), out);
+  });
+
+  const typename InputImageType::SizeType &inputSize = input->GetLargestPossibleRegion().GetSize();
+  const TPixel *inputBuffer = input->GetBufferPointer();
+
+  unsigned int resultSize[3] = {1, 1, 1};
+  for (unsigned int i = 0; i < std::min(3u, result->GetDimension()); ++i)
+    resultSize[i] = result->GetDimension(i);
+
+  ImageWriteAccessor resultAccessor(result);
+  TPixel *resultBuffer = static_cast<TPixel *>(resultAccessor.GetData());
+
+  // values outside of the range of the pixel type are clamped, like in itk::ResampleImageFilter
+  const double minimumValue = static_cast<double>(std::numeric_limits<TPixel>::lowest());
+  const double maximumValue = static_cast<double>(std::numeric_limits<TPixel>::max());
+
+  mitk::ParallelFor(static_cast<std::size_t>(resultSize[1]) * resultSize[2], m_NumberOfThreads, [&](std::size_t row) {
+    double resultIndex[3] = {0.0, static_cast<double>(row % resultSize[1]), static_cast<double>(row / resultSize[1])};
+    double targetPoint[3];
+    double targetIndex[3];
+    double movingPoint[3];
+    double movingIndex[3];
+    double displacement[3];
+
+    TPixel *resultPixel = resultBuffer + row * resultSize[0];
+
+    for (unsigned int x = 0; x < resultSize[0]; ++x, ++resultPixel)
+    {
+      *resultPixel = TPixel(0);
+
+      resultIndex[0] = x;
+      resultIndexToWorld.Map(resultIndex, targetPoint);
+      m_TargetWorldToIndex.Map(targetPoint, targetIndex);
+
+      if (this->IsInsideGrid(targetIndex))
+      {
+        if (!this->InterpolateDisplacement(targetIndex, displacement))
+          continue;
+
+        for (unsigned int i = 0; i < 3; ++i)
+          movingPoint[i] = targetPoint[i] + displacement[i];
+      }
+      else if (!this->MapPointByRegistration(targetPoint, movingPoint))
+      {
+        continue;
+      }
+
+      movingWorldToIndex.Map(movingPoint, movingIndex);
+
+      // trilinear interpolation, points within half a voxel of the image are interpolated with the border voxels
+      itk::SizeValueType lower[3];
+      itk::SizeValueType upper[3];
+      double weight[3];
+      bool inside = true;
+
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double maximum = static_cast<double>(inputSize[i] - 1);
+        if (movingIndex[i] < -0.5 || movingIndex[i] > maximum + 0.5)
+        {
+          inside = false;
+          break;
+        }
+
+        const double position = std::min(std::max(movingIndex[i], 0.0), maximum);
+        lower[i] = static_cast<itk::SizeValueType>(position);
+        upper[i] = std::min<itk::SizeValueType>(lower[i] + 1, inputSize[i] - 1);
+        weight[i] = position - lower[i];
+      }
+
+      if (!inside)
+        continue;
+
+      double value = 0.0;
+      for (unsigned int corner = 0; corner < 8; ++corner)
+      {
+        const itk::SizeValueType ix = (corner & 1) ? upper[0] : lower[0];
+        const itk::SizeValueType iy = (corner & 2) ? upper[1] : lower[1];
+        const itk::SizeValueType iz = (corner & 4) ? upper[2] : lower[2];
+
+        const double cornerWeight = ((corner & 1) ? weight[0] : 1.0 - weight[0]) *
+                                    ((corner & 2) ? weight[1] : 1.0 - weight[1]) *
+                                    ((corner & 4) ? weight[2] : 1.0 - weight[2]);
+
+        if (cornerWeight != 0.0)
+          value += cornerWeight * inputBuffer[(iz * inputSize[1] + iy) * inputSize[0] + ix];
+      }
+
+      *resultPixel = static_cast<TPixel>(std::min(std::max(value, minimumValue), maximumValue));
+    }
+  });
+}
@@ -0,0 +1,158 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef __MITK_REGISTRATION_DISPLACEMENT_FIELD_H_
+#define __MITK_REGISTRATION_DISPLACEMENT_FIELD_H_
+
+#include <mitkImage.h>
+#include <mitkMAPRegistrationWrapper.h>
+
+#include <itkMultiThreader.h>
+
+#include <atomic>
+#include <vector>
+
+#include "MitkMatchPointRegistrationExports.h"
+
+namespace mitk
+{
+  /** Inverse mapping of a registration sampled on the grid of a target geometry.
+   * Generate() maps every grid point from target to moving space once and stores the displacement.
+   * Afterwards MapPointInverse() and MapImage() interpolate the displacement trilinearly instead of
+   * passing every point through the mapping kernel of the registration, which is slow for deformable
+   * registrations. If the grid has more than MaximumNumberOfPoints points, every n-th grid point
+   * is sampled in each direction.
+   * MapImage() reproduces ImageMappingHelper::map() with linear interpolation, padding value 0 and
+   * error value 0 for 3D images with one time step.
+   * GenerateInBackground() runs Generate() in a thread of its own, it can be stopped with Abort().
+   */
+  class MITKMATCHPOINTREGISTRATION_EXPORT RegistrationDisplacementField : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(RegistrationDisplacementField, itk::Object);
+
+    itkNewMacro(Self);
+
+    /** Sets the registration and the target geometry whose grid is sampled. The field has to be generated again,
+     * a running generation is stopped. */
+    void Initialize(const MAPRegistrationWrapper *registration, const BaseGeometry *targetGeometry);
+
+    /** Returns whether the field was initialized with the given registration and target geometry, and neither
+     * of them was modified since. */
+    bool IsInitializedFor(const MAPRegistrationWrapper *registration, const BaseGeometry *targetGeometry) const;
+
+    itkSetMacro(MaximumNumberOfPoints, std::size_t);
+    itkGetConstMacro(MaximumNumberOfPoints, std::size_t);
+
+    /** Number of threads used by Generate() and MapImage(), 0 (default) to use the default number of threads of ITK. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Samples the inverse mapping of the registration.
+     * @return false if the registration is not a 3D registration or the generation was aborted.*/
+    bool Generate();
+
+    /** Stops a running Generate() as soon as possible. */
+    void Abort();
+
+    /** Starts Generate() in a thread of its own. */
+    void GenerateInBackground();
+
+    /** Returns whether the generation started by GenerateInBackground() finished, successfully or not. */
+    bool IsGenerationFinished() const;
+
+    /** Waits until the generation started by GenerateInBackground() finished. */
+    void WaitForGeneration();
+
+    /** Returns whether Generate() finished successfully. */
+    bool IsGenerated() const;
+
+    /** Maps a point from target to moving space by interpolating the sampled displacement.
+     * Points outside of the sampled grid are mapped by the registration itself.
+     * @return false if the mapping failed.*/
+    bool MapPointInverse(const Point3D &targetPoint, Point3D &movingPoint) const;
+
+    /** Returns whether MapImage() supports the image, i.e. it is a 3D image with one time step and scalar pixels. */
+    bool CanMapImage(const Image *input) const;
+
+    /** Maps the input image into the grid of the result geometry, see ImageMappingHelper::map().
+     * @pre the field must be generated and CanMapImage(input) must be true.*/
+    Image::Pointer MapImage(const Image *input, const BaseGeometry *resultGeometry) const;
+
+  protected:
+    RegistrationDisplacementField();
+    ~RegistrationDisplacementField() override;
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void MapImageInternal(const itk::Image<TPixel, VImageDimension> *input,
+                          const BaseGeometry *resultGeometry,
+                          Image *result) const;
+
+    /** Returns whether the continuous index of the target geometry is covered by the samples. */
+    bool IsInsideGrid(const double targetIndex[3]) const;
+
+    /** Interpolates the displacement at a continuous index of the target geometry inside of the grid.
+     * @return false if a neighbouring sample could not be mapped.*/
+    bool InterpolateDisplacement(const double targetIndex[3], double displacement[3]) const;
+
+    /** Maps a point from target to moving space by the registration itself. */
+    bool MapPointByRegistration(const double targetPoint[3], double movingPoint[3]) const;
+
+    /** static start method of the generation thread */
+    static ITK_THREAD_RETURN_TYPE GenerationThread(void *pInfoStruct);
+
+    /** Affine mapping between world and index coordinates of a geometry */
+    struct AffineMapping
+    {
+      double Origin[3];
+      double Axes[3][3];
+
+      void Map(const double in[3], double out[3]) const
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+          out[i] = Origin[i] + Axes[0][i] * in[0] + Axes[1][i] * in[1] + Axes[2][i] * in[2];
+      }
+    };
+
+  private:
+    MAPRegistrationWrapper::ConstPointer m_Registration;
+    unsigned long m_RegistrationMTime;
+
+    BaseGeometry::ConstPointer m_TargetGeometry;
+    unsigned long m_TargetGeometryMTime;
+
+    std::size_t m_MaximumNumberOfPoints;
+    unsigned int m_NumberOfThreads;
+
+    AffineMapping m_TargetIndexToWorld;
+    AffineMapping m_TargetWorldToIndex;
+
+    /** distance of the samples in voxels of the target geometry */
+    unsigned int m_SampleDistance;
+    unsigned int m_NumberOfSamples[3];
+
+    /** displacements of the samples, NaN if the mapping failed */
+    std::vector<float> m_Displacements;
+
+    std::atomic<bool> m_Abort;
+    std::atomic<bool> m_Generated;
+
+    itk::MultiThreader::Pointer m_MultiThreader;
+    int m_GenerationThreadID;
+    std::atomic<bool> m_GenerationFinished;
+
+    RegistrationDisplacementField(const Self &) = delete;
+    Self &operator=(const Self &) = delete;
+  };
+}
+
+#endif
@@ -68,7 +68,7 @@ found in the LICENSE file.
 #include <mitkRegEvaluationObject.h>
 #include <mitkImageMappingHelper.h>
 
-mitk::RegEvaluationMapper2D::RegEvaluationMapper2D()
+mitk::RegEvaluationMapper2D::RegEvaluationMapper2D() : m_DisplacementFieldPending(false)
 {
 }
 
@@ -282,8 +282,16 @@ void mitk::RegEvaluationMapper2D::GenerateDataForRenderer( mitk::BaseRenderer *r
     movingInput->GetMTime() > localStorage->m_LastUpdateTime ||
     reg->GetMTime() > localStorage->m_LastUpdateTime)
   {
-    //Map moving image
-    localStorage->m_slicedMappedImage = mitk::ImageMappingHelper::map(movingInput,reg,false,0,localStorage->m_slicedTargetImage->GetGeometry(),false,0);
+    //Map moving image, by the displacement field as soon as it is available
+    const RegistrationDisplacementField* field = this->GetDisplacementField(reg, targetInput);
+    if (field != nullptr && field->CanMapImage(movingInput))
+    {
+      localStorage->m_slicedMappedImage = field->MapImage(movingInput, localStorage->m_slicedTargetImage->GetGeometry());
+    }
+    else
+    {
+      localStorage->m_slicedMappedImage = mitk::ImageMappingHelper::map(movingInput,reg,false,0,localStorage->m_slicedTargetImage->GetGeometry(),false,0);
+    }
     updated = true;
   }
 
@@ -759,6 +767,44 @@ void mitk::RegEvaluationMapper2D::TransformActor(mitk::BaseRenderer* renderer)
   }
 }
 
+const mitk::RegistrationDisplacementField* mitk::RegEvaluationMapper2D::GetDisplacementField(const MAPRegistrationWrapper* registration, const Image* targetImage)
+{
+  if (registration == nullptr || targetImage == nullptr)
+  {
+    return nullptr;
+  }
+
+  if (m_DisplacementField.IsNull() || !m_DisplacementField->IsInitializedFor(registration, targetImage->GetGeometry()))
+  {
+    if (m_DisplacementField.IsNotNull())
+    { //the running generation is outdated
+      m_DisplacementField->Abort();
+    }
+
+    m_DisplacementField = RegistrationDisplacementField::New();
+    m_DisplacementField->Initialize(registration, targetImage->GetGeometry());
+    m_DisplacementField->GenerateInBackground();
+    m_DisplacementFieldPending = true;
+    return nullptr;
+  }
+
+  if (m_DisplacementFieldPending)
+  {
+    if (!m_DisplacementField->IsGenerationFinished())
+    {
+      return nullptr;
+    }
+
+    m_DisplacementFieldPending = false;
+    if (!m_DisplacementField->IsGenerated())
+    {
+      MITK_WARN << "Displacement field of the registration could not be generated. The moving image is mapped by the registration.";
+    }
+  }
+
+  return m_DisplacementField->IsGenerated() ? m_DisplacementField.GetPointer() : nullptr;
+}
+
 bool mitk::RegEvaluationMapper2D::RenderingGeometryIntersectsImage( const PlaneGeometry* renderingGeometry, SlicedGeometry3D* imageGeometry )
 {
   // if either one of the two geometries is nullptr we return true
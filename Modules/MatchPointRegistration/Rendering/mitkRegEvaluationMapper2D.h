@@ -16,6 +16,7 @@ found in the LICENSE file.
 //MatchPoint
 #include <mapRegistration.h>
 #include "mitkRegEvaluationObject.h"
+#include "mitkRegistrationDisplacementField.h"
 
 //MITK
 #include <mitkCommon.h>
@@ -238,6 +239,17 @@ protected:
     * If the distances have different sign, there is an intersection.
     **/
   bool RenderingGeometryIntersectsImage( const PlaneGeometry* renderingGeometry, SlicedGeometry3D* imageGeometry );
+
+  /** \brief Returns the displacement field of the registration on the grid of the target image.
+   * If the registration or the target geometry changed, the generation of a new field is started in the
+   * background. Until it is finished, nullptr is returned and the moving image is mapped by the registration.*/
+  const RegistrationDisplacementField* GetDisplacementField(const MAPRegistrationWrapper* registration, const Image* targetImage);
+
+private:
+  /** \brief The displacement field is shared by all renderers. */
+  RegistrationDisplacementField::Pointer m_DisplacementField;
+  /** \brief The displacement field is being generated and its result was not checked yet. */
+  bool m_DisplacementFieldPending;
 };
 
 } // namespace mitk
@@ -1,3 +1,4 @@
 SET(MODULE_TESTS
   mitkTimeFramesRegistrationHelperTest.cpp
+  mitkRegistrationDisplacementFieldTest.cpp
 )
\ No newline at end of file
@@ -0,0 +1,196 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+#include "mitkImageGenerator.h"
+#include "mitkImageMappingHelper.h"
+#include "mitkImagePixelReadAccessor.h"
+#include "mitkRegistrationDisplacementField.h"
+
+#include <mapNullRegistrationKernel.h>
+#include <mapPreCachedRegistrationKernel.h>
+#include <mapRegistrationManipulator.h>
+
+#include <itkEuler3DTransform.h>
+
+class mitkRegistrationDisplacementFieldTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRegistrationDisplacementFieldTestSuite);
+  MITK_TEST(MapPointInverse_EqualsRegistration);
+  MITK_TEST(MapPointInverse_CoarseField_EqualsRegistration);
+  MITK_TEST(MapImage_EqualsImageMappingHelper);
+  MITK_TEST(IsInitializedFor_ModifiedRegistration);
+  MITK_TEST(Generate_Aborted);
+  MITK_TEST(GenerateInBackground_EqualsRegistration);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef ::map::core::Registration<3, 3> MAPRegistrationType;
+
+  mitk::Image::Pointer m_Image;
+  mitk::MAPRegistrationWrapper::Pointer m_Registration;
+
+  void CheckMapPointInverse(const mitk::RegistrationDisplacementField *field)
+  {
+    const mitk::BaseGeometry *geometry = m_Image->GetGeometry();
+
+    mitk::Point3D index;
+    for (index[2] = -0.25; index[2] < 20; index[2] += 3.7)
+    {
+      for (index[1] = 0.3; index[1] < 15; index[1] += 2.9)
+      {
+        for (index[0] = 0.0; index[0] < 10; index[0] += 1.3)
+        {
+          mitk::Point3D targetPoint;
+          geometry->IndexToWorld(index, targetPoint);
+
+          mitk::Point3D expectedPoint;
+          mitk::Point3D movingPoint;
+          CPPUNIT_ASSERT(m_Registration->MapPointInverse<3, 3>(targetPoint, expectedPoint));
+          CPPUNIT_ASSERT(field->MapPointInverse(targetPoint, movingPoint));
+          CPPUNIT_ASSERT_MESSAGE("Mapped point differs from the registration", mitk::Equal(expectedPoint, movingPoint, 1e-4, true));
+        }
+      }
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateGradientImage<float>(10, 15, 20, 1.0, 1.5, 2.0);
+
+    // rigid transform, its displacement is interpolated exactly
+    itk::Euler3DTransform<::map::core::continuous::ScalarType>::Pointer transform =
+      itk::Euler3DTransform<::map::core::continuous::ScalarType>::New();
+    transform->SetRotation(0.05, -0.1, 0.2);
+    itk::Euler3DTransform<::map::core::continuous::ScalarType>::OutputVectorType translation;
+    translation[0] = 1.5;
+    translation[1] = -2.25;
+    translation[2] = 3.0;
+    transform->SetTranslation(translation);
+
+    MAPRegistrationType::Pointer registration = MAPRegistrationType::New();
+    ::map::core::RegistrationManipulator<MAPRegistrationType> manipulator(registration);
+    ::map::core::PreCachedRegistrationKernel<3, 3>::Pointer kernel = ::map::core::PreCachedRegistrationKernel<3, 3>::New();
+    kernel->setTransformModel(transform);
+    manipulator.setInverseMapping(kernel);
+    manipulator.setDirectMapping(::map::core::NullRegistrationKernel<3, 3>::New());
+
+    m_Registration = mitk::MAPRegistrationWrapper::New();
+    m_Registration->SetRegistration(registration);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Registration = nullptr;
+  }
+
+  void MapPointInverse_EqualsRegistration()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    CPPUNIT_ASSERT(field->Generate());
+    CPPUNIT_ASSERT(field->IsGenerated());
+
+    this->CheckMapPointInverse(field);
+
+    // points outside of the field are mapped by the registration
+    mitk::Point3D targetPoint;
+    mitk::FillVector3D(targetPoint, -50.0, 100.0, 7.0);
+    mitk::Point3D expectedPoint;
+    mitk::Point3D movingPoint;
+    CPPUNIT_ASSERT(m_Registration->MapPointInverse<3, 3>(targetPoint, expectedPoint));
+    CPPUNIT_ASSERT(field->MapPointInverse(targetPoint, movingPoint));
+    CPPUNIT_ASSERT(mitk::Equal(expectedPoint, movingPoint, 1e-6, true));
+  }
+
+  void MapPointInverse_CoarseField_EqualsRegistration()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->SetMaximumNumberOfPoints(100);
+    field->SetNumberOfThreads(2);
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    CPPUNIT_ASSERT(field->Generate());
+
+    this->CheckMapPointInverse(field);
+  }
+
+  void MapImage_EqualsImageMappingHelper()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    CPPUNIT_ASSERT(field->Generate());
+    CPPUNIT_ASSERT(field->CanMapImage(m_Image));
+
+    mitk::Image::Pointer expected =
+      mitk::ImageMappingHelper::map(m_Image, m_Registration, false, 0, m_Image->GetGeometry(), false, 0);
+    mitk::Image::Pointer result = field->MapImage(m_Image, m_Image->GetGeometry());
+
+    mitk::ImagePixelReadAccessor<float, 3> expectedAccessor(expected);
+    mitk::ImagePixelReadAccessor<float, 3> resultAccessor(result);
+
+    itk::Index<3> index;
+    for (index[2] = 0; index[2] < 20; ++index[2])
+      for (index[1] = 0; index[1] < 15; ++index[1])
+        for (index[0] = 0; index[0] < 10; ++index[0])
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedAccessor.GetPixelByIndex(index), resultAccessor.GetPixelByIndex(index), 1e-3);
+  }
+
+  void IsInitializedFor_ModifiedRegistration()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+
+    CPPUNIT_ASSERT(field->IsInitializedFor(m_Registration, m_Image->GetGeometry()));
+
+    m_Registration->Modified();
+    CPPUNIT_ASSERT(!field->IsInitializedFor(m_Registration, m_Image->GetGeometry()));
+
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    m_Image->GetGeometry()->SetSpacing(mitk::Vector3D(2.0));
+    CPPUNIT_ASSERT(!field->IsInitializedFor(m_Registration, m_Image->GetGeometry()));
+  }
+
+  void Generate_Aborted()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    field->Abort();
+
+    CPPUNIT_ASSERT(!field->Generate());
+    CPPUNIT_ASSERT(!field->IsGenerated());
+  }
+
+  void GenerateInBackground_EqualsRegistration()
+  {
+    mitk::RegistrationDisplacementField::Pointer field = mitk::RegistrationDisplacementField::New();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+    field->GenerateInBackground();
+    field->WaitForGeneration();
+
+    CPPUNIT_ASSERT(field->IsGenerationFinished());
+    CPPUNIT_ASSERT(field->IsGenerated());
+    this->CheckMapPointInverse(field);
+
+    // initializing again stops the generation and drops the field
+    field->GenerateInBackground();
+    field->Initialize(m_Registration, m_Image->GetGeometry());
+
+    CPPUNIT_ASSERT(field->IsGenerationFinished());
+    CPPUNIT_ASSERT(!field->IsGenerated());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRegistrationDisplacementField)
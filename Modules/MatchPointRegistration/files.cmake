@@ -11,6 +11,7 @@ set(CPP_FILES
   Helper/mitkPointSetMappingHelper.cpp
   Helper/mitkResultNodeGenerationHelper.cpp
   Helper/mitkTimeFramesRegistrationHelper.cpp
+  Helper/mitkRegistrationDisplacementField.cpp
   Rendering/mitkRegistrationWrapperMapper2D.cpp
   Rendering/mitkRegistrationWrapperMapper3D.cpp
   Rendering/mitkRegistrationWrapperMapperBase.cpp
@@ -45,6 +46,7 @@ set(H_FILES
   Helper/mitkPointSetMappingHelper.h
   Helper/mitkResultNodeGenerationHelper.h
   Helper/mitkTimeFramesRegistrationHelper.h
+  Helper/mitkRegistrationDisplacementField.h
   Rendering/mitkRegistrationWrapperMapper2D.h
   Rendering/mitkRegistrationWrapperMapper3D.h
   Rendering/mitkRegistrationWrapperMapperBase.h
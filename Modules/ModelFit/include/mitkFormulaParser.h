@@ -13,8 +13,11 @@ found in the LICENSE file.
 #ifndef __MITKFORMULAPARSER_H__
 #define __MITKFORMULAPARSER_H__
 
-#include <string>
+#include <cstddef>
 #include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "mitkExceptionMacro.h"
 
@@ -32,6 +35,68 @@ namespace mitk
   };
 
 
+  class FormulaProgram;
+
+  /*!
+   *	@brief		A formula that was translated once by @ref FormulaParser::compile and can be
+   *				evaluated for arbitrary variable values without parsing the string again.
+   *	@details	The formula is stored as a small stack program. Each variable of the formula
+   *				is bound to a slot; the slots are numbered in the order in which the
+   *				variables first appear in the formula (see @ref getVariableNames).
+   *				@ref evaluateSeries computes the formula for a whole series of values of one
+   *				variable (e.g. all time points of a time grid) block by block, so each
+   *				operation of the formula runs as a tight loop over the block.
+   *
+   *				Copies of a CompiledFormula share the (immutable) program, so it is cheap to
+   *				copy and can be evaluated from several threads at once.
+   */
+  class MITKMODELFIT_EXPORT CompiledFormula
+  {
+  public:
+    using ValueType = double;
+    using VariableNamesType = std::vector<std::string>;
+    using VariableValuesType = std::vector<ValueType>;
+
+    /*! @brief Constructs an empty formula. Evaluating it throws a FormulaParserException. */
+    CompiledFormula();
+
+    /*! @brief Returns true if the formula holds a compiled program. */
+    bool isValid() const;
+
+    /*! @brief Returns the names of the variables of the formula in the order of their slots. */
+    const VariableNamesType& getVariableNames() const;
+
+    /*!
+     *	@brief					Evaluates the formula.
+     *	@param[in] variables	The values of the variables, one per slot.
+     *	@return					The resulting value.
+     *	@throw FormulaParserException	If the formula is empty or the number of values does
+     *							not match the number of variables.
+     */
+    ValueType evaluate(const VariableValuesType& variables) const;
+
+    /*!
+     *	@brief					Evaluates the formula for a series of values of one variable.
+     *	@param[in] variables	The values of the variables, one per slot. The value of the slot
+     *							@b seriesSlot is ignored.
+     *	@param[in] seriesSlot	The slot of the variable that takes the values of @b series.
+     *	@param[in] series		Pointer to @b count values of the series variable.
+     *	@param[in] count		Number of values in the series.
+     *	@param[out] result		Pointer to memory for @b count results.
+     *	@throw FormulaParserException	If the formula is empty, the number of values does not
+     *							match the number of variables or @b seriesSlot is not a slot.
+     */
+    void evaluateSeries(const VariableValuesType& variables, std::size_t seriesSlot,
+      const ValueType* series, std::size_t count, ValueType* result) const;
+
+  private:
+    friend class FormulaParser;
+
+    CompiledFormula(std::shared_ptr<const FormulaProgram> program);
+
+    std::shared_ptr<const FormulaProgram> m_Program;
+  };
+
   /*!
    *	@brief		This class offers the functionality to evaluate simple mathematical formula
    *				strings (e.g. <code>"3.5 + 4 * x * sin(x) - 1 / 2"</code>).
@@ -59,6 +124,10 @@ namespace mitk
    *				sure to update the look-up table everytime a variable's value changes since that
    *				is not done automatically.
    *
+   *				If the same formula has to be evaluated for many different values (e.g. for
+   *				every time point of a model), use @ref FormulaParser::compile instead. It
+   *				parses the string only once and returns a @ref CompiledFormula.
+   *
    *	@author		Sascha Diatschuk
    */
   class MITKMODELFIT_EXPORT FormulaParser
@@ -98,6 +167,16 @@ namespace mitk
      */
     ValueType lookupVariable(const std::string var);
 
+    /*!
+     *	@brief				Translates the @b input string into a formula that can be evaluated
+     *						repeatedly without parsing it again. No variables are looked up.
+     *	@param[in] input	The string to be compiled.
+     *	@return				The compiled formula.
+     *	@throw FormulaParserException	If the parser comes across an unexpected character or
+     *						cannot apply the grammar to the string at all.
+     */
+    static CompiledFormula compile(const std::string& input);
+
   private:
     /*! @brief Map that holds the values that will replace the variables during evaluation. */
     const VariableMapType* m_Variables;
@@ -14,6 +14,7 @@ found in the LICENSE file.
 #define __MITK_GENERIC_PARAM_MODEL_H_
 
 #include "mitkModelBase.h"
+#include "mitkFormulaParser.h"
 
 #include "MitkModelFitExports.h"
 
@@ -31,6 +32,9 @@ namespace mitk
   - following unary functions: abs, exp, sin, cos, tan, sind (sine in degrees), cosd (cosine in degrees), tand (tangent in degrees)
   - variables (x, a, b, ... j)
 
+  The function string is compiled once when it is set; computing the model function then evaluates
+  the compiled formula for the whole time grid at once.
+
   Remark: The variable "x" is reserved. It is the signal position / timepoint.
   Remark: The current version supports up to 10 model parameter.
   Don't use it for a model parameter that should be deduced by fitting (these are a..j).*/
@@ -60,7 +64,10 @@ namespace mitk
     std::string GetModelType() const override;
 
     FunctionStringType GetFunctionString() const override;
-    itkSetStringMacro(FunctionString);
+    /**Sets the function string and compiles it. Errors in the string are reported (as
+     FormulaParserException) when the model function is computed.*/
+    void SetFunctionString(const FunctionStringType& functionString);
+    void SetFunctionString(const char* functionString);
 
     /**@pre The Number of paremeters must be between 1 and 10.*/
     itkSetClampMacro(NumberOfParameters, ParametersSizeType, 1, 10);
@@ -95,6 +102,9 @@ namespace mitk
     /**Function string that should be parsed when computing the model function.*/
     FunctionStringType m_FunctionString;
 
+    /**Compiled version of m_FunctionString. Invalid if the string could not be compiled.*/
+    CompiledFormula m_Formula;
+
     /**Number of parameters the model should offer / the function string contains.*/
     ParametersSizeType m_NumberOfParameters;
 
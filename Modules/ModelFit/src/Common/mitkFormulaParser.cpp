@@ -15,6 +15,8 @@ found in the LICENSE file.
 #include <boost/spirit/include/phoenix.hpp>
 #include <boost/version.hpp>
 
+#include <algorithm>
+
 #include "mitkFormulaParser.h"
 #include "mitkFresnel.h"
 
@@ -110,59 +112,197 @@ namespace mitk
   }
 
   /*!
-   *	@brief		The grammar that defines the language (i.e. what is allowed) for the parser.
+   *	@brief		The program a formula is compiled to.
+   *	@details	The instructions are in postfix order and work on a value stack: constants
+   *				and variables push a value, the operations replace the topmost value(s) by
+   *				the result. Each instruction is executed for a whole block of values at once.
    */
-  class Grammar : public qi::grammar<Iter, FormulaParser::ValueType(), Skipper>
+  class FormulaProgram
   {
-    /*!
-     *	@brief	Helper structure that makes it easier to dynamically call any
-     *			one-parameter-function by overloading the @c () operator.
-     */
-    struct func1_
+  public:
+    using ValueType = FormulaParser::ValueType;
+    using FunctionType = ValueType(*)(ValueType);
+
+    enum class OperationType
     {
-      // Required for Phoenix 3+
-      template<typename Sig>
-      struct result;
+      Constant,
+      Variable,
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Negate,
+      Function
+    };
 
-      /*!
-       *	@brief				Helper structure that is needed for compatibility with
-       *						@c boost::phoenix.
-       *	@tparam Functor		Type of the functor (this struct).
-       *	@tparam Function	Type of the function that should be called.
-       *	@tparam Arg1		Type of the argument the function should be called with.
-       *
-       */
-      template<typename Functor, typename Function, typename Arg1>
-      struct result<Functor(Function, Arg1&)>
+    struct Instruction
+    {
+      OperationType operation;
+      ValueType value;
+      std::size_t slot;
+      FunctionType function;
+    };
+
+    void pushConstant(ValueType value)
+    {
+      m_Instructions.push_back({ OperationType::Constant, value, 0, nullptr });
+    }
+
+    void pushVariable(const std::string& name)
+    {
+      auto finding = std::find(m_VariableNames.begin(), m_VariableNames.end(), name);
+      const std::size_t slot = static_cast<std::size_t>(finding - m_VariableNames.begin());
+      if (finding == m_VariableNames.end())
       {
-        /*! @brief The result structure always needs this typedef */
-        typedef Arg1 type;
-      };
+        m_VariableNames.push_back(name);
+      }
+      m_Instructions.push_back({ OperationType::Variable, 0, slot, nullptr });
+    }
 
-      /*!
-       *	@brief				Calls the function @b f with the argument @b a1 and returns the
-       *						result.
-       *						The result always has the same type as the argument.
-       *	@tparam Function	Type of the function that should be called.
-       *	@tparam Arg1			Type of the argument the function should be called with.
-       *	@param[in] f		The function that should be called.
-       *	@param[in] a1		The argument the function should be called with.
-       *	@return				The result of the called function.
-       */
-      template<typename Function, typename Arg1>
-      Arg1 operator()(const Function f, const Arg1 a1) const
+    void pushOperation(OperationType operation)
+    {
+      m_Instructions.push_back({ operation, 0, 0, nullptr });
+    }
+
+    void pushFunction(FunctionType function)
+    {
+      m_Instructions.push_back({ OperationType::Function, 0, 0, function });
+    }
+
+    /*! @brief Computes the needed stack depth. Has to be called once after the program is built. */
+    void finalize()
+    {
+      std::size_t depth = 0;
+      for (const auto& instruction : m_Instructions)
       {
-        return f(a1);
+        switch (instruction.operation)
+        {
+        case OperationType::Constant:
+        case OperationType::Variable:
+          m_StackDepth = std::max(m_StackDepth, ++depth);
+          break;
+        case OperationType::Add:
+        case OperationType::Subtract:
+        case OperationType::Multiply:
+        case OperationType::Divide:
+          --depth;
+          break;
+        default:
+          break;
+        }
       }
-    };
+    }
+
+    const CompiledFormula::VariableNamesType& getVariableNames() const
+    {
+      return m_VariableNames;
+    }
+
+    /*!
+     *	@brief	Executes the program for @b count values. If @b series is not null, the
+     *			variable in slot @b seriesSlot takes the values of @b series instead of its
+     *			value in @b variables.
+     */
+    void execute(const ValueType* variables, std::size_t seriesSlot, const ValueType* series,
+      std::size_t count, ValueType* result) const
+    {
+      // number of values that are computed at once by every instruction
+      const std::size_t blockSize = 256;
+      const std::size_t stride = std::min(count, blockSize);
+      std::vector<ValueType> stack(m_StackDepth * stride);
+
+      for (std::size_t offset = 0; offset < count; offset += stride)
+      {
+        const std::size_t n = std::min(stride, count - offset);
+        ValueType* top = nullptr;
+
+        for (const auto& instruction : m_Instructions)
+        {
+          switch (instruction.operation)
+          {
+          case OperationType::Constant:
+          case OperationType::Variable:
+          {
+            top = (top == nullptr) ? stack.data() : top + stride;
+            if (instruction.operation == OperationType::Variable && series != nullptr && instruction.slot == seriesSlot)
+            {
+              std::copy(series + offset, series + offset + n, top);
+            }
+            else
+            {
+              const ValueType value = (instruction.operation == OperationType::Constant) ? instruction.value : variables[instruction.slot];
+              std::fill(top, top + n, value);
+            }
+            break;
+          }
+          case OperationType::Add:
+          {
+            ValueType* a = top - stride;
+            for (std::size_t i = 0; i < n; ++i)
+              a[i] += top[i];
+            top = a;
+            break;
+          }
+          case OperationType::Subtract:
+          {
+            ValueType* a = top - stride;
+            for (std::size_t i = 0; i < n; ++i)
+              a[i] -= top[i];
+            top = a;
+            break;
+          }
+          case OperationType::Multiply:
+          {
+            ValueType* a = top - stride;
+            for (std::size_t i = 0; i < n; ++i)
+              a[i] *= top[i];
+            top = a;
+            break;
+          }
+          case OperationType::Divide:
+          {
+            ValueType* a = top - stride;
+            for (std::size_t i = 0; i < n; ++i)
+              a[i] /= top[i];
+            top = a;
+            break;
+          }
+          case OperationType::Negate:
+            for (std::size_t i = 0; i < n; ++i)
+              top[i] = -top[i];
+            break;
+          case OperationType::Function:
+            for (std::size_t i = 0; i < n; ++i)
+              top[i] = instruction.function(top[i]);
+            break;
+          }
+        }
+
+        std::copy(top, top + n, result + offset);
+      }
+    }
+
+  private:
+    std::vector<Instruction> m_Instructions;
+    CompiledFormula::VariableNamesType m_VariableNames;
+    std::size_t m_StackDepth = 0;
+  };
 
+  /*!
+   *	@brief		The grammar that defines the language (i.e. what is allowed) for the parser.
+   *	@details	Instead of computing the value directly, the semantic actions append the
+   *				matching instructions to a FormulaProgram. Partially matched alternatives may
+   *				leave instructions behind, but the grammar is built so that this only happens
+   *				if the input cannot be parsed at all.
+   */
+  class Grammar : public qi::grammar<Iter, Skipper>
+  {
     /*!
-     *	@brief	Helper structure that maps strings to function calls so that parsing e.g.
-     *			@c "cos(0)" actually calls the @c std::cos function with parameter @c 1 so it
-     *			returns @c 0.
+     *	@brief	Helper structure that maps strings to functions so that parsing e.g.
+     *			@c "cos(0)" adds a call of the @c std::cos function to the program.
      */
     class unaryFunction_ :
-      public qi::symbols<typename std::iterator_traits<Iter>::value_type, FormulaParser::ValueType(*)(FormulaParser::ValueType)>
+      public qi::symbols<typename std::iterator_traits<Iter>::value_type, FormulaProgram::FunctionType>
     {
     public:
       /*!
@@ -186,70 +326,131 @@ namespace mitk
 
   public:
     /*!
-     *	@brief							Constructs the grammar with the given formula parser.
-     *	@param[in, out] formulaParser	The formula parser this grammar is for - so it can
-     *									access its variable map.
+     *	@brief						Constructs the grammar for the given program.
+     *	@param[in, out] program		The program the instructions of the parsed input are
+     *								appended to.
      */
-    Grammar(FormulaParser& formulaParser) : Grammar::base_type(start)
+    Grammar(FormulaProgram& program) : Grammar::base_type(start)
     {
-      using qi::_val;
       using qi::_1;
-      using qi::_2;
       using qi::char_;
       using qi::alpha;
       using qi::alnum;
       using qi::double_;
       using qi::as_string;
+      using Operation = FormulaProgram::OperationType;
 
-      phx::function<func1_> func1;
+      auto pushOperation = [&program](Operation operation)
+      {
+        return phx::bind(&FormulaProgram::pushOperation, phx::ref(program), operation);
+      };
 
       start = expression > qi::eoi;
 
-      expression = term[_val = _1]
-        >> *(('+' >> term[_val += _1])
-          | ('-' >> term[_val -= _1]));
+      expression = term
+        >> *(('+' >> term)[pushOperation(Operation::Add)]
+          | ('-' >> term)[pushOperation(Operation::Subtract)]);
 
-      term = factor[_val = _1]
-        >> *(('*' >> factor[_val *= _1])
-          | ('/' >> factor[_val /= _1]));
+      term = factor
+        >> *(('*' >> factor)[pushOperation(Operation::Multiply)]
+          | ('/' >> factor)[pushOperation(Operation::Divide)]);
 
-      factor = primary[_val = _1];
+      factor = primary.alias();
       /*!	@TODO:	Repair exponentiation */
-      //>> *('^' >> factor[phx::bind<FormulaParser::ValueType, FormulaParser::ValueType, FormulaParser::ValueType>(std::pow, _val, _1)]);
 
       variable = as_string[alpha >> *(alnum | char_('_'))]
-        [_val = phx::bind(&FormulaParser::lookupVariable, &formulaParser, _1)];
-
-      primary = double_[_val = _1]
-        | '(' >> expression[_val = _1] >> ')'
-        | ('-' >> primary[_val = -_1])
-        | ('+' >> primary[_val = _1])
-        | (unaryFunction >> '(' >> expression >> ')')[_val = func1(_1, _2)]
-        | variable[_val = _1];
+        [phx::bind(&FormulaProgram::pushVariable, phx::ref(program), _1)];
+
+      primary = double_[phx::bind(&FormulaProgram::pushConstant, phx::ref(program), _1)]
+        | '(' >> expression >> ')'
+        | ('-' >> primary)[pushOperation(Operation::Negate)]
+        | ('+' >> primary)
+        | (unaryFunction >> '(' >> expression >> ')')[phx::bind(&FormulaProgram::pushFunction, phx::ref(program), _1)]
+        | variable;
     }
 
     /*! the rules of the grammar. */
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> start;
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> expression;
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> term;
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> factor;
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> variable;
-    qi::rule<Iter, FormulaParser::ValueType(), Skipper> primary;
+    qi::rule<Iter, Skipper> start;
+    qi::rule<Iter, Skipper> expression;
+    qi::rule<Iter, Skipper> term;
+    qi::rule<Iter, Skipper> factor;
+    qi::rule<Iter, Skipper> variable;
+    qi::rule<Iter, Skipper> primary;
   };
 
 
+  CompiledFormula::CompiledFormula()
+  {}
+
+  CompiledFormula::CompiledFormula(std::shared_ptr<const FormulaProgram> program) : m_Program(program)
+  {}
+
+  bool CompiledFormula::isValid() const
+  {
+    return m_Program != nullptr;
+  }
+
+  const CompiledFormula::VariableNamesType& CompiledFormula::getVariableNames() const
+  {
+    static const VariableNamesType noNames;
+    return m_Program != nullptr ? m_Program->getVariableNames() : noNames;
+  }
+
+  CompiledFormula::ValueType CompiledFormula::evaluate(const VariableValuesType& variables) const
+  {
+    ValueType result = 0;
+    this->evaluateSeries(variables, variables.size(), nullptr, 1, &result);
+    return result;
+  }
+
+  void CompiledFormula::evaluateSeries(const VariableValuesType& variables, std::size_t seriesSlot,
+    const ValueType* series, std::size_t count, ValueType* result) const
+  {
+    if (m_Program == nullptr)
+    {
+      mitkThrowException(FormulaParserException) << "Formula was not compiled";
+    }
+
+    if (variables.size() != m_Program->getVariableNames().size())
+    {
+      mitkThrowException(FormulaParserException) << "Formula has " << m_Program->getVariableNames().size() <<
+        " variables, but " << variables.size() << " values were given";
+    }
+
+    if (series != nullptr && seriesSlot >= variables.size())
+    {
+      mitkThrowException(FormulaParserException) << "Formula has no variable slot " << seriesSlot;
+    }
+
+    m_Program->execute(variables.data(), seriesSlot, series, count, result);
+  }
+
+
   FormulaParser::FormulaParser(const VariableMapType* variables) : m_Variables(variables)
   {}
 
   FormulaParser::ValueType FormulaParser::parse(const std::string& input)
+  {
+    const CompiledFormula formula = compile(input);
+
+    CompiledFormula::VariableValuesType values;
+    for (const auto& name : formula.getVariableNames())
+    {
+      values.push_back(this->lookupVariable(name));
+    }
+
+    return formula.evaluate(values);
+  };
+
+  CompiledFormula FormulaParser::compile(const std::string& input)
   {
     std::string::const_iterator iter = input.begin();
     std::string::const_iterator end = input.end();
-    FormulaParser::ValueType result = static_cast<FormulaParser::ValueType>(0);
+    auto program = std::make_shared<FormulaProgram>();
 
     try
     {
-      if (!qi::phrase_parse(iter, end, Grammar(*this), ascii::space, result))
+      if (!qi::phrase_parse(iter, end, Grammar(*program), ascii::space))
       {
         mitkThrowException(FormulaParserException) << "Could not parse '" << input <<
           "': Grammar could not be applied to the input " << "at all.";
@@ -267,8 +468,9 @@ namespace mitk
         "': Unexpected character '" << *e.first << "' after '" << parsed << "'";
     }
 
-    return result;
-  };
+    program->finalize();
+    return CompiledFormula(program);
+  }
 
   FormulaParser::ValueType FormulaParser::lookupVariable(const std::string var)
   {
@@ -11,7 +11,8 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkGenericParamModel.h"
-#include "mitkFormulaParser.h"
+
+#include <algorithm>
 
 const std::string mitk::GenericParamModel::NAME_STATIC_PARAMETER_number = "number_of_parameters";
 
@@ -30,6 +31,34 @@ mitk::GenericParamModel::FunctionStringType mitk::GenericParamModel::GetFunction
   return m_FunctionString;
 };
 
+void mitk::GenericParamModel::SetFunctionString(const FunctionStringType& functionString)
+{
+  if (functionString == m_FunctionString)
+  {
+    return;
+  }
+
+  m_FunctionString = functionString;
+
+  try
+  {
+    m_Formula = FormulaParser::compile(m_FunctionString);
+  }
+  catch (const FormulaParserException&)
+  {
+    // The error is reported by ComputeModelfunction, like it was done before the string was
+    // compiled in advance.
+    m_Formula = CompiledFormula();
+  }
+
+  this->Modified();
+};
+
+void mitk::GenericParamModel::SetFunctionString(const char* functionString)
+{
+  this->SetFunctionString(FunctionStringType(functionString != nullptr ? functionString : ""));
+};
+
 std::string mitk::GenericParamModel::GetXName() const
 {
   return "x";
@@ -97,25 +126,43 @@ mitk::GenericParamModel::ComputeModelfunction(const ParametersType& parameters)
   unsigned int timeSteps = m_TimeGrid.GetSize();
   ModelResultType signal(timeSteps);
 
-  std::map<std::string, double> parameterMap;
-  parameterMap.insert(std::make_pair(GetXName(), 0.0));
-
-  auto paramNames = this->GetParameterNames();
-  for (ParametersType::size_type i = 0; i < parameters.size(); ++i)
+  if (!m_Formula.isValid())
   {
-    parameterMap.insert(std::make_pair(paramNames[i], parameters[i]));
+    // throws the parse error of the function string
+    FormulaParser::compile(m_FunctionString);
   }
 
-  FormulaParser formulaParser(&parameterMap);
+  // bind the variables of the formula to x and the parameters
+  const auto& variableNames = m_Formula.getVariableNames();
+  CompiledFormula::VariableValuesType variableValues(variableNames.size(), 0.0);
+  std::size_t xSlot = variableNames.size();
 
-  TimeGridType::const_iterator timeGridEnd = m_TimeGrid.end();
-  ModelResultType::iterator signalPos = signal.begin();
+  auto paramNames = this->GetParameterNames();
+  const std::size_t numberOfParameters = std::min<std::size_t>(parameters.size(), paramNames.size());
+
+  for (std::size_t slot = 0; slot < variableNames.size(); ++slot)
+  {
+    if (variableNames[slot] == GetXName())
+    {
+      xSlot = slot;
+      continue;
+    }
+
+    auto finding = std::find(paramNames.begin(), paramNames.begin() + numberOfParameters, variableNames[slot]);
+    if (finding == paramNames.begin() + numberOfParameters)
+    {
+      mitkThrowException(FormulaParserException) << "No variable '" << variableNames[slot] << "' defined in lookup";
+    }
+    variableValues[slot] = parameters[finding - paramNames.begin()];
+  }
 
-  for (TimeGridType::const_iterator gridPos = m_TimeGrid.begin(); gridPos != timeGridEnd;
-       ++gridPos, ++signalPos)
+  if (xSlot < variableNames.size())
+  {
+    m_Formula.evaluateSeries(variableValues, xSlot, m_TimeGrid.data_block(), timeSteps, signal.data_block());
+  }
+  else
   {
-    parameterMap[GetXName()] = *gridPos;
-    *signalPos = formulaParser.parse(m_FunctionString);
+    signal.Fill(m_Formula.evaluate(variableValues));
   }
 
   return signal;
@@ -164,6 +211,7 @@ itk::LightObject::Pointer mitk::GenericParamModel::InternalClone() const
 
   newClone->SetTimeGrid(this->m_TimeGrid);
   newClone->SetNumberOfParameters(this->m_NumberOfParameters);
+  newClone->SetFunctionString(this->m_FunctionString);
 
   return newClone.GetPointer();
 };
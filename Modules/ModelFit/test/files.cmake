@@ -13,4 +13,10 @@ SET(MODULE_TESTS
   mitkMVConstrainedCostFunctionDecoratorTest.cpp
   mitkConcreteModelFactoryBaseTest.cpp
   mitkFormulaParserTest.cpp
+  mitkGenericParamModelTest.cpp
+)
+
+# not run by ctest, the benchmark takes some time and only reports timings
+set(MODULE_CUSTOM_TESTS
+  mitkGenericParamModelBenchmarkTest.cpp
 )
@@ -13,6 +13,8 @@ found in the LICENSE file.
 #include "mitkTestingMacros.h"
 #include "mitkFormulaParser.h"
 
+#include <cmath>
+
 using namespace mitk;
 
 #define TEST_NOTHROW(expression, MSG) \
@@ -211,6 +213,68 @@ public:
 
     delete parser;
   }
+
+  static void TestCompile()
+  {
+    // errors are reported by compile already
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, FormulaParser::compile(""));
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, FormulaParser::compile("5="));
+
+    // an empty formula can't be evaluated
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, CompiledFormula().evaluate(CompiledFormula::VariableValuesType()));
+
+    const std::string formula = "3.5 + a * x * sin(x) - b / 2 - -x + abs(a - x)";
+    CompiledFormula compiled;
+    TEST_NOTHROW(compiled = FormulaParser::compile(formula),
+      "Testing if compile throws an unwanted exception");
+
+    // variables get their slots in the order of their first appearance
+    const CompiledFormula::VariableNamesType expectedNames = { "a", "x", "b" };
+    MITK_TEST_CONDITION_REQUIRED(compiled.getVariableNames() == expectedNames,
+      "Testing if compile binds the variables to the correct slots");
+
+    // wrong number of values
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, compiled.evaluate(CompiledFormula::VariableValuesType(2, 1.0)));
+
+    // parity with parse; the series is longer than one evaluation block
+    const std::size_t count = 1000;
+    std::vector<double> series(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      series[i] = -5. + 0.01 * i;
+    }
+
+    CompiledFormula::VariableValuesType values = { 1.5, 0., -4. };
+    std::vector<double> result(count);
+    TEST_NOTHROW(compiled.evaluateSeries(values, 1, series.data(), count, result.data()),
+      "Testing if evaluateSeries throws an unwanted exception");
+
+    std::map<std::string, double> varMap;
+    varMap["a"] = 1.5;
+    varMap["b"] = -4.;
+    FormulaParser parser(&varMap);
+
+    bool seriesCorrect = true;
+    bool evaluateCorrect = true;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const double x = series[i];
+      varMap["x"] = x;
+      const double expected = 3.5 + 1.5 * x * std::sin(x) - -4. / 2 + x + std::abs(1.5 - x);
+
+      seriesCorrect = seriesCorrect && result[i] == parser.parse(formula) && std::abs(result[i] - expected) < 1e-10;
+
+      values[1] = x;
+      evaluateCorrect = evaluateCorrect && compiled.evaluate(values) == result[i];
+    }
+    MITK_TEST_CONDITION_REQUIRED(seriesCorrect,
+      "Testing if evaluateSeries produces the same results as parse");
+    MITK_TEST_CONDITION_REQUIRED(evaluateCorrect,
+      "Testing if evaluate produces the same results as evaluateSeries");
+
+    // invalid series slot
+    MITK_TEST_FOR_EXCEPTION(FormulaParserException, compiled.evaluateSeries(values, 3, series.data(), count, result.data()));
+  }
 };
 
 int mitkFormulaParserTest(int, char *[])
@@ -220,6 +284,7 @@ int mitkFormulaParserTest(int, char *[])
   FormulaParserTests::TestConstructor();
   FormulaParserTests::TestLookupVariable();
   FormulaParserTests::TestParse();
+  FormulaParserTests::TestCompile();
 
   MITK_TEST_END();
 }
@@ -0,0 +1,82 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <chrono>
+#include <vector>
+#include "mitkTestingMacros.h"
+
+#include "mitkGenericParamModel.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+
+/** Measures the time of fitting a user defined model to many samples. It is not part of the regular tests,
+ * run it with the test driver of the module: MitkModelFitTestDriver mitkGenericParamModelBenchmarkTest */
+int mitkGenericParamModelBenchmarkTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  // always start with this!
+  MITK_TEST_BEGIN("GenericParamModelBenchmark")
+
+  const unsigned int numberOfTimePoints = 300;
+  const unsigned int numberOfSamples = 500;
+
+  mitk::ModelBase::TimeGridType grid(numberOfTimePoints);
+  for (unsigned int i = 0; i < numberOfTimePoints; ++i)
+  {
+    grid[i] = 0.1 * i;
+  }
+
+  const std::string function = "a*exp(-b*x)+c*sin(x)-abs(x-2)/4";
+
+  mitk::GenericParamModel::Pointer model = mitk::GenericParamModel::New();
+  model->SetTimeGrid(grid);
+  model->SetNumberOfParameters(3);
+  model->SetFunctionString(function);
+
+  mitk::ModelBase::ParametersType params;
+  params.SetSize(3);
+  params[0] = 10;
+  params[1] = 0.3;
+  params[2] = 1.5;
+
+  mitk::ModelBase::ParametersType initParams;
+  initParams.SetSize(3);
+  initParams[0] = 5;
+  initParams[1] = 0.5;
+  initParams[2] = 1;
+
+  mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor =
+    mitk::LevenbergMarquardtModelFitFunctor::New();
+
+  typedef std::vector<double> ValueArrayType;
+  ValueArrayType sample(numberOfTimePoints);
+  mitk::ModelBase::ModelResultType sampleSignal = model->GetSignal(params);
+  sample.assign(sampleSignal.begin(), sampleSignal.end());
+
+  ValueArrayType output;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < numberOfSamples; ++i)
+  {
+    output = fitFunctor->Compute(sample, model, initParams);
+  }
+  const double fitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  MITK_INFO << "Fitted '" << function << "' to " << numberOfSamples << " samples with " << numberOfTimePoints
+            << " time points in " << fitTime << " s";
+
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(params[0], output[0], 1e-4, true) == true,
+                               "Check fitted parameter a.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(params[1], output[1], 1e-4, true) == true,
+                               "Check fitted parameter b.");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(params[2], output[2], 1e-4, true) == true,
+                               "Check fitted parameter c.");
+
+  MITK_TEST_END()
+}
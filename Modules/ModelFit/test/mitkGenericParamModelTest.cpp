@@ -0,0 +1,115 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <cmath>
+#include "mitkTestingMacros.h"
+
+#include "mitkGenericParamModel.h"
+#include "mitkLinearModel.h"
+#include "mitkFormulaParser.h"
+
+int mitkGenericParamModelTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  // always start with this!
+  MITK_TEST_BEGIN("GenericParamModel")
+
+  //Prepare test artifacts and helper
+
+  const unsigned int numberOfTimePoints = 300;
+  mitk::ModelBase::TimeGridType grid(numberOfTimePoints);
+  for (unsigned int i = 0; i < numberOfTimePoints; ++i)
+  {
+    grid[i] = 0.1 * i;
+  }
+
+  mitk::GenericParamModel::Pointer model = mitk::GenericParamModel::New();
+  model->SetTimeGrid(grid);
+
+  //Test parity with the linear model
+
+  mitk::LinearModel::Pointer linearModel = mitk::LinearModel::New();
+  linearModel->SetTimeGrid(grid);
+
+  model->SetNumberOfParameters(2);
+  model->SetFunctionString("a*x+b");
+
+  mitk::ModelBase::ParametersType linearParams;
+  linearParams.SetSize(2);
+  linearParams[0] = 2.5;
+  linearParams[1] = -3;
+
+  mitk::ModelBase::ModelResultType signal = model->GetSignal(linearParams);
+  mitk::ModelBase::ModelResultType linearSignal = linearModel->GetSignal(linearParams);
+
+  CPPUNIT_ASSERT_MESSAGE("Check size of the signal.", numberOfTimePoints == signal.GetSize());
+
+  bool equal = true;
+  for (unsigned int i = 0; i < numberOfTimePoints; ++i)
+  {
+    equal = equal && mitk::Equal(linearSignal[i], signal[i], 1e-10, true);
+  }
+  MITK_TEST_CONDITION_REQUIRED(equal, "Check signal of 'a*x+b' against the linear model.");
+
+  //Test parity with the per time point parser
+
+  const std::string function = "a*exp(-b*x)+c*sin(x)-abs(x-2)/4";
+  model->SetNumberOfParameters(3);
+  model->SetFunctionString(function);
+
+  mitk::ModelBase::ParametersType params;
+  params.SetSize(3);
+  params[0] = 10;
+  params[1] = 0.3;
+  params[2] = 1.5;
+
+  signal = model->GetSignal(params);
+
+  std::map<std::string, double> parameterMap;
+  parameterMap["a"] = params[0];
+  parameterMap["b"] = params[1];
+  parameterMap["c"] = params[2];
+  mitk::FormulaParser parser(&parameterMap);
+
+  equal = true;
+  for (unsigned int i = 0; i < numberOfTimePoints; ++i)
+  {
+    parameterMap["x"] = grid[i];
+    equal = equal && signal[i] == parser.parse(function);
+  }
+  MITK_TEST_CONDITION_REQUIRED(equal, "Check signal against the result of FormulaParser::parse for every time point.");
+
+  //Test clone and formulas without x
+
+  mitk::ModelBase::Pointer clone = model->Clone().GetPointer();
+  MITK_TEST_CONDITION_REQUIRED(clone->GetFunctionString() == function, "Check if clone copies the function string.");
+  mitk::ModelBase::ModelResultType cloneSignal = clone->GetSignal(params);
+  MITK_TEST_CONDITION_REQUIRED(cloneSignal == signal, "Check if clone computes the same signal.");
+
+  model->SetFunctionString("a+c");
+  signal = model->GetSignal(params);
+  equal = true;
+  for (unsigned int i = 0; i < numberOfTimePoints; ++i)
+  {
+    equal = equal && signal[i] == 11.5;
+  }
+  MITK_TEST_CONDITION_REQUIRED(equal, "Check signal of a function string that does not depend on x.");
+
+  //Test invalid function strings
+
+  model->SetFunctionString("a*(x");
+  MITK_TEST_FOR_EXCEPTION(mitk::FormulaParserException, model->GetSignal(params));
+
+  model->SetFunctionString("a*x+d");
+  MITK_TEST_FOR_EXCEPTION(mitk::FormulaParserException, model->GetSignal(params));
+
+  MITK_TEST_END()
+}
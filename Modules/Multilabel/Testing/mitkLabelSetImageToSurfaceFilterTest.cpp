@@ -0,0 +1,228 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkPolyData.h>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+
+  MITK_TEST(AllLabels_OneSurfacePerLabel);
+  MITK_TEST(RequestedLabel_EqualsSurfaceOfAllLabels);
+  MITK_TEST(RequestedLabel_NotContained_Throws);
+  MITK_TEST(ChangedLabel_OnlyChangedSurfaceIsGenerated);
+  MITK_TEST(ModifiedRegion_OnlyLabelsOfRegionAreScanned);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LabelSetImageToSurfaceFilter::LabelType LabelType;
+
+  mitk::Image::Pointer m_Image;
+
+  void FillBox(LabelType label, const itk::Index<3> &min, const itk::Index<3> &max)
+  {
+    mitk::ImagePixelWriteAccessor<LabelType, 3> writeAccessor(m_Image);
+
+    itk::Index<3> index;
+    for (index[2] = min[2]; index[2] <= max[2]; ++index[2])
+      for (index[1] = min[1]; index[1] <= max[1]; ++index[1])
+        for (index[0] = min[0]; index[0] <= max[0]; ++index[0])
+          writeAccessor.SetPixelByIndexSafe(index, label);
+  }
+
+  static itk::Index<3> MakeIndex(itk::IndexValueType x, itk::IndexValueType y, itk::IndexValueType z)
+  {
+    itk::Index<3> index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = z;
+    return index;
+  }
+
+  static mitk::Image::VolumeRegionType MakeRegion(const itk::Index<3> &min, const itk::Index<3> &max)
+  {
+    mitk::Image::VolumeRegionType region;
+    region.SetIndex(min);
+    for (unsigned int i = 0; i < 3; ++i)
+      region.SetSize(i, max[i] - min[i] + 1);
+    return region;
+  }
+
+public:
+  void setUp() override
+  {
+    unsigned int dimensions[3] = {40, 30, 20};
+
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<LabelType>(), 3, dimensions);
+
+    mitk::Vector3D spacing;
+    spacing[0] = 1.0;
+    spacing[1] = 0.5;
+    spacing[2] = 2.0;
+    m_Image->SetSpacing(spacing);
+
+    this->FillBox(0, MakeIndex(0, 0, 0), MakeIndex(39, 29, 19));
+    this->FillBox(1, MakeIndex(2, 2, 2), MakeIndex(10, 10, 8));
+    this->FillBox(2, MakeIndex(20, 5, 5), MakeIndex(30, 25, 15));
+    // touches the border of the image
+    this->FillBox(3, MakeIndex(34, 0, 10), MakeIndex(39, 8, 19));
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void AllLabels_OneSurfacePerLabel()
+  {
+    auto filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(3),
+                         filter->GetNumberOfIndexedOutputs());
+    CPPUNIT_ASSERT_EQUAL(3u, filter->GetNumberOfGeneratedLabels());
+
+    for (unsigned int idx = 0; idx < 3; ++idx)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(idx + 1), filter->GetLabelOfOutput(idx));
+
+      vtkPolyData *polyData = filter->GetOutput(idx)->GetVtkPolyData();
+      CPPUNIT_ASSERT(polyData != nullptr);
+      CPPUNIT_ASSERT(polyData->GetNumberOfPoints() > 0);
+    }
+
+    // the surface of label 2 lies around its box in world coordinates
+    double bounds[6];
+    filter->GetOutput(1)->GetVtkPolyData()->GetBounds(bounds);
+    CPPUNIT_ASSERT(bounds[0] > 18.0 && bounds[1] < 32.0);
+    CPPUNIT_ASSERT(bounds[2] > 1.5 && bounds[3] < 13.5);
+    CPPUNIT_ASSERT(bounds[4] > 6.0 && bounds[5] < 34.0);
+  }
+
+  void RequestedLabel_EqualsSurfaceOfAllLabels()
+  {
+    auto allLabelsFilter = mitk::LabelSetImageToSurfaceFilter::New();
+    allLabelsFilter->SetInput(m_Image);
+    allLabelsFilter->GenerateAllLabelsOn();
+    allLabelsFilter->Update();
+
+    auto filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(3);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(3), filter->GetLabelOfOutput(0));
+    CPPUNIT_ASSERT_EQUAL(allLabelsFilter->GetOutput(2)->GetVtkPolyData()->GetNumberOfPoints(),
+                         filter->GetOutput()->GetVtkPolyData()->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(allLabelsFilter->GetOutput(2)->GetVtkPolyData()->GetNumberOfCells(),
+                         filter->GetOutput()->GetVtkPolyData()->GetNumberOfCells());
+  }
+
+  void RequestedLabel_NotContained_Throws()
+  {
+    auto filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(4);
+
+    CPPUNIT_ASSERT_THROW(filter->Update(), itk::ExceptionObject);
+  }
+
+  void ChangedLabel_OnlyChangedSurfaceIsGenerated()
+  {
+    auto filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    const vtkIdType numberOfPoints1 = filter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPoints();
+    const vtkIdType numberOfPoints2 = filter->GetOutput(1)->GetVtkPolyData()->GetNumberOfPoints();
+
+    // modifying an output must not change the kept surface
+    filter->GetOutput(0)->GetVtkPolyData()->Initialize();
+
+    // grow label 2 by one slice
+    this->FillBox(2, MakeIndex(20, 5, 16), MakeIndex(30, 25, 16));
+    m_Image->Modified();
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(1u, filter->GetNumberOfGeneratedLabels());
+    CPPUNIT_ASSERT_EQUAL(numberOfPoints1, filter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPoints());
+    CPPUNIT_ASSERT(numberOfPoints2 < filter->GetOutput(1)->GetVtkPolyData()->GetNumberOfPoints());
+
+    // a label that vanished loses its output
+    this->FillBox(0, MakeIndex(2, 2, 2), MakeIndex(10, 10, 8));
+    m_Image->Modified();
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(0u, filter->GetNumberOfGeneratedLabels());
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(2),
+                         filter->GetNumberOfIndexedOutputs());
+    CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(2), filter->GetLabelOfOutput(0));
+  }
+
+  void ModifiedRegion_OnlyLabelsOfRegionAreScanned()
+  {
+    auto filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    const vtkIdType numberOfPoints1 = filter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPoints();
+
+    // grow label 2 by one slice and mark only that slice as modified
+    this->FillBox(2, MakeIndex(20, 5, 16), MakeIndex(30, 25, 16));
+    // label 1 lies outside of the marked region, so this change is not seen by the filter
+    this->FillBox(0, MakeIndex(2, 2, 2), MakeIndex(10, 10, 2));
+    m_Image->ModifiedRegion(0, MakeRegion(MakeIndex(20, 5, 16), MakeIndex(30, 25, 16)));
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(1u, filter->GetNumberOfGeneratedLabels());
+    CPPUNIT_ASSERT_EQUAL(numberOfPoints1, filter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPoints());
+
+    // the surface of label 2 equals the one of a filter that scans the whole image
+    auto label2Filter = mitk::LabelSetImageToSurfaceFilter::New();
+    label2Filter->SetInput(m_Image);
+    label2Filter->SetRequestedLabel(2);
+    label2Filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(2), filter->GetLabelOfOutput(1));
+    CPPUNIT_ASSERT_EQUAL(label2Filter->GetOutput()->GetVtkPolyData()->GetNumberOfPoints(),
+                         filter->GetOutput(1)->GetVtkPolyData()->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(label2Filter->GetOutput()->GetVtkPolyData()->GetNumberOfCells(),
+                         filter->GetOutput(1)->GetVtkPolyData()->GetNumberOfCells());
+
+    // a label that is overwritten within the marked region is replaced by the new label
+    this->FillBox(4, MakeIndex(34, 0, 10), MakeIndex(39, 8, 19));
+    m_Image->ModifiedRegion(0, MakeRegion(MakeIndex(34, 0, 10), MakeIndex(39, 8, 19)));
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(1u, filter->GetNumberOfGeneratedLabels());
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::ProcessObject::DataObjectPointerArraySizeType>(3),
+                         filter->GetNumberOfIndexedOutputs());
+    CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(4), filter->GetLabelOfOutput(2));
+
+    // a region that is not marked is scanned completely
+    m_Image->Modified();
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(1u, filter->GetNumberOfGeneratedLabels());
+    CPPUNIT_ASSERT_EQUAL(static_cast<LabelType>(1), filter->GetLabelOfOutput(0));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
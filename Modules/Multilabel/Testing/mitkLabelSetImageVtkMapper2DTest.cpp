@@ -0,0 +1,288 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// MITK
+#include <mitkExtractSliceFilter.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageVtkMapper2D.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// VTK
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
+
+class mitkLabelSetImageVtkMapper2DTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageVtkMapper2DTestSuite);
+  MITK_TEST(Render_AxialSlice_LayersMatchExtractSliceFilter);
+  MITK_TEST(Render_ObliqueSlice_LayersMatchExtractSliceFilter);
+  MITK_TEST(Render_PropertyChanged_ReusesOutline);
+  MITK_TEST(Render_ActiveLabelChanged_RecomputesOutline);
+  MITK_TEST(Render_LabelPainted_RecomputesOutline);
+  MITK_TEST(Render_SliceChanged_RecomputesOutline);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::LabelSetImage::Pointer m_Image;
+  mitk::DataNode::Pointer m_Node;
+  mitk::LabelSetImageVtkMapper2D::Pointer m_Mapper;
+
+  static void AddLabel(mitk::LabelSet *labelSet, mitk::Label::PixelType value)
+  {
+    mitk::Label::Pointer label = mitk::Label::New();
+    label->SetName("Label " + std::to_string(value));
+    label->SetValue(value);
+    labelSet->AddLabel(label);
+  }
+
+  /** Sets all voxels in [min, max) to value */
+  static void FillBox(mitk::Image *image, const int min[3], const int max[3], mitk::Label::PixelType value)
+  {
+    mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(image);
+    itk::Index<3> index;
+    for (index[2] = min[2]; index[2] < max[2]; ++index[2])
+      for (index[1] = min[1]; index[1] < max[1]; ++index[1])
+        for (index[0] = min[0]; index[0] < max[0]; ++index[0])
+          accessor.SetPixelByIndex(index, value);
+  }
+
+  mitk::BaseRenderer *GetRenderer()
+  {
+    return mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  }
+
+  mitk::LabelSetImageVtkMapper2D::LocalStorage *GetLocalStorage()
+  {
+    return m_Mapper->GetLocalStorage(this->GetRenderer());
+  }
+
+  /** Reslices a layer with its own ExtractSliceFilter, as the mapper did for every layer before the
+   *  layers shared the slice geometry of the first one. */
+  vtkSmartPointer<vtkImageData> ExtractSlice(mitk::Image *layerImage)
+  {
+    mitk::ExtractSliceFilter::Pointer reslicer = mitk::ExtractSliceFilter::New();
+    reslicer->SetInput(layerImage);
+    reslicer->SetWorldGeometry(this->GetRenderer()->GetCurrentWorldPlaneGeometry());
+    reslicer->SetTimeStep(0);
+    reslicer->SetResliceTransformByGeometry(layerImage->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    reslicer->SetInPlaneResampleExtentByGeometry(false);
+    reslicer->SetInterpolationMode(mitk::ExtractSliceFilter::RESLICE_NEAREST);
+    reslicer->SetVtkOutputRequest(true);
+    reslicer->SetOutputDimensionality(2);
+    reslicer->SetOutputSpacingZDirection(1.0);
+    reslicer->SetOutputExtentZDirection(0, 0);
+    reslicer->Modified();
+    reslicer->UpdateLargestPossibleRegion();
+
+    vtkSmartPointer<vtkImageData> slice = vtkSmartPointer<vtkImageData>::New();
+    slice->DeepCopy(reslicer->GetVtkOutput());
+    return slice;
+  }
+
+  void AssertLayersMatchExtractSliceFilter()
+  {
+    auto *localStorage = this->GetLocalStorage();
+    CPPUNIT_ASSERT_EQUAL(3, localStorage->m_NumberOfLayers);
+
+    for (unsigned int layer = 0; layer < m_Image->GetNumberOfLayers(); ++layer)
+    {
+      mitk::Image *layerImage =
+        layer == m_Image->GetActiveLayer() ? m_Image.GetPointer() : m_Image->GetLayerImage(layer);
+      vtkSmartPointer<vtkImageData> expected = this->ExtractSlice(layerImage);
+      vtkImageData *actual = localStorage->m_ReslicedImageVector[layer];
+      CPPUNIT_ASSERT(actual != nullptr);
+
+      int expectedExtent[6];
+      int actualExtent[6];
+      expected->GetExtent(expectedExtent);
+      actual->GetExtent(actualExtent);
+      for (int i = 0; i < 6; ++i)
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Extent of layer " + std::to_string(layer), expectedExtent[i], actualExtent[i]);
+
+      unsigned int labelVoxels = 0;
+      for (int z = expectedExtent[4]; z <= expectedExtent[5]; ++z)
+        for (int y = expectedExtent[2]; y <= expectedExtent[3]; ++y)
+          for (int x = expectedExtent[0]; x <= expectedExtent[1]; ++x)
+          {
+            const double expectedValue = expected->GetScalarComponentAsDouble(x, y, z, 0);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Pixel of layer " + std::to_string(layer),
+                                         expectedValue,
+                                         actual->GetScalarComponentAsDouble(x, y, z, 0));
+            labelVoxels += expectedValue != 0.0;
+          }
+
+      // make sure that the slice is not trivially empty
+      CPPUNIT_ASSERT_MESSAGE("Slice of layer " + std::to_string(layer) + " contains labels", labelVoxels > 0);
+    }
+  }
+
+  vtkPolyData *RenderAndGetOutline()
+  {
+    m_RenderingTestHelper.Render();
+    vtkPolyData *outline = this->GetLocalStorage()->m_OutlinePolyData;
+    CPPUNIT_ASSERT(outline != nullptr);
+    return outline;
+  }
+
+  static bool HaveSameBounds(vtkPolyData *outline1, vtkPolyData *outline2)
+  {
+    double bounds1[6];
+    double bounds2[6];
+    outline1->GetBounds(bounds1);
+    outline2->GetBounds(bounds2);
+    for (int i = 0; i < 6; ++i)
+    {
+      if (!mitk::Equal(bounds1[i], bounds2[i]))
+        return false;
+    }
+    return true;
+  }
+
+public:
+  mitkLabelSetImageVtkMapper2DTestSuite() : m_RenderingTestHelper(300, 300) {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(300, 300);
+
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {24, 20, 12};
+    regularImage->Initialize(mitk::MakeScalarPixelType<mitk::Label::PixelType>(), 3, dimensions);
+
+    m_Image = mitk::LabelSetImage::New();
+    m_Image->Initialize(regularImage);
+    AddLabel(m_Image->GetLabelSet(0), 1);
+    m_Image->AddLayer();
+    AddLabel(m_Image->GetLabelSet(1), 1);
+    AddLabel(m_Image->GetLabelSet(1), 2);
+    m_Image->AddLayer();
+    AddLabel(m_Image->GetLabelSet(2), 3);
+
+    // layer 2 is active after adding it, the others are stored as layer images
+    const int layer0Min[3] = {2, 3, 0};
+    const int layer0Max[3] = {12, 15, 12};
+    FillBox(m_Image->GetLayerImage(0), layer0Min, layer0Max, 1);
+
+    const int label1Min[3] = {4, 4, 2};
+    const int label1Max[3] = {14, 14, 8};
+    FillBox(m_Image->GetLayerImage(1), label1Min, label1Max, 1);
+    const int label2Min[3] = {10, 2, 2};
+    const int label2Max[3] = {20, 8, 8};
+    FillBox(m_Image->GetLayerImage(1), label2Min, label2Max, 2);
+
+    const int layer2Min[3] = {8, 10, 1};
+    const int layer2Max[3] = {22, 19, 11};
+    FillBox(m_Image, layer2Min, layer2Max, 3);
+    m_Image->Modified();
+
+    // the middle layer is active, so the first layer is resliced by the ExtractSliceFilter and the
+    // active and the last layer by the shared vtkImageReslice setup
+    m_Image->SetActiveLayer(1);
+    m_Image->GetActiveLabelSet()->SetActiveLabel(1);
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_Image);
+    m_Mapper = mitk::LabelSetImageVtkMapper2D::New();
+    m_Node->SetMapper(mitk::BaseRenderer::Standard2D, m_Mapper);
+    mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(m_Node);
+    m_Node->SetBoolProperty("labelset.contour.active", true);
+
+    m_RenderingTestHelper.AddNodeToStorage(m_Node);
+  }
+
+  void tearDown() override
+  {
+    m_Mapper = nullptr;
+    m_Node = nullptr;
+    m_Image = nullptr;
+  }
+
+  void Render_AxialSlice_LayersMatchExtractSliceFilter()
+  {
+    m_RenderingTestHelper.Render();
+    this->AssertLayersMatchExtractSliceFilter();
+  }
+
+  void Render_ObliqueSlice_LayersMatchExtractSliceFilter()
+  {
+    mitk::Point3D center = m_Image->GetGeometry()->GetCenter();
+    mitk::Vector3D normal;
+    mitk::FillVector3D(normal, 1.0, 0.5, 2.0);
+    m_RenderingTestHelper.ReorientSlices(center, normal);
+    m_RenderingTestHelper.Render();
+
+    this->AssertLayersMatchExtractSliceFilter();
+  }
+
+  void Render_PropertyChanged_ReusesOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = this->RenderAndGetOutline();
+    CPPUNIT_ASSERT(outline->GetNumberOfPoints() > 0);
+
+    // a property change generates the data again, but the slice and the label are the same
+    m_Node->SetOpacity(0.5);
+    CPPUNIT_ASSERT(outline.GetPointer() == this->RenderAndGetOutline());
+  }
+
+  void Render_ActiveLabelChanged_RecomputesOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = this->RenderAndGetOutline();
+
+    m_Image->GetActiveLabelSet()->SetActiveLabel(2);
+    vtkPolyData *newOutline = this->RenderAndGetOutline();
+
+    CPPUNIT_ASSERT(outline.GetPointer() != newOutline);
+    CPPUNIT_ASSERT(newOutline->GetNumberOfPoints() > 0);
+    CPPUNIT_ASSERT(!HaveSameBounds(outline, newOutline));
+  }
+
+  void Render_LabelPainted_RecomputesOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = this->RenderAndGetOutline();
+
+    // extend label 1 of the active layer, which is stored in the label set image itself
+    const int min[3] = {1, 14, 0};
+    const int max[3] = {18, 18, 12};
+    FillBox(m_Image, min, max, 1);
+    m_Image->Modified();
+    vtkPolyData *newOutline = this->RenderAndGetOutline();
+
+    CPPUNIT_ASSERT(outline.GetPointer() != newOutline);
+    CPPUNIT_ASSERT(!HaveSameBounds(outline, newOutline));
+  }
+
+  void Render_SliceChanged_RecomputesOutline()
+  {
+    vtkSmartPointer<vtkPolyData> outline = this->RenderAndGetOutline();
+    CPPUNIT_ASSERT(outline->GetNumberOfPoints() > 0);
+
+    // label 1 of the active layer ends at slice 8
+    mitk::Point3D point = m_Image->GetGeometry()->GetCenter();
+    mitk::Point3D index;
+    m_Image->GetGeometry()->WorldToIndex(point, index);
+    index[2] = 10;
+    m_Image->GetGeometry()->IndexToWorld(index, point);
+    mitk::Vector3D normal;
+    mitk::FillVector3D(normal, 0.0, 0.0, 1.0);
+    m_RenderingTestHelper.ReorientSlices(point, normal);
+
+    vtkPolyData *newOutline = this->RenderAndGetOutline();
+    CPPUNIT_ASSERT(outline.GetPointer() != newOutline);
+    CPPUNIT_ASSERT_EQUAL(static_cast<vtkIdType>(0), newOutline->GetNumberOfPoints());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageVtkMapper2D)
@@ -12,30 +12,138 @@ found in the LICENSE file.
 
 #include <mitkLabelSetImageToSurfaceFilter.h>
 
+#include <mitkExceptionMacro.h>
 #include <mitkImageAccessByItk.h>
-#include <mitkImageCast.h>
+#include <mitkParallelFor.h>
 
 // itk
 #include <itkAntiAliasBinaryImageFilter.h>
-#include <itkAutoCropLabelMapFilter.h>
-#include <itkBinaryThresholdImageFilter.h>
-#include <itkLabelImageToLabelMapFilter.h>
-#include <itkLabelMap.h>
-#include <itkLabelMapToLabelImageFilter.h>
-#include <itkLabelObject.h>
-#include <itkNumericTraits.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 #include <itkSmoothingRecursiveGaussianImageFilter.h>
 
 // vtk
 #include <vtkCleanPolyData.h>
-#include <vtkImageChangeInformation.h>
+#include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkMarchingCubes.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
+// std
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace
+{
+  const unsigned long long HASH_OFFSET_BASIS = 14695981039346656037ull;
+  const unsigned long long HASH_PRIME = 1099511628211ull;
+
+  /// Voxel count, bounding box and a hash of the voxel offsets of a label, collected while scanning the image.
+  struct LabelStatistics
+  {
+    LabelStatistics() : Count(0), Hash(HASH_OFFSET_BASIS)
+    {
+      std::fill(Min, Min + 3, std::numeric_limits<itk::IndexValueType>::max());
+      std::fill(Max, Max + 3, std::numeric_limits<itk::IndexValueType>::min());
+    }
+
+    void Add(const itk::Index<3> &index, itk::OffsetValueType offset)
+    {
+      ++Count;
+      Hash = (Hash ^ static_cast<unsigned long long>(offset)) * HASH_PRIME;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        Min[i] = std::min(Min[i], index[i]);
+        Max[i] = std::max(Max[i], index[i]);
+      }
+    }
+
+    unsigned long Count;
+    unsigned long long Hash;
+    itk::IndexValueType Min[3];
+    itk::IndexValueType Max[3];
+  };
+
+  unsigned long GetGeometryMTime(const mitk::BaseGeometry *geometry)
+  {
+    return std::max(geometry->GetMTime(), geometry->GetIndexToWorldTransform()->GetMTime());
+  }
+
+  bool RegionsOverlap(const itk::ImageRegion<3> &region1, const itk::ImageRegion<3> &region2)
+  {
+    itk::ImageRegion<3> intersection = region1;
+    return region1.GetNumberOfPixels() > 0 && region2.GetNumberOfPixels() > 0 && intersection.Crop(region2);
+  }
+
+  /// Grows the region to the bounding region of both regions.
+  void UniteRegions(itk::ImageRegion<3> &region, const itk::ImageRegion<3> &other)
+  {
+    if (other.GetNumberOfPixels() == 0)
+      return;
+
+    if (region.GetNumberOfPixels() == 0)
+    {
+      region = other;
+      return;
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const auto begin = std::min(region.GetIndex(i), other.GetIndex(i));
+      const auto end = std::max(region.GetUpperIndex()[i], other.GetUpperIndex()[i]);
+      region.SetIndex(i, begin);
+      region.SetSize(i, static_cast<itk::SizeValueType>(end - begin + 1));
+    }
+  }
+
+  /// Calls function(value, index, offset) for the voxels of a region of an image buffer, in the order of the buffer.
+  template <typename TPixel, typename TFunction>
+  void ForEachVoxel(const TPixel *buffer,
+                    const itk::Size<3> &size,
+                    const itk::ImageRegion<3> &region,
+                    TFunction function)
+  {
+    if (region.GetNumberOfPixels() == 0)
+      return;
+
+    const itk::Index<3> begin = region.GetIndex();
+    const itk::Index<3> end = region.GetUpperIndex();
+    itk::Index<3> index;
+
+    for (index[2] = begin[2]; index[2] <= end[2]; ++index[2])
+    {
+      for (index[1] = begin[1]; index[1] <= end[1]; ++index[1])
+      {
+        itk::OffsetValueType offset =
+          (index[2] * static_cast<itk::OffsetValueType>(size[1]) + index[1]) * size[0] + begin[0];
+        for (index[0] = begin[0]; index[0] <= end[0]; ++index[0], ++offset)
+          function(buffer[offset], index, offset);
+      }
+    }
+  }
+}
+
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
-  : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
+  : m_GenerateAllLabels(false),
+    m_RequestedLabel(1),
+    m_BackgroundLabel(0),
+    m_UseSmoothing(0),
+    m_Sigma(0.1),
+    m_NumberOfThreads(0),
+    m_NumberOfGeneratedLabels(0),
+    m_CachedInput(nullptr),
+    m_CachedInputMTime(0),
+    m_CachedGeometryMTime(0),
+    m_CachedUseSmoothing(0),
+    m_CachedSigma(0.0),
+    m_CachedGenerateAllLabels(false),
+    m_CachedRequestedLabel(0),
+    m_CachedBackgroundLabel(0)
 {
 }
 
@@ -64,6 +172,17 @@ const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
   return static_cast<const mitk::Image *>(this->ProcessObject::GetInput(0));
 }
 
+mitk::LabelSetImageToSurfaceFilter::LabelType mitk::LabelSetImageToSurfaceFilter::GetLabelOfOutput(
+  unsigned int idx) const
+{
+  auto iter = m_IndexToLabels.find(idx);
+
+  if (iter == m_IndexToLabels.end())
+    mitkThrow() << "No surface was generated for output " << idx << ".";
+
+  return iter->second;
+}
+
 void mitk::LabelSetImageToSurfaceFilter::GenerateOutputInformation()
 {
   itkDebugMacro(<< "GenerateOutputInformation()");
@@ -88,51 +207,262 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
 
-  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> BinaryThresholdFilterType;
-  typedef itk::LabelObject<TPixel, VDimension> LabelObjectType;
-  typedef itk::LabelMap<LabelObjectType> LabelMapType;
-  typedef itk::LabelImageToLabelMapFilter<ImageType, LabelMapType> Image2LabelMapType;
-  typedef itk::AutoCropLabelMapFilter<LabelMapType> AutoCropType;
-  typedef itk::LabelMapToLabelImageFilter<LabelMapType, ImageType> LabelMap2ImageType;
+  const mitk::Image *inputImage = this->GetInput();
+
+  // surfaces of a previous update can only be reused if they were generated the same way
+  const unsigned long geometryMTime = GetGeometryMTime(inputImage->GetGeometry());
+  const bool cacheIsValid = m_CachedInput == inputImage && m_CachedGeometryMTime == geometryMTime &&
+                            m_CachedUseSmoothing == m_UseSmoothing && m_CachedSigma == m_Sigma;
+  if (!cacheIsValid)
+  {
+    m_LabelSurfaces.clear();
+  }
+
+  const typename ImageType::SizeType &size = input->GetLargestPossibleRegion().GetSize();
+  const TPixel *buffer = input->GetBufferPointer();
+
+  auto isSurfaceLabel = [this](TPixel value) {
+    const auto label = static_cast<LabelType>(value);
+    return static_cast<TPixel>(label) == value && static_cast<int>(label) != m_BackgroundLabel &&
+           (m_GenerateAllLabels || static_cast<int>(label) == m_RequestedLabel);
+  };
+
+  // count, bounding box and hash of the labels that are scanned
+  std::vector<LabelStatistics> statistics;
+  LabelSurfaceMapType labelSurfaces;
+
+  auto addVoxel = [&statistics](LabelType label, const itk::Index<3> &index, itk::OffsetValueType offset) {
+    if (label >= statistics.size())
+      statistics.resize(label + 1);
+    statistics[label].Add(index, offset);
+  };
+
+  RegionType modifiedRegion;
+  if (cacheIsValid && m_CachedGenerateAllLabels == m_GenerateAllLabels &&
+      m_CachedRequestedLabel == m_RequestedLabel && m_CachedBackgroundLabel == m_BackgroundLabel &&
+      inputImage->GetModifiedRegionSince(m_CachedInputMTime, 0, modifiedRegion))
+  {
+    // only regions of the image were modified, e.g. by a segmentation tool: only the labels that are
+    // contained in the modified region now or whose voxels were contained in it before are scanned again
+    if (!modifiedRegion.Crop(input->GetLargestPossibleRegion()))
+      modifiedRegion = RegionType();
+
+    std::vector<bool> isAffected;
+    ForEachVoxel(buffer, size, modifiedRegion, [&](TPixel value, const itk::Index<3> &, itk::OffsetValueType) {
+      if (!isSurfaceLabel(value))
+        return;
+
+      const auto label = static_cast<LabelType>(value);
+      if (label >= isAffected.size())
+        isAffected.resize(label + 1, false);
+      isAffected[label] = true;
+    });
+
+    // voxels outside of the modified region did not change, so all voxels of an affected label lie
+    // within the modified region or within its previous bounding box
+    RegionType scanRegion = modifiedRegion;
+    for (const auto &cachedLabelSurface : m_LabelSurfaces)
+    {
+      const LabelType label = cachedLabelSurface.first;
+      bool labelIsAffected = label < isAffected.size() && isAffected[label];
+
+      if (!labelIsAffected && RegionsOverlap(cachedLabelSurface.second.Region, modifiedRegion))
+      {
+        if (label >= isAffected.size())
+          isAffected.resize(label + 1, false);
+        isAffected[label] = true;
+        labelIsAffected = true;
+      }
+
+      if (labelIsAffected)
+        UniteRegions(scanRegion, cachedLabelSurface.second.Region);
+      else
+        labelSurfaces[label] = cachedLabelSurface.second;
+    }
+
+    ForEachVoxel(buffer, size, scanRegion, [&](TPixel value, const itk::Index<3> &index, itk::OffsetValueType offset) {
+      const auto label = static_cast<LabelType>(value);
+      if (isSurfaceLabel(value) && label < isAffected.size() && isAffected[label])
+        addVoxel(label, index, offset);
+    });
+  }
+  else
+  {
+    // collect the statistics of all labels in a single pass over the image
+    ForEachVoxel(buffer,
+                 size,
+                 input->GetLargestPossibleRegion(),
+                 [&](TPixel value, const itk::Index<3> &index, itk::OffsetValueType offset) {
+                   if (isSurfaceLabel(value))
+                     addVoxel(static_cast<LabelType>(value), index, offset);
+                 });
+  }
+
+  // take over the surfaces of all scanned labels whose voxels did not change
+  std::vector<LabelType> labelsToGenerate;
+  std::vector<RegionType> regionsToGenerate;
+
+  for (std::size_t label = 0; label < statistics.size(); ++label)
+  {
+    const LabelStatistics &labelStatistics = statistics[label];
+    if (0 == labelStatistics.Count)
+      continue;
+
+    LabelSurface labelSurface;
+    labelSurface.Count = labelStatistics.Count;
+    labelSurface.Hash = labelStatistics.Hash;
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      labelSurface.Region.SetIndex(i, labelStatistics.Min[i]);
+      labelSurface.Region.SetSize(i, labelStatistics.Max[i] - labelStatistics.Min[i] + 1);
+    }
+
+    auto cachedLabelSurface = m_LabelSurfaces.find(static_cast<LabelType>(label));
+    if (cachedLabelSurface != m_LabelSurfaces.end() && cachedLabelSurface->second.Count == labelSurface.Count &&
+        cachedLabelSurface->second.Hash == labelSurface.Hash && cachedLabelSurface->second.Region == labelSurface.Region)
+    {
+      labelSurface.PolyData = cachedLabelSurface->second.PolyData;
+    }
+    else
+    {
+      labelsToGenerate.push_back(static_cast<LabelType>(label));
+      regionsToGenerate.push_back(labelSurface.Region);
+    }
+
+    labelSurfaces[static_cast<LabelType>(label)] = labelSurface;
+  }
+
+  if (!m_GenerateAllLabels && labelSurfaces.empty())
+    throw itk::ExceptionObject(__FILE__, __LINE__, "the requested label is not contained in the image.");
+
+  // generate the surfaces of the changed labels in parallel, each on the cropped region of its label
+  vtkSmartPointer<vtkMatrix4x4> vtkmatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  inputImage->GetGeometry()->GetVtkTransform()->GetMatrix(vtkmatrix);
+
+  double indexToWorld[4][4];
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      indexToWorld[i][j] = vtkmatrix->GetElement(i, j);
+
+  // the ITK filters run single-threaded while several labels are processed at once
+  const bool singleThreaded = labelsToGenerate.size() > 1 && 1 != m_NumberOfThreads;
+
+  std::vector<vtkSmartPointer<vtkPolyData>> generatedSurfaces(labelsToGenerate.size());
+
+  mitk::ParallelFor(
+    labelsToGenerate.size(),
+    m_NumberOfThreads,
+    [&](std::size_t i) {
+      generatedSurfaces[i] =
+        this->GenerateLabelSurface(input, labelsToGenerate[i], regionsToGenerate[i], indexToWorld, singleThreaded);
+    },
+    this->GetMultiThreader());
+
+  for (std::size_t i = 0; i < labelsToGenerate.size(); ++i)
+    labelSurfaces[labelsToGenerate[i]].PolyData = generatedSurfaces[i];
+
+  m_LabelSurfaces.swap(labelSurfaces);
+  m_CachedInput = inputImage;
+  m_CachedInputMTime = inputImage->GetMTime();
+  m_CachedGeometryMTime = geometryMTime;
+  m_CachedUseSmoothing = m_UseSmoothing;
+  m_CachedSigma = m_Sigma;
+  m_CachedGenerateAllLabels = m_GenerateAllLabels;
+  m_CachedRequestedLabel = m_RequestedLabel;
+  m_CachedBackgroundLabel = m_BackgroundLabel;
+  m_NumberOfGeneratedLabels = static_cast<unsigned int>(labelsToGenerate.size());
+
+  // one output per label
+  m_AvailableLabels.clear();
+  m_IndexToLabels.clear();
+
+  if (!m_GenerateAllLabels)
+  {
+    vtkPolyData *polydata = m_LabelSurfaces.begin()->second.PolyData;
 
+    if ((!polydata) || (!polydata->GetNumberOfPoints()))
+      throw itk::ExceptionObject(__FILE__, __LINE__, "marching cubes has failed.");
+  }
+
+  this->SetNumberOfIndexedOutputs(std::max<std::size_t>(1, m_LabelSurfaces.size()));
+
+  unsigned int idx = 0;
+  for (const auto &labelSurface : m_LabelSurfaces)
+  {
+    mitk::Surface::Pointer output = this->GetOutput(idx);
+    if (output.IsNull())
+    {
+      this->SetNthOutput(idx, this->MakeOutput(idx));
+      output = this->GetOutput(idx);
+    }
+
+    // the outputs get their own copy, so that modifying an output does not change the kept surface
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->DeepCopy(labelSurface.second.PolyData);
+    output->SetVtkPolyData(polyData, 0);
+
+    m_AvailableLabels[labelSurface.first] = labelSurface.second.Count;
+    m_IndexToLabels[idx] = labelSurface.first;
+    ++idx;
+  }
+
+  if (m_LabelSurfaces.empty())
+    this->GetOutput(0)->SetVtkPolyData(vtkSmartPointer<vtkPolyData>::New(), 0);
+}
+
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::GenerateLabelSurface(
+  const itk::Image<TPixel, VDimension> *input,
+  LabelType label,
+  const RegionType &region,
+  const double (&indexToWorld)[4][4],
+  bool singleThreaded)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef itk::Image<unsigned char, VDimension> BinaryImageType;
   typedef itk::Image<float, VDimension> RealImageType;
 
-  typedef itk::AntiAliasBinaryImageFilter<ImageType, RealImageType> AntiAliasFilterType;
+  typedef itk::AntiAliasBinaryImageFilter<BinaryImageType, RealImageType> AntiAliasFilterType;
   typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
 
-  typename BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
-  thresholdFilter->SetInput(input);
-  thresholdFilter->SetLowerThreshold(m_RequestedLabel);
-  thresholdFilter->SetUpperThreshold(m_RequestedLabel);
-  thresholdFilter->SetOutsideValue(0);
-  thresholdFilter->SetInsideValue(1);
-  //  thresholdFilter->ReleaseDataFlagOn();
-  thresholdFilter->Update();
+  // crop the label with a border of 3 voxels, voxels of the border outside of the image are background
+  RegionType cropRegion = region;
+  cropRegion.PadByRadius(3);
 
-  typename Image2LabelMapType::Pointer image2label = Image2LabelMapType::New();
-  image2label->SetInput(thresholdFilter->GetOutput());
+  typename BinaryImageType::RegionType binaryRegion;
+  binaryRegion.SetSize(cropRegion.GetSize());
 
-  typename AutoCropType::SizeType border;
-  border[0] = 3;
-  border[1] = 3;
-  border[2] = 3;
+  typename BinaryImageType::Pointer binaryImage = BinaryImageType::New();
+  binaryImage->SetRegions(binaryRegion);
+  binaryImage->SetSpacing(input->GetSpacing());
+  binaryImage->Allocate();
+  binaryImage->FillBuffer(0);
 
-  typename AutoCropType::Pointer autoCropFilter = AutoCropType::New();
-  autoCropFilter->SetInput(image2label->GetOutput());
-  autoCropFilter->SetCropBorder(border);
-  autoCropFilter->InPlaceOn();
+  RegionType inputRegion = cropRegion;
+  inputRegion.Crop(input->GetLargestPossibleRegion());
 
-  typename LabelMap2ImageType::Pointer label2image = LabelMap2ImageType::New();
-  label2image->SetInput(autoCropFilter->GetOutput());
+  typename BinaryImageType::RegionType binaryInputRegion = inputRegion;
+  for (unsigned int i = 0; i < 3; ++i)
+    binaryInputRegion.SetIndex(i, inputRegion.GetIndex(i) - cropRegion.GetIndex(i));
 
-  label2image->Update();
+  itk::ImageRegionConstIterator<ImageType> inputIter(input, inputRegion);
+  itk::ImageRegionIterator<BinaryImageType> binaryIter(binaryImage, binaryInputRegion);
+
+  for (; !inputIter.IsAtEnd(); ++inputIter, ++binaryIter)
+  {
+    if (inputIter.Get() == static_cast<TPixel>(label))
+      binaryIter.Set(1);
+  }
 
   typename AntiAliasFilterType::Pointer antiAliasFilter = AntiAliasFilterType::New();
-  antiAliasFilter->SetInput(label2image->GetOutput());
+  antiAliasFilter->SetInput(binaryImage);
   antiAliasFilter->SetMaximumRMSError(0.001);
   antiAliasFilter->SetNumberOfLayers(3);
   antiAliasFilter->SetUseImageSpacing(false);
   antiAliasFilter->SetNumberOfIterations(40);
+  if (singleThreaded)
+    antiAliasFilter->SetNumberOfThreads(1);
 
   antiAliasFilter->Update();
 
@@ -143,6 +473,8 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
     typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
     gaussianFilter->SetSigma(m_Sigma);
     gaussianFilter->SetInput(antiAliasFilter->GetOutput());
+    if (singleThreaded)
+      gaussianFilter->SetNumberOfThreads(1);
     gaussianFilter->Update();
     result = gaussianFilter->GetOutput();
   }
@@ -153,62 +485,39 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   result->DisconnectPipeline();
 
-  typename ImageType::RegionType cropRegion;
-  cropRegion = autoCropFilter->GetOutput()->GetLargestPossibleRegion();
+  // marching cubes works in index coordinates of the cropped region, they are transformed to world coordinates below
+  const typename RealImageType::SizeType &size = result->GetLargestPossibleRegion().GetSize();
 
-  const typename ImageType::IndexType &cropIndex = cropRegion.GetIndex();
+  vtkSmartPointer<vtkFloatArray> scalars = vtkSmartPointer<vtkFloatArray>::New();
+  scalars->SetArray(result->GetBufferPointer(), static_cast<vtkIdType>(result->GetPixelContainer()->Size()), 1);
 
-  m_ResultImage = mitk::Image::New();
-  mitk::CastToMitkImage(result, m_ResultImage);
-
-  mitk::BaseGeometry *newGeometry = m_ResultImage->GetSlicedGeometry();
-  mitk::Point3D origin;
-  vtk2itk(cropIndex, origin);
-  this->GetInput()->GetGeometry()->IndexToWorld(origin, origin);
-  newGeometry->SetOrigin(origin);
-
-  auto *vtkimage = m_ResultImage->GetVtkImageData(0);
-
-  vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
-    vtkSmartPointer<vtkImageChangeInformation>::New();
-  indexCoordinatesImageFilter->SetInputData(vtkimage);
-  indexCoordinatesImageFilter->SetOutputOrigin(0.0, 0.0, 0.0);
+  vtkSmartPointer<vtkImageData> vtkimage = vtkSmartPointer<vtkImageData>::New();
+  vtkimage->SetDimensions(size[0], size[1], size[2]);
+  vtkimage->GetPointData()->SetScalars(scalars);
 
   vtkSmartPointer<vtkMarchingCubes> marching = vtkSmartPointer<vtkMarchingCubes>::New();
   marching->ComputeScalarsOff();
   marching->ComputeNormalsOn();
   marching->ComputeGradientsOn();
-  marching->SetInputConnection(indexCoordinatesImageFilter->GetOutputPort());
+  marching->SetInputData(vtkimage);
   marching->SetValue(0, 0.0);
 
   marching->Update();
 
   vtkPolyData *polydata = marching->GetOutput();
 
-  if ((!polydata) || (!polydata->GetNumberOfPoints()))
-    throw itk::ExceptionObject(__FILE__, __LINE__, "marching cubes has failed.");
-
-  mitk::Vector3D spacing = newGeometry->GetSpacing();
-
   vtkPoints *points = polydata->GetPoints();
-  vtkMatrix4x4 *vtkmatrix = vtkMatrix4x4::New();
-  newGeometry->GetVtkTransform()->GetMatrix(vtkmatrix);
-  double(*matrix)[4] = vtkmatrix->Element;
-
-  for (int i = 0; i < 3; ++i)
-    for (int j = 0; j < 3; ++j)
-      matrix[i][j] /= spacing[j];
-
-  unsigned int n = points->GetNumberOfPoints();
+  const vtkIdType n = points != nullptr ? points->GetNumberOfPoints() : 0;
   double point[3];
 
-  for (unsigned int i = 0; i < n; i++)
+  for (vtkIdType i = 0; i < n; i++)
   {
     points->GetPoint(i, point);
-    mitkVtkLinearTransformPoint(matrix, point, point);
+    for (unsigned int j = 0; j < 3; ++j)
+      point[j] += cropRegion.GetIndex(j);
+    mitkVtkLinearTransformPoint(indexToWorld, point, point);
     points->SetPoint(i, point);
   }
-  vtkmatrix->Delete();
 
   vtkSmartPointer<vtkCleanPolyData> cleanPolyDataFilter = vtkSmartPointer<vtkCleanPolyData>::New();
   cleanPolyDataFilter->SetInputData(polydata);
@@ -219,6 +528,5 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  mitk::Surface::Pointer output = this->GetOutput(0);
-  output->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), 0);
+  return cleanPolyDataFilter->GetOutput();
 }
@@ -19,8 +19,10 @@ found in the LICENSE file.
 #include <mitkSurfaceSource.h>
 
 #include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
 
 #include <itkImage.h>
+#include <itkImageRegion.h>
 
 #include <map>
 
@@ -29,7 +31,16 @@ namespace mitk
   /**
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
-   * you may call GenerateAllLabelsOn().
+   * you may call GenerateAllLabelsOn(). In that case, one output is generated for
+   * each label found in the image, see GetLabelOfOutput().
+   *
+   * The image is scanned once to determine the bounding box of each label, and the
+   * surfaces are generated on the cropped label regions in parallel. The surfaces are
+   * kept between updates, so that only the surfaces of labels whose voxels changed are
+   * generated again. Each output gets its own copy of the kept surface.
+   *
+   * If the image was only changed in regions marked by Image::ModifiedRegion() since the last
+   * update, only the modified region and the bounding boxes of the labels touching it are scanned.
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -105,6 +116,24 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Sets the number of threads used to generate the surfaces of several labels.
+     * @param _arg the number of threads, 0 (default) to use the default number of threads of ITK
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * Returns the label whose surface is provided by the output with the given index.
+     */
+    LabelType GetLabelOfOutput(unsigned int idx) const;
+
+    /**
+     * Returns the number of label surfaces that were generated by the last update,
+     * i.e. that were not taken over from a previous update.
+     */
+    itkGetMacro(NumberOfGeneratedLabels, unsigned int);
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -124,11 +153,32 @@ namespace mitk
       out[2] = z;
     }
 
-    mitk::Image::Pointer m_ResultImage;
+    typedef itk::ImageRegion<3> RegionType;
+
+    /**
+     * Voxel count, bounding box and a hash of the voxel positions of a label, and the
+     * surface generated for it.
+     */
+    struct LabelSurface
+    {
+      unsigned long Count;
+      unsigned long long Hash;
+      RegionType Region;
+      vtkSmartPointer<vtkPolyData> PolyData;
+    };
+
+    typedef std::map<LabelType, LabelSurface> LabelSurfaceMapType;
 
     template <typename TPixel, unsigned int VImageDimension>
     void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
 
+    template <typename TPixel, unsigned int VImageDimension>
+    vtkSmartPointer<vtkPolyData> GenerateLabelSurface(const itk::Image<TPixel, VImageDimension> *input,
+                                                      LabelType label,
+                                                      const RegionType &region,
+                                                      const double (&indexToWorld)[4][4],
+                                                      bool singleThreaded);
+
     bool m_GenerateAllLabels;
 
     int m_RequestedLabel;
@@ -139,6 +189,28 @@ namespace mitk
 
     float m_Sigma;
 
+    unsigned int m_NumberOfThreads;
+
+    unsigned int m_NumberOfGeneratedLabels;
+
+    LabelSurfaceMapType m_LabelSurfaces;
+
+    const void *m_CachedInput;
+
+    unsigned long m_CachedInputMTime;
+
+    unsigned long m_CachedGeometryMTime;
+
+    int m_CachedUseSmoothing;
+
+    float m_CachedSigma;
+
+    bool m_CachedGenerateAllLabels;
+
+    int m_CachedRequestedLabel;
+
+    int m_CachedBackgroundLabel;
+
     LabelMapType m_AvailableLabels;
 
     IndexToLabelMapType m_IndexToLabels;
@@ -13,11 +13,13 @@ found in the LICENSE file.
 #include "mitkLabelSetImageToSurfaceThreadedFilter.h"
 
 #include "mitkLabelSetImage.h"
-#include "mitkLabelSetImageToSurfaceFilter.h"
+
+#include <vtkPolyData.h>
 
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter()
+    : m_RequestedLabel(1), m_GenerateAllLabels(false), m_Filter(LabelSetImageToSurfaceFilter::New())
   {
   }
 
@@ -70,16 +72,26 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
-    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
-    filter->SetInput(image);
-    //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
-    filter->SetRequestedLabel(m_RequestedLabel);
-    filter->SetUseSmoothing(useSmoothing);
+    try
+    {
+      this->GetParameter("GenerateAllLabels", m_GenerateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+      // optional, by default only the requested label is extracted
+    }
+
+    m_Filter->SetInput(image);
+    //  m_Filter->SetObserver(obsv);
+    m_Filter->SetGenerateAllLabels(m_GenerateAllLabels);
+    m_Filter->SetRequestedLabel(m_RequestedLabel);
+    m_Filter->SetUseSmoothing(useSmoothing);
+
+    m_Results.clear();
 
     try
     {
-      filter->Update();
+      m_Filter->Update();
     }
     catch (itk::ExceptionObject &e)
     {
@@ -97,14 +109,19 @@ namespace mitk
       return false;
     }
 
-    m_Result = filter->GetOutput();
+    for (unsigned int idx = 0; idx < m_Filter->GetNumberOfIndexedOutputs(); ++idx)
+    {
+      Surface::Pointer result = m_Filter->GetOutput(idx);
 
-    if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
-      return false;
+      if (result.IsNull() || !result->GetVtkPolyData() || !result->GetVtkPolyData()->GetNumberOfPoints())
+        continue;
 
-    m_Result->DisconnectPipeline();
+      // the filter creates new outputs on its next update, the generated surfaces stay shared with its cache
+      result->DisconnectPipeline();
+      m_Results.emplace_back(m_Filter->GetLabelOfOutput(idx), result);
+    }
 
-    return true;
+    return !m_Results.empty();
   }
 
   void LabelSetImageToSurfaceThreadedFilter::ThreadedUpdateSuccessful()
@@ -112,17 +129,26 @@ namespace mitk
     LabelSetImage::Pointer image;
     this->GetPointerParameter("Input", image);
 
-    std::string name = this->GetGroupNode()->GetName();
-    name.append("-surf");
+    for (const auto &result : m_Results)
+    {
+      mitk::Label *label = image->GetLabel(result.first, image->GetActiveLayer());
+
+      std::string name = this->GetGroupNode()->GetName();
+      if (m_GenerateAllLabels && label != nullptr)
+        name.append("-").append(label->GetName());
+      name.append("-surf");
 
-    mitk::DataNode::Pointer node = mitk::DataNode::New();
-    node->SetData(m_Result);
-    node->SetName(name);
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetData(result.second);
+      node->SetName(name);
 
-    mitk::Color color = image->GetLabel(m_RequestedLabel, image->GetActiveLayer())->GetColor();
-    node->SetColor(color);
+      if (label != nullptr)
+        node->SetColor(label->GetColor());
+
+      this->InsertBelowGroupNode(node);
+    }
 
-    this->InsertBelowGroupNode(node);
+    m_Results.clear();
 
     Superclass::ThreadedUpdateSuccessful();
   }
@@ -13,10 +13,14 @@ found in the LICENSE file.
 #ifndef __mitkLabelSetImageToSurfaceThreadedFilter_H_
 #define __mitkLabelSetImageToSurfaceThreadedFilter_H_
 
+#include "mitkLabelSetImageToSurfaceFilter.h"
 #include "mitkSegmentationSink.h"
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
+#include <utility>
+#include <vector>
+
 namespace mitk
 {
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceThreadedFilter : public SegmentationSink
@@ -38,7 +42,12 @@ namespace mitk
 
   private:
     int m_RequestedLabel;
-    Surface::Pointer m_Result;
+    bool m_GenerateAllLabels;
+
+    /// kept between runs, so that only the surfaces of changed labels are generated again
+    LabelSetImageToSurfaceFilter::Pointer m_Filter;
+
+    std::vector<std::pair<LabelSetImageToSurfaceFilter::LabelType, Surface::Pointer>> m_Results;
   };
 
 } // namespace
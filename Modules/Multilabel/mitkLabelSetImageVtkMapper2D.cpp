@@ -36,6 +36,7 @@ found in the LICENSE file.
 // VTK
 #include <vtkCamera.h>
 #include <vtkCellArray.h>
+#include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
 #include <vtkImageReslice.h>
 #include <vtkLookupTable.h>
@@ -50,6 +51,9 @@ found in the LICENSE file.
 
 // ITK
 #include <itkRGBAPixel.h>
+
+// STL
+#include <algorithm>
 #include <mitkRenderingModeProperty.h>
 
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
@@ -72,6 +76,21 @@ mitk::LabelSetImageVtkMapper2D::LocalStorage *mitk::LabelSetImageVtkMapper2D::Ge
   return m_LSH.GetLocalStorage(renderer);
 }
 
+namespace
+{
+  /** \brief Maximum number of outlines kept by the outline cache of the mapper. */
+  const std::size_t MAXIMUM_NUMBER_OF_CACHED_OUTLINES = 8;
+
+  bool RegionsOverlap(const mitk::Image::VolumeRegionType &region1, const mitk::Image::VolumeRegionType &region2)
+  {
+    if (region1.GetNumberOfPixels() == 0 || region2.GetNumberOfPixels() == 0)
+      return false;
+
+    mitk::Image::VolumeRegionType intersection = region1;
+    return intersection.Crop(region2);
+  }
+}
+
 void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *renderer)
 {
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
@@ -96,7 +115,11 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   {
     localStorage->m_NumberOfLayers = numberOfLayers;
     localStorage->m_ReslicedImageVector.clear();
-    localStorage->m_ReslicerVector.clear();
+    localStorage->m_LayerResliceVector.clear();
+    localStorage->m_LayerUnitSpacingVector.clear();
+    localStorage->m_ReslicedLayerImageVector.clear();
+    localStorage->m_ReslicedLayerMTimeVector.clear();
+    localStorage->m_CheckedLayerMTimeVector.clear();
     localStorage->m_LayerTextureVector.clear();
     localStorage->m_LevelWindowFilterVector.clear();
     localStorage->m_LayerMapperVector.clear();
@@ -107,7 +130,11 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     for (int lidx = 0; lidx < numberOfLayers; ++lidx)
     {
       localStorage->m_ReslicedImageVector.push_back(vtkSmartPointer<vtkImageData>::New());
-      localStorage->m_ReslicerVector.push_back(mitk::ExtractSliceFilter::New());
+      localStorage->m_LayerResliceVector.push_back(vtkSmartPointer<vtkImageReslice>::New());
+      localStorage->m_LayerUnitSpacingVector.push_back(vtkSmartPointer<vtkImageChangeInformation>::New());
+      localStorage->m_ReslicedLayerImageVector.push_back(nullptr);
+      localStorage->m_ReslicedLayerMTimeVector.push_back(0);
+      localStorage->m_CheckedLayerMTimeVector.push_back(0);
       localStorage->m_LayerTextureVector.push_back(vtkSmartPointer<vtkNeverTranslucentTexture>::New());
       localStorage->m_LevelWindowFilterVector.push_back(vtkSmartPointer<vtkMitkLevelWindowFilter>::New());
       localStorage->m_LayerMapperVector.push_back(vtkSmartPointer<vtkPolyDataMapper>::New());
@@ -136,6 +163,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     for (int lidx = 0; lidx < numberOfLayers; ++lidx)
     {
       localStorage->m_ReslicedImageVector[lidx] = nullptr;
+      localStorage->m_ReslicedLayerImageVector[lidx] = nullptr;
       localStorage->m_LayerMapperVector[lidx]->SetInputData(localStorage->m_EmptyPolyData);
       localStorage->m_OutlineActor->SetVisibility(false);
       localStorage->m_OutlineShadowActor->SetVisibility(false);
@@ -143,76 +171,166 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     return;
   }
 
+  // is the geometry of the slice based on the image image or the worldgeometry?
+  bool inPlaneResampleExtentByGeometry = false;
+  node->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
+
+  // All layers share the geometry of the image, thus the slice geometry only has to be
+  // computed again if the plane, the image geometry or the resample mode changed.
+  const int timeStep = this->GetTimestep();
+  const BaseGeometry *layerGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+  const bool sliceGeometryChanged =
+    (localStorage->m_LastSliceGeometryUpdateTime < worldGeometry->GetMTime()) ||
+    (localStorage->m_LastSliceGeometryUpdateTime < renderer->GetCurrentWorldPlaneGeometryUpdateTime()) ||
+    (localStorage->m_LastSliceGeometryUpdateTime < image->GetTimeGeometry()->GetMTime()) ||
+    (localStorage->m_LastSliceGeometryUpdateTime < layerGeometry->GetMTime()) ||
+    (localStorage->m_LastSliceTimeStep != timeStep) ||
+    (localStorage->m_LastInPlaneResampleExtentByGeometry != inPlaneResampleExtentByGeometry);
+
+  std::vector<mitk::Image *> layerImages(numberOfLayers);
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
-  {
-    mitk::Image *layerImage = nullptr;
+    layerImages[lidx] = (lidx == activeLayer) ? image : image->GetLayerImage(lidx);
 
-    // set main input for ExtractSliceFilter
-    if (lidx == activeLayer)
-      layerImage = image;
-    else
-      layerImage = image->GetLayerImage(lidx);
+  auto layerNeedsReslice = [&](int lidx) {
+    if (sliceGeometryChanged || localStorage->m_ReslicedImageVector[lidx] == nullptr ||
+        localStorage->m_ReslicedLayerImageVector[lidx] != layerImages[lidx])
+      return true;
+
+    const itk::ModifiedTimeType layerMTime = layerImages[lidx]->GetMTime();
+    if (localStorage->m_CheckedLayerMTimeVector[lidx] == layerMTime)
+      return false;
 
-    localStorage->m_ReslicerVector[lidx]->SetInput(layerImage);
-    localStorage->m_ReslicerVector[lidx]->SetWorldGeometry(worldGeometry);
-    localStorage->m_ReslicerVector[lidx]->SetTimeStep(this->GetTimestep());
+    // e.g. a segmentation tool that wrote into another slice does not change the resliced image
+    mitk::Image::VolumeRegionType modifiedRegion;
+    if (layerImages[lidx]->GetModifiedRegionSince(
+          localStorage->m_CheckedLayerMTimeVector[lidx], timeStep, modifiedRegion) &&
+        !RegionsOverlap(modifiedRegion, localStorage->m_SliceRegion))
+    {
+      localStorage->m_CheckedLayerMTimeVector[lidx] = layerMTime;
+      return false;
+    }
+
+    return true;
+  };
+
+  // 1) the first layer is resliced by the ExtractSliceFilter which also computes the slice geometry
+  if (sliceGeometryChanged || layerNeedsReslice(0))
+  {
+    localStorage->m_Reslicer->SetInput(layerImages[0]);
+    localStorage->m_Reslicer->SetWorldGeometry(worldGeometry);
+    localStorage->m_Reslicer->SetTimeStep(timeStep);
 
     // set the transformation of the image to adapt reslice axis
-    localStorage->m_ReslicerVector[lidx]->SetResliceTransformByGeometry(
-      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+    localStorage->m_Reslicer->SetResliceTransformByGeometry(
+      layerImages[0]->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
 
-    // is the geometry of the slice based on the image image or the worldgeometry?
-    bool inPlaneResampleExtentByGeometry = false;
-    node->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
-    localStorage->m_ReslicerVector[lidx]->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
-    localStorage->m_ReslicerVector[lidx]->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-    localStorage->m_ReslicerVector[lidx]->SetVtkOutputRequest(true);
+    localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
+    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+    localStorage->m_Reslicer->SetVtkOutputRequest(true);
 
     // this is needed when thick mode was enabled before. These variables have to be reset to default values
-    localStorage->m_ReslicerVector[lidx]->SetOutputDimensionality(2);
-    localStorage->m_ReslicerVector[lidx]->SetOutputSpacingZDirection(1.0);
-    localStorage->m_ReslicerVector[lidx]->SetOutputExtentZDirection(0, 0);
-
-    // Bounds information for reslicing (only required if reference geometry is present)
-    // this used for generating a vtkPLaneSource with the right size
-    double sliceBounds[6];
-    sliceBounds[0] = 0.0;
-    sliceBounds[1] = 0.0;
-    sliceBounds[2] = 0.0;
-    sliceBounds[3] = 0.0;
-    sliceBounds[4] = 0.0;
-    sliceBounds[5] = 0.0;
-
-    localStorage->m_ReslicerVector[lidx]->GetClippedPlaneBounds(sliceBounds);
-
-    // setup the textured plane
-    this->GeneratePlane(renderer, sliceBounds);
-
-    // get the spacing of the slice
-    localStorage->m_mmPerPixel = localStorage->m_ReslicerVector[lidx]->GetOutputSpacing();
-    localStorage->m_ReslicerVector[lidx]->Modified();
+    localStorage->m_Reslicer->SetOutputDimensionality(2);
+    localStorage->m_Reslicer->SetOutputSpacingZDirection(1.0);
+    localStorage->m_Reslicer->SetOutputExtentZDirection(0, 0);
+
+    localStorage->m_Reslicer->Modified();
     // start the pipeline with updating the largest possible, needed if the geometry of the image has changed
-    localStorage->m_ReslicerVector[lidx]->UpdateLargestPossibleRegion();
-    localStorage->m_ReslicedImageVector[lidx] = localStorage->m_ReslicerVector[lidx]->GetVtkOutput();
+    localStorage->m_Reslicer->UpdateLargestPossibleRegion();
+    localStorage->m_ReslicedImageVector[0] = localStorage->m_Reslicer->GetVtkOutput();
+    localStorage->m_ReslicedLayerImageVector[0] = layerImages[0];
+    localStorage->m_ReslicedLayerMTimeVector[0] = layerImages[0]->GetMTime();
+    localStorage->m_CheckedLayerMTimeVector[0] = localStorage->m_ReslicedLayerMTimeVector[0];
+  }
 
-    const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
+  // 2) the other layers reuse the reslice axes, transform and extent of the first layer
+  vtkImageReslice *referenceReslice = localStorage->m_ReferenceReslice;
+  for (int lidx = 1; lidx < numberOfLayers; ++lidx)
+  {
+    if (!layerNeedsReslice(lidx))
+      continue;
 
-    double textureClippingBounds[6];
-    for (auto &textureClippingBound : textureClippingBounds)
+    vtkImageReslice *reslice = localStorage->m_LayerResliceVector[lidx];
+    vtkImageData *layerData = layerImages[lidx]->GetVtkImageData(timeStep);
+    if (referenceReslice->GetResliceTransform() != nullptr)
+    {
+      // see ExtractSliceFilter: the reslice transform already contains the spacing of the image
+      localStorage->m_LayerUnitSpacingVector[lidx]->SetOutputSpacing(1.0, 1.0, 1.0);
+      localStorage->m_LayerUnitSpacingVector[lidx]->SetInputData(layerData);
+      reslice->SetInputConnection(localStorage->m_LayerUnitSpacingVector[lidx]->GetOutputPort());
+    }
+    else
     {
-      textureClippingBound = 0.0;
+      reslice->SetInputData(layerData);
     }
 
-    // Calculate the actual bounds of the transformed plane clipped by the
-    // dataset bounding box; this is required for drawing the texture at the
-    // correct position during 3D mapping.
-    mitk::PlaneClipping::CalculateClippedPlaneBounds(layerImage->GetGeometry(), planeGeometry, textureClippingBounds);
+    reslice->SetResliceTransform(referenceReslice->GetResliceTransform());
+    reslice->SetResliceAxes(referenceReslice->GetResliceAxes());
+    reslice->SetBackgroundLevel(referenceReslice->GetBackgroundLevel());
+    reslice->SetOutputDimensionality(referenceReslice->GetOutputDimensionality());
+    reslice->SetInterpolationModeToNearestNeighbor();
+    reslice->SetOutputExtent(referenceReslice->GetOutputExtent());
+    reslice->SetOutputOrigin(referenceReslice->GetOutputOrigin());
+    reslice->SetOutputSpacing(referenceReslice->GetOutputSpacing());
+    reslice->Update();
+
+    localStorage->m_ReslicedImageVector[lidx] = reslice->GetOutput();
+    localStorage->m_ReslicedLayerImageVector[lidx] = layerImages[lidx];
+    localStorage->m_ReslicedLayerMTimeVector[lidx] = layerImages[lidx]->GetMTime();
+    localStorage->m_CheckedLayerMTimeVector[lidx] = localStorage->m_ReslicedLayerMTimeVector[lidx];
+  }
+
+  if (sliceGeometryChanged)
+  {
+    localStorage->m_SliceRegion = image->GetRegionOfPlane(worldGeometry, timeStep);
+    localStorage->m_LastSliceTimeStep = timeStep;
+    localStorage->m_LastInPlaneResampleExtentByGeometry = inPlaneResampleExtentByGeometry;
+    localStorage->m_LastSliceGeometryUpdateTime.Modified();
+  }
+
+  // Bounds information for reslicing (only required if reference geometry is present)
+  // this used for generating a vtkPLaneSource with the right size
+  double sliceBounds[6];
+  sliceBounds[0] = 0.0;
+  sliceBounds[1] = 0.0;
+  sliceBounds[2] = 0.0;
+  sliceBounds[3] = 0.0;
+  sliceBounds[4] = 0.0;
+  sliceBounds[5] = 0.0;
+
+  localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
+
+  // setup the textured plane
+  this->GeneratePlane(renderer, sliceBounds);
 
-    textureClippingBounds[0] = static_cast<int>(textureClippingBounds[0] / localStorage->m_mmPerPixel[0] + 0.5);
-    textureClippingBounds[1] = static_cast<int>(textureClippingBounds[1] / localStorage->m_mmPerPixel[0] + 0.5);
-    textureClippingBounds[2] = static_cast<int>(textureClippingBounds[2] / localStorage->m_mmPerPixel[1] + 0.5);
-    textureClippingBounds[3] = static_cast<int>(textureClippingBounds[3] / localStorage->m_mmPerPixel[1] + 0.5);
+  // get the spacing of the slice
+  localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
 
+  const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
+
+  double textureClippingBounds[6];
+  for (auto &textureClippingBound : textureClippingBounds)
+  {
+    textureClippingBound = 0.0;
+  }
+
+  // Calculate the actual bounds of the transformed plane clipped by the
+  // dataset bounding box; this is required for drawing the texture at the
+  // correct position during 3D mapping.
+  mitk::PlaneClipping::CalculateClippedPlaneBounds(image->GetGeometry(), planeGeometry, textureClippingBounds);
+
+  textureClippingBounds[0] = static_cast<int>(textureClippingBounds[0] / localStorage->m_mmPerPixel[0] + 0.5);
+  textureClippingBounds[1] = static_cast<int>(textureClippingBounds[1] / localStorage->m_mmPerPixel[0] + 0.5);
+  textureClippingBounds[2] = static_cast<int>(textureClippingBounds[2] / localStorage->m_mmPerPixel[1] + 0.5);
+  textureClippingBounds[3] = static_cast<int>(textureClippingBounds[3] / localStorage->m_mmPerPixel[1] + 0.5);
+
+  // check for texture interpolation property
+  bool textureInterpolation = false;
+  node->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
+
+  this->TransformActor(renderer);
+
+  for (int lidx = 0; lidx < numberOfLayers; ++lidx)
+  {
     // clipping bounds for cutting the imageLayer
     localStorage->m_LevelWindowFilterVector[lidx]->SetClippingBounds(textureClippingBounds);
 
@@ -226,18 +344,12 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_LevelWindowFilterVector[lidx]->SetInputData(localStorage->m_ReslicedImageVector[lidx]);
     // connect the texture with the output of the levelwindow filter
 
-    // check for texture interpolation property
-    bool textureInterpolation = false;
-    node->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
-
     // set the interpolation modus according to the property
     localStorage->m_LayerTextureVector[lidx]->SetInterpolate(textureInterpolation);
 
     localStorage->m_LayerTextureVector[lidx]->SetInputConnection(
       localStorage->m_LevelWindowFilterVector[lidx]->GetOutputPort());
 
-    this->TransformActor(renderer);
-
     // set the plane as input for the mapper
     localStorage->m_LayerMapperVector[lidx]->SetInputConnection(localStorage->m_Plane->GetOutputPort());
 
@@ -255,7 +367,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     {
       //generate contours/outlines
       localStorage->m_OutlinePolyData =
-        this->CreateOutlinePolyData(renderer, localStorage->m_ReslicedImageVector[activeLayer], activeLabel->GetValue());
+        this->GetOutlinePolyData(renderer, activeLayer, activeLabel->GetValue());
       localStorage->m_OutlineActor->SetVisibility(true);
       localStorage->m_OutlineShadowActor->SetVisibility(true);
       const mitk::Color& color = activeLabel->GetColor();
@@ -278,6 +390,55 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   localStorage->m_OutlineShadowActor->SetVisibility(false);
 }
 
+bool mitk::LabelSetImageVtkMapper2D::OutlineCacheEntry::HasSameKey(const OutlineCacheEntry &other) const
+{
+  return LayerImage == other.LayerImage && LayerMTime == other.LayerMTime && TimeStep == other.TimeStep &&
+         PixelValue == other.PixelValue && ResliceAxes == other.ResliceAxes && Extent == other.Extent &&
+         Spacing == other.Spacing;
+}
+
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::GetOutlinePolyData(mitk::BaseRenderer *renderer,
+                                                                                int layer,
+                                                                                int pixelValue)
+{
+  LocalStorage *localStorage = this->GetLocalStorage(renderer);
+  vtkImageData *reslicedImage = localStorage->m_ReslicedImageVector[layer];
+  // all layers are resliced with the axes of the first layer
+  vtkMatrix4x4 *resliceAxes = localStorage->m_ReferenceReslice->GetResliceAxes();
+
+  OutlineCacheEntry key;
+  key.LayerImage = localStorage->m_ReslicedLayerImageVector[layer];
+  key.LayerMTime = localStorage->m_ReslicedLayerMTimeVector[layer];
+  key.TimeStep = this->GetTimestep();
+  key.PixelValue = pixelValue;
+  for (int i = 0; i < 16; ++i)
+    key.ResliceAxes[i] = resliceAxes->GetElement(i / 4, i % 4);
+  reslicedImage->GetExtent(key.Extent.data());
+  key.Spacing[0] = localStorage->m_mmPerPixel[0];
+  key.Spacing[1] = localStorage->m_mmPerPixel[1];
+
+  for (const auto &entry : m_OutlineCache)
+  {
+    if (entry.HasSameKey(key))
+      return entry.Outline;
+  }
+
+  key.Outline = CreateOutlinePolyData(reslicedImage, pixelValue, localStorage->m_mmPerPixel);
+
+  // drop outlines of images that were modified in the meantime and the oldest entries
+  m_OutlineCache.erase(std::remove_if(m_OutlineCache.begin(),
+                                      m_OutlineCache.end(),
+                                      [&key](const OutlineCacheEntry &entry) {
+                                        return entry.LayerImage == key.LayerImage && entry.LayerMTime != key.LayerMTime;
+                                      }),
+                       m_OutlineCache.end());
+  if (m_OutlineCache.size() >= MAXIMUM_NUMBER_OF_CACHED_OUTLINES)
+    m_OutlineCache.erase(m_OutlineCache.begin());
+  m_OutlineCache.push_back(key);
+
+  return key.Outline;
+}
+
 bool mitk::LabelSetImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry,
                                                                       SlicedGeometry3D *imageGeometry)
 {
@@ -307,12 +468,10 @@ bool mitk::LabelSetImageVtkMapper2D::RenderingGeometryIntersectsImage(const Plan
   return false;
 }
 
-vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer,
-                                                                                   vtkImageData *image,
-                                                                                   int pixelValue)
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyData(vtkImageData *image,
+                                                                                   int pixelValue,
+                                                                                   const mitk::ScalarType *mmPerPixel)
 {
-  LocalStorage *localStorage = this->GetLocalStorage(renderer);
-
   // get the min and max index values of each direction
   int *extent = image->GetExtent();
   int xMin = extent[0];
@@ -325,8 +484,8 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
   int x = xMin;                       // pixel index x
   int y = yMin;                       // pixel index y
 
-  // get the depth for each contour
-  float depth = this->CalculateLayerDepth(renderer);
+  // the depth of the contour is applied by the outline actors, see TransformActor()
+  const float depth = 0.0f;
 
   vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();      // the points to draw
   vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New(); // the lines to connect the points
@@ -348,9 +507,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       { // x direction - bottom edge of the pixel
         // add the 2 points
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint((x + 1) * mmPerPixel[0], y * mmPerPixel[1], depth);
         // add the line between both points
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
@@ -361,9 +520,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if (y < yMax && *(currentPixel + line) != pixelValue)
       { // x direction - top edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          (x + 1) * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -373,9 +532,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if ((x > xMin || y > yMin) && *(currentPixel - 1) != pixelValue)
       { // y direction - left edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -385,9 +544,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if ((y < yMax || (x < xMax)) && *(currentPixel + 1) != pixelValue)
       { // y direction - right edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint((x + 1) * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          (x + 1) * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -399,9 +558,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if (x == xMin)
       { // draw left edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -411,9 +570,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if (x == xMax)
       { // draw right edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint((x + 1) * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          (x + 1) * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -423,9 +582,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if (y == yMin)
       { // draw bottom edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], y * mmPerPixel[1], depth);
         vtkIdType p2 =
-          points->InsertNextPoint((x + 1) * localStorage->m_mmPerPixel[0], y * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint((x + 1) * mmPerPixel[0], y * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -435,9 +594,9 @@ vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyDa
       if (y == yMax)
       { // draw top edge of the pixel
         vtkIdType p1 =
-          points->InsertNextPoint(x * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          points->InsertNextPoint(x * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         vtkIdType p2 = points->InsertNextPoint(
-          (x + 1) * localStorage->m_mmPerPixel[0], (y + 1) * localStorage->m_mmPerPixel[1], depth);
+          (x + 1) * mmPerPixel[0], (y + 1) * mmPerPixel[1], depth);
         lines->InsertNextCell(2);
         lines->InsertCellPoint(p1);
         lines->InsertCellPoint(p2);
@@ -579,7 +738,7 @@ void mitk::LabelSetImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_ReslicerVector[0]->GetResliceAxes(); // same for all layers
+  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes(); // same for all layers
   trans->SetMatrix(matrix);
 
   for (int lidx = 0; lidx < localStorage->m_NumberOfLayers; ++lidx)
@@ -590,14 +749,18 @@ void mitk::LabelSetImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer
     localStorage->m_LayerActorVector[lidx]->SetPosition(
       -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
   }
+
+  // the outlines are shared between renderers and generated without depth, see CreateOutlinePolyData()
+  float depth = this->CalculateLayerDepth(renderer);
+
   // same for outline actor
   localStorage->m_OutlineActor->SetUserTransform(trans);
   localStorage->m_OutlineActor->SetPosition(
-    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
+    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], depth);
   // same for outline shadow actor
   localStorage->m_OutlineShadowActor->SetUserTransform(trans);
   localStorage->m_OutlineShadowActor->SetPosition(
-    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
+    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], depth);
 }
 
 void mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(mitk::DataNode *node,
@@ -639,8 +802,13 @@ mitk::LabelSetImageVtkMapper2D::LocalStorage::LocalStorage()
   m_OutlineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
   m_OutlineShadowActor = vtkSmartPointer<vtkActor>::New();
 
+  m_ReferenceReslice = vtkSmartPointer<vtkImageReslice>::New();
+  m_Reslicer = mitk::ExtractSliceFilter::New(m_ReferenceReslice);
+
   m_NumberOfLayers = 0;
   m_mmPerPixel = nullptr;
+  m_LastSliceTimeStep = -1;
+  m_LastInPlaneResampleExtentByGeometry = false;
 
   m_OutlineActor->SetMapper(m_OutlineMapper);
   m_OutlineShadowActor->SetMapper(m_OutlineMapper);
@@ -26,12 +26,16 @@ found in the LICENSE file.
 // VTK
 #include <vtkSmartPointer.h>
 
+// STL
+#include <array>
+
 class vtkActor;
 class vtkPolyDataMapper;
 class vtkPlaneSource;
 class vtkImageData;
 class vtkLookupTable;
 class vtkImageReslice;
+class vtkImageChangeInformation;
 class vtkPoints;
 class vtkMitkThickSlicesFilter;
 class vtkPolyData;
@@ -95,7 +99,27 @@ namespace mitk
       vtkSmartPointer<vtkPolyData> m_EmptyPolyData;
       vtkSmartPointer<vtkPlaneSource> m_Plane;
 
-      std::vector<mitk::ExtractSliceFilter::Pointer> m_ReslicerVector;
+      /** \brief Reslices the first layer and computes the slice geometry that is shared by all layers. */
+      mitk::ExtractSliceFilter::Pointer m_Reslicer;
+      /** \brief The vtkImageReslice of m_Reslicer, its settings are copied to the reslicers of the other layers. */
+      vtkSmartPointer<vtkImageReslice> m_ReferenceReslice;
+      /** \brief Reslicers of the layers > 0 (index 0 is unused), they reuse the slice geometry of the first layer. */
+      std::vector<vtkSmartPointer<vtkImageReslice>> m_LayerResliceVector;
+      std::vector<vtkSmartPointer<vtkImageChangeInformation>> m_LayerUnitSpacingVector;
+
+      /** \brief Layer image and its modified time each resliced image was generated from. */
+      std::vector<const mitk::Image *> m_ReslicedLayerImageVector;
+      std::vector<itk::ModifiedTimeType> m_ReslicedLayerMTimeVector;
+      /** \brief Modified time of each layer image up to which all modifications are known to miss the slice. */
+      std::vector<itk::ModifiedTimeType> m_CheckedLayerMTimeVector;
+      /** \brief Voxels of the layer images that contribute to the current slice, see Image::GetRegionOfPlane(). */
+      mitk::Image::VolumeRegionType m_SliceRegion;
+
+      /** \brief Timestamp of the last computation of the slice geometry. */
+      itk::TimeStamp m_LastSliceGeometryUpdateTime;
+      /** \brief Time step and resample mode used for the last computation of the slice geometry. */
+      int m_LastSliceTimeStep;
+      bool m_LastInPlaneResampleExtentByGeometry;
 
       vtkSmartPointer<vtkPolyData> m_OutlinePolyData;
       /** \brief An actor for the outline */
@@ -164,12 +188,38 @@ namespace mitk
     void GeneratePlane(mitk::BaseRenderer *renderer, double planeBounds[6]);
 
     /** \brief Generates a vtkPolyData object containing the outline of a given binary slice.
-        \param renderer: Pointer to the renderer containing the needed information
+        \param image: the resliced image
+        \param pixelValue: the label value the outline is generated for
+        \param mmPerPixel: the spacing of the resliced image
+        The outline is generated in the plane z = 0, the depth is applied by the outline actors.
         \note This code is based on code from the iil library.
         */
-    vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(mitk::BaseRenderer *renderer,
-                                                       vtkImageData *image,
-                                                       int pixelValue = 1);
+    static vtkSmartPointer<vtkPolyData> CreateOutlinePolyData(vtkImageData *image,
+                                                              int pixelValue,
+                                                              const mitk::ScalarType *mmPerPixel);
+
+    /** \brief Returns the outline of the given label in the resliced layer of the renderer.
+      *
+      * Outlines are cached by slice and label, so render windows that show the same plane of the
+      * same image share the outline instead of extracting it again.
+      */
+    vtkSmartPointer<vtkPolyData> GetOutlinePolyData(mitk::BaseRenderer *renderer, int layer, int pixelValue);
+
+    /** \brief Cache entry of an outline, see GetOutlinePolyData(). */
+    struct OutlineCacheEntry
+    {
+      const mitk::Image *LayerImage;
+      itk::ModifiedTimeType LayerMTime;
+      int TimeStep;
+      int PixelValue;
+      std::array<double, 16> ResliceAxes;
+      std::array<int, 6> Extent;
+      std::array<double, 2> Spacing;
+      vtkSmartPointer<vtkPolyData> Outline;
+
+      bool HasSameKey(const OutlineCacheEntry &other) const;
+    };
+    std::vector<OutlineCacheEntry> m_OutlineCache;
 
     /** Default constructor */
     LabelSetImageVtkMapper2D();
@@ -15,7 +15,12 @@ found in the LICENSE file.
 #include "itkByteSwapper.h"
 #include "igtlImageMessage.h"
 
+// Upper bound for the number of messages kept for recycling. If consumers hold
+// more frames at the same time, surplus messages are left to them.
+static const std::size_t MAXIMUM_MESSAGE_POOL_SIZE = 8;
+
 mitk::ImageToIGTLMessageFilter::ImageToIGTLMessageFilter()
+  : m_Upstream(nullptr)
 {
   mitk::IGTLMessage::Pointer output = mitk::IGTLMessage::New();
   this->SetNumberOfRequiredOutputs(1);
@@ -52,7 +57,7 @@ void mitk::ImageToIGTLMessageFilter::GenerateData()
       continue;
     }
 
-    igtl::ImageMessage::Pointer imgMsg = igtl::ImageMessage::New();
+    igtl::ImageMessage::Pointer imgMsg = this->GetRecycledMessage();
 
     // TODO: Which kind of coordinate system does MITK really use?
     imgMsg->SetCoordinateSystem(igtl::ImageMessage::COORDINATE_RAS);
@@ -142,7 +147,8 @@ void mitk::ImageToIGTLMessageFilter::GenerateData()
     }
     imgMsg->SetDimensions(sizes);
 
-    // Allocate and copy data.
+    // Allocate and copy data. A recycled message of the same size keeps its
+    // pack buffer, so this does not allocate while streaming.
     imgMsg->AllocatePack();
     imgMsg->AllocateScalars();
 
@@ -203,6 +209,32 @@ void mitk::ImageToIGTLMessageFilter::GenerateData()
   }
 }
 
+igtl::ImageMessage::Pointer mitk::ImageToIGTLMessageFilter::GetRecycledMessage()
+{
+  for (auto& message : m_MessagePool)
+  {
+    // a message is free if it is only referenced by the pool and (in case it
+    // was the last frame) by one of our outputs. Messages waiting in an
+    // IGTLMessageQueue or being sent hold an additional reference.
+    int ownReferences = 1;
+    for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+    {
+      mitk::IGTLMessage* output = this->GetOutput(i);
+      if (output != nullptr && output->GetMessage().GetPointer() == message.GetPointer())
+        ++ownReferences;
+    }
+
+    if (message->GetReferenceCount() == ownReferences)
+      return message;
+  }
+
+  igtl::ImageMessage::Pointer message = igtl::ImageMessage::New();
+  if (m_MessagePool.size() >= MAXIMUM_MESSAGE_POOL_SIZE)
+    m_MessagePool.erase(m_MessagePool.begin());
+  m_MessagePool.push_back(message);
+  return message;
+}
+
 void mitk::ImageToIGTLMessageFilter::SetInput(const mitk::Image* img)
 {
   this->ProcessObject::SetNthInput(0, const_cast<mitk::Image*>(img));
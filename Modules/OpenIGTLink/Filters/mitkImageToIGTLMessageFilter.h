@@ -18,12 +18,22 @@ found in the LICENSE file.
 #include <mitkImage.h>
 #include <mitkImageSource.h>
 
+#include <igtlImageMessage.h>
+
+#include <vector>
+
 namespace mitk
 {
 /**Documentation
  *
  * \brief This filter creates IGTL messages from mitk::Image objects
  *
+ * The created igtl::ImageMessage objects are recycled: a message is reused
+ * for a later frame as soon as nobody but this filter references it anymore,
+ * e.g. after it was sent by an IGTLDevice. Streaming images of constant size
+ * therefore does not allocate a new message buffer per frame, the pixel data
+ * is copied once into the pack buffer of the message.
+ *
  * \ingroup OpenIGTLink
  *
  */
@@ -87,7 +97,20 @@ class MITKOPENIGTLINK_EXPORT ImageToIGTLMessageFilter : public IGTLMessageSource
   */
   virtual void CreateOutputsForAllInputs();
 
+  /**
+  * \brief Returns a message of the pool that is not referenced outside of
+  * this filter anymore, or a new one if all of them are still in use
+  *
+  * IGTLMessageQueue::PushSendMessage() keeps a reference to the igtl message
+  * until the sending thread sent it, so queued and in-flight messages are
+  * never reused.
+  */
+  igtl::ImageMessage::Pointer GetRecycledMessage();
+
   mitk::ImageSource* m_Upstream;
+
+  /** messages that were handed out by this filter and may be reused */
+  std::vector<igtl::ImageMessage::Pointer> m_MessagePool;
 };
 }  // namespace mitk
 
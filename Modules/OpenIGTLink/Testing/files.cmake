@@ -3,3 +3,8 @@ set(MODULE_TESTS
    mitkOpenIGTLinkImageFactoryTest.cpp
    mitkOpenIGTLinkIGTLImageMessageFilterTest.cpp
 )
+
+# not run by ctest, the benchmark takes some time and only reports timings
+set(MODULE_CUSTOM_TESTS
+   mitkOpenIGTLinkLatencyTest.cpp
+)
@@ -0,0 +1,144 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+//MITK
+#include "mitkIGTLServer.h"
+#include "mitkIGTLClient.h"
+#include "mitkIGTLMessageFactory.h"
+
+//IGTL
+#include "igtlStatusMessage.h"
+
+static int PORT = 35353;
+static const std::string HOSTNAME = "localhost";
+static const unsigned int NUMBER_OF_MESSAGES = 500;
+
+/**
+ * Measures the time between IGTLDevice::SendMessage() on a server and the
+ * message showing up in the receive queue of the connected clients over
+ * localhost, and reports the mean and maximum latency.
+ * It is not part of the regular tests, run it with the test driver of the module:
+ * MitkOpenIGTLinkTestDriver mitkOpenIGTLinkLatencyTest
+ */
+class mitkOpenIGTLinkLatencyTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkLatencyTestSuite);
+  MITK_TEST(Test_ServerToTwoClientsLatency);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLServer::Pointer m_Server;
+  mitk::IGTLClient::Pointer m_Client_One;
+  mitk::IGTLClient::Pointer m_Client_Two;
+  mitk::IGTLMessageFactory::Pointer m_MessageFactory;
+
+  static mitk::IGTLClient::Pointer CreateClient(const std::string& name)
+  {
+    mitk::IGTLClient::Pointer client = mitk::IGTLClient::New(true);
+    client->SetObjectName(name);
+    client->SetName(name);
+    client->SetHostname(HOSTNAME);
+    client->SetPortNumber(PORT);
+    return client;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_MessageFactory = mitk::IGTLMessageFactory::New();
+    m_Server = mitk::IGTLServer::New(true);
+    m_Server->SetObjectName("Latency Server");
+    m_Server->SetName("Latency Server");
+    m_Server->SetHostname(HOSTNAME);
+    m_Server->SetPortNumber(PORT);
+    m_Client_One = CreateClient("Latency Client 1");
+    m_Client_Two = CreateClient("Latency Client 2");
+  }
+
+  void tearDown() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    m_Server = nullptr;
+    m_Client_One = nullptr;
+    m_Client_Two = nullptr;
+    m_MessageFactory = nullptr;
+  }
+
+  void Test_ServerToTwoClientsLatency()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Could not open Connection with Server", m_Server->OpenConnection());
+    m_Server->StartCommunication();
+    CPPUNIT_ASSERT_MESSAGE("Could not connect to Server with first client", m_Client_One->OpenConnection());
+    m_Client_One->StartCommunication();
+    CPPUNIT_ASSERT_MESSAGE("Could not connect to Server with second client", m_Client_Two->OpenConnection());
+    m_Client_Two->StartCommunication();
+
+    // both clients are accepted by the receiving thread of the server
+    int steps = 0;
+    while (m_Server->GetNumberOfConnections() < 2 && ++steps < 100)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CPPUNIT_ASSERT_EQUAL(2u, m_Server->GetNumberOfConnections());
+
+    double totalLatency = 0.0;
+    double maximumLatency = 0.0;
+
+    for (unsigned int i = 0; i < NUMBER_OF_MESSAGES; ++i)
+    {
+      igtl::MessageBase::Pointer sentMessage = m_MessageFactory->CreateInstance("STATUS");
+      dynamic_cast<igtl::StatusMessage*>(sentMessage.GetPointer())->SetStatusString(std::to_string(i).c_str());
+
+      auto start = std::chrono::high_resolution_clock::now();
+      m_Server->SendMessage(mitk::IGTLMessage::New(sentMessage));
+
+      igtl::MessageBase::Pointer receivedMessage1;
+      igtl::MessageBase::Pointer receivedMessage2;
+      while (receivedMessage1.IsNull() || receivedMessage2.IsNull())
+      {
+        if (receivedMessage1.IsNull())
+          receivedMessage1 = m_Client_One->GetMessageQueue()->PullMiscMessage();
+        if (receivedMessage2.IsNull())
+          receivedMessage2 = m_Client_Two->GetMessageQueue()->PullMiscMessage();
+
+        if (std::chrono::high_resolution_clock::now() - start > std::chrono::seconds(1))
+          break;
+        std::this_thread::yield();
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+
+      CPPUNIT_ASSERT_MESSAGE("First client did not receive the message", receivedMessage1.IsNotNull());
+      CPPUNIT_ASSERT_MESSAGE("Second client did not receive the message", receivedMessage2.IsNotNull());
+      double latency = std::chrono::duration<double, std::micro>(end - start).count();
+      totalLatency += latency;
+      maximumLatency = std::max(maximumLatency, latency);
+    }
+
+    CPPUNIT_ASSERT(m_Client_Two->CloseConnection());
+    CPPUNIT_ASSERT(m_Client_One->CloseConnection());
+    CPPUNIT_ASSERT(m_Server->CloseConnection());
+
+    MITK_INFO << "Server to two clients latency over " << NUMBER_OF_MESSAGES << " messages [us]:"
+              << " mean " << totalLatency / NUMBER_OF_MESSAGES
+              << " max " << maximumLatency;
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkLatency)
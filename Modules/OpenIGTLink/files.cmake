@@ -10,6 +10,7 @@ set(CPP_FILES
   mitkIGTLMessageCloneHandler.h
   mitkIGTLDummyMessage.cpp
   mitkIGTLMessageQueue.cpp
+  mitkIGTLSocket.cpp
   mitkIGTLMessageProvider.cpp
   mitkIGTLMeasurements.cpp
   mitkIGTLModuleActivator.cpp
@@ -19,7 +19,7 @@ found in the LICENSE file.
 #include <itksys/SystemTools.hxx>
 #include <itkMutexLockHolder.h>
 
-#include <igtlClientSocket.h>
+#include <mitkIGTLSocket.h>
 #include <igtl_status.h>
 
 typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
@@ -53,7 +53,7 @@ bool mitk::IGTLClient::OpenConnection()
   }
 
   //create a new client socket
-  m_Socket = igtl::ClientSocket::New();
+  m_Socket = mitk::IGTLClientSocket::New();
 
   //try to connect to the igtl server
   int response = dynamic_cast<igtl::ClientSocket*>(m_Socket.GetPointer())->
@@ -77,7 +77,11 @@ bool mitk::IGTLClient::OpenConnection()
 
 void mitk::IGTLClient::Receive()
 {
-  //MITK_INFO << "Trying to receive message";
+  //sleep until the server sent something or the socket timeout elapsed
+  SocketVectorType readableSockets;
+  if (!this->WaitForReadableSockets({ this->m_Socket }, readableSockets))
+    return;
+
   //try to receive a message, if the socket is not present anymore stop the
   //communication
   unsigned int status = this->ReceivePrivate(this->m_Socket);
@@ -94,16 +98,17 @@ void mitk::IGTLClient::Send()
 {
   mitk::IGTLMessage::Pointer mitkMessage;
 
-  //get the latest message from the queue
-  mitkMessage = this->m_MessageQueue->PullSendMessage();
-
-  // there is no message => return
-  if (mitkMessage.IsNull())
+  //sleep until a message is pushed into the queue
+  if (!this->WaitForSendMessage())
     return;
 
-  if (!this->SendMessagePrivate(mitkMessage, this->m_Socket))
+  //send all messages that were queued in the meantime
+  while ((mitkMessage = this->m_MessageQueue->PullSendMessage()).IsNotNull())
   {
-    MITK_WARN("IGTLDevice") << "Could not send the message.";
+    if (!this->SendMessagePrivate(mitkMessage, this->m_Socket))
+    {
+      MITK_WARN("IGTLDevice") << "Could not send the message.";
+    }
   }
 }
 
@@ -19,9 +19,16 @@ found in the LICENSE file.
 
 #include <igtlTransformMessage.h>
 #include <mitkIGTLMessageCommon.h>
+#include <mitkIGTLSocket.h>
 
 #include <igtl_status.h>
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
 //remove later
 #include <igtlTrackingDataMessage.h>
 
@@ -29,6 +36,20 @@ found in the LICENSE file.
 static const int SOCKET_SEND_RECEIVE_TIMEOUT_MSEC = 100;
 typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
 
+namespace
+{
+  /** Returns the descriptor of a socket created by IGTLClient or IGTLServer,
+   *  -1 if it is closed and -2 if the socket type does not expose it. */
+  int GetSocketDescriptor(igtl::Socket* socket)
+  {
+    if (auto clientSocket = dynamic_cast<mitk::IGTLClientSocket*>(socket))
+      return clientSocket->GetSocketDescriptor();
+    if (auto serverSocket = dynamic_cast<mitk::IGTLServerSocket*>(socket))
+      return serverSocket->GetSocketDescriptor();
+    return -2;
+  }
+}
+
 mitk::IGTLDevice::IGTLDevice(bool ReadFully) :
 //  m_Data(mitk::DeviceDataUnspecified),
 m_State(mitk::IGTLDevice::Setup),
@@ -37,7 +58,7 @@ m_StopCommunication(false),
 m_Hostname("127.0.0.1"),
 m_PortNumber(-1),
 m_LogMessages(false),
-m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0), m_ConnectThreadID(0)
+m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0)
 {
   m_ReadFully = ReadFully;
   m_StopCommunicationMutex = itk::FastMutexLock::New();
@@ -45,11 +66,9 @@ m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0), m_ConnectThre
   //  m_LatestMessageMutex = itk::FastMutexLock::New();
   m_SendingFinishedMutex = itk::FastMutexLock::New();
   m_ReceivingFinishedMutex = itk::FastMutexLock::New();
-  m_ConnectingFinishedMutex = itk::FastMutexLock::New();
   // execution rights are owned by the application thread at the beginning
   m_SendingFinishedMutex->Lock();
   m_ReceivingFinishedMutex->Lock();
-  m_ConnectingFinishedMutex->Lock();
   m_MultiThreader = itk::MultiThreader::New();
   //  m_Data = mitk::DeviceDataUnspecified;
   //  m_LatestMessage = igtl::MessageBase::New();
@@ -81,10 +100,6 @@ mitk::IGTLDevice::~IGTLDevice()
     {
       m_MultiThreader->TerminateThread(m_ReceiveThreadID);
     }
-    if ((m_ConnectThreadID != 0))
-    {
-      m_MultiThreader->TerminateThread(m_ConnectThreadID);
-    }
   }
   m_MultiThreader = nullptr;
 }
@@ -259,6 +274,78 @@ unsigned int mitk::IGTLDevice::ReceivePrivate(igtl::Socket* socket)
   }
 }
 
+bool mitk::IGTLDevice::WaitForReadableSockets(const SocketVectorType& sockets,
+  SocketVectorType& readableSockets)
+{
+  readableSockets.clear();
+
+#ifdef _WIN32
+  std::vector<WSAPOLLFD> descriptors;
+#else
+  std::vector<pollfd> descriptors;
+#endif
+  SocketVectorType polledSockets;
+  descriptors.reserve(sockets.size());
+  polledSockets.reserve(sockets.size());
+
+  for (auto& socket : sockets)
+  {
+    int fd = socket.IsNotNull() ? GetSocketDescriptor(socket) : -1;
+    if (fd == -1)
+      continue;
+
+    if (fd < 0)
+    {
+      // the descriptor is unknown, the socket is served with a blocking
+      // receive as before
+      readableSockets.push_back(socket);
+      continue;
+    }
+
+    descriptors.emplace_back();
+    descriptors.back().fd = fd;
+    descriptors.back().events = POLLIN;
+    descriptors.back().revents = 0;
+    polledSockets.push_back(socket);
+  }
+
+  if (descriptors.empty())
+  {
+    if (!readableSockets.empty())
+      return true;
+
+    // nothing to wait for, e.g. a server without clients that was closed
+    itksys::SystemTools::Delay(SOCKET_SEND_RECEIVE_TIMEOUT_MSEC);
+    return false;
+  }
+
+  const int timeout = readableSockets.empty() ? SOCKET_SEND_RECEIVE_TIMEOUT_MSEC : 0;
+#ifdef _WIN32
+  int result = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), timeout);
+#else
+  int result = poll(descriptors.data(), descriptors.size(), timeout);
+#endif
+
+  if (result > 0)
+  {
+    for (std::size_t i = 0; i < descriptors.size(); ++i)
+    {
+      // a hang up or error is reported as readable, ReceivePrivate() detects
+      // the lost connection then
+      if (descriptors[i].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
+        readableSockets.push_back(polledSockets[i]);
+    }
+  }
+
+  // on timeout or interruption the caller checks the stop flag
+  return !readableSockets.empty();
+}
+
+bool mitk::IGTLDevice::WaitForSendMessage()
+{
+  return m_MessageQueue->WaitForSendMessage(SOCKET_SEND_RECEIVE_TIMEOUT_MSEC);
+}
+
 void mitk::IGTLDevice::SendMessage(mitk::IGTLMessage::Pointer msg)
 {
   m_MessageQueue->PushSendMessage(msg);
@@ -320,9 +407,6 @@ void mitk::IGTLDevice::RunCommunication(void (IGTLDevice::*ComFunction)(void), i
       this->m_StopCommunicationMutex->Lock();
       localStopCommunication = m_StopCommunication;
       this->m_StopCommunicationMutex->Unlock();
-
-      // time to relax, this sets the maximum ever possible framerate to 1000 Hz
-      itksys::SystemTools::Delay(1);
     }
   }
   catch (...)
@@ -360,15 +444,13 @@ bool mitk::IGTLDevice::StartCommunication()
   // transfer the execution rights to tracking thread
   m_SendingFinishedMutex->Unlock();
   m_ReceivingFinishedMutex->Unlock();
-  m_ConnectingFinishedMutex->Unlock();
 
-  // start new threads that execute the communication
+  // start new threads that execute the communication, the receiving thread
+  // also accepts new connections
   m_SendThreadID =
     m_MultiThreader->SpawnThread(this->ThreadStartSending, this);
   m_ReceiveThreadID =
     m_MultiThreader->SpawnThread(this->ThreadStartReceiving, this);
-  m_ConnectThreadID =
-    m_MultiThreader->SpawnThread(this->ThreadStartConnecting, this);
   //  mitk::IGTTimeStamp::GetInstance()->Start(this);
   return true;
 }
@@ -382,11 +464,13 @@ bool mitk::IGTLDevice::StopCommunication()
     m_StopCommunicationMutex->Lock();
     m_StopCommunication = true;
     m_StopCommunicationMutex->Unlock();
+    // wake up the sending thread, the receiving thread notices the stop
+    // request after at most one socket timeout
+    m_MessageQueue->InterruptWaitForSendMessage();
     // we have to wait here that the other thread recognizes the STOP-command
     // and executes it
     m_SendingFinishedMutex->Lock();
     m_ReceivingFinishedMutex->Lock();
-    m_ConnectingFinishedMutex->Lock();
     //    mitk::IGTTimeStamp::GetInstance()->Stop(this); // notify realtime clock
     // StopCommunication was called, thus the mode should be changed back
     // to Ready now that the tracking loop has ended.
@@ -534,26 +618,3 @@ ITK_THREAD_RETURN_TYPE mitk::IGTLDevice::ThreadStartReceiving(void* pInfoStruct)
   igtlDevice->m_ReceiveThreadID = 0;  // erase thread id because thread will end.
   return ITK_THREAD_RETURN_VALUE;
 }
-
-ITK_THREAD_RETURN_TYPE mitk::IGTLDevice::ThreadStartConnecting(void* pInfoStruct)
-{
-  /* extract this pointer from Thread Info structure */
-  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
-    (struct itk::MultiThreader::ThreadInfoStruct*)pInfoStruct;
-  if (pInfo == nullptr)
-  {
-    return ITK_THREAD_RETURN_VALUE;
-  }
-  if (pInfo->UserData == nullptr)
-  {
-    return ITK_THREAD_RETURN_VALUE;
-  }
-  IGTLDevice *igtlDevice = (IGTLDevice*)pInfo->UserData;
-  if (igtlDevice != nullptr)
-  {
-    igtlDevice->RunCommunication(&mitk::IGTLDevice::Connect,
-      igtlDevice->m_ConnectingFinishedMutex);
-  }
-  igtlDevice->m_ConnectThreadID = 0;  // erase thread id because thread will end.
-  return ITK_THREAD_RETURN_VALUE;
-}
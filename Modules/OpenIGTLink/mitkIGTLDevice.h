@@ -20,6 +20,8 @@ found in the LICENSE file.
 #include "itkFastMutexLock.h"
 #include "itkMultiThreader.h"
 
+#include <vector>
+
 //igtl
 #include "igtlSocket.h"
 #include "igtlMessageBase.h"
@@ -103,7 +105,10 @@ namespace mitk {
      * \brief Continuously calls the given function
      *
      * This may only be called if the device is in Running state and only from
-     * a seperate thread.
+     * a seperate thread. The given function is expected to block until there
+     * is work to do (see WaitForReadableSockets() and
+     * IGTLMessageQueue::WaitForSendMessage()) or until the socket timeout
+     * elapsed, so that the stop flag is checked regularly.
      *
      * \param ComFunction function pointer that specifies the method to be executed
      * \param mutex the mutex that corresponds to the function pointer
@@ -205,12 +210,6 @@ namespace mitk {
     */
     static ITK_THREAD_RETURN_TYPE ThreadStartReceiving(void* data);
 
-    /**
-    * \brief static start method for the connection thread.
-    * \param data a void pointer to the IGTLDevice object.
-    */
-    static ITK_THREAD_RETURN_TYPE ThreadStartConnecting(void* data);
-
     /**
      * \brief TestConnection() tries to connect to a IGTL device on the current
      * ip and port
@@ -289,19 +288,50 @@ namespace mitk {
     */
     unsigned int ReceivePrivate(igtl::Socket* device);
 
+    typedef std::vector<igtl::Socket::Pointer> SocketVectorType;
+
+    /**
+    * \brief Waits until at least one of the given sockets becomes readable
+    *
+    * Blocks in poll() until data (or a pending connection in case of a server
+    * socket) is available on one of the sockets, one of them was closed by the
+    * peer, or the socket timeout elapsed. Closed sockets are ignored. Only
+    * sockets created as IGTLClientSocket or IGTLServerSocket can be polled,
+    * other sockets are always reported as readable.
+    *
+    * The sockets are passed as smart pointers, so they stay valid while
+    * waiting even if they are removed from the device in the meantime.
+    *
+    * \param sockets the sockets to watch
+    * \param readableSockets is cleared and filled with the sockets that can
+    * be read from without blocking
+    * \return false if the timeout elapsed or poll() failed
+    */
+    bool WaitForReadableSockets(const SocketVectorType& sockets,
+      SocketVectorType& readableSockets);
+
     /**
     * \brief Call this method to send a message. The message will be read from
     * the queue.
     */
     virtual void Send() = 0;
 
+    /**
+    * \brief Blocks until there is a message in the send queue, the
+    * communication is stopped or the socket timeout elapsed
+    *
+    * \return true if the send queue should be drained
+    */
+    bool WaitForSendMessage();
+
     /**
     * \brief Call this method to check for other devices that want to connect
     * to this one.
     *
     * In case of a client this method is doing nothing. In case of a server it
     * is checking for other devices and if there is one it establishes a
-    * connection.
+    * connection. The server calls it from its receiving thread whenever the
+    * listening socket is readable.
     */
     virtual void Connect();
 
@@ -332,8 +362,6 @@ namespace mitk {
     itk::FastMutexLock::Pointer m_SendingFinishedMutex;
     /** mutex used to make sure that the receive thread is just started once */
     itk::FastMutexLock::Pointer m_ReceivingFinishedMutex;
-    /** mutex used to make sure that the connect thread is just started once */
-    itk::FastMutexLock::Pointer m_ConnectingFinishedMutex;
     /** mutex to control access to m_State */
     itk::FastMutexLock::Pointer m_StateMutex;
 
@@ -361,8 +389,6 @@ namespace mitk {
     int m_SendThreadID;
     /** ID of receiving thread */
     int m_ReceiveThreadID;
-    /** ID of connecting thread */
-    int m_ConnectThreadID;
     /** Always try to read the full message. */
     bool m_ReadFully;
   };
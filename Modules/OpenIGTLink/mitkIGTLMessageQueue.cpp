@@ -11,6 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLMessageQueue.h"
+#include <chrono>
 #include <string>
 #include "igtlMessageBase.h"
 
@@ -20,8 +21,35 @@ void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
   if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
     m_SendQueue.clear();
 
-  m_SendQueue.push_back(message);
+  //queue a shallow copy: it keeps a reference to the igtl message until it is
+  //sent, even if the producer sets a new message on its output meanwhile
+  m_SendQueue.push_back(message->Clone());
   this->m_Mutex->Unlock();
+
+  {
+    std::lock_guard<std::mutex> lock(m_SendSignalMutex);
+    m_SendSignaled = true;
+  }
+  m_SendSignalCondition.notify_all();
+}
+
+bool mitk::IGTLMessageQueue::WaitForSendMessage(unsigned int timeoutMsec)
+{
+  std::unique_lock<std::mutex> lock(m_SendSignalMutex);
+  m_SendSignalCondition.wait_for(lock, std::chrono::milliseconds(timeoutMsec),
+    [this] { return m_SendSignaled; });
+  bool signaled = m_SendSignaled;
+  m_SendSignaled = false;
+  return signaled;
+}
+
+void mitk::IGTLMessageQueue::InterruptWaitForSendMessage()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_SendSignalMutex);
+    m_SendSignaled = true;
+  }
+  m_SendSignalCondition.notify_all();
 }
 
 void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
@@ -300,6 +328,7 @@ mitk::IGTLMessageQueue::IGTLMessageQueue()
 {
   this->m_Mutex = itk::FastMutexLock::New();
   this->m_BufferingType = IGTLMessageQueue::NoBuffering;
+  this->m_SendSignaled = false;
 }
 
 mitk::IGTLMessageQueue::~IGTLMessageQueue()
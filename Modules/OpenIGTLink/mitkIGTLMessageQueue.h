@@ -19,7 +19,9 @@ found in the LICENSE file.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <mitkIGTLMessage.h>
 
 //OpenIGTLink
@@ -50,6 +52,15 @@ namespace mitk {
        */
     enum BufferingType { Infinit, NoBuffering };
 
+    /**
+    * \brief Adds a message to the send queue
+    *
+    * The queue stores a shallow copy of the given message that references the
+    * same igtl::MessageBase. The igtl message is therefore kept alive and
+    * marked as in use (see ImageToIGTLMessageFilter) until the sending thread
+    * pulled and sent it, and later changes of the given object do not affect
+    * the queued message.
+    */
     void PushSendMessage(mitk::IGTLMessage::Pointer message);
 
     /**
@@ -73,6 +84,22 @@ namespace mitk {
     igtl::TransformMessage::Pointer PullTransformMessage();
     mitk::IGTLMessage::Pointer PullSendMessage();
 
+    /**
+    * \brief Blocks until a message was pushed into the send queue, the wait
+    * was interrupted or the timeout elapsed
+    *
+    * Returns true if the caller was woken up by PushSendMessage() or
+    * InterruptWaitForSendMessage() since the last call, false on timeout. The
+    * caller is expected to drain the send queue with PullSendMessage()
+    * afterwards.
+    */
+    bool WaitForSendMessage(unsigned int timeoutMsec);
+
+    /**
+    * \brief Wakes up all threads blocked in WaitForSendMessage()
+    */
+    void InterruptWaitForSendMessage();
+
     /**
     * \brief Get the number of messages in the queue
     */
@@ -114,6 +141,13 @@ namespace mitk {
     */
     itk::FastMutexLock::Pointer m_Mutex;
 
+    /**
+    * \brief Signals the sending thread that m_SendQueue changed
+    */
+    std::mutex m_SendSignalMutex;
+    std::condition_variable m_SendSignalCondition;
+    bool m_SendSignaled;
+
     /**
     * \brief the queue that stores pointer to the inserted messages
     */
@@ -11,12 +11,13 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLServer.h"
+#include <algorithm>
 #include <cstdio>
 
 #include <itksys/SystemTools.hxx>
 #include <itkMutexLockHolder.h>
 
-#include <igtlServerSocket.h>
+#include <mitkIGTLSocket.h>
 #include <igtlTrackingDataMessage.h>
 #include <igtlImageMessage.h>
 #include <igtl_status.h>
@@ -52,10 +53,10 @@ bool mitk::IGTLServer::OpenConnection()
   }
 
   //create a new server socket
-  m_Socket = igtl::ServerSocket::New();
+  m_Socket = mitk::IGTLServerSocket::New();
 
   //try to create the igtl server
-  int response = dynamic_cast<igtl::ServerSocket*>(m_Socket.GetPointer())->
+  int response = dynamic_cast<mitk::IGTLServerSocket*>(m_Socket.GetPointer())->
     CreateServer(portNumber);
 
   //check the response
@@ -90,7 +91,7 @@ void mitk::IGTLServer::Connect()
   igtl::Socket::Pointer socket;
   //check if another igtl device wants to connect to this socket
   socket =
-    ((igtl::ServerSocket*)(this->m_Socket.GetPointer()))->WaitForConnection(1);
+    static_cast<mitk::IGTLServerSocket*>(this->m_Socket.GetPointer())->WaitForConnection(1);
   //if there is a new connection the socket is not null
   if (socket.IsNotNull())
   {
@@ -111,22 +112,46 @@ void mitk::IGTLServer::Receive()
   unsigned int status = IGTL_STATUS_OK;
   SocketListType socketsToBeRemoved;
 
-  //the server can be connected with several clients, therefore it has to check
-  //all registered clients
-  SocketListIteratorType it;
+  //wait for the listening socket and all registered clients at once, so that
+  //a single thread serves every client and is only woken up if there is data.
+  //The smart pointers keep the sockets alive while the list is unlocked.
+  SocketVectorType sockets;
   m_ReceiveListMutex->Lock();
-  auto it_end = this->m_RegisteredClients.end();
-  for (it = this->m_RegisteredClients.begin(); it != it_end; ++it)
+  igtl::Socket::Pointer listeningSocket = this->m_Socket;
+  sockets.reserve(this->m_RegisteredClients.size() + 1);
+  sockets.push_back(listeningSocket);
+  sockets.insert(sockets.end(), this->m_RegisteredClients.begin(), this->m_RegisteredClients.end());
+  m_ReceiveListMutex->Unlock();
+
+  SocketVectorType readableSockets;
+  if (!this->WaitForReadableSockets(sockets, readableSockets))
+    return;
+
+  bool connectionRequested = false;
+  m_ReceiveListMutex->Lock();
+  for (auto& socket : readableSockets)
   {
+    //a readable listening socket means that a client wants to connect
+    if (socket == listeningSocket)
+    {
+      connectionRequested = true;
+      continue;
+    }
+
+    //the client may have been removed while waiting, e.g. by CloseConnection()
+    if (std::find(this->m_RegisteredClients.begin(), this->m_RegisteredClients.end(),
+      socket) == this->m_RegisteredClients.end())
+      continue;
+
     //it is possible that ReceivePrivate detects that the current socket is
     //already disconnected. Therefore, it is necessary to remove this socket
     //from the registered clients list
-    status = this->ReceivePrivate(*it);
+    status = this->ReceivePrivate(socket);
     if (status == IGTL_STATUS_NOT_PRESENT)
     {
       //remember this socket for later, it is not a good idea to remove it
       //from the list directly because we iterate over the list at this point
-      socketsToBeRemoved.push_back(*it);
+      socketsToBeRemoved.push_back(socket);
       MITK_WARN("IGTLServer") << "Lost connection to a client socket. ";
     }
     else if (status != 1)
@@ -142,15 +167,17 @@ void mitk::IGTLServer::Receive()
     //inform observers about loosing the connection to these sockets
     this->InvokeEvent(LostConnectionEvent());
   }
+
+  if (connectionRequested)
+  {
+    this->Connect();
+  }
 }
 
 void mitk::IGTLServer::Send()
 {
-  //get the latest message from the queue
-  mitk::IGTLMessage::Pointer curMessage = this->m_MessageQueue->PullSendMessage();
-
-  // there is no message => return
-  if (curMessage.IsNull())
+  //sleep until a message is pushed into the queue
+  if (!this->WaitForSendMessage())
     return;
 
   //the server can be connected with several clients, therefore it has to check
@@ -160,17 +187,21 @@ void mitk::IGTLServer::Send()
   //the data would be send to the appropriate client and to noone else.
   //(I know it is no excuse but PLUS is doing exactly the same, they broadcast
   //everything)
-  m_SentListMutex->Lock();
-  SocketListIteratorType it;
-  auto it_end =
-    this->m_RegisteredClients.end();
-  for (it = this->m_RegisteredClients.begin(); it != it_end; ++it)
+  mitk::IGTLMessage::Pointer curMessage;
+  while ((curMessage = this->m_MessageQueue->PullSendMessage()).IsNotNull())
   {
-    //maybe there should be a check here if the current socket is still active
-    this->SendMessagePrivate(curMessage, *it);
-    MITK_DEBUG("IGTLServer") << "Sent IGTL Message";
+    m_SentListMutex->Lock();
+    SocketListIteratorType it;
+    auto it_end =
+      this->m_RegisteredClients.end();
+    for (it = this->m_RegisteredClients.begin(); it != it_end; ++it)
+    {
+      //maybe there should be a check here if the current socket is still active
+      this->SendMessagePrivate(curMessage, *it);
+      MITK_DEBUG("IGTLServer") << "Sent IGTL Message";
+    }
+    m_SentListMutex->Unlock();
   }
-  m_SentListMutex->Unlock();
 }
 
 void mitk::IGTLServer::StopCommunicationWithSocket(
@@ -0,0 +1,48 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkIGTLSocket.h"
+
+mitk::IGTLClientSocket::IGTLClientSocket()
+{
+}
+
+mitk::IGTLClientSocket::~IGTLClientSocket()
+{
+}
+
+mitk::IGTLServerSocket::IGTLServerSocket()
+{
+}
+
+mitk::IGTLServerSocket::~IGTLServerSocket()
+{
+}
+
+mitk::IGTLClientSocket::Pointer mitk::IGTLServerSocket::WaitForConnection(unsigned long msec)
+{
+  if (this->m_SocketDescriptor < 0)
+    return nullptr;
+
+  //same as igtl::ServerSocket::WaitForConnection(), but the accepted
+  //descriptor is handed to an IGTLClientSocket
+  if (this->SelectSocket(this->m_SocketDescriptor, msec) <= 0)
+    return nullptr;
+
+  int clientDescriptor = this->Accept(this->m_SocketDescriptor);
+  if (clientDescriptor == -1)
+    return nullptr;
+
+  IGTLClientSocket::Pointer clientSocket = IGTLClientSocket::New();
+  clientSocket->m_SocketDescriptor = clientDescriptor;
+  return clientSocket;
+}
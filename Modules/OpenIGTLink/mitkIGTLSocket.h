@@ -0,0 +1,89 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+
+#ifndef MITKIGTLSOCKET_H
+#define MITKIGTLSOCKET_H
+
+#include <MitkOpenIGTLinkExports.h>
+
+#include <igtlClientSocket.h>
+#include <igtlServerSocket.h>
+
+
+namespace mitk
+{
+
+  /**
+  * \brief igtl::ClientSocket that exposes its socket descriptor
+  *
+  * IGTLDevice needs the descriptor to wait for several sockets at once.
+  *
+  * \ingroup OpenIGTLink
+  */
+  class MITKOPENIGTLINK_EXPORT IGTLClientSocket : public igtl::ClientSocket
+  {
+  public:
+    typedef IGTLClientSocket Self;
+    typedef igtl::ClientSocket Superclass;
+    typedef igtl::SmartPointer<Self> Pointer;
+    typedef igtl::SmartPointer<const Self> ConstPointer;
+
+    igtlTypeMacro(mitk::IGTLClientSocket, igtl::ClientSocket);
+    igtlNewMacro(mitk::IGTLClientSocket);
+
+    /** \brief Returns the socket descriptor or -1 if the socket is closed */
+    int GetSocketDescriptor() const { return this->m_SocketDescriptor; }
+
+  protected:
+    IGTLClientSocket();
+    ~IGTLClientSocket() override;
+
+  private:
+    friend class IGTLServerSocket;
+  };
+
+  /**
+  * \brief igtl::ServerSocket that exposes its socket descriptor and accepts
+  * connections as IGTLClientSocket
+  *
+  * \ingroup OpenIGTLink
+  */
+  class MITKOPENIGTLINK_EXPORT IGTLServerSocket : public igtl::ServerSocket
+  {
+  public:
+    typedef IGTLServerSocket Self;
+    typedef igtl::ServerSocket Superclass;
+    typedef igtl::SmartPointer<Self> Pointer;
+    typedef igtl::SmartPointer<const Self> ConstPointer;
+
+    igtlTypeMacro(mitk::IGTLServerSocket, igtl::ServerSocket);
+    igtlNewMacro(mitk::IGTLServerSocket);
+
+    /** \brief Returns the socket descriptor or -1 if the socket is closed */
+    int GetSocketDescriptor() const { return this->m_SocketDescriptor; }
+
+    /**
+    * \brief Waits for a connection like igtl::ServerSocket::WaitForConnection()
+    *
+    * \param msec timeout in milliseconds, 0 waits until a client connects
+    * \return the socket of the new client or nullptr if no client connected
+    */
+    IGTLClientSocket::Pointer WaitForConnection(unsigned long msec = 0);
+
+  protected:
+    IGTLServerSocket();
+    ~IGTLServerSocket() override;
+  };
+}
+
+#endif // MITKIGTLSOCKET_H
@@ -158,6 +158,11 @@ bool configureApplicationSettings(std::map<std::string, us::Any> parsedArgs)
     inFilename = us::any_cast<std::string>(parsedArgs["input"]);
     outFileName = us::any_cast<std::string>(parsedArgs["output"]);
 
+    // the batch host runs the app several times in one process, so reset the optional settings
+    maskFileName.clear();
+    aifImageFileName.clear();
+    aifMaskFileName.clear();
+
     if (parsedArgs.count("mask"))
     {
       maskFileName = us::any_cast<std::string>(parsedArgs["mask"]);
@@ -769,7 +774,7 @@ void doPreview()
   }
 }
 
-int main(int argc, char* argv[])
+int MRPerfusionMiniAppMain(int argc, char* argv[])
 {
     mitkCommandLineParser parser;
     setupParser(parser);
@@ -789,6 +794,12 @@ int main(int argc, char* argv[])
         return EXIT_SUCCESS;
     }
 
+    // images of a previous run of the batch host
+    image = nullptr;
+    mask = nullptr;
+    aifImage = nullptr;
+    aifMask = nullptr;
+
     //! [do processing]
     try
     {
@@ -872,3 +883,10 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 }
+
+#ifndef MITK_COMMANDLINE_BATCH_HOST
+int main(int argc, char* argv[])
+{
+  return MRPerfusionMiniAppMain(argc, argv);
+}
+#endif
@@ -7,6 +7,7 @@ set(CPP_FILES
   mitkPropertyListDeserializer.cpp
   mitkPropertyListDeserializerV1.cpp
   mitkSceneIO.cpp
+  mitkSceneIOJobs.cpp
   mitkSceneReader.cpp
   mitkSceneReaderV1.cpp
   mitkSurfaceSerializer.cpp
@@ -17,6 +17,7 @@ found in the LICENSE file.
 
 #include "mitkDataStorage.h"
 #include "mitkNodePredicateBase.h"
+#include "mitkSceneReader.h"
 
 #include <Poco/Zip/ZipLocalFileHeader.h>
 
@@ -111,13 +112,52 @@ namespace mitk
      */
     const PropertyList *GetFailedProperties();
 
+    /**
+     * \brief Number of threads used to (de)serialize the data of the nodes.
+     *
+     * 0 (default) uses one thread per core, 1 restores the sequential behavior.
+     * Properties and the scene index are always handled by the calling thread.
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * \brief Stream node data into/out of the scene archive (default: on).
+     *
+     * When saving, the files of each node are added to the archive as soon as they are
+     * written and deleted right afterwards. When loading, only the index and the property
+     * files are unpacked up front; each data file is extracted just before it is read and
+     * removed afterwards. This avoids keeping an unpacked copy of the complete scene in
+     * the temporary directory. Switch off to use the old unpack-everything behavior.
+     */
+    itkSetMacro(Streaming, bool);
+    itkGetConstMacro(Streaming, bool);
+    itkBooleanMacro(Streaming);
+
   protected:
     SceneIO();
     ~SceneIO() override;
 
     std::string CreateEmptyTempDirectory();
 
+    DataStorage::Pointer LoadSceneFromIndex(const std::string &indexfilename,
+                                            DataStorage *storage,
+                                            bool clearStorageFirst,
+                                            SceneReader::DataFileProvider *dataFileProvider);
+
+    DataStorage::Pointer LoadSceneStreaming(std::istream &file, DataStorage *storage, bool clearStorageFirst);
+
     TiXmlElement *SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error);
+
+    /**
+     * \brief Serializes data into workingDirectory and returns the written filename.
+     *
+     * Does not modify the SceneIO object, so it may be called from several threads.
+     */
+    std::string SerializeBaseData(BaseData *data,
+                                  const std::string &filenamehint,
+                                  const std::string &workingDirectory,
+                                  bool &error) const;
     TiXmlElement *SavePropertyList(PropertyList *propertyList, const std::string &filenamehint);
 
     void OnUnzipError(const void *pSender, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string> &info);
@@ -128,6 +168,9 @@ namespace mitk
 
     std::string m_WorkingDirectory;
     unsigned int m_UnzipErrors;
+
+    unsigned int m_NumberOfThreads;
+    bool m_Streaming;
   };
 }
 
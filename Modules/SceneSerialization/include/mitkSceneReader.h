@@ -27,6 +27,52 @@ namespace mitk
     itkFactorylessNewMacro(Self);
     itkCloneMacro(Self);
 
-      virtual bool LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage);
+    /**
+     * \brief Source of the data files referenced by a scene.
+     *
+     * Allows SceneIO to extract a data file from the scene archive just before it is
+     * read and to delete it right afterwards, instead of unpacking the complete archive
+     * in advance. Data files are requested from the reading threads, so implementations
+     * have to be thread-safe.
+     */
+    class MITKSCENESERIALIZATION_EXPORT DataFileProvider
+    {
+    public:
+      virtual ~DataFileProvider();
+
+      /**
+       * \brief Make the file (relative to the working directory) available on disk.
+       * \return false if the file cannot be provided.
+       */
+      virtual bool Acquire(const std::string &filename) = 0;
+
+      /**
+       * \brief Called when the file was read and is not needed anymore.
+       */
+      virtual void Release(const std::string &filename) = 0;
+    };
+
+    /**
+     * \brief Number of threads used to read the data of the scene nodes.
+     *
+     * 0 (default) uses one thread per core, 1 reads all data sequentially.
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * \brief Optional provider of the data files, see DataFileProvider. Not owned by the reader.
+     */
+    void SetDataFileProvider(DataFileProvider *provider);
+    DataFileProvider *GetDataFileProvider() const;
+
+    virtual bool LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage);
+
+  protected:
+    SceneReader();
+    ~SceneReader() override;
+
+    unsigned int m_NumberOfThreads;
+    DataFileProvider *m_DataFileProvider;
   };
 }
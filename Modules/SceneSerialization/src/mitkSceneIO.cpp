@@ -11,14 +11,19 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <Poco/Delegate.h>
+#include <Poco/FileStream.h>
 #include <Poco/Path.h>
+#include <Poco/StreamCopier.h>
 #include <Poco/TemporaryFile.h>
 #include <Poco/Zip/Compress.h>
 #include <Poco/Zip/Decompress.h>
+#include <Poco/Zip/ZipArchive.h>
+#include <Poco/Zip/ZipStream.h>
 
 #include "mitkBaseDataSerializer.h"
 #include "mitkPropertyListSerializer.h"
 #include "mitkSceneIO.h"
+#include "mitkSceneIOJobs.h"
 #include "mitkSceneReader.h"
 
 #include "mitkBaseRenderer.h"
@@ -34,11 +39,102 @@ found in the LICENSE file.
 
 #include <fstream>
 #include <mitkIOUtil.h>
+#include <mutex>
+#include <set>
 #include <sstream>
 
 #include "itksys/SystemTools.hxx"
 
-mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0)
+namespace
+{
+  /**
+    \brief Extracts single entries of a scene archive on request.
+
+    All access to the archive stream is serialized, so the provider can be used by the
+    reading threads of SceneReader.
+  */
+  class ZipArchiveDataFileProvider : public mitk::SceneReader::DataFileProvider
+  {
+  public:
+    ZipArchiveDataFileProvider(std::istream &archiveStream, const std::string &targetDirectory)
+      : m_ArchiveStream(archiveStream), m_Archive(archiveStream), m_TargetDirectory(targetDirectory), m_Errors(0)
+    {
+    }
+
+    bool Extract(const std::string &filename)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+
+      auto header = m_Archive.findHeader(filename);
+      if (header == m_Archive.headerEnd() || !header->second.isFile())
+        return false;
+
+      try
+      {
+        Poco::Path target = this->GetTargetPath(filename);
+        Poco::File(target.parent()).createDirectories();
+
+        m_ArchiveStream.clear();
+        Poco::Zip::ZipInputStream in(m_ArchiveStream, header->second);
+        Poco::FileOutputStream out(target.toString());
+        Poco::StreamCopier::copyStream(in, out);
+        out.close();
+        return true;
+      }
+      catch (std::exception &e)
+      {
+        ++m_Errors;
+        MITK_ERROR << "Error while unzipping: " << filename << ": " << e.what();
+      }
+      return false;
+    }
+
+    void ExtractAllExcept(const std::set<std::string> &skippedFiles)
+    {
+      std::vector<std::string> filenames;
+      for (auto header = m_Archive.headerBegin(); header != m_Archive.headerEnd(); ++header)
+      {
+        if (header->second.isFile() && skippedFiles.count(header->first) == 0)
+          filenames.push_back(header->first);
+      }
+
+      for (const auto &filename : filenames)
+        this->Extract(filename);
+    }
+
+    bool Acquire(const std::string &filename) override { return this->Extract(filename); }
+
+    void Release(const std::string &filename) override
+    {
+      try
+      {
+        Poco::File(this->GetTargetPath(filename)).remove();
+      }
+      catch (...)
+      {
+        // the temporary directory is removed as a whole later on
+      }
+    }
+
+    unsigned int GetNumberOfErrors() const { return m_Errors; }
+
+  private:
+    Poco::Path GetTargetPath(const std::string &filename) const
+    {
+      Poco::Path target(m_TargetDirectory);
+      target.makeDirectory();
+      return Poco::Path(target, Poco::Path(filename, Poco::Path::PATH_UNIX));
+    }
+
+    std::istream &m_ArchiveStream;
+    Poco::Zip::ZipArchive m_Archive;
+    std::string m_TargetDirectory;
+    unsigned int m_Errors;
+    std::mutex m_Mutex;
+  };
+}
+
+mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0), m_NumberOfThreads(0), m_Streaming(true)
 {
 }
 
@@ -117,30 +213,41 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
     return storage;
   }
 
-  // unzip all filenames contents to temp dir
   m_UnzipErrors = 0;
-  Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
-  unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
-  unzipper.decompressAllFiles();
-  unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
-
-  if (m_UnzipErrors)
+  if (m_Streaming)
   {
-    MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename
-               << "'. Will attempt to read whatever could be unzipped.";
+    storage = LoadSceneStreaming(file, storage, clearStorageFirst);
   }
+  else
+  {
+    // unzip all filenames contents to temp dir
+    Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
+    unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+    unzipper.decompressAllFiles();
+    unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+
+    if (m_UnzipErrors)
+    {
+      MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename
+                 << "'. Will attempt to read whatever could be unzipped.";
+    }
 
-  // transcode locale-dependent string
-  m_WorkingDirectory = Poco::Path::transcode (m_WorkingDirectory);
+    // transcode locale-dependent string
+    auto indexFile = Poco::Path::transcode(m_WorkingDirectory) + mitk::IOUtil::GetDirectorySeparator() + "index.xml";
+    storage = LoadSceneUnzipped(indexFile, storage, clearStorageFirst);
+  }
 
-  auto indexFile = m_WorkingDirectory + mitk::IOUtil::GetDirectorySeparator() + "index.xml";
-  storage = LoadSceneUnzipped(indexFile, storage, clearStorageFirst);
+  if (m_Streaming && m_UnzipErrors)
+  {
+    MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename
+               << "'. Whatever could be unzipped was read.";
+  }
 
   // delete temp directory
   try
@@ -157,9 +264,60 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
   return storage;
 }
 
+mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneStreaming(std::istream &file,
+                                                             DataStorage *storage,
+                                                             bool clearStorageFirst)
+{
+  // transcode locale-dependent string
+  auto indexFile = Poco::Path::transcode(m_WorkingDirectory) + mitk::IOUtil::GetDirectorySeparator() + "index.xml";
+
+  try
+  {
+    ZipArchiveDataFileProvider provider(file, m_WorkingDirectory);
+
+    // the data files are extracted on demand by the scene reader, everything else
+    // (index, property lists, companion files of data files) is unpacked right away
+    std::set<std::string> dataFiles;
+    if (provider.Extract("index.xml"))
+    {
+      TiXmlDocument document(indexFile);
+      if (document.LoadFile())
+      {
+        for (TiXmlElement *element = document.FirstChildElement("node"); element != nullptr;
+             element = element->NextSiblingElement("node"))
+        {
+          TiXmlElement *dataElement = element->FirstChildElement("data");
+          const char *dataFile = dataElement != nullptr ? dataElement->Attribute("file") : nullptr;
+          if (dataFile != nullptr && dataFile[0] != '\0')
+            dataFiles.insert(dataFile);
+        }
+      }
+    }
+    provider.ExtractAllExcept(dataFiles);
+
+    storage = LoadSceneFromIndex(indexFile, storage, clearStorageFirst, &provider);
+    m_UnzipErrors += provider.GetNumberOfErrors();
+  }
+  catch (std::exception &e)
+  {
+    ++m_UnzipErrors;
+    MITK_ERROR << "Could not read scene archive: " << e.what();
+  }
+
+  return storage;
+}
+
 mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneUnzipped(const std::string &indexfilename,
   DataStorage *pStorage,
   bool clearStorageFirst)
+{
+  return LoadSceneFromIndex(indexfilename, pStorage, clearStorageFirst, nullptr);
+}
+
+mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneFromIndex(const std::string &indexfilename,
+                                                             DataStorage *pStorage,
+                                                             bool clearStorageFirst,
+                                                             SceneReader::DataFileProvider *dataFileProvider)
 {
   mitk::LocaleSwitch localeSwitch("C");
 
@@ -205,6 +363,8 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneUnzipped(const std::string &i
   }
 
   SceneReader::Pointer reader = SceneReader::New();
+  reader->SetNumberOfThreads(m_NumberOfThreads);
+  reader->SetDataFileProvider(dataFileProvider);
   if (!reader->LoadScene(document, workingDir, storage))
   {
     MITK_ERROR << "There were errors while loading scene file " << indexfilename << ". Your data may be corrupted";
@@ -257,6 +417,19 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
     version->SetAttribute("FileVersion", 1);
     document.LinkEndChild(version);
 
+    // data of the nodes, serialized once the structure of the index is complete
+    struct DataJob
+    {
+      DataNode *node;
+      BaseData *data;
+      std::string filenameHint;
+      TiXmlElement *element;
+      std::string directory;
+      std::string file;
+      bool error;
+    };
+    std::vector<DataJob> dataJobs;
+
     // DataStorage::SetOfObjects::ConstPointer sceneNodes = storage->GetSubset( predicate );
 
     if (sceneNodes.IsNull())
@@ -355,16 +528,19 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
             }
           }
 
-          // store basedata
+          // store basedata (the data itself is serialized below, possibly concurrently)
           if (BaseData *data = node->GetData())
           {
-            // std::string filenameHint( node->GetName() );
-            bool error(false);
-            TiXmlElement *dataElement(SaveBaseData(data, filenameHint, error)); // returns a reference to a file
-            if (error)
-            {
-              m_FailedNodes->push_back(node);
-            }
+            auto *dataElement = new TiXmlElement("data");
+            dataElement->SetAttribute("type", data->GetNameOfClass());
+
+            DataJob job;
+            job.node = node;
+            job.data = data;
+            job.filenameHint = filenameHint;
+            job.element = dataElement;
+            job.error = true;
+            dataJobs.push_back(job);
 
             // store basedata properties
             PropertyList *propertyList = data->GetPropertyList();
@@ -407,69 +583,142 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
           MITK_WARN << "Ignoring nullptr node during scene serialization.";
         }
 
-        ProgressBar::GetInstance()->Progress();
+        // nodes with data report their progress once the data is written
+        if (!node || !node->GetData())
+        {
+          ProgressBar::GetInstance()->Progress();
+        }
       } // end for all nodes
     }   // end if sceneNodes
 
     std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
 
-    if (!document.SaveFile(defaultLocale_WorkingDirectory + Poco::Path::separator() + "index.xml"))
+    Poco::File deleteFile(filename.c_str());
+    if (deleteFile.exists())
     {
-      MITK_ERROR << "Could not write scene to " << defaultLocale_WorkingDirectory << Poco::Path::separator() << "index.xml"
-                 << "\nTinyXML reports '" << document.ErrorDesc() << "'";
+      deleteFile.remove();
+    }
+
+    // create zip at filename
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::out);
+    if (!file.good())
+    {
+      MITK_ERROR << "Could not open a zip file for writing: '" << filename << "'";
       return false;
     }
-    else
+
+    Poco::Zip::Compress zipper(file, true);
+
+    // In streaming mode every node's data goes to a directory of its own, which is
+    // moved into the archive as soon as the node is done. Otherwise all data is
+    // written to the working directory and archived together with the index.
+    for (std::size_t i = 0; i < dataJobs.size(); ++i)
     {
-      try
+      if (m_Streaming)
       {
-        Poco::File deleteFile(filename.c_str());
-        if (deleteFile.exists())
-        {
-          deleteFile.remove();
-        }
-
-        // create zip at filename
-        std::ofstream file(filename.c_str(), std::ios::binary | std::ios::out);
-        if (!file.good())
-        {
-          MITK_ERROR << "Could not open a zip file for writing: '" << filename << "'";
-          return false;
-        }
-        else
-        {
-          Poco::Zip::Compress zipper(file, true);
-          Poco::Path tmpdir(m_WorkingDirectory);
-          zipper.addRecursive(tmpdir);
-          zipper.close();
-        }
-        try
-        {
-          Poco::File deleteDir(m_WorkingDirectory);
-          deleteDir.remove(true); // recursive
-        }
-        catch (...)
-        {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
-          return false; // ok?
-        }
+        dataJobs[i].directory = m_WorkingDirectory + Poco::Path::separator() + "data" + std::to_string(i);
+        Poco::File(dataJobs[i].directory).createDirectory();
       }
-      catch (std::exception &e)
+      else
       {
-        MITK_ERROR << "Could not create ZIP file from " << m_WorkingDirectory << "\nReason: " << e.what();
-        return false;
+        dataJobs[i].directory = m_WorkingDirectory;
       }
-      return true;
     }
+
+    const auto numberOfJobs = static_cast<unsigned int>(dataJobs.size());
+    const auto numberOfThreads = GetSceneIONumberOfThreads(m_NumberOfThreads, numberOfJobs);
+
+    RunSceneIOJobs(numberOfJobs,
+                   numberOfThreads,
+                   m_Streaming ? 2 * numberOfThreads : numberOfJobs,
+                   [&](unsigned int i) {
+                     DataJob &job = dataJobs[i];
+                     job.file = SerializeBaseData(
+                       job.data, job.filenameHint, Poco::Path::transcode(job.directory), job.error);
+                   },
+                   [&](unsigned int i) {
+                     DataJob &job = dataJobs[i];
+                     if (job.error)
+                     {
+                       m_FailedNodes->push_back(job.node);
+                     }
+                     else
+                     {
+                       job.element->SetAttribute("file", job.file);
+                     }
+
+                     if (m_Streaming)
+                     {
+                       zipper.addRecursive(Poco::Path(job.directory));
+                       Poco::File(job.directory).remove(true);
+                     }
+
+                     ProgressBar::GetInstance()->Progress();
+                   });
+
+    if (!document.SaveFile(defaultLocale_WorkingDirectory + Poco::Path::separator() + "index.xml"))
+    {
+      MITK_ERROR << "Could not write scene to " << defaultLocale_WorkingDirectory << Poco::Path::separator() << "index.xml"
+                 << "\nTinyXML reports '" << document.ErrorDesc() << "'";
+      zipper.close();
+      file.close();
+      deleteFile.remove();
+      return false;
+    }
+
+    try
+    {
+      // in streaming mode only the index and the property lists are left
+      Poco::Path tmpdir(m_WorkingDirectory);
+      zipper.addRecursive(tmpdir);
+      zipper.close();
+    }
+    catch (std::exception &e)
+    {
+      MITK_ERROR << "Could not create ZIP file from " << m_WorkingDirectory << "\nReason: " << e.what();
+      return false;
+    }
+
+    try
+    {
+      Poco::File deleteDir(m_WorkingDirectory);
+      deleteDir.remove(true); // recursive
+    }
+    catch (...)
+    {
+      MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+      return false; // ok?
+    }
+    return true;
   }
   catch (std::exception &e)
   {
-    MITK_ERROR << "Caught exception during saving temporary files to disk. Error description: '" << e.what() << "'";
+    MITK_ERROR << "Caught exception during saving scene to disk. Error description: '" << e.what() << "'";
     return false;
   }
 }
 
 TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error)
+{
+  assert(data);
+
+  auto *element = new TiXmlElement("data");
+  element->SetAttribute("type", data->GetNameOfClass());
+
+  std::string writtenfilename =
+    SerializeBaseData(data, filenamehint, Poco::Path::transcode(m_WorkingDirectory), error);
+  if (!error)
+  {
+    element->SetAttribute("file", writtenfilename);
+  }
+
+  return element;
+}
+
+std::string mitk::SceneIO::SerializeBaseData(BaseData *data,
+                                             const std::string &filenamehint,
+                                             const std::string &workingDirectory,
+                                             bool &error) const
 {
   assert(data);
   error = true;
@@ -479,8 +728,6 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
   //  - create a file containing all information to recreate the BaseData object --> needs to know where to put this
   //  file (and a filename?)
   //  - TODO what to do about writers that creates one file per timestep?
-  auto *element = new TiXmlElement("data");
-  element->SetAttribute("type", data->GetNameOfClass());
 
   // construct name of serializer class
   std::string serializername(data->GetNameOfClass());
@@ -493,6 +740,7 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
     MITK_ERROR << "No serializer found for " << data->GetNameOfClass() << ". Skipping object";
   }
 
+  std::string writtenfilename;
   for (auto iter = thingsThatCanSerializeThis.begin();
        iter != thingsThatCanSerializeThis.end();
        ++iter)
@@ -501,23 +749,25 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
     {
       serializer->SetData(data);
       serializer->SetFilenameHint(filenamehint);
-      std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
-      serializer->SetWorkingDirectory(defaultLocale_WorkingDirectory);
+      serializer->SetWorkingDirectory(workingDirectory);
       try
       {
-        std::string writtenfilename = serializer->Serialize();
-        element->SetAttribute("file", writtenfilename);
+        writtenfilename = serializer->Serialize();
         error = false;
       }
       catch (std::exception &e)
       {
         MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed: " << e.what();
       }
+      catch (...)
+      {
+        MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed with an unknown exception";
+      }
       break;
     }
   }
 
-  return element;
+  return writtenfilename;
 }
 
 TiXmlElement *mitk::SceneIO::SavePropertyList(PropertyList *propertyList, const std::string &filenamehint)
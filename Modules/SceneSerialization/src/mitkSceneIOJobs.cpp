@@ -0,0 +1,123 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSceneIOJobs.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void mitk::RunSceneIOJobs(unsigned int count,
+                          unsigned int numberOfThreads,
+                          unsigned int maxPending,
+                          const std::function<void(unsigned int)> &job,
+                          const std::function<void(unsigned int)> &finished)
+{
+  if (numberOfThreads <= 1 || count <= 1)
+  {
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      job(i);
+      finished(i);
+    }
+    return;
+  }
+
+  maxPending = std::max(maxPending, 1u);
+
+  std::mutex mutex;
+  std::condition_variable jobFinished;
+  std::condition_variable slotAvailable;
+  std::deque<unsigned int> done;
+  unsigned int next = 0;
+  unsigned int consumed = 0;
+  bool cancelled = false;
+
+  auto worker = [&]() {
+    for (;;)
+    {
+      unsigned int i;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotAvailable.wait(lock, [&]() { return cancelled || next >= count || next < consumed + maxPending; });
+        if (cancelled || next >= count)
+          return;
+        i = next++;
+      }
+
+      job(i);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.push_back(i);
+      }
+      jobFinished.notify_one();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < std::min(numberOfThreads, count); ++t)
+  {
+    threads.emplace_back(worker);
+  }
+
+  std::exception_ptr exception;
+  for (unsigned int handled = 0; handled < count; ++handled)
+  {
+    unsigned int i;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobFinished.wait(lock, [&]() { return !done.empty(); });
+      i = done.front();
+      done.pop_front();
+    }
+
+    try
+    {
+      finished(i);
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++consumed;
+      cancelled = exception != nullptr;
+    }
+    slotAvailable.notify_all();
+
+    if (exception)
+      break;
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+unsigned int mitk::GetSceneIONumberOfThreads(unsigned int configured, unsigned int count)
+{
+  unsigned int numberOfThreads = configured != 0 ? configured : std::thread::hardware_concurrency();
+  return std::max(1u, std::min(numberOfThreads, count));
+}
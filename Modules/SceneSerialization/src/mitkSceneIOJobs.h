@@ -0,0 +1,46 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkSceneIOJobs_h
+#define mitkSceneIOJobs_h
+
+#include <functional>
+
+namespace mitk
+{
+  /**
+    \brief Runs job(i) for all i in [0, count) on a number of worker threads.
+
+    finished(i) is called on the calling thread for every completed job, in order of
+    completion. This is where results are consumed and where GUI bound things like the
+    ProgressBar may be updated. At most maxPending jobs are started ahead of their
+    finished() call, which bounds the amount of intermediate results (e.g. temporary
+    files) that exist at the same time.
+
+    job must not throw. If finished throws, no further jobs are started; running jobs
+    are waited for and the exception is rethrown.
+
+    With numberOfThreads <= 1 all jobs run sequentially on the calling thread.
+  */
+  void RunSceneIOJobs(unsigned int count,
+                      unsigned int numberOfThreads,
+                      unsigned int maxPending,
+                      const std::function<void(unsigned int)> &job,
+                      const std::function<void(unsigned int)> &finished);
+
+  /**
+    \brief Resolves a configured number of threads (0 = one per core) for count jobs.
+  */
+  unsigned int GetSceneIONumberOfThreads(unsigned int configured, unsigned int count);
+}
+
+#endif
@@ -12,6 +12,28 @@ found in the LICENSE file.
 
 #include "mitkSceneReader.h"
 
+mitk::SceneReader::DataFileProvider::~DataFileProvider()
+{
+}
+
+mitk::SceneReader::SceneReader() : m_NumberOfThreads(0), m_DataFileProvider(nullptr)
+{
+}
+
+mitk::SceneReader::~SceneReader()
+{
+}
+
+void mitk::SceneReader::SetDataFileProvider(DataFileProvider *provider)
+{
+  m_DataFileProvider = provider;
+}
+
+mitk::SceneReader::DataFileProvider *mitk::SceneReader::GetDataFileProvider() const
+{
+  return m_DataFileProvider;
+}
+
 bool mitk::SceneReader::LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage)
 {
   // find version node --> note version in some variable
@@ -45,6 +67,8 @@ bool mitk::SceneReader::LoadScene(TiXmlDocument &document, const std::string &wo
   {
     if (auto *reader = dynamic_cast<SceneReader *>(iter->GetPointer()))
     {
+      reader->SetNumberOfThreads(m_NumberOfThreads);
+      reader->SetDataFileProvider(m_DataFileProvider);
       if (!reader->LoadScene(document, workingDirectory, storage))
       {
         MITK_ERROR << "There were errors while loading scene file "
@@ -11,6 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkSceneReaderV1.h"
+#include "mitkSceneIOJobs.h"
 #include "Poco/Path.h"
 #include "mitkBaseRenderer.h"
 #include "mitkIOUtil.h"
@@ -75,11 +76,38 @@ bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &
 
   ProgressBar::GetInstance()->AddStepsToDo(listSize * 2);
 
+  std::vector<TiXmlElement *> dataElements;
+  dataElements.reserve(listSize);
   for (TiXmlElement *element = document.FirstChildElement("node"); element != nullptr;
        element = element->NextSiblingElement("node"))
   {
-    DataNodes.push_back(LoadBaseDataFromDataTag(element->FirstChildElement("data"), workingDirectory, error));
-    ProgressBar::GetInstance()->Progress();
+    dataElements.push_back(element->FirstChildElement("data"));
+  }
+
+  // read the data of all nodes concurrently; the progress bar is only touched from this thread
+  std::vector<BaseData::Pointer> baseData(listSize);
+  std::vector<std::string> errorMessages(listSize);
+
+  RunSceneIOJobs(
+    listSize,
+    GetSceneIONumberOfThreads(m_NumberOfThreads, listSize),
+    listSize,
+    [&](unsigned int i) { baseData[i] = ReadBaseDataFromDataTag(dataElements[i], workingDirectory, errorMessages[i]); },
+    [](unsigned int) { ProgressBar::GetInstance()->Progress(); });
+
+  for (unsigned int i = 0; i < listSize; ++i)
+  {
+    DataNode::Pointer node = DataNode::New();
+    if (!errorMessages[i].empty())
+    {
+      MITK_ERROR << errorMessages[i];
+      error = true;
+    }
+    else if (baseData[i].IsNotNull())
+    {
+      node->SetData(baseData[i]);
+    }
+    DataNodes.push_back(node);
   }
 
   // iterate all nodes
@@ -237,17 +265,23 @@ bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &
   return !error;
 }
 
-mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElement *dataElement,
-                                                                     const std::string &workingDirectory,
-                                                                     bool &error)
+mitk::BaseData::Pointer mitk::SceneReaderV1::ReadBaseDataFromDataTag(TiXmlElement *dataElement,
+                                                                      const std::string &workingDirectory,
+                                                                      std::string &errorMessage) const
 {
-  DataNode::Pointer node;
+  BaseData::Pointer data;
 
   if (dataElement)
   {
     const char *filename = dataElement->Attribute("file");
     if (filename && strlen(filename) != 0)
     {
+      if (m_DataFileProvider && !m_DataFileProvider->Acquire(filename))
+      {
+        errorMessage = std::string("Error during attempt to read '") + filename + "'. File is not part of the scene.";
+        return data;
+      }
+
       try
       {
         std::vector<BaseData::Pointer> baseData = IOUtil::Load(workingDirectory + Poco::Path::separator() + filename);
@@ -255,29 +289,51 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElemen
         {
           MITK_WARN << "Discarding multiple base data results from " << filename << " except the first one.";
         }
-        node = DataNode::New();
-        node->SetData(baseData.front());
+        data = baseData.front();
       }
       catch (std::exception &e)
       {
-        MITK_ERROR << "Error during attempt to read '" << filename << "'. Exception says: " << e.what();
-        error = true;
+        errorMessage = std::string("Error during attempt to read '") + filename + "'. Exception says: " + e.what();
+      }
+      catch (...)
+      {
+        errorMessage = std::string("Error during attempt to read '") + filename + "'. Unknown exception.";
       }
 
-      if (node.IsNull())
+      if (m_DataFileProvider)
       {
-        MITK_ERROR << "Error during attempt to read '" << filename << "'. Factory returned nullptr object.";
-        error = true;
+        m_DataFileProvider->Release(filename);
+      }
+
+      if (data.IsNull() && errorMessage.empty())
+      {
+        errorMessage = std::string("Error during attempt to read '") + filename + "'. Factory returned nullptr object.";
       }
     }
   }
 
-  // in case there was no <data> element we create a new empty node (for appending a propertylist later)
-  if (node.IsNull())
+  return data;
+}
+
+mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElement *dataElement,
+                                                                     const std::string &workingDirectory,
+                                                                     bool &error)
+{
+  DataNode::Pointer node = DataNode::New();
+
+  std::string errorMessage;
+  BaseData::Pointer data = ReadBaseDataFromDataTag(dataElement, workingDirectory, errorMessage);
+  if (!errorMessage.empty())
+  {
+    MITK_ERROR << errorMessage;
+    error = true;
+  }
+  else if (data.IsNotNull())
   {
-    node = DataNode::New();
+    node->SetData(data);
   }
 
+  // in case there was no <data> element we keep an empty node (for appending a propertylist later)
   return node;
 }
 
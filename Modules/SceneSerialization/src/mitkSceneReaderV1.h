@@ -26,6 +26,16 @@ namespace mitk
                              DataStorage *storage) override;
 
   protected:
+    /**
+      \brief reads the BaseData referenced by a given XML <data> element
+
+      Does not modify the reader, so it can be called from several threads at once.
+      Problems are reported via errorMessage instead of the error flag.
+    */
+    BaseData::Pointer ReadBaseDataFromDataTag(TiXmlElement *dataElement,
+                                              const std::string &workingDirectory,
+                                              std::string &errorMessage) const;
+
     /**
       \brief tries to create one DataNode from a given XML <node> element
     */
@@ -78,13 +78,28 @@ class mitkSceneIOTest2Suite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkSceneIOTest2Suite);
   MITK_TEST(Test_SceneIOInterfaces);
   MITK_TEST(Test_ReconstructionOfScenes);
+  MITK_TEST(Test_ReconstructionOfScenesSequential);
+  MITK_TEST(Test_ReconstructionOfScenesMixedModes);
   CPPUNIT_TEST_SUITE_END();
 
   mitk::SceneIOTestScenarioProvider m_TestCaseProvider;
 
 public:
   void Test_SceneIOInterfaces() { CPPUNIT_ASSERT_MESSAGE("Not urgent", true); }
-  void Test_ReconstructionOfScenes()
+  void Test_ReconstructionOfScenes() { this->ReconstructScenes(0, true, true); }
+
+  /// the old, sequential and unpack-everything code path
+  void Test_ReconstructionOfScenesSequential() { this->ReconstructScenes(1, false, false); }
+
+  /// streamed archives must be readable the old way and vice versa
+  void Test_ReconstructionOfScenesMixedModes()
+  {
+    this->ReconstructScenes(4, true, false);
+    this->ReconstructScenes(4, false, true);
+  }
+
+private:
+  void ReconstructScenes(unsigned int numberOfThreads, bool streamedWriting, bool streamedReading)
   {
     std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOTest_XXXXXX");
 
@@ -96,6 +111,8 @@ public:
 
       std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
       mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+      writer->SetNumberOfThreads(numberOfThreads);
+      writer->SetStreaming(streamedWriting);
       mitk::DataStorage::Pointer originalStorage = scenario.BuildDataStorage();
       CPPUNIT_ASSERT_MESSAGE(
         std::string("Save test scenario '") + scenario.key + "' to '" + archiveFilename + "'",
@@ -104,6 +121,8 @@ public:
       if (scenario.serializable)
       {
         mitk::SceneIO::Pointer reader = mitk::SceneIO::New();
+        reader->SetNumberOfThreads(numberOfThreads);
+        reader->SetStreaming(streamedReading);
         mitk::DataStorage::Pointer restoredStorage;
         CPPUNIT_ASSERT_NO_THROW(restoredStorage = reader->LoadScene(archiveFilename));
         CPPUNIT_ASSERT_MESSAGE(
@@ -14,6 +14,8 @@ found in the LICENSE file.
 #include "mitkStandardFileLocations.h"
 #include <itksys/SystemTools.hxx>
 
+#include <atomic>
+
 mitk::BaseDataSerializer::BaseDataSerializer() : m_FilenameHint("unnamed"), m_WorkingDirectory("")
 {
 }
@@ -32,8 +34,8 @@ std::string mitk::BaseDataSerializer::Serialize()
 
 std::string mitk::BaseDataSerializer::GetUniqueFilenameInWorkingDirectory()
 {
-  // tmpname
-  static unsigned long count = 0;
+  // tmpname; atomic because SceneIO serializes several objects concurrently
+  static std::atomic<unsigned long> count(0);
   unsigned long n = count++;
   std::ostringstream name;
   for (int i = 0; i < 6; ++i)
@@ -62,9 +62,15 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     extractor->Modified();
     extractor->Update();
 
-    // make sure the modification is rendered
+    // make sure the modification is rendered, only the voxels of the slice were written
     RenderingManager::GetInstance()->RequestUpdateAll();
-    imageOperation->GetImage()->Modified();
+    mitk::Image *image = imageOperation->GetImage();
+    const auto *modifiedPlane = dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry());
+    const auto modifiedRegion = image->GetRegionOfPlane(modifiedPlane, imageOperation->GetTimeStep());
+    if (modifiedPlane != nullptr && modifiedRegion.GetNumberOfPixels() > 0)
+      image->ModifiedRegion(imageOperation->GetTimeStep(), modifiedRegion);
+    else
+      image->Modified();
 
     mitk::ExtractSliceFilter::Pointer extractor2 = mitk::ExtractSliceFilter::New();
     extractor2->SetInput(imageOperation->GetImage());
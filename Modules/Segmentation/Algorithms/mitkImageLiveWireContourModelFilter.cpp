@@ -27,6 +27,7 @@ mitk::ImageLiveWireContourModelFilter::ImageLiveWireContourModelFilter()
   m_CostFunction = CostFunctionType::New();
   m_ShortestPathFilter = ShortestPathImageFilterType::New();
   m_ShortestPathFilter->SetCostFunction(m_CostFunction);
+  m_ShortestPathFilter->SetKeepShortestPathTree(true);
   m_UseDynamicCostMap = false;
   m_TimeStep = 0;
 }
@@ -126,16 +127,29 @@ void mitk::ImageLiveWireContourModelFilter::ItkPreProcessImage(const itk::Image<
   m_InternalImage = castFilter->GetOutput();
   m_CostFunction->SetImage(m_InternalImage);
   m_ShortestPathFilter->SetInput(m_InternalImage);
+  m_ShortestPathFilter->ResetShortestPathTree();
+}
+
+void mitk::ImageLiveWireContourModelFilter::SetUseDynamicCostMap(bool useDynamicCostMap)
+{
+  if (m_UseDynamicCostMap != useDynamicCostMap)
+  {
+    m_UseDynamicCostMap = useDynamicCostMap;
+    m_ShortestPathFilter->ResetShortestPathTree();
+    this->Modified();
+  }
 }
 
 void mitk::ImageLiveWireContourModelFilter::ClearRepulsivePoints()
 {
   m_CostFunction->ClearRepulsivePoints();
+  m_ShortestPathFilter->ResetShortestPathTree();
 }
 
 void mitk::ImageLiveWireContourModelFilter::AddRepulsivePoint(const itk::Index<2> &idx)
 {
   m_CostFunction->AddRepulsivePoint(idx);
+  m_ShortestPathFilter->ResetShortestPathTree();
 }
 
 void mitk::ImageLiveWireContourModelFilter::DumpMaskImage()
@@ -149,6 +163,7 @@ void mitk::ImageLiveWireContourModelFilter::DumpMaskImage()
 void mitk::ImageLiveWireContourModelFilter::RemoveRepulsivePoint(const itk::Index<2> &idx)
 {
   m_CostFunction->RemoveRepulsivePoint(idx);
+  m_ShortestPathFilter->ResetShortestPathTree();
 }
 
 void mitk::ImageLiveWireContourModelFilter::SetRepulsivePoints(const ShortestPathType &points)
@@ -160,6 +175,7 @@ void mitk::ImageLiveWireContourModelFilter::SetRepulsivePoints(const ShortestPat
   {
     m_CostFunction->AddRepulsivePoint((*iter));
   }
+  m_ShortestPathFilter->ResetShortestPathTree();
 }
 
 void mitk::ImageLiveWireContourModelFilter::UpdateLiveWire()
@@ -433,4 +449,5 @@ void mitk::ImageLiveWireContourModelFilter::CreateDynamicCostMapByITK(
 
   this->m_CostFunction->SetDynamicCostMap(histogram);
   this->m_CostFunction->SetCostMapMaximum(max);
+  this->m_ShortestPathFilter->ResetShortestPathTree();
 }
@@ -43,6 +43,10 @@ namespace mitk
    contour
    at a specific timestep.
 
+    The shortest path filter keeps the tree of shortest paths from the current start point. Moving only the end point
+   (as done while following the mouse cursor) therefore just grows that tree as far as needed and traces the path back,
+   instead of searching from scratch. Changing the costs (repulsive points, dynamic cost map) discards the tree.
+
    \ingroup ContourModelFilters
    \ingroup Process
   */
@@ -74,7 +78,7 @@ namespace mitk
     \Note On the fly training will be used for next update only.
     The computation uses the last calculated segment to map cost according to features in the area of the segment.
     */
-    itkSetMacro(UseDynamicCostMap, bool);
+    virtual void SetUseDynamicCostMap(bool useDynamicCostMap);
     itkGetMacro(UseDynamicCostMap, bool);
 
     /** \brief Actual time step
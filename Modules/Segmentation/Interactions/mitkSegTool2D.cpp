@@ -400,8 +400,13 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->Modified();
   extractor->Update();
 
-  // the image was modified within the pipeline, but not marked so
-  image->Modified();
+  // the image was modified within the pipeline, but not marked so.
+  // Only the voxels of the slice were written, so consumers may update just this region.
+  const auto modifiedRegion = image->GetRegionOfPlane(sliceInfo.plane, sliceInfo.timestep);
+  if (modifiedRegion.GetNumberOfPixels() > 0)
+    image->ModifiedRegion(sliceInfo.timestep, modifiedRegion);
+  else
+    image->Modified();
   image->GetVtkImageData()->Modified();
 
   /*============= BEGIN undo/redo feature block ========================*/
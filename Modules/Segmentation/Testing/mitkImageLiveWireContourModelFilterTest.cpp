@@ -0,0 +1,156 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkImageLiveWireContourModelFilter.h>
+#include <mitkTestFixture.h>
+
+#include <mitkITKImageImport.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+class mitkImageLiveWireContourModelFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterTestSuite);
+  MITK_TEST(testPathEndsAtStartAndEndPoint);
+  MITK_TEST(testMovingEndPointMatchesFreshSearch);
+  MITK_TEST(testRepulsivePointsInvalidateTree);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+
+  mitk::Point3D IndexToWorld(double x, double y)
+  {
+    mitk::Point3D index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = 0.0;
+    mitk::Point3D world;
+    m_Image->GetGeometry()->IndexToWorld(index, world);
+    return world;
+  }
+
+  std::vector<mitk::Point3D> ComputePath(mitk::ImageLiveWireContourModelFilter *filter,
+                                         const mitk::Point3D &start,
+                                         const mitk::Point3D &end)
+  {
+    filter->SetStartPoint(start);
+    filter->SetEndPoint(end);
+    filter->Update();
+
+    std::vector<mitk::Point3D> path;
+    mitk::ContourModel *contour = filter->GetOutput();
+    for (auto it = contour->IteratorBegin(); it != contour->IteratorEnd(); ++it)
+    {
+      path.push_back((*it)->Coordinates);
+    }
+    return path;
+  }
+
+public:
+  void setUp() override
+  {
+    // bright ring on dark background, giving the live wire an edge to follow
+    typedef itk::Image<unsigned char, 2> ImageType;
+    ImageType::Pointer itkImage = ImageType::New();
+    ImageType::RegionType region;
+    region.SetSize(0, 64);
+    region.SetSize(1, 64);
+    itkImage->SetRegions(region);
+    itkImage->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(itkImage, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const double dx = it.GetIndex()[0] - 32.0;
+      const double dy = it.GetIndex()[1] - 32.0;
+      it.Set(dx * dx + dy * dy < 20.0 * 20.0 ? 200 : 20);
+    }
+
+    m_Image = mitk::GrabItkImageMemory(itkImage.GetPointer());
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void testPathEndsAtStartAndEndPoint()
+  {
+    auto filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(m_Image);
+
+    auto start = this->IndexToWorld(12, 32);
+    auto end = this->IndexToWorld(32, 12);
+    auto path = this->ComputePath(filter, start, end);
+
+    CPPUNIT_ASSERT_MESSAGE("Path is not empty", !path.empty());
+    CPPUNIT_ASSERT_MESSAGE("Path begins at the start point", path.front().EuclideanDistanceTo(start) < mitk::eps);
+    CPPUNIT_ASSERT_MESSAGE("Path ends at the end point", path.back().EuclideanDistanceTo(end) < mitk::eps);
+  }
+
+  void testMovingEndPointMatchesFreshSearch()
+  {
+    // one filter keeps its shortest path tree while the end point follows a "mouse cursor",
+    // the results have to be identical to a search from scratch for every end point
+    auto trackingFilter = mitk::ImageLiveWireContourModelFilter::New();
+    trackingFilter->SetInput(m_Image);
+
+    auto start = this->IndexToWorld(12, 32);
+    const double endPoints[][2] = {{14, 30}, {32, 12}, {52, 32}, {20, 20}, {60, 60}, {13, 31}, {32, 52}};
+
+    for (const auto &endPoint : endPoints)
+    {
+      auto end = this->IndexToWorld(endPoint[0], endPoint[1]);
+
+      auto freshFilter = mitk::ImageLiveWireContourModelFilter::New();
+      freshFilter->SetInput(m_Image);
+
+      auto trackedPath = this->ComputePath(trackingFilter, start, end);
+      auto freshPath = this->ComputePath(freshFilter, start, end);
+
+      CPPUNIT_ASSERT_EQUAL(freshPath.size(), trackedPath.size());
+      for (std::size_t i = 0; i < freshPath.size(); ++i)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Reused tree yields the same path",
+                               freshPath[i].EuclideanDistanceTo(trackedPath[i]) < mitk::eps);
+      }
+    }
+  }
+
+  void testRepulsivePointsInvalidateTree()
+  {
+    auto filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(m_Image);
+
+    auto start = this->IndexToWorld(12, 32);
+    auto end = this->IndexToWorld(52, 32);
+    auto path = this->ComputePath(filter, start, end);
+    CPPUNIT_ASSERT_MESSAGE("Path is long enough to block it", path.size() > 4);
+
+    // block the middle of the previous path, the next update must not reuse the old tree
+    mitk::Point3D blockedPoint;
+    m_Image->GetGeometry()->WorldToIndex(path[path.size() / 2], blockedPoint);
+    itk::Index<2> blockedIndex;
+    blockedIndex[0] = static_cast<itk::IndexValueType>(blockedPoint[0] + 0.5);
+    blockedIndex[1] = static_cast<itk::IndexValueType>(blockedPoint[1] + 0.5);
+    filter->AddRepulsivePoint(blockedIndex);
+
+    auto detour = this->ComputePath(filter, start, end);
+    for (const auto &point : detour)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Path avoids the repulsive point",
+                             point.EuclideanDistanceTo(path[path.size() / 2]) > mitk::eps);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilter)
@@ -375,6 +375,46 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  // test ReuseMeshTopology mode against the standard reconstruction
+  MITK_INFO<<"Test filter with reused mesh topology";
+  filter->SetReconstructionMode(mitk::ToFDistanceImageToSurfaceFilter::WithInterPixelDistance);
+  filter->SetTriangulationThreshold(50.0);
+  filter->SetReuseMeshTopology(false);
+  filter->Update();
+  vtkSmartPointer<vtkPolyData> standardMesh = vtkSmartPointer<vtkPolyData>::New();
+  standardMesh->DeepCopy(filter->GetOutput()->GetVtkPolyData());
+  vtkSmartPointer<vtkIdList> standardVertexIds = vtkSmartPointer<vtkIdList>::New();
+  standardVertexIds->DeepCopy(filter->GetVertexIdList());
+
+  filter->ReuseMeshTopologyOn();
+  filter->Modified();
+  filter->Update();
+  vtkPolyData* reusedMesh = filter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(reusedMesh->GetNumberOfPoints() == static_cast<vtkIdType>(dimX*dimY),"Testing one point per pixel with reused mesh topology");
+  MITK_TEST_CONDITION_REQUIRED(reusedMesh->GetNumberOfPolys() == standardMesh->GetNumberOfPolys(),"Testing number of triangles with reused mesh topology");
+  MITK_TEST_CONDITION_REQUIRED(reusedMesh->GetNumberOfVerts() == standardMesh->GetNumberOfVerts(),"Testing number of vertices with reused mesh topology");
+
+  bool reusedPointsEqual = true;
+  {
+    mitk::ImagePixelReadAccessor<float,2> readAccess(image, image->GetSliceData());
+    for (unsigned int pixelID = 0; pixelID < dimX*dimY; ++pixelID)
+    {
+      itk::Index<2> index = {{ static_cast<itk::IndexValueType>(pixelID % dimX), static_cast<itk::IndexValueType>(pixelID / dimX) }};
+      if (readAccess.GetPixelByIndex(index) <= mitk::eps)
+        continue;
+      mitk::Point3D expectedPoint(standardMesh->GetPoint(standardVertexIds->GetId(pixelID)));
+      mitk::Point3D resultPoint(reusedMesh->GetPoint(filter->GetVertexIdList()->GetId(pixelID)));
+      if (!mitk::Equal(expectedPoint, resultPoint, 1e-6))
+        reusedPointsEqual = false;
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(reusedPointsEqual,"Testing points with reused mesh topology");
+
+  image->Modified();
+  filter->Update();
+  MITK_TEST_CONDITION_REQUIRED(filter->GetOutput()->GetVtkPolyData() == reusedMesh,"Testing that the mesh is reused for the next frame");
+  MITK_TEST_CONDITION_REQUIRED(reusedMesh->GetNumberOfPolys() == standardMesh->GetNumberOfPolys(),"Testing number of triangles of the next frame");
+
   //clean up
   delete[] point;
   //  expectedResult->Delete();
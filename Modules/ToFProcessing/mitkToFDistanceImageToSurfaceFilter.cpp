@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include <mitkInstantiateAccessFunctions.h>
 #include <mitkSurface.h>
 #include "mitkImageReadAccessor.h"
+#include <mitkParallelFor.h>
 
 #include <itkImage.h>
 
@@ -25,12 +26,54 @@ found in the LICENSE file.
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <memory>
+#include <vector>
 #include <vtkMath.h>
 
+namespace
+{
+  /// Number of image rows processed by one task in the ReuseMeshTopology mode.
+  const int ROWS_PER_TASK = 16;
+}
+
+struct mitk::ToFDistanceImageToSurfaceFilter::FixedTopologyData
+{
+  FixedTopologyData() : XDimension(0), YDimension(0)
+  {
+    Parameters.fill(0.0);
+  }
+
+  int XDimension;
+  int YDimension;
+  std::array<double, 12> Parameters; ///< reconstruction parameters the rays were computed with
+
+  std::vector<double> Rays; ///< Three components per pixel. The point of a pixel is its distance times its ray.
+  std::vector<unsigned char> PointValid; ///< Validity of each pixel of the current frame
+  std::vector<unsigned char> QuadState; ///< For each pixel (i,j) with i,j >= 1 and its three upper left neighbours: 0 = no cell, 1 = two triangles, 2 = vertex only
+  std::vector<vtkIdType> RowPolyOffsets; ///< Offset of the first poly cell entry of each row in PolyConnectivity
+  std::vector<vtkIdType> RowVertexOffsets; ///< Offset of the first vertex cell entry of each row in VertexConnectivity
+  std::vector<vtkIdType> PolyConnectivity;
+  std::vector<vtkIdType> VertexConnectivity;
+
+  vtkSmartPointer<vtkPolyData> Mesh;
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkCellArray> Vertices;
+  vtkSmartPointer<vtkIdTypeArray> PolyIds;
+  vtkSmartPointer<vtkIdTypeArray> VertexIds;
+  vtkSmartPointer<vtkFloatArray> Scalars;
+  vtkSmartPointer<vtkFloatArray> TextureCoords;
+};
+
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
-  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
+  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0), m_ReuseMeshTopology(false)
 {
   m_InterPixelDistance.Fill(0.045);
   m_CameraIntrinsics = mitk::CameraIntrinsics::New();
@@ -38,6 +81,10 @@ mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_CameraIntrinsics->SetPrincipalPoint(107.867935181,98.3807373047);
   m_CameraIntrinsics->SetDistorsionCoeffs(-0.486690014601f,0.553943634033f,0.00222016777843f,-0.00300851115026f);
   m_ReconstructionMode = WithInterPixelDistance;
+
+  // the ReuseMeshTopology mode runs several short parallel passes per frame,
+  // keep the threads of the filter alive between them
+  this->GetMultiThreader()->SetUseThreadPool(true);
 }
 
 mitk::ToFDistanceImageToSurfaceFilter::~ToFDistanceImageToSurfaceFilter()
@@ -87,6 +134,12 @@ mitk::Image* mitk::ToFDistanceImageToSurfaceFilter::GetInput( unsigned int idx )
 
 void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
 {
+  if (m_ReuseMeshTopology)
+  {
+    this->GenerateDataWithFixedTopology();
+    return;
+  }
+
   mitk::Surface::Pointer output = this->GetOutput();
   assert(output);
   mitk::Image::Pointer input = this->GetInput();
@@ -307,6 +360,313 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   output->SetVtkPolyData(mesh);
 }
 
+void mitk::ToFDistanceImageToSurfaceFilter::GenerateDataWithFixedTopology()
+{
+  mitk::Surface::Pointer output = this->GetOutput();
+  assert(output);
+  mitk::Image::Pointer input = this->GetInput();
+  assert(input);
+
+  const int xDimension = input->GetDimension(0);
+  const int yDimension = input->GetDimension(1);
+  const std::size_t size = static_cast<std::size_t>(xDimension) * yDimension;
+
+  if (!m_FixedTopology)
+    m_FixedTopology.reset(new FixedTopologyData);
+  FixedTopologyData& data = *m_FixedTopology;
+
+  mitk::Point3D origin = input->GetGeometry()->GetOrigin();
+  mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
+
+  std::array<double, 12> parameters = {{ static_cast<double>(m_ReconstructionMode),
+    m_CameraIntrinsics->GetFocalLengthX(), m_CameraIntrinsics->GetFocalLengthY(),
+    m_CameraIntrinsics->GetPrincipalPointX(), m_CameraIntrinsics->GetPrincipalPointY(),
+    m_InterPixelDistance[0], m_InterPixelDistance[1],
+    origin[0], origin[1], spacing[0], spacing[1], 0.0 }};
+
+  // (re)allocate the buffers and the mesh if the frame size changed
+  if (data.Mesh == nullptr || data.XDimension != xDimension || data.YDimension != yDimension)
+  {
+    data.XDimension = xDimension;
+    data.YDimension = yDimension;
+    data.Parameters.fill(0.0);
+
+    data.Rays.resize(3 * size);
+    data.PointValid.resize(size);
+    data.QuadState.assign(size, 0);
+    data.RowPolyOffsets.resize(yDimension + 1);
+    data.RowVertexOffsets.resize(yDimension + 1);
+    // at most two triangles per pixel, 4 entries each (number of points + 3 IDs)
+    data.PolyConnectivity.resize(8 * size);
+    data.VertexConnectivity.resize(2 * size);
+
+    data.Points = vtkSmartPointer<vtkPoints>::New();
+    data.Points->SetDataTypeToDouble();
+    data.Points->SetNumberOfPoints(size);
+
+    data.PolyIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    data.VertexIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    data.Polys = vtkSmartPointer<vtkCellArray>::New();
+    data.Vertices = vtkSmartPointer<vtkCellArray>::New();
+
+    data.Scalars = vtkSmartPointer<vtkFloatArray>::New();
+    data.Scalars->SetNumberOfTuples(size);
+
+    //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
+    data.TextureCoords = vtkSmartPointer<vtkFloatArray>::New();
+    data.TextureCoords->SetNumberOfComponents(2);
+    data.TextureCoords->SetNumberOfTuples(size);
+    float* textureCoords = data.TextureCoords->GetPointer(0);
+    for (int j = 0; j < yDimension; ++j)
+    {
+      for (int i = 0; i < xDimension; ++i)
+      {
+        textureCoords[2 * (i + j * xDimension)] = ((float)i) / xDimension;
+        textureCoords[2 * (i + j * xDimension) + 1] = ((float)j) / yDimension;
+      }
+    }
+
+    data.Mesh = vtkSmartPointer<vtkPolyData>::New();
+    data.Mesh->SetPoints(data.Points);
+    data.Mesh->SetPolys(data.Polys);
+    data.Mesh->SetVerts(data.Vertices);
+    data.Mesh->GetPointData()->SetTCoords(data.TextureCoords);
+
+    // point IDs correspond to the image pixel IDs in this mode
+    m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
+    m_VertexIdList->SetNumberOfIds(size);
+    for (std::size_t i = 0; i < size; ++i)
+      m_VertexIdList->SetId(i, i);
+  }
+
+  // The back projection is linear in the distance, so the ray of each pixel
+  // (its point at distance 1) only has to be computed if the camera changes.
+  if (data.Parameters != parameters)
+  {
+    data.Parameters = parameters;
+
+    mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
+    focalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
+    focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
+    //convert focallength from pixel to mm
+    mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm =
+      (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
+    mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
+    principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
+    principalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
+
+    for (int j = 0; j < yDimension; ++j)
+    {
+      for (int i = 0; i < xDimension; ++i)
+      {
+        // see GenerateData() for the incorporation of spacing and origin
+        unsigned int completeIndexX = i*spacing[0]+origin[0];
+        unsigned int completeIndexY = j*spacing[1]+origin[1];
+
+        mitk::ToFProcessingCommon::ToFPoint3D ray;
+        ray.Fill(0.0);
+        switch (m_ReconstructionMode)
+        {
+        case WithOutInterPixelDistance:
+          ray = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,1.0,focalLengthInPixelUnits,principalPoint);
+          break;
+        case WithInterPixelDistance:
+          ray = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,1.0,focalLengthInMm,m_InterPixelDistance,principalPoint);
+          break;
+        case Kinect:
+          ray = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,1.0,focalLengthInPixelUnits,principalPoint);
+          break;
+        default:
+          MITK_ERROR << "Incorrect reconstruction mode!";
+        }
+
+        std::size_t pixelID = i + static_cast<std::size_t>(j) * xDimension;
+        data.Rays[3 * pixelID] = ray[0];
+        data.Rays[3 * pixelID + 1] = ray[1];
+        data.Rays[3 * pixelID + 2] = ray[2];
+      }
+    }
+  }
+
+  ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
+  const float* inputFloatData = static_cast<const float*>(inputAcc.GetData());
+
+  std::unique_ptr<ImageReadAccessor> textureAcc;
+  const float* scalarFloatData = nullptr;
+  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
+  {
+    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
+  }
+  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
+  {
+    textureAcc.reset(new ImageReadAccessor(this->GetInput(m_TextureIndex)));
+    scalarFloatData = static_cast<const float*>(textureAcc->GetData());
+  }
+
+  double* points = static_cast<vtkDoubleArray*>(data.Points->GetData())->GetPointer(0);
+  float* scalars = data.Scalars->GetPointer(0);
+  const double* rays = data.Rays.data();
+  unsigned char* pointValid = data.PointValid.data();
+  unsigned char* quadState = data.QuadState.data();
+  const double triangulationThreshold = m_TriangulationThreshold;
+  const bool useTriangulationThreshold = !mitk::Equal(m_TriangulationThreshold, 0.0);
+  const bool generateTriangularMesh = m_GenerateTriangularMesh;
+  const std::size_t numberOfTasks = (yDimension + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+  // 1) scale the rays by the distances. The inner loop has no branches and
+  //    works on contiguous arrays, so that it can be vectorized.
+  mitk::ParallelFor(numberOfTasks, this->GetNumberOfThreads(), [&](std::size_t task) {
+    const int firstRow = static_cast<int>(task) * ROWS_PER_TASK;
+    const int lastRow = std::min(yDimension, firstRow + ROWS_PER_TASK);
+    for (int j = firstRow; j < lastRow; ++j)
+    {
+      const std::size_t rowStart = static_cast<std::size_t>(j) * xDimension;
+      for (std::size_t pixelID = rowStart; pixelID < rowStart + xDimension; ++pixelID)
+      {
+        //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+        const bool valid = inputFloatData[pixelID] > mitk::eps;
+        const double distance = valid ? inputFloatData[pixelID] : 0.0;
+        points[3 * pixelID] = distance * rays[3 * pixelID];
+        points[3 * pixelID + 1] = distance * rays[3 * pixelID + 1];
+        points[3 * pixelID + 2] = distance * rays[3 * pixelID + 2];
+        pointValid[pixelID] = valid;
+      }
+      if (scalarFloatData)
+        std::copy(scalarFloatData + rowStart, scalarFloatData + rowStart + xDimension, scalars + rowStart);
+    }
+  }, this->GetMultiThreader());
+
+  // 2) update the cell validity mask and count the cell entries of each row
+  mitk::ParallelFor(numberOfTasks, this->GetNumberOfThreads(), [&](std::size_t task) {
+    const int firstRow = static_cast<int>(task) * ROWS_PER_TASK;
+    const int lastRow = std::min(yDimension, firstRow + ROWS_PER_TASK);
+    for (int j = firstRow; j < lastRow; ++j)
+    {
+      vtkIdType numberOfPolys = 0;
+      vtkIdType numberOfVertices = 0;
+      const std::size_t rowStart = static_cast<std::size_t>(j) * xDimension;
+
+      if (!generateTriangularMesh)
+      {
+        for (std::size_t pixelID = rowStart; pixelID < rowStart + xDimension; ++pixelID)
+          numberOfVertices += pointValid[pixelID];
+      }
+      else if (j >= 1)
+      {
+        for (std::size_t xy = rowStart + 1; xy < rowStart + xDimension; ++xy)
+        {
+          // see GenerateData() for the naming of the four vertices
+          const std::size_t x_1y = xy - 1;
+          const std::size_t xy_1 = xy - xDimension;
+          const std::size_t x_1y_1 = xy_1 - 1;
+
+          unsigned char state = 0;
+          if (pointValid[xy] && pointValid[x_1y] && pointValid[x_1y_1] && pointValid[xy_1])
+          {
+            state = 1;
+            if (useTriangulationThreshold
+              && ((vtkMath::Distance2BetweenPoints(points + 3 * xy, points + 3 * x_1y) > triangulationThreshold)
+                || (vtkMath::Distance2BetweenPoints(points + 3 * xy, points + 3 * xy_1) > triangulationThreshold)
+                || (vtkMath::Distance2BetweenPoints(points + 3 * x_1y, points + 3 * x_1y_1) > triangulationThreshold)
+                || (vtkMath::Distance2BetweenPoints(points + 3 * xy_1, points + 3 * x_1y_1) > triangulationThreshold)))
+            {
+              //We dont want triangulation, but we want to keep the vertex
+              state = 2;
+            }
+          }
+          quadState[xy] = state;
+          numberOfPolys += (state == 1);
+          numberOfVertices += (state == 2);
+        }
+      }
+
+      data.RowPolyOffsets[j + 1] = 8 * numberOfPolys;
+      data.RowVertexOffsets[j + 1] = 2 * numberOfVertices;
+    }
+  }, this->GetMultiThreader());
+
+  data.RowPolyOffsets[0] = 0;
+  data.RowVertexOffsets[0] = 0;
+  for (int j = 0; j < yDimension; ++j)
+  {
+    data.RowPolyOffsets[j + 1] += data.RowPolyOffsets[j];
+    data.RowVertexOffsets[j + 1] += data.RowVertexOffsets[j];
+  }
+
+  // 3) write the cells of each row to its place in the connectivity arrays
+  vtkIdType* polyConnectivity = data.PolyConnectivity.data();
+  vtkIdType* vertexConnectivity = data.VertexConnectivity.data();
+  mitk::ParallelFor(numberOfTasks, this->GetNumberOfThreads(), [&](std::size_t task) {
+    const int firstRow = static_cast<int>(task) * ROWS_PER_TASK;
+    const int lastRow = std::min(yDimension, firstRow + ROWS_PER_TASK);
+    for (int j = firstRow; j < lastRow; ++j)
+    {
+      vtkIdType* polys = polyConnectivity + data.RowPolyOffsets[j];
+      vtkIdType* vertices = vertexConnectivity + data.RowVertexOffsets[j];
+      const vtkIdType rowStart = static_cast<vtkIdType>(j) * xDimension;
+
+      if (!generateTriangularMesh)
+      {
+        for (vtkIdType pixelID = rowStart; pixelID < rowStart + xDimension; ++pixelID)
+        {
+          if (pointValid[pixelID])
+          {
+            *vertices++ = 1;
+            *vertices++ = pixelID;
+          }
+        }
+      }
+      else if (j >= 1)
+      {
+        for (vtkIdType xy = rowStart + 1; xy < rowStart + xDimension; ++xy)
+        {
+          if (quadState[xy] == 1)
+          {
+            const vtkIdType x_1y = xy - 1;
+            const vtkIdType xy_1 = xy - xDimension;
+            const vtkIdType x_1y_1 = xy_1 - 1;
+
+            *polys++ = 3;
+            *polys++ = x_1y;
+            *polys++ = xy;
+            *polys++ = x_1y_1;
+
+            *polys++ = 3;
+            *polys++ = x_1y_1;
+            *polys++ = xy;
+            *polys++ = xy_1;
+          }
+          else if (quadState[xy] == 2)
+          {
+            *vertices++ = 1;
+            *vertices++ = xy;
+          }
+        }
+      }
+    }
+  }, this->GetMultiThreader());
+
+  // hand the connectivity buffers to VTK without copying them
+  const vtkIdType polyEntries = data.RowPolyOffsets[yDimension];
+  const vtkIdType vertexEntries = data.RowVertexOffsets[yDimension];
+  data.PolyIds->SetArray(polyConnectivity, polyEntries, 1);
+  data.VertexIds->SetArray(vertexConnectivity, vertexEntries, 1);
+  data.Polys->SetCells(polyEntries / 4, data.PolyIds);
+  data.Vertices->SetCells(vertexEntries / 2, data.VertexIds);
+
+  data.Points->Modified();
+  //Pass the scalars to the polydata (if they were set).
+  data.Mesh->GetPointData()->SetScalars(scalarFloatData ? data.Scalars.GetPointer() : nullptr);
+  data.Scalars->Modified();
+  data.Mesh->DeleteCells();
+  data.Mesh->Modified();
+
+  output->SetVtkPolyData(data.Mesh);
+  // SetVtkPolyData() ignores the same poly data, thus the output is updated explicitly
+  output->CalculateBoundingBox();
+  output->Modified();
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::CreateOutputsForAllInputs()
 {
   this->SetNumberOfIndexedOutputs(this->GetNumberOfInputs());  // create outputs for all inputs
@@ -24,6 +24,8 @@ found in the LICENSE file.
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 
+#include <memory>
+
 namespace mitk
 {
   /**
@@ -75,6 +77,23 @@ namespace mitk
     itkSetMacro(GenerateTriangularMesh,bool);
     itkGetMacro(GenerateTriangularMesh,bool);
 
+    /**
+     * @brief Enables the fixed grid topology mode meant for continuous streaming.
+     *
+     * If enabled, the output mesh, its points and cell arrays are allocated once and
+     * reused for every following frame of the same size. Every image pixel owns the
+     * point with the same ID (the vertex ID list is the identity), invalid pixels are
+     * placed at the origin and are not referenced by any cell. The viewing rays of the
+     * pixels are cached, so that each frame only scales them by the measured distances
+     * and rebuilds the list of valid cells. The rows of the image are processed in
+     * parallel on the threader of the filter (see itk::ProcessObject::SetNumberOfThreads()).
+     * @note The output surface keeps the same vtkPolyData, which is overwritten on the
+     * next update. Copy it if a frame has to be kept. Disabled by default.
+     */
+    itkSetMacro(ReuseMeshTopology,bool);
+    itkGetMacro(ReuseMeshTopology,bool);
+    itkBooleanMacro(ReuseMeshTopology);
+
 
     /**
      * @brief The ReconstructionModeType enum: Defines the reconstruction mode, if using no interpixeldistances and focal lenghts in pixel units  or interpixeldistances and focal length in mm. The Kinect option defines a special reconstruction mode for the kinect.
@@ -167,6 +186,11 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
 
+    /*!
+    \brief Generates the output in the ReuseMeshTopology mode.
+    */
+    void GenerateDataWithFixedTopology();
+
     IplImage* m_IplScalarImage; ///< Scalar image used for surface texturing
 
     mitk::CameraIntrinsics::Pointer m_CameraIntrinsics; ///< Specifies the intrinsic parameters
@@ -184,6 +208,11 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+    bool m_ReuseMeshTopology; ///< Reuse the output mesh and the pixel rays of the previous frame, see SetReuseMeshTopology()
+
+    struct FixedTopologyData;
+    std::unique_ptr<FixedTopologyData> m_FixedTopology; ///< Buffers that are reused between frames in the ReuseMeshTopology mode
+
   };
 } //END mitk namespace
 #endif
@@ -27,12 +27,20 @@ found in the LICENSE file.
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
+#include <map>
+#include <vector>
+
 namespace mitk
 {
   /**
   * 3D Mapper for mitk::Graph< TubeGraphVertex, TubeGraphEdge >. This mapper creates tubes
   * around each tubular structure by using vtkTubeFilter.
   *
+  * If the property "Tube Graph.Batched Rendering" is set (default) and the structures are not
+  * clipped, all tubes and all spheres are merged into one vtkPolyData each, so the whole graph
+  * is rendered by two actors. Changes of the TubeGraphProperty (e.g. selection, colors or
+  * visibility of labels) then only update the color scalars and the visible cells of these
+  * poly data. Otherwise one actor is created for each tube and each sphere.
   */
 
   class MITKTUBEGRAPH_EXPORT TubeGraphVtkMapper3D : public VtkMapper
@@ -76,6 +84,17 @@ namespace mitk
     */
     virtual void RenderTubeGraphPropertyInformation(mitk::BaseRenderer *renderer);
 
+    /**
+    * Generates the tubes and spheres like GenerateTubeGraphData, but merges them into
+    * one vtkPolyData for all tubes and one for all spheres.
+    */
+    virtual void GenerateBatchedTubeGraphData(mitk::BaseRenderer *renderer);
+
+    /**
+    * Updates the color scalars and the visible cells of the merged poly data.
+    */
+    virtual void RenderBatchedTubeGraphPropertyInformation(mitk::BaseRenderer *renderer);
+
     /**
     * Converts a single tube into a vtkPolyData. Each point of the
     * tube surface is labeled with the tube id.
@@ -92,8 +111,57 @@ namespace mitk
                       const TubeGraphProperty::Pointer &graphProperty,
                       mitk::BaseRenderer *renderer);
 
+    vtkSmartPointer<vtkPolyData> CreateTubePolyData(TubeGraphEdge &edge,
+                                                    const TubeGraph::Pointer &graph,
+                                                    const Color &color);
+    vtkSmartPointer<vtkPolyData> CreateSpherePolyData(TubeGraphVertex &vertex);
+
   private:
     bool ClipStructures();
+    bool BatchedRendering();
+
+    /**
+    * Several tubes or spheres merged into one vtkPolyData. Each segment owns a range of
+    * points and a range of cells; the cells of invisible segments are left out.
+    */
+    class BatchedGeometry
+    {
+    public:
+      struct Segment
+      {
+        vtkIdType FirstPoint;
+        vtkIdType NumberOfPoints;
+        std::size_t PolysBegin;
+        std::size_t PolysEnd;
+        vtkIdType NumberOfPolys;
+        std::size_t StripsBegin;
+        std::size_t StripsEnd;
+        vtkIdType NumberOfStrips;
+        bool Visible;
+        unsigned char Color[3];
+      };
+
+      vtkSmartPointer<vtkPolyData> PolyData;
+      vtkSmartPointer<vtkActor> Actor;
+
+      BatchedGeometry();
+
+      void Clear();
+      /** Appends the points and cells of the poly data as new segment and returns its index.*/
+      std::size_t AddSegment(vtkPolyData *polyData);
+      /** Sets the color of all points of a segment. Returns true if the color has changed.*/
+      bool SetSegmentColor(std::size_t segment, const Color &color);
+      /** Returns true if the visibility has changed.*/
+      bool SetSegmentVisible(std::size_t segment, bool visible);
+      /** Rebuilds the cell arrays of the poly data from the visible segments.*/
+      void UpdateCells();
+
+    private:
+      std::vector<Segment> m_Segments;
+      // cells of all segments in the layout of vtkCellArray (npts, id_0, ..., id_npts-1)
+      std::vector<vtkIdType> m_Polys;
+      std::vector<vtkIdType> m_Strips;
+    };
 
     class LocalStorage : public mitk::Mapper::BaseLocalStorage
     {
@@ -102,10 +170,19 @@ namespace mitk
       std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor>> m_vtkTubesActorMap;
       std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor>> m_vtkSpheresActorMap;
 
+      BatchedGeometry m_BatchedTubes;
+      BatchedGeometry m_BatchedSpheres;
+      std::map<TubeGraph::TubeDescriptorType, std::size_t> m_BatchedTubeSegments;
+      std::map<TubeGraph::VertexDescriptorType, std::size_t> m_BatchedSphereSegments;
+      bool m_BatchedDataGenerated;
+
       itk::TimeStamp m_lastGenerateDataTime;
       itk::TimeStamp m_lastRenderDataTime;
 
-      LocalStorage() { m_vtkTubeGraphAssembly = vtkSmartPointer<vtkAssembly>::New(); }
+      LocalStorage() : m_BatchedDataGenerated(false)
+      {
+        m_vtkTubeGraphAssembly = vtkSmartPointer<vtkAssembly>::New();
+      }
       ~LocalStorage() override {}
     };
 
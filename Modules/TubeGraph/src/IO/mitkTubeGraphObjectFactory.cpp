@@ -52,6 +52,7 @@ void mitk::TubeGraphObjectFactory::SetDefaultProperties(mitk::DataNode *node)
   if ((dynamic_cast<mitk::TubeGraph *>(node->GetData()) != nullptr))
   {
     node->SetProperty("Tube Graph.Clip Structures", mitk::BoolProperty::New(false));
+    node->SetProperty("Tube Graph.Batched Rendering", mitk::BoolProperty::New(true));
     mitk::TubeGraphVtkMapper3D::SetDefaultProperties(node);
   }
 }
@@ -20,19 +20,25 @@ found in the LICENSE file.
 #include <vtkCylinder.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImplicitBoolean.h>
 #include <vtkImplicitModeller.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkProp3DCollection.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkSampleFunction.h>
 #include <vtkSphereSource.h>
 #include <vtkTubeFilter.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkUnsignedIntArray.h>
 
+#include <algorithm>
+#include <set>
+
 mitk::TubeGraphVtkMapper3D::TubeGraphVtkMapper3D()
 {
 }
@@ -65,10 +71,17 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
     itkWarningMacro(<< "Input of tube graph mapper is nullptr!");
     return;
   }
+
+  // clipping needs separate poly data for each tube and sphere
+  const bool batched = this->BatchedRendering() && !this->ClipStructures();
+
   // Check if the tube graph has changed; if the data has changed, generate the spheres and tubes new;
-  if (tubeGraph->GetMTime() > ls->m_lastGenerateDataTime)
+  if (tubeGraph->GetMTime() > ls->m_lastGenerateDataTime || batched != ls->m_BatchedDataGenerated)
   {
-    this->GenerateTubeGraphData(renderer);
+    if (batched)
+      this->GenerateBatchedTubeGraphData(renderer);
+    else
+      this->GenerateTubeGraphData(renderer);
     renderTubeGraph = true;
   }
   else
@@ -77,18 +90,24 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
     // new;
     if (tubeGraphProperty->GetMTime() > ls->m_lastRenderDataTime)
     {
-      this->RenderTubeGraphPropertyInformation(renderer);
+      if (batched)
+        this->RenderBatchedTubeGraphPropertyInformation(renderer);
+      else
+        this->RenderTubeGraphPropertyInformation(renderer);
       renderTubeGraph = true;
     }
   }
 
-  if (renderTubeGraph)
+  // the batched actors stay in the assembly; only their poly data is updated
+  if (renderTubeGraph && !batched)
   {
-    std::vector<TubeGraph::VertexDescriptorType> alreadyRenderedVertexList;
+    ls->m_vtkTubeGraphAssembly->GetParts()->RemoveAllItems();
+    ls->m_vtkTubeGraphAssembly->Modified();
+
+    std::set<TubeGraph::VertexDescriptorType> alreadyRenderedVertices;
     // don't render the sphere which is the root of the graph; so add it to the list before;
     // TODO check both spheres
-    TubeGraph::VertexDescriptorType root = tubeGraph->GetRootVertex();
-    alreadyRenderedVertexList.push_back(root);
+    alreadyRenderedVertices.insert(tubeGraph->GetRootVertex());
 
     for (auto itTubes =
            ls->m_vtkTubesActorMap.begin();
@@ -101,23 +120,19 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
         ls->m_vtkTubeGraphAssembly->AddPart(itTubes->second);
 
         // render the clipped spheres as end-cups of a tube and connections between tubes
-        if (std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.first) ==
-            alreadyRenderedVertexList.end())
+        if (alreadyRenderedVertices.insert(itTubes->first.first).second)
         {
           auto itSourceSphere =
             ls->m_vtkSpheresActorMap.find(itTubes->first.first);
           if (itSourceSphere != ls->m_vtkSpheresActorMap.end())
             ls->m_vtkTubeGraphAssembly->AddPart(itSourceSphere->second);
-          alreadyRenderedVertexList.push_back(itSourceSphere->first);
         }
-        if (std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.second) ==
-            alreadyRenderedVertexList.end())
+        if (alreadyRenderedVertices.insert(itTubes->first.second).second)
         {
           auto itTargetSphere =
             ls->m_vtkSpheresActorMap.find(itTubes->first.second);
           if (itTargetSphere != ls->m_vtkSpheresActorMap.end())
             ls->m_vtkTubeGraphAssembly->AddPart(itTargetSphere->second);
-          alreadyRenderedVertexList.push_back(itTargetSphere->first);
         }
       }
     }
@@ -213,6 +228,127 @@ void mitk::TubeGraphVtkMapper3D::RenderTubeGraphPropertyInformation(mitk::BaseRe
   ls->m_lastRenderDataTime.Modified();
 }
 
+void mitk::TubeGraphVtkMapper3D::RenderBatchedTubeGraphPropertyInformation(mitk::BaseRenderer *renderer)
+{
+  LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
+  TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph *>(this->GetInput());
+  TubeGraphProperty::Pointer tubeGraphProperty =
+    dynamic_cast<TubeGraphProperty *>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+
+  if (tubeGraphProperty.IsNull())
+  {
+    MITK_INFO << "No tube graph property!! So no special render information...";
+    return;
+  }
+
+  struct SphereColor
+  {
+    double Sum[3];
+    unsigned int NumberOfVisibleTubes;
+  };
+  std::map<TubeGraph::VertexDescriptorType, SphereColor> sphereColors;
+
+  bool tubeCellsChanged = false;
+  for (const auto &tubeSegment : ls->m_BatchedTubeSegments)
+  {
+    const bool visible = tubeGraphProperty->IsTubeVisible(tubeSegment.first);
+    tubeCellsChanged |= ls->m_BatchedTubes.SetSegmentVisible(tubeSegment.second, visible);
+
+    if (!visible)
+      continue;
+
+    const Color tubeColor = tubeGraphProperty->GetColorOfTube(tubeSegment.first);
+    ls->m_BatchedTubes.SetSegmentColor(tubeSegment.second, tubeColor);
+
+    // the spheres get the mean color of their visible tubes
+    for (const auto &vertexDesc : {tubeSegment.first.first, tubeSegment.first.second})
+    {
+      SphereColor &sphereColor = sphereColors[vertexDesc];
+      for (unsigned int i = 0; i < 3; ++i)
+        sphereColor.Sum[i] += tubeColor[i];
+      ++sphereColor.NumberOfVisibleTubes;
+    }
+  }
+
+  // don't render the sphere which is the root of the graph
+  const TubeGraph::VertexDescriptorType root = tubeGraph->GetRootVertex();
+
+  bool sphereCellsChanged = false;
+  for (const auto &sphereSegment : ls->m_BatchedSphereSegments)
+  {
+    auto sphereColor = sphereColors.find(sphereSegment.first);
+    const bool visible = sphereColor != sphereColors.end() && sphereSegment.first != root;
+    sphereCellsChanged |= ls->m_BatchedSpheres.SetSegmentVisible(sphereSegment.second, visible);
+
+    if (!visible)
+      continue;
+
+    Color color;
+    for (unsigned int i = 0; i < 3; ++i)
+      color[i] = sphereColor->second.Sum[i] / sphereColor->second.NumberOfVisibleTubes;
+    ls->m_BatchedSpheres.SetSegmentColor(sphereSegment.second, color);
+  }
+
+  if (tubeCellsChanged)
+    ls->m_BatchedTubes.UpdateCells();
+  if (sphereCellsChanged)
+    ls->m_BatchedSpheres.UpdateCells();
+
+  ls->m_lastRenderDataTime.Modified();
+}
+
+void mitk::TubeGraphVtkMapper3D::GenerateBatchedTubeGraphData(mitk::BaseRenderer *renderer)
+{
+  LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
+
+  ls->m_vtkTubesActorMap.clear();
+  ls->m_vtkSpheresActorMap.clear();
+  ls->m_BatchedTubes.Clear();
+  ls->m_BatchedSpheres.Clear();
+  ls->m_BatchedTubeSegments.clear();
+  ls->m_BatchedSphereSegments.clear();
+
+  TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph *>(this->GetInput());
+
+  // the colors are set by RenderBatchedTubeGraphPropertyInformation
+  Color color;
+  color.Fill(150);
+
+  std::vector<TubeGraphEdge> allEdges = tubeGraph->GetVectorOfAllEdges();
+  for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+  {
+    std::pair<TubeGraphVertex, TubeGraphVertex> soureTargetPair =
+      tubeGraph->GetVerticesOfAnEdge(tubeGraph->GetEdgeDescriptor(*edge));
+
+    // build tube descriptor [sourceId,targetId]
+    TubeGraph::TubeDescriptorType tube;
+    tube.first = tubeGraph->GetVertexDescriptor(soureTargetPair.first);
+    tube.second = tubeGraph->GetVertexDescriptor(soureTargetPair.second);
+
+    vtkSmartPointer<vtkPolyData> tubePolyData = this->CreateTubePolyData(*edge, tubeGraph, color);
+    ls->m_BatchedTubeSegments[tube] = ls->m_BatchedTubes.AddSegment(tubePolyData);
+  }
+
+  std::vector<TubeGraphVertex> allVertices = tubeGraph->GetVectorOfAllVertices();
+  for (auto vertex = allVertices.begin(); vertex != allVertices.end(); ++vertex)
+  {
+    vtkSmartPointer<vtkPolyData> spherePolyData = this->CreateSpherePolyData(*vertex);
+    ls->m_BatchedSphereSegments[tubeGraph->GetVertexDescriptor(*vertex)] =
+      ls->m_BatchedSpheres.AddSegment(spherePolyData);
+  }
+
+  ls->m_vtkTubeGraphAssembly->GetParts()->RemoveAllItems();
+  ls->m_vtkTubeGraphAssembly->AddPart(ls->m_BatchedTubes.Actor);
+  ls->m_vtkTubeGraphAssembly->AddPart(ls->m_BatchedSpheres.Actor);
+  ls->m_vtkTubeGraphAssembly->Modified();
+
+  ls->m_BatchedDataGenerated = true;
+  ls->m_lastGenerateDataTime.Modified();
+
+  // all segments are invisible until now
+  this->RenderBatchedTubeGraphPropertyInformation(renderer);
+}
+
 void mitk::TubeGraphVtkMapper3D::GenerateTubeGraphData(mitk::BaseRenderer *renderer)
 {
   MITK_INFO << "Render tube graph!";
@@ -220,6 +356,7 @@ void mitk::TubeGraphVtkMapper3D::GenerateTubeGraphData(mitk::BaseRenderer *rende
 
   ls->m_vtkTubesActorMap.clear();
   ls->m_vtkSpheresActorMap.clear();
+  ls->m_BatchedDataGenerated = false;
 
   TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph *>(this->GetInput());
   TubeGraphProperty::Pointer tubeGraphProperty =
@@ -254,6 +391,18 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForFurcation(mitk::TubeGraphVer
 {
   LocalStorage *ls = this->m_LSH.GetLocalStorage(renderer);
 
+  // generate a actor with a mapper for the sphere
+  vtkSmartPointer<vtkPolyDataMapper> sphereMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  vtkSmartPointer<vtkActor> sphereActor = vtkSmartPointer<vtkActor>::New();
+
+  sphereMapper->SetInputData(this->CreateSpherePolyData(vertex));
+  sphereActor->SetMapper(sphereMapper);
+
+  ls->m_vtkSpheresActorMap.insert(std::make_pair(graph->GetVertexDescriptor(vertex), sphereActor));
+}
+
+vtkSmartPointer<vtkPolyData> mitk::TubeGraphVtkMapper3D::CreateSpherePolyData(mitk::TubeGraphVertex &vertex)
+{
   mitk::Point3D coordinates;
   float diameter = 2;
 
@@ -269,14 +418,7 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForFurcation(mitk::TubeGraphVer
   sphereSource->SetPhiResolution(12);
   sphereSource->Update();
 
-  // generate a actor with a mapper for the sphere
-  vtkSmartPointer<vtkPolyDataMapper> sphereMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  vtkSmartPointer<vtkActor> sphereActor = vtkSmartPointer<vtkActor>::New();
-
-  sphereMapper->SetInputConnection(sphereSource->GetOutputPort());
-  sphereActor->SetMapper(sphereMapper);
-
-  ls->m_vtkSpheresActorMap.insert(std::make_pair(graph->GetVertexDescriptor(vertex), sphereActor));
+  return sphereSource->GetOutput();
 }
 
 void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &edge,
@@ -311,6 +453,26 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
     color[2] = 150;
   }
 
+  // generate a actor with a mapper for the
+  vtkSmartPointer<vtkPolyDataMapper> tubeMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  vtkSmartPointer<vtkActor> tubeActor = vtkSmartPointer<vtkActor>::New();
+
+  tubeMapper->SetInputData(this->CreateTubePolyData(edge, graph, color));
+  tubeActor->SetMapper(tubeMapper);
+  tubeActor->GetProperty()->SetColor(color[0], color[1], color[2]);
+
+  ls->m_vtkTubesActorMap.insert(std::pair<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor>>(tube, tubeActor));
+}
+
+vtkSmartPointer<vtkPolyData> mitk::TubeGraphVtkMapper3D::CreateTubePolyData(mitk::TubeGraphEdge &edge,
+                                                                           const mitk::TubeGraph::Pointer &graph,
+                                                                           const mitk::Color &color)
+{
+  std::pair<TubeGraphVertex, TubeGraphVertex> soureTargetPair =
+    graph->GetVerticesOfAnEdge(graph->GetEdgeDescriptor(edge));
+  TubeGraphVertex source = soureTargetPair.first;
+  TubeGraphVertex target = soureTargetPair.second;
+
   // add 2 points for the source and target vertices.
   unsigned int numberOfPoints = edge.GetNumberOfElements() + 2;
 
@@ -411,15 +573,7 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
 
   tubeFilter->GetOutput()->GetPointData()->SetActiveScalars("colorScalars");
 
-  // generate a actor with a mapper for the
-  vtkSmartPointer<vtkPolyDataMapper> tubeMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  vtkSmartPointer<vtkActor> tubeActor = vtkSmartPointer<vtkActor>::New();
-
-  tubeMapper->SetInputConnection(tubeFilter->GetOutputPort());
-  tubeActor->SetMapper(tubeMapper);
-  tubeActor->GetProperty()->SetColor(color[0], color[1], color[2]);
-
-  ls->m_vtkTubesActorMap.insert(std::pair<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor>>(tube, tubeActor));
+  return tubeFilter->GetOutput();
 }
 
 void mitk::TubeGraphVtkMapper3D::ClipPolyData(mitk::TubeGraphVertex &vertex,
@@ -751,3 +905,184 @@ bool mitk::TubeGraphVtkMapper3D::ClipStructures()
 
   return clipStructures;
 }
+
+bool mitk::TubeGraphVtkMapper3D::BatchedRendering()
+{
+  DataNode::Pointer node = this->GetDataNode();
+  if (node.IsNull())
+  {
+    itkWarningMacro(<< "associated node is nullptr!");
+    return false;
+  }
+
+  bool batchedRendering = true;
+  node->GetBoolProperty("Tube Graph.Batched Rendering", batchedRendering);
+
+  return batchedRendering;
+}
+
+mitk::TubeGraphVtkMapper3D::BatchedGeometry::BatchedGeometry()
+{
+  PolyData = vtkSmartPointer<vtkPolyData>::New();
+  Actor = vtkSmartPointer<vtkActor>::New();
+
+  vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  mapper->SetInputData(PolyData);
+  mapper->SetScalarModeToUsePointData();
+  mapper->ScalarVisibilityOn();
+  Actor->SetMapper(mapper);
+
+  this->Clear();
+}
+
+void mitk::TubeGraphVtkMapper3D::BatchedGeometry::Clear()
+{
+  m_Segments.clear();
+  m_Polys.clear();
+  m_Strips.clear();
+
+  vtkSmartPointer<vtkFloatArray> normals = vtkSmartPointer<vtkFloatArray>::New();
+  normals->SetName("normals");
+  normals->SetNumberOfComponents(3);
+
+  vtkSmartPointer<vtkUnsignedCharArray> colorScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colorScalars->SetName("colorScalars");
+  colorScalars->SetNumberOfComponents(3);
+
+  PolyData->Initialize();
+  PolyData->SetPoints(vtkSmartPointer<vtkPoints>::New());
+  PolyData->SetPolys(vtkSmartPointer<vtkCellArray>::New());
+  PolyData->SetStrips(vtkSmartPointer<vtkCellArray>::New());
+  PolyData->GetPointData()->SetNormals(normals);
+  PolyData->GetPointData()->SetScalars(colorScalars);
+}
+
+std::size_t mitk::TubeGraphVtkMapper3D::BatchedGeometry::AddSegment(vtkPolyData *polyData)
+{
+  Segment segment;
+  segment.FirstPoint = PolyData->GetNumberOfPoints();
+  segment.NumberOfPoints = polyData->GetNumberOfPoints();
+  segment.Visible = false;
+  // the color is unset until the first call of SetSegmentColor
+  segment.Color[0] = 0;
+  segment.Color[1] = 0;
+  segment.Color[2] = 0;
+
+  vtkPoints *points = PolyData->GetPoints();
+  vtkDataArray *normals = PolyData->GetPointData()->GetNormals();
+  vtkUnsignedCharArray *colorScalars = vtkUnsignedCharArray::SafeDownCast(PolyData->GetPointData()->GetScalars());
+  vtkDataArray *segmentNormals = polyData->GetPointData()->GetNormals();
+
+  const double noNormal[3] = {0.0, 0.0, 0.0};
+  for (vtkIdType i = 0; i < segment.NumberOfPoints; ++i)
+  {
+    points->InsertNextPoint(polyData->GetPoint(i));
+    normals->InsertNextTuple(segmentNormals != nullptr ? segmentNormals->GetTuple3(i) : noNormal);
+    colorScalars->InsertNextTuple3(0, 0, 0);
+  }
+
+  // shift the point ids of the cells to the points of the segment
+  auto appendCells = [&segment](vtkCellArray *cells, std::vector<vtkIdType> &connectivity) -> vtkIdType
+  {
+    vtkIdType numberOfCells = 0;
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++numberOfCells)
+    {
+      connectivity.push_back(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        connectivity.push_back(segment.FirstPoint + pts[i]);
+      }
+    }
+    return numberOfCells;
+  };
+
+  segment.PolysBegin = m_Polys.size();
+  segment.NumberOfPolys = appendCells(polyData->GetPolys(), m_Polys);
+  segment.PolysEnd = m_Polys.size();
+
+  segment.StripsBegin = m_Strips.size();
+  segment.NumberOfStrips = appendCells(polyData->GetStrips(), m_Strips);
+  segment.StripsEnd = m_Strips.size();
+
+  m_Segments.push_back(segment);
+
+  points->Modified();
+  return m_Segments.size() - 1;
+}
+
+bool mitk::TubeGraphVtkMapper3D::BatchedGeometry::SetSegmentColor(std::size_t segmentIndex, const Color &color)
+{
+  Segment &segment = m_Segments[segmentIndex];
+
+  const unsigned char newColor[3] = {static_cast<unsigned char>(color[0]),
+                                     static_cast<unsigned char>(color[1]),
+                                     static_cast<unsigned char>(color[2])};
+  if (std::equal(newColor, newColor + 3, segment.Color))
+    return false;
+
+  std::copy(newColor, newColor + 3, segment.Color);
+
+  vtkUnsignedCharArray *colorScalars = vtkUnsignedCharArray::SafeDownCast(PolyData->GetPointData()->GetScalars());
+  for (vtkIdType i = segment.FirstPoint; i < segment.FirstPoint + segment.NumberOfPoints; ++i)
+  {
+    colorScalars->SetTypedTuple(i, newColor);
+  }
+  colorScalars->Modified();
+
+  return true;
+}
+
+bool mitk::TubeGraphVtkMapper3D::BatchedGeometry::SetSegmentVisible(std::size_t segmentIndex, bool visible)
+{
+  if (m_Segments[segmentIndex].Visible == visible)
+    return false;
+
+  m_Segments[segmentIndex].Visible = visible;
+  return true;
+}
+
+void mitk::TubeGraphVtkMapper3D::BatchedGeometry::UpdateCells()
+{
+  vtkIdType numberOfPolys = 0;
+  vtkIdType numberOfStrips = 0;
+  std::size_t polysSize = 0;
+  std::size_t stripsSize = 0;
+
+  for (const auto &segment : m_Segments)
+  {
+    if (segment.Visible)
+    {
+      numberOfPolys += segment.NumberOfPolys;
+      numberOfStrips += segment.NumberOfStrips;
+      polysSize += segment.PolysEnd - segment.PolysBegin;
+      stripsSize += segment.StripsEnd - segment.StripsBegin;
+    }
+  }
+
+  vtkSmartPointer<vtkIdTypeArray> polysIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  polysIds->SetNumberOfValues(polysSize);
+  vtkSmartPointer<vtkIdTypeArray> stripsIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  stripsIds->SetNumberOfValues(stripsSize);
+
+  vtkIdType *polysIt = polysIds->GetPointer(0);
+  vtkIdType *stripsIt = stripsIds->GetPointer(0);
+  for (const auto &segment : m_Segments)
+  {
+    if (segment.Visible)
+    {
+      polysIt = std::copy(m_Polys.begin() + segment.PolysBegin, m_Polys.begin() + segment.PolysEnd, polysIt);
+      stripsIt = std::copy(m_Strips.begin() + segment.StripsBegin, m_Strips.begin() + segment.StripsEnd, stripsIt);
+    }
+  }
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  polys->SetCells(numberOfPolys, polysIds);
+  vtkSmartPointer<vtkCellArray> strips = vtkSmartPointer<vtkCellArray>::New();
+  strips->SetCells(numberOfStrips, stripsIds);
+
+  PolyData->SetPolys(polys);
+  PolyData->SetStrips(strips);
+  PolyData->Modified();
+}
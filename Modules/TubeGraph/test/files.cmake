@@ -0,0 +1,3 @@
+set(MODULE_TESTS
+  mitkTubeGraphVtkMapper3DTest.cpp
+)
@@ -0,0 +1,319 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// MITK
+#include <mitkCircularProfileTubeElement.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkTubeGraph.h>
+#include <mitkTubeGraphProperty.h>
+#include <mitkTubeGraphVtkMapper3D.h>
+
+// VTK
+#include <vtkActor.h>
+#include <vtkAssembly.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkMapper.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkProp3DCollection.h>
+#include <vtkSmartPointer.h>
+
+// std
+#include <map>
+#include <set>
+
+class mitkTubeGraphVtkMapper3DTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTubeGraphVtkMapper3DTestSuite);
+  MITK_TEST(BatchedRendering_AllTubesVisible_MatchesUnbatchedRendering);
+  MITK_TEST(BatchedRendering_TubeHidden_MatchesUnbatchedRendering);
+  MITK_TEST(BatchedRendering_TubeShownAgain_RestoresCells);
+  MITK_TEST(BatchedRendering_TubeColorChanged_UpdatesScalars);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::TubeGraph::Pointer m_TubeGraph;
+  mitk::TubeGraphProperty::Pointer m_TubeGraphProperty;
+  mitk::TubeGraphProperty::LabelGroup::Label *m_Label;
+  mitk::DataNode::Pointer m_Node;
+  mitk::TubeGraphVtkMapper3D::Pointer m_Mapper;
+  mitk::TubeGraph::VertexDescriptorType m_Furcation;
+  mitk::TubeGraph::VertexDescriptorType m_LabeledTubeEnd;
+
+  mitk::BaseRenderer *GetRenderer()
+  {
+    return mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  }
+
+  mitk::TubeGraph::VertexDescriptorType AddVertex(float x, float y)
+  {
+    mitk::TubeGraphVertex vertex;
+    vertex.SetTubeElement(new mitk::CircularProfileTubeElement(x, y, 0.0f, 2.0f));
+    return m_TubeGraph->AddVertex(vertex);
+  }
+
+  void AddEdge(const mitk::TubeGraph::VertexDescriptorType &vertexA,
+               const mitk::TubeGraph::VertexDescriptorType &vertexB)
+  {
+    const mitk::Point3D coordinatesA = m_TubeGraph->GetVertex(vertexA).GetTubeElement()->GetCoordinates();
+    const mitk::Point3D coordinatesB = m_TubeGraph->GetVertex(vertexB).GetTubeElement()->GetCoordinates();
+
+    mitk::TubeGraphEdge edge;
+    edge.AddTubeElement(new mitk::CircularProfileTubeElement(
+      (coordinatesA[0] + coordinatesB[0]) / 2, (coordinatesA[1] + coordinatesB[1]) / 2, 0.0f, 2.0f));
+    m_TubeGraph->AddEdge(vertexA, vertexB, edge);
+  }
+
+  /** The merged poly data of the tubes (part 0) or of the spheres (part 1) of the batched rendering */
+  vtkPolyData *GetBatchedPolyData(int part)
+  {
+    auto *assembly = dynamic_cast<vtkAssembly *>(m_Mapper->GetVtkProp(this->GetRenderer()));
+    CPPUNIT_ASSERT(assembly != nullptr);
+    CPPUNIT_ASSERT_EQUAL(2, assembly->GetParts()->GetNumberOfItems());
+
+    auto *actor = dynamic_cast<vtkActor *>(assembly->GetParts()->GetItemAsObject(part));
+    CPPUNIT_ASSERT(actor != nullptr);
+    auto *polyData = dynamic_cast<vtkPolyData *>(actor->GetMapper()->GetInput());
+    CPPUNIT_ASSERT(polyData != nullptr);
+    return polyData;
+  }
+
+  /** Number of cells of all actors of the assembly, for the batched and the unbatched rendering */
+  vtkIdType GetNumberOfRenderedCells()
+  {
+    auto *assembly = dynamic_cast<vtkAssembly *>(m_Mapper->GetVtkProp(this->GetRenderer()));
+    CPPUNIT_ASSERT(assembly != nullptr);
+
+    vtkIdType numberOfCells = 0;
+    vtkProp3DCollection *parts = assembly->GetParts();
+    for (int i = 0; i < parts->GetNumberOfItems(); ++i)
+    {
+      auto *actor = dynamic_cast<vtkActor *>(parts->GetItemAsObject(i));
+      CPPUNIT_ASSERT(actor != nullptr);
+      numberOfCells += actor->GetMapper()->GetInput()->GetNumberOfCells();
+    }
+    return numberOfCells;
+  }
+
+  /** Number of points that are used by the (visible) cells of the poly data */
+  static vtkIdType GetNumberOfUsedPoints(vtkPolyData *polyData)
+  {
+    std::set<vtkIdType> usedPoints;
+    vtkSmartPointer<vtkIdList> pointIds = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType cell = 0; cell < polyData->GetNumberOfCells(); ++cell)
+    {
+      polyData->GetCellPoints(cell, pointIds);
+      for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+        usedPoints.insert(pointIds->GetId(i));
+    }
+    return static_cast<vtkIdType>(usedPoints.size());
+  }
+
+  static vtkIdType GetNumberOfPointsWithColor(vtkPolyData *polyData, const mitk::Color &color)
+  {
+    vtkDataArray *scalars = polyData->GetPointData()->GetScalars();
+    CPPUNIT_ASSERT(scalars != nullptr);
+    CPPUNIT_ASSERT_EQUAL(3, scalars->GetNumberOfComponents());
+    CPPUNIT_ASSERT_EQUAL(polyData->GetNumberOfPoints(), scalars->GetNumberOfTuples());
+
+    vtkIdType numberOfPoints = 0;
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+    {
+      if (scalars->GetComponent(i, 0) == color[0] && scalars->GetComponent(i, 1) == color[1] &&
+          scalars->GetComponent(i, 2) == color[2])
+        ++numberOfPoints;
+    }
+    return numberOfPoints;
+  }
+
+  void SetBatchedRendering(bool batched)
+  {
+    m_Node->SetBoolProperty("Tube Graph.Batched Rendering", batched);
+    m_RenderingTestHelper.Render();
+  }
+
+  void SetLabelVisibility(bool visible)
+  {
+    m_TubeGraphProperty->SetLabelVisibility(m_Label, visible);
+    m_RenderingTestHelper.Render();
+  }
+
+  void AssertBatchedRenderingMatchesUnbatchedRendering()
+  {
+    const vtkIdType batchedCells = this->GetNumberOfRenderedCells();
+    this->SetBatchedRendering(false);
+    const vtkIdType unbatchedCells = this->GetNumberOfRenderedCells();
+    this->SetBatchedRendering(true);
+
+    CPPUNIT_ASSERT(batchedCells > 0);
+    CPPUNIT_ASSERT_EQUAL(unbatchedCells, batchedCells);
+    CPPUNIT_ASSERT_EQUAL(batchedCells, this->GetNumberOfRenderedCells());
+  }
+
+public:
+  mitkTubeGraphVtkMapper3DTestSuite() : m_RenderingTestHelper(300, 300) {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(300, 300);
+
+    // a root tube, which furcates into the labeled tube and a third tube
+    m_TubeGraph = mitk::TubeGraph::New();
+    const mitk::TubeGraph::VertexDescriptorType root = this->AddVertex(0.0f, 0.0f);
+    m_Furcation = this->AddVertex(10.0f, 0.0f);
+    m_LabeledTubeEnd = this->AddVertex(20.0f, 5.0f);
+    const mitk::TubeGraph::VertexDescriptorType end = this->AddVertex(20.0f, -5.0f);
+    this->AddEdge(root, m_Furcation);
+    this->AddEdge(m_Furcation, m_LabeledTubeEnd);
+    this->AddEdge(m_Furcation, end);
+    m_TubeGraph->SetRoot(root);
+
+    mitk::BaseGeometry::BoundsArrayType bounds;
+    bounds[0] = -1.0;
+    bounds[1] = 21.0;
+    bounds[2] = -6.0;
+    bounds[3] = 6.0;
+    bounds[4] = -1.0;
+    bounds[5] = 1.0;
+    m_TubeGraph->GetGeometry()->SetBounds(bounds);
+
+    mitk::Color grey;
+    grey.Fill(150);
+
+    auto *undefinedLabel = new mitk::TubeGraphProperty::LabelGroup::Label();
+    undefinedLabel->labelName = "Undefined";
+    undefinedLabel->isVisible = true;
+    undefinedLabel->labelColor = grey;
+
+    m_Label = new mitk::TubeGraphProperty::LabelGroup::Label();
+    m_Label->labelName = "Label";
+    m_Label->isVisible = true;
+    m_Label->labelColor = grey;
+
+    auto *labelGroup = new mitk::TubeGraphProperty::LabelGroup();
+    labelGroup->labelGroupName = "Label Group";
+    labelGroup->labels.push_back(undefinedLabel);
+    labelGroup->labels.push_back(m_Label);
+
+    m_TubeGraphProperty = mitk::TubeGraphProperty::New();
+    m_TubeGraphProperty->AddLabelGroup(labelGroup, 0);
+
+    std::map<mitk::TubeGraphProperty::TubeToLabelGroupType, std::string> tubesToLabels;
+    tubesToLabels[mitk::TubeGraphProperty::TubeToLabelGroupType(
+      mitk::TubeGraph::TubeDescriptorType(m_Furcation, m_LabeledTubeEnd), labelGroup->labelGroupName)] =
+      m_Label->labelName;
+    m_TubeGraphProperty->SetTubesToLabels(tubesToLabels);
+    m_TubeGraph->SetProperty("Tube Graph.Visualization Information", m_TubeGraphProperty);
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_TubeGraph);
+    m_Mapper = mitk::TubeGraphVtkMapper3D::New();
+    m_Node->SetMapper(mitk::BaseRenderer::Standard3D, m_Mapper);
+    m_Node->SetBoolProperty("Tube Graph.Batched Rendering", true);
+
+    m_RenderingTestHelper.SetMapperIDToRender3D();
+    m_RenderingTestHelper.AddNodeToStorage(m_Node);
+    m_RenderingTestHelper.Render();
+  }
+
+  void tearDown() override
+  {
+    m_Mapper = nullptr;
+    m_Node = nullptr;
+    m_Label = nullptr;
+    m_TubeGraphProperty = nullptr;
+    m_TubeGraph = nullptr;
+  }
+
+  void BatchedRendering_AllTubesVisible_MatchesUnbatchedRendering()
+  {
+    this->AssertBatchedRenderingMatchesUnbatchedRendering();
+
+    // the sphere of the root is not rendered
+    vtkPolyData *spheres = this->GetBatchedPolyData(1);
+    CPPUNIT_ASSERT_EQUAL(spheres->GetNumberOfPoints() / 4 * 3, GetNumberOfUsedPoints(spheres));
+  }
+
+  void BatchedRendering_TubeHidden_MatchesUnbatchedRendering()
+  {
+    const vtkIdType tubeCells = this->GetBatchedPolyData(0)->GetNumberOfCells();
+    const vtkIdType sphereCells = this->GetBatchedPolyData(1)->GetNumberOfCells();
+
+    this->SetLabelVisibility(false);
+
+    CPPUNIT_ASSERT(this->GetBatchedPolyData(0)->GetNumberOfCells() < tubeCells);
+    // the end of the hidden tube has no other tube, so its sphere is hidden, too
+    vtkPolyData *spheres = this->GetBatchedPolyData(1);
+    CPPUNIT_ASSERT_EQUAL(sphereCells / 3 * 2, spheres->GetNumberOfCells());
+    CPPUNIT_ASSERT_EQUAL(spheres->GetNumberOfPoints() / 4 * 2, GetNumberOfUsedPoints(spheres));
+
+    this->AssertBatchedRenderingMatchesUnbatchedRendering();
+  }
+
+  void BatchedRendering_TubeShownAgain_RestoresCells()
+  {
+    const vtkIdType tubeCells = this->GetBatchedPolyData(0)->GetNumberOfCells();
+    const vtkIdType sphereCells = this->GetBatchedPolyData(1)->GetNumberOfCells();
+
+    this->SetLabelVisibility(false);
+    this->SetLabelVisibility(true);
+
+    CPPUNIT_ASSERT_EQUAL(tubeCells, this->GetBatchedPolyData(0)->GetNumberOfCells());
+    CPPUNIT_ASSERT_EQUAL(sphereCells, this->GetBatchedPolyData(1)->GetNumberOfCells());
+  }
+
+  void BatchedRendering_TubeColorChanged_UpdatesScalars()
+  {
+    mitk::Color grey;
+    grey.Fill(150);
+    mitk::Color red;
+    red[0] = 255;
+    red[1] = 0;
+    red[2] = 0;
+    // mean color of the three tubes at the furcation
+    mitk::Color mixed;
+    mixed[0] = 185;
+    mixed[1] = 100;
+    mixed[2] = 100;
+
+    vtkPolyData *tubes = this->GetBatchedPolyData(0);
+    vtkPolyData *spheres = this->GetBatchedPolyData(1);
+    const vtkIdType numberOfSpherePoints = spheres->GetNumberOfPoints() / 4;
+
+    // the points of the labeled tube are the points, which are not used if it is hidden
+    const vtkIdType allTubePoints = GetNumberOfUsedPoints(tubes);
+    this->SetLabelVisibility(false);
+    const vtkIdType labeledTubePoints = allTubePoints - GetNumberOfUsedPoints(tubes);
+    this->SetLabelVisibility(true);
+    CPPUNIT_ASSERT(labeledTubePoints > 0);
+
+    CPPUNIT_ASSERT_EQUAL(tubes->GetNumberOfPoints(), GetNumberOfPointsWithColor(tubes, grey));
+    CPPUNIT_ASSERT_EQUAL(numberOfSpherePoints * 3, GetNumberOfPointsWithColor(spheres, grey));
+
+    const vtkIdType tubeCells = tubes->GetNumberOfCells();
+    m_TubeGraphProperty->SetLabelColor(m_Label, red);
+    m_RenderingTestHelper.Render();
+
+    CPPUNIT_ASSERT_EQUAL(tubeCells, tubes->GetNumberOfCells());
+    CPPUNIT_ASSERT_EQUAL(labeledTubePoints, GetNumberOfPointsWithColor(tubes, red));
+    CPPUNIT_ASSERT_EQUAL(tubes->GetNumberOfPoints() - labeledTubePoints, GetNumberOfPointsWithColor(tubes, grey));
+    CPPUNIT_ASSERT_EQUAL(numberOfSpherePoints, GetNumberOfPointsWithColor(spheres, red));
+    CPPUNIT_ASSERT_EQUAL(numberOfSpherePoints, GetNumberOfPointsWithColor(spheres, mixed));
+    CPPUNIT_ASSERT_EQUAL(numberOfSpherePoints, GetNumberOfPointsWithColor(spheres, grey));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTubeGraphVtkMapper3D)
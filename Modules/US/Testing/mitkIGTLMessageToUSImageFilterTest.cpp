@@ -0,0 +1,127 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkIGTLMessageToUSImageFilter.h>
+#include <mitkImageToIGTLMessageFilter.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+
+#include <igtlImageMessage.h>
+
+#include <chrono>
+#include <cstring>
+#include <set>
+
+static const unsigned int FRAME_DIM = 1024u;
+static const unsigned int NUMBER_OF_FRAMES = 100u;
+
+/**
+ * Streams images through ImageToIGTLMessageFilter and
+ * IGTLMessageToUSImageFilter in loopback and checks that the message and
+ * image buffers are recycled instead of being allocated per frame.
+ */
+class mitkIGTLMessageToUSImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIGTLMessageToUSImageFilterTestSuite);
+  MITK_TEST(GetNextImage_LoopbackStream_ReusesBuffers);
+  MITK_TEST(GetNextImage_FrameStillInUse_IsNotOverwritten);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_TestImage;
+  mitk::ImageToIGTLMessageFilter::Pointer m_ImageToIGTLMessageFilter;
+  mitk::IGTLMessageToUSImageFilter::Pointer m_IGTLMessageToUSImageFilter;
+
+  mitk::Image::Pointer GetNextFrame()
+  {
+    // force the sending filter to produce a new message
+    m_TestImage->Modified();
+    m_ImageToIGTLMessageFilter->Modified();
+    std::vector<mitk::Image::Pointer> images = m_IGTLMessageToUSImageFilter->GetNextImage();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), images.size());
+    return images[0];
+  }
+
+  igtl::ImageMessage* GetSentMessage()
+  {
+    igtl::MessageBase::Pointer message = m_ImageToIGTLMessageFilter->GetOutput()->GetMessage();
+    return dynamic_cast<igtl::ImageMessage*>(message.GetPointer());
+  }
+
+public:
+  void setUp() override
+  {
+    m_TestImage = mitk::ImageGenerator::GenerateGradientImage<unsigned char>(FRAME_DIM, FRAME_DIM, 1u);
+    m_ImageToIGTLMessageFilter = mitk::ImageToIGTLMessageFilter::New();
+    m_ImageToIGTLMessageFilter->SetInput(m_TestImage);
+    m_IGTLMessageToUSImageFilter = mitk::IGTLMessageToUSImageFilter::New();
+    m_IGTLMessageToUSImageFilter->ConnectTo(m_ImageToIGTLMessageFilter);
+  }
+
+  void tearDown() override
+  {
+    m_IGTLMessageToUSImageFilter = nullptr;
+    m_ImageToIGTLMessageFilter = nullptr;
+    m_TestImage = nullptr;
+  }
+
+  void GetNextImage_LoopbackStream_ReusesBuffers()
+  {
+    std::set<const void*> messageBuffers;
+    std::size_t numberOfFramesReferencingMessage = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < NUMBER_OF_FRAMES; ++i)
+    {
+      mitk::Image::Pointer frame = this->GetNextFrame();
+      CPPUNIT_ASSERT(frame.IsNotNull() && frame->IsInitialized());
+
+      const void* messageBuffer = this->GetSentMessage()->GetScalarPointer();
+      messageBuffers.insert(messageBuffer);
+
+      mitk::ImageReadAccessor readAccess(frame);
+      if (readAccess.GetData() == messageBuffer)
+        ++numberOfFramesReferencingMessage;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    MITK_INFO << "Loopback of " << NUMBER_OF_FRAMES << " frames of " << FRAME_DIM << "x" << FRAME_DIM
+              << " pixels: " << NUMBER_OF_FRAMES / seconds << " frames/s, "
+              << messageBuffers.size() << " message buffers allocated";
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Received frames should reference the message body",
+      std::size_t(NUMBER_OF_FRAMES), numberOfFramesReferencingMessage);
+    CPPUNIT_ASSERT_MESSAGE("Message buffers should be recycled", messageBuffers.size() <= 3);
+  }
+
+  void GetNextImage_FrameStillInUse_IsNotOverwritten()
+  {
+    mitk::Image::Pointer heldFrame = this->GetNextFrame();
+    const void* heldBuffer = this->GetSentMessage()->GetScalarPointer();
+
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+      this->GetNextFrame();
+      CPPUNIT_ASSERT_MESSAGE("A buffer referenced by a held frame was reused",
+        this->GetSentMessage()->GetScalarPointer() != heldBuffer);
+    }
+
+    mitk::ImageReadAccessor heldAccess(heldFrame);
+    mitk::ImageReadAccessor inputAccess(m_TestImage);
+    CPPUNIT_ASSERT(std::memcmp(heldAccess.GetData(), inputAccess.GetData(), FRAME_DIM * FRAME_DIM) == 0);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIGTLMessageToUSImageFilter)
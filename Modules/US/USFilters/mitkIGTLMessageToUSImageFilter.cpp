@@ -14,7 +14,13 @@ found in the LICENSE file.
 #include <igtlImageMessage.h>
 #include <itkByteSwapper.h>
 
-#include <vtkSmartPointer.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+
+// Upper bound for the number of unused frames with an own buffer that are kept
+// for recycling.
+static const std::size_t MAXIMUM_NUMBER_OF_FREE_FRAMES = 4;
 
 void mitk::IGTLMessageToUSImageFilter::GetNextRawImage(
   std::vector<mitk::Image::Pointer>& imgVector)
@@ -36,6 +42,15 @@ void mitk::IGTLMessageToUSImageFilter::GetNextRawImage(
   igtl::MessageBase::Pointer msgBase = msg->GetMessage();
   igtl::ImageMessage* imgMsg = (igtl::ImageMessage*)(msgBase.GetPointer());
 
+  // the upstream source did not receive a new message since the last call
+  if (msgBase == m_previousMessage && m_previousImage.IsNotNull())
+  {
+    img = m_previousImage;
+    return;
+  }
+
+  this->ReleaseUnusedFrames();
+
   bool big_endian = (imgMsg->GetEndian() == igtl::ImageMessage::ENDIAN_BIG);
 
   if (imgMsg->GetCoordinateSystem() != igtl::ImageMessage::COORDINATE_RAS)
@@ -80,22 +95,14 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
   igtl::ImageMessage* msg,
   bool big_endian)
 {
-  typedef itk::Image<TPixel, 3> ImageType;
-
-  typename ImageType::Pointer output = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::RegionType::SizeType size;
-  typename ImageType::RegionType::IndexType index;
-  typename ImageType::SpacingType spacing;
-  typename ImageType::PointType origin;
-
   // Copy dimensions
   int dims[3];
+  unsigned int dimensions[3];
   msg->GetDimensions(dims);
   size_t num_pixel = 1;
   for (size_t i = 0; i < 3; i++)
   {
-    size[i] = dims[i];
+    dimensions[i] = dims[i];
     num_pixel *= dims[i];
   }
 
@@ -112,57 +119,92 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
     }
   }
 
-  index.Fill(0);
-
-  float matF[4][4];
-  msg->GetMatrix(matF);
-  vtkSmartPointer<vtkMatrix4x4> vtkMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-
-  for (size_t i = 0; i < 4; ++i)
-    for (size_t j = 0; j < 4; ++j)
-      vtkMatrix->SetElement(i, j, matF[i][j]);
-
   float spacingMsg[3];
-
   msg->GetSpacing(spacingMsg);
-
+  mitk::Vector3D spacing;
   for (int i = 0; i < 3; ++i)
     spacing[i] = spacingMsg[i];
 
-  region.SetSize(size);
-  region.SetIndex(index);
-  output->SetRegions(region);
-  output->SetSpacing(spacing);
-  output->Allocate();
+  // Even though the ByteSwapper methods are called "FromSystemToBigEndian", they
+  // also swap "FromBigEndianToSystem".
+  bool swap = sizeof(TPixel) > 1 &&
+    (big_endian ? itk::ByteSwapper<TPixel>::SystemIsLittleEndian() : itk::ByteSwapper<TPixel>::SystemIsBigEndian());
 
   TPixel* in = (TPixel*)msg->GetScalarPointer();
-  TPixel* out = (TPixel*)output->GetBufferPointer();
-  memcpy(out, in, num_pixel * sizeof(TPixel));
-  if (big_endian)
+  mitk::PixelType pixelType = mitk::MakeScalarPixelType<TPixel>();
+
+  if (!swap)
   {
-    // Even though this method is called "FromSystemToBigEndian", it also swaps
-    // "FromBigEndianToSystem".
-    // This makes sense, but might be confusing at first glance.
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
+    // Adopt the message body as image buffer. The message must not be
+    // released before the image, so both are stored as one frame.
+    img = mitk::Image::New();
+    img->Initialize(pixelType, 3, dimensions);
+    img->SetImportVolume(in, 0, 0, mitk::Image::ReferenceMemory);
+
+    Frame frame;
+    frame.Image = img;
+    frame.Message = msg;
+    m_FramePool.push_back(frame);
   }
   else
   {
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
+    img = this->GetRecycledImage(pixelType, dimensions);
+    img->SetImportVolume(in, 0, 0, mitk::Image::CopyMemory);
+
+    mitk::ImageWriteAccessor writeAccess(img);
+    TPixel* out = (TPixel*)writeAccess.GetData();
+    if (big_endian)
+    {
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
+    }
+    else
+    {
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
+    }
   }
 
-  img = mitk::Image::New();
-  img->InitializeByItk(output.GetPointer());
-  img->SetVolume(output->GetBufferPointer());
-  //img->GetGeometry()->SetIndexToWorldTransformByVtkMatrix(vtkMatrix);
+  img->GetGeometry()->SetSpacing(spacing);
   m_previousImage = img;
+  m_previousMessage = msg;
+}
 
-  float iorigin[3];
-  msg->GetOrigin(iorigin);
-  for (size_t i = 0; i < 3; i++)
+void mitk::IGTLMessageToUSImageFilter::ReleaseUnusedFrames()
+{
+  std::size_t numberOfFreeFrames = 0;
+  auto isUnused = [&numberOfFreeFrames](const Frame& frame)
   {
-    origin[i] = iorigin[i];
+    if (frame.Image->GetReferenceCount() != 1)
+      return false;
+
+    // frames with an own buffer are kept for recycling
+    return frame.Message.IsNotNull() || ++numberOfFreeFrames > MAXIMUM_NUMBER_OF_FREE_FRAMES;
+  };
+
+  m_FramePool.erase(std::remove_if(m_FramePool.begin(), m_FramePool.end(), isUnused), m_FramePool.end());
+}
+
+mitk::Image::Pointer mitk::IGTLMessageToUSImageFilter::GetRecycledImage(const mitk::PixelType& pixelType,
+  const unsigned int* dimensions)
+{
+  for (auto& frame : m_FramePool)
+  {
+    if (frame.Message.IsNotNull() || frame.Image->GetReferenceCount() != 1)
+      continue;
+
+    if (frame.Image->GetPixelType() == pixelType &&
+      frame.Image->GetDimension(0) == dimensions[0] &&
+      frame.Image->GetDimension(1) == dimensions[1] &&
+      frame.Image->GetDimension(2) == dimensions[2])
+    {
+      return frame.Image;
+    }
   }
-  output->SetOrigin(origin);
+
+  Frame frame;
+  frame.Image = mitk::Image::New();
+  frame.Image->Initialize(pixelType, 3, dimensions);
+  m_FramePool.push_back(frame);
+  return frame.Image;
 }
 
 mitk::IGTLMessageToUSImageFilter::IGTLMessageToUSImageFilter()
@@ -19,8 +19,21 @@ found in the LICENSE file.
 #include <mitkIGTLMessageSource.h>
 #include <igtlImageMessage.h>
 
+#include <vector>
+
 namespace mitk
 {
+  /**
+   * \brief Converts OpenIGTLink image messages into mitk::Image objects.
+   *
+   * Little endian messages (the common case) are not copied: the image
+   * references the pixel data in the body of the received message, and the
+   * message is kept alive together with the image in a frame pool. A frame is
+   * recycled for a later message of the same size and pixel type as soon as
+   * the image is not referenced outside of this filter anymore, so streaming
+   * does neither allocate image buffers nor copy pixel data. Messages that
+   * need a byte swap are copied into an image owned buffer.
+   */
   class MITKUS_EXPORT IGTLMessageToUSImageFilter : public USImageSource
   {
   public:
@@ -60,8 +73,32 @@ namespace mitk
     void GetNextRawImage(std::vector<mitk::Image::Pointer>& imgVector) override;
 
   private:
+    /**
+     * \brief An image together with the message whose body it references.
+     */
+    struct Frame
+    {
+      mitk::Image::Pointer Image;
+      igtl::MessageBase::Pointer Message;
+    };
+
+    /**
+     * \brief Removes frames whose images are not referenced outside of this
+     * filter anymore. The messages of zero-copy frames are released, frames
+     * with an own buffer are kept for GetRecycledImage().
+     */
+    void ReleaseUnusedFrames();
+
+    /**
+     * \brief Returns an image with an own buffer that is not referenced
+     * outside of this filter and fits the given layout, or a new image.
+     */
+    mitk::Image::Pointer GetRecycledImage(const mitk::PixelType& pixelType, const unsigned int* dimensions);
+
     mitk::IGTLMessageSource* m_upstream;
     mitk::Image::Pointer m_previousImage;
+    igtl::MessageBase::Pointer m_previousMessage;
+    std::vector<Frame> m_FramePool;
     /**
      * \brief Templated method to copy the data of the OIGTL message to the image, depending
      * on the pixel type contained in the message.